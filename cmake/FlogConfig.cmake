@@ -21,6 +21,46 @@
 find_package(OpenSSL)
 find_package(Threads)
 
+# The checked-in codecs of fixed-size protocol structures can only be
+# regenerated when Python 3 is available. FindPython3 is new in CMake 3.12;
+# older versions search with FindPythonInterp instead.
+if(NOT CMAKE_VERSION VERSION_LESS 3.12)
+  find_package(Python3 COMPONENTS Interpreter)
+else()
+  find_package(PythonInterp 3)
+  set(Python3_Interpreter_FOUND ${PYTHONINTERP_FOUND})
+  set(Python3_EXECUTABLE ${PYTHON_EXECUTABLE})
+endif()
+if(Python3_Interpreter_FOUND)
+  set(FLOG_HAVE_CODEGEN TRUE)
+else()
+  message(STATUS "Python 3 not found: Disabling codec generation")
+  set(FLOG_HAVE_CODEGEN FALSE)
+endif()
+
+# Optional system facilities. The io_uring reactor backend is built when
+# the kernel headers provide it, and is probed again at run time.
+include(CheckIncludeFileCXX)
+check_include_file_cxx(linux/io_uring.h FLOG_HAVE_IO_URING)
+if(FLOG_HAVE_IO_URING)
+  add_definitions(-DFLOG_HAVE_IO_URING)
+endif()
+
+# The coroutine interface for applications is header-only, and needs a
+# compiler that accepts -std=c++20. The libraries remain C++11.
+include(CheckCXXSourceCompiles)
+set(CMAKE_REQUIRED_FLAGS "-std=c++20")
+check_cxx_source_compiles("
+  #include <coroutine>
+  int main() { return __cpp_impl_coroutine ? 0 : 1; }"
+  FLOG_HAVE_COROUTINES)
+unset(CMAKE_REQUIRED_FLAGS)
+
+# The lowest log level compiled into the libraries and tools: 0 (Debug),
+# 1 (Info), 2 (Warning) or 3 (Error).
+set(FLOG_LOG_LEVEL 1 CACHE STRING "Lowest log level compiled in")
+add_definitions(-DFLOG_LOG_LEVEL=${FLOG_LOG_LEVEL})
+
 # Set up global include directories for the compiler.
 include_directories(${OPENSSL_INCLUDE_DIR} ${CMAKE_SOURCE_DIR})
 
@@ -0,0 +1,118 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <algorithm>
+#include <cstdint>
+
+#include "arena.hpp"
+#include "pool.hpp"
+
+namespace flog {
+
+namespace {
+
+// The arena of the innermost scope on this thread.
+thread_local Arena* current_arena = nullptr;
+
+// Returns p rounded up to a multiple of a, which is a power of two.
+inline char*
+align_up(char* p, std::size_t a)
+{
+  std::uintptr_t n = reinterpret_cast<std::uintptr_t>(p);
+  return reinterpret_cast<char*>((n + a - 1) & ~std::uintptr_t(a - 1));
+}
+
+} // namespace
+
+constexpr std::size_t Arena::default_block;
+
+Arena::Arena(std::size_t block)
+  : head_(nullptr), current_(nullptr), first_(nullptr), last_(nullptr),
+    block_(block), used_(0), reserved_(0)
+{ }
+
+Arena::~Arena()
+{
+  while (Block* b = head_) {
+    head_ = b->next;
+    pool_release(b, sizeof(Block) + b->size);
+  }
+}
+
+void*
+Arena::allocate(std::size_t n, std::size_t a)
+{
+  char* p = align_up(first_, a);
+  if (first_ and p + n <= last_) {
+    first_ = p + n;
+    used_ += n;
+    return p;
+  }
+  return grow(n, a);
+}
+
+// Move to the block after the current one, allocating a new block if
+// there is none or it is too small for n bytes aligned to a. Blocks kept
+// by reset() are reused in order.
+void*
+Arena::grow(std::size_t n, std::size_t a)
+{
+  Block* b = current_ ? current_->next : head_;
+  if (not b or b->size < n + a) {
+    std::size_t size = std::max(block_, n + a);
+    b = static_cast<Block*>(pool_allocate(sizeof(Block) + size));
+    b->size = size;
+    b->next = current_ ? current_->next : head_;
+    if (current_)
+      current_->next = b;
+    else
+      head_ = b;
+    reserved_ += size;
+  }
+  current_ = b;
+  first_ = reinterpret_cast<char*>(b + 1);
+  last_ = first_ + b->size;
+
+  char* p = align_up(first_, a);
+  first_ = p + n;
+  used_ += n;
+  return p;
+}
+
+void
+Arena::reset()
+{
+  if (not head_)
+    return;
+  current_ = head_;
+  first_ = reinterpret_cast<char*>(head_ + 1);
+  last_ = first_ + head_->size;
+  used_ = 0;
+}
+
+Arena*
+Arena::current() { return current_arena; }
+
+Arena_scope::Arena_scope(Arena& a)
+  : prev_(current_arena)
+{
+  current_arena = &a;
+}
+
+Arena_scope::~Arena_scope()
+{
+  current_arena = prev_;
+}
+
+} // namespace flog
@@ -0,0 +1,195 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_ARENA_H
+#define FLOWGRAMMABLE_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+/// \file arena.hpp
+/// Region allocation for decoded messages.
+
+namespace flog {
+
+// -------------------------------------------------------------------------- //
+// Arena
+
+/// \brief A region from which the objects of a message are allocated.
+///
+/// Decoding a message such as a Flow_mod allocates the storage of many
+/// small sequences: the entries of its match, its instructions and the
+/// actions of each instruction. An arena serves these allocations by
+/// bumping a pointer through large blocks, and releases them all at once
+/// when it is reset. Deallocating from an arena does nothing. The blocks
+/// are kept across resets, so an arena that is reused for a stream of
+/// messages settles at the size of the largest and stops allocating.
+///
+/// Allocations are routed to an arena by an Arena_scope. For example:
+///
+///     Arena arena;
+///     {
+///       Arena_scope scope(arena);
+///       v1_3::Message m;
+///       from_buffer(v, m);
+///       handle(m);
+///     }
+///     arena.reset();
+///
+/// The arena must outlive every object allocated from it. A message that
+/// is kept beyond the arena must be copied outside of its scope.
+class Arena
+{
+public:
+  /// The default size of the blocks of an arena.
+  static constexpr std::size_t default_block = 4096;
+
+  explicit Arena(std::size_t block = default_block);
+  ~Arena();
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /// Allocate n bytes aligned to a.
+  void* allocate(std::size_t n, std::size_t a = alignof(std::max_align_t));
+
+  /// Release every allocation. The blocks are kept for reuse.
+  void reset();
+
+  /// Returns the number of bytes allocated since the last reset.
+  std::size_t used() const { return used_; }
+
+  /// Returns the number of bytes held in blocks.
+  std::size_t reserved() const { return reserved_; }
+
+  /// Returns the arena of the innermost scope on the calling thread, or
+  /// nullptr if there is none.
+  static Arena* current();
+
+private:
+  struct Block
+  {
+    Block* next;
+    std::size_t size;
+  };
+
+  void* grow(std::size_t n, std::size_t a);
+
+  Block* head_;
+  Block* current_;
+  char* first_;
+  char* last_;
+  std::size_t block_;
+  std::size_t used_;
+  std::size_t reserved_;
+};
+
+// -------------------------------------------------------------------------- //
+// Arena scope
+
+/// \brief Routes the allocations of the calling thread to an arena.
+///
+/// Scopes nest; the previous arena, if any, is restored when the scope
+/// ends.
+class Arena_scope
+{
+public:
+  explicit Arena_scope(Arena& a);
+  ~Arena_scope();
+
+  Arena_scope(const Arena_scope&) = delete;
+  Arena_scope& operator=(const Arena_scope&) = delete;
+
+private:
+  Arena* prev_;
+};
+
+// -------------------------------------------------------------------------- //
+// Allocator
+
+/// \brief An allocator that draws from the arena of the current scope.
+///
+/// An allocator binds to the calling thread's current arena when it is
+/// constructed, and to the heap when there is none. A container keeps the
+/// allocator it was constructed with, so sequences created while decoding
+/// a message in an arena scope allocate from that arena for their entire
+/// lifetime. Moving a container moves its allocator. Copying a container
+/// binds the copy to the current arena, so that a message copied outside
+/// any scope is independent of the arena it was decoded into.
+template<typename T>
+  class Allocator
+  {
+  public:
+    using value_type = T;
+
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    Allocator()
+      : arena_(Arena::current()) { }
+
+    template<typename U>
+      Allocator(const Allocator<U>& x)
+        : arena_(x.arena()) { }
+
+    T* allocate(std::size_t n);
+    void deallocate(T* p, std::size_t n);
+
+    Allocator select_on_container_copy_construction() const {
+      return Allocator();
+    }
+
+    /// Returns the arena, or nullptr if allocating from the heap.
+    Arena* arena() const { return arena_; }
+
+  private:
+    Arena* arena_;
+  };
+
+template<typename T>
+  inline T*
+  Allocator<T>::allocate(std::size_t n)
+  {
+    if (arena_)
+      return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+template<typename T>
+  inline void
+  Allocator<T>::deallocate(T* p, std::size_t)
+  {
+    if (not arena_)
+      ::operator delete(p);
+  }
+
+template<typename T, typename U>
+  inline bool
+  operator==(const Allocator<T>& a, const Allocator<U>& b)
+  {
+    return a.arena() == b.arena();
+  }
+
+template<typename T, typename U>
+  inline bool
+  operator!=(const Allocator<T>& a, const Allocator<U>& b)
+  {
+    return a.arena() != b.arena();
+  }
+
+} // namespace flog
+
+#endif
@@ -0,0 +1,120 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <cstdint>
+#include <iostream>
+
+#include <libflog/sequence.hpp>
+
+using namespace flog;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+bool
+aligned(void* p, std::size_t a)
+{
+  return reinterpret_cast<std::uintptr_t>(p) % a == 0;
+}
+
+int main()
+{
+  // Allocations are aligned and bump through a block.
+  {
+    Arena a(256);
+    char* p = static_cast<char*>(a.allocate(3, 1));
+    void* q = a.allocate(8, 8);
+    if (not aligned(q, 8) or static_cast<char*>(q) - p >= 16)
+      return fail("allocation was not aligned in the block");
+    if (a.used() != 11 or a.reserved() != 256)
+      return fail("allocations did not bump through the block");
+
+    // Large allocations get their own block. Blocks are reused after a
+    // reset.
+    a.allocate(1000);
+    std::size_t n = a.reserved();
+    if (n <= 1000)
+      return fail("large allocation did not get its own block");
+    a.reset();
+    if (a.used() != 0 or a.reserved() != n)
+      return fail("reset did not keep the blocks");
+    void* r = a.allocate(3, 1);
+    if (r != p)
+      return fail("first block was not reused after a reset");
+    a.allocate(1000);
+    if (a.reserved() != n)
+      return fail("large block was not reused after a reset");
+  }
+
+  // Scopes nest.
+  {
+    Arena a, b;
+    if (Arena::current() != nullptr)
+      return fail("arena is current outside of any scope");
+    {
+      Arena_scope s1(a);
+      if (Arena::current() != &a)
+        return fail("arena of the scope is not current");
+      {
+        Arena_scope s2(b);
+        if (Arena::current() != &b)
+          return fail("arena of the inner scope is not current");
+      }
+      if (Arena::current() != &a)
+        return fail("arena of the outer scope was not restored");
+    }
+    if (Arena::current() != nullptr)
+      return fail("arena is current after its scope");
+  }
+
+  // Sequences, including nested ones, allocate from the arena of the
+  // scope they are created in.
+  {
+    using Inner = Sequence<int>;
+    using Outer = Sequence<Inner>;
+
+    Arena a;
+    Outer t;
+    {
+      Outer y;
+      {
+        Arena_scope scope(a);
+        Outer x;
+        for (int i = 0; i < 10; ++i)
+          x.push_back(Inner(i, i));
+        if (x.get_allocator().arena() != &a
+            or x[9].get_allocator().arena() != &a or a.used() == 0)
+          return fail("sequences were not allocated from the arena");
+
+        // Moving keeps the arena.
+        y = std::move(x);
+        if (y.get_allocator().arena() != &a)
+          return fail("moving did not keep the arena");
+      }
+
+      // Copies made outside of any scope are on the heap.
+      t = y;
+      if (t.get_allocator().arena() != nullptr
+          or t[9].get_allocator().arena() != nullptr)
+        return fail("copy outside of any scope was not on the heap");
+    }
+    a.reset();
+    if (t.size() != 10 or t[9] != Inner(9, 9))
+      return fail("copy did not survive a reset of the arena");
+  }
+}
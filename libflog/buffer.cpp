@@ -63,9 +63,7 @@ from_buffer(Buffer_view& v, Buffer& b)
 Error_condition
 from_buffer(Buffer_view& v, Greedy_buffer& b)
 {
-  if (not remaining(v))
-    return SUCCESS;
-  b = Greedy_buffer(v.first, v.last);
+  b.assign(v.first, v.last);
   v.first = v.last;
   return SUCCESS;
 }
@@ -80,6 +78,68 @@ to_string(const Buffer& b, Formatter& f)
   return ss.str();
 }
 
+// -------------------------------------------------------------------------- //
+// Buffer reference
+
+void
+Buffer_ref::own()
+{
+  if (owned_)
+    return;
+  store_ = Buffer(first_, last_);
+  owned_ = true;
+  rebase();
+}
+
+bool
+operator==(const Buffer_ref& a, const Buffer_ref& b)
+{
+  return a.size() == b.size() and std::equal(a.begin(), a.end(), b.begin());
+}
+
+bool
+operator!=(const Buffer_ref& a, const Buffer_ref& b)
+{
+  return not (a == b);
+}
+
+Error_condition
+to_buffer(Buffer_view& v, const Buffer_ref& b)
+{
+  if (not available(v, b.size()))
+    return AVAILABLE_BUFFER;
+  put(v, b.data(), b.size());
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Buffer_ref& b)
+{
+  b = Buffer_ref(v.first, v.last);
+  v.first = v.last;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Buffer_ref& b, std::size_t n)
+{
+  if (not available(v, n))
+    return AVAILABLE_BUFFER;
+  b = Buffer_ref(v.first, v.first + n);
+  v.first += n;
+  return SUCCESS;
+}
+
+std::string
+to_string(const Buffer_ref& b, Formatter& f)
+{
+  std::stringstream ss;
+  open_block(ss, f, "Buffer");
+  nvp_to_string(ss, f, "Bytes", b.size());
+  close_block(ss, f, "Buffer");
+  return ss.str();
+}
+
 
 
 } // namespace flog
@@ -22,6 +22,7 @@
 
 #include "utilities.hpp"
 #include "error.hpp"
+#include "pool.hpp"
 
 /// \file buffer.hpp
 /// Resources for memory buffers.
@@ -34,6 +35,9 @@ class Buffer_view;
 
 using Byte = uint8_t;
 
+/// The storage of a Buffer, drawn from the size-class pool.
+using Byte_vector = std::vector<Byte, Pool_allocator<Byte>>;
+
 // -------------------------------------------------------------------------- //
 // Buffer
 
@@ -56,7 +60,11 @@ using Byte = uint8_t;
 ///     if (b) {
 ///       std::cout << "success!\n";
 ///     }
-class Buffer : public std::vector<Byte>
+///
+/// The storage of a buffer comes from a size-class pool (see pool.hpp), so
+/// that the buffers of a steady stream of messages are recycled rather
+/// than allocated anew.
+class Buffer : public Byte_vector
 {
 public:
   enum State { GOOD, MISSING, BAD };
@@ -97,18 +105,18 @@ private:
 
 inline 
 Buffer::Buffer()
-  : std::vector<Byte>(), state_(GOOD), missing_(0) 
+  : Byte_vector(), state_(GOOD), missing_(0) 
 { }
 
 inline 
 Buffer::Buffer(Buffer&& x)
-  : std::vector<Byte>(std::move(x)), state_(x.state_), missing_(x.missing_) 
+  : Byte_vector(std::move(x)), state_(x.state_), missing_(x.missing_) 
 { }
 
 inline Buffer&
 Buffer::operator=(Buffer&& x)
 {
-  std::vector<Byte>::operator=(std::move(x));
+  Byte_vector::operator=(std::move(x));
   state_ = x.state_;
   missing_ = x.missing_;
   return *this;
@@ -116,13 +124,13 @@ Buffer::operator=(Buffer&& x)
 
 inline 
 Buffer::Buffer(const Buffer& x)
-  : std::vector<Byte>(x), state_(x.state_), missing_(x.missing_) 
+  : Byte_vector(x), state_(x.state_), missing_(x.missing_) 
 { }
 
 inline Buffer&
 Buffer::operator=(const Buffer& x)
 {
-  std::vector<Byte>::operator=(x);
+  Byte_vector::operator=(x);
   state_ = x.state_;
   missing_ = x.missing_;
   return *this;
@@ -130,12 +138,12 @@ Buffer::operator=(const Buffer& x)
 
 inline
 Buffer::Buffer(std::size_t n)
-  : std::vector<Byte>(n), state_(GOOD), missing_(0)
+  : Byte_vector(n), state_(GOOD), missing_(0)
 { }
 
 inline
 Buffer::Buffer(const Byte* first, const Byte* last)
-  : std::vector<Byte>(first, last), state_(GOOD), missing_(0)
+  : Byte_vector(first, last), state_(GOOD), missing_(0)
 { }
 
 inline void
@@ -206,6 +214,169 @@ struct Greedy_buffer : Buffer
 Error_condition from_buffer(Buffer_view&, Greedy_buffer&);
 
 
+// -------------------------------------------------------------------------- //
+// Buffer reference
+
+/// \brief A sequence of bytes that may be borrowed from another buffer.
+///
+/// Reading a buffer reference from a view does not copy any bytes. The
+/// reference points into the buffer underlying the view, which must
+/// outlive it. This is how decoded messages hold packet data, so that a
+/// Packet_in does not duplicate the frame it was received in. A message
+/// that is kept after its receive buffer is reused must first take
+/// ownership of its data by calling own().
+///
+/// A reference constructed from a Buffer owns a copy of its bytes. Copying
+/// an owned reference copies the bytes; copying a borrowed reference
+/// borrows the same bytes.
+class Buffer_ref
+{
+public:
+  Buffer_ref();
+
+  /// Borrow the bytes in [f, l).
+  Buffer_ref(Byte* f, Byte* l);
+
+  /// Own the bytes of b.
+  Buffer_ref(const Buffer& b);
+  Buffer_ref(Buffer&& b);
+
+  // Move semantics
+  Buffer_ref(Buffer_ref&& x);
+  Buffer_ref& operator=(Buffer_ref&& x);
+
+  // Copy semantics
+  Buffer_ref(const Buffer_ref& x);
+  Buffer_ref& operator=(const Buffer_ref& x);
+
+  Byte* data() { return first_; }
+  const Byte* data() const { return first_; }
+
+  std::size_t size() const { return last_ - first_; }
+  bool empty() const { return first_ == last_; }
+
+  Byte* begin() { return first_; }
+  Byte* end() { return last_; }
+  const Byte* begin() const { return first_; }
+  const Byte* end() const { return last_; }
+
+  Byte& operator[](std::size_t n) { return first_[n]; }
+  const Byte& operator[](std::size_t n) const { return first_[n]; }
+
+  /// Returns true if the bytes belong to another buffer.
+  bool borrowed() const { return not owned_; }
+
+  /// Copy borrowed bytes into storage owned by the reference. This has
+  /// no effect if the reference already owns its bytes.
+  void own();
+
+private:
+  void rebase();
+
+  Byte* first_;
+  Byte* last_;
+  bool owned_;
+  Buffer store_;
+};
+
+inline
+Buffer_ref::Buffer_ref()
+  : first_(nullptr), last_(nullptr), owned_(true)
+{ }
+
+inline
+Buffer_ref::Buffer_ref(Byte* f, Byte* l)
+  : first_(f), last_(l), owned_(false)
+{ }
+
+inline
+Buffer_ref::Buffer_ref(const Buffer& b)
+  : owned_(true), store_(b)
+{ rebase(); }
+
+inline
+Buffer_ref::Buffer_ref(Buffer&& b)
+  : owned_(true), store_(std::move(b))
+{ rebase(); }
+
+inline
+Buffer_ref::Buffer_ref(Buffer_ref&& x)
+  : first_(x.first_), last_(x.last_), owned_(x.owned_),
+    store_(std::move(x.store_))
+{
+  if (owned_)
+    rebase();
+}
+
+inline Buffer_ref&
+Buffer_ref::operator=(Buffer_ref&& x)
+{
+  first_ = x.first_;
+  last_ = x.last_;
+  owned_ = x.owned_;
+  store_ = std::move(x.store_);
+  if (owned_)
+    rebase();
+  return *this;
+}
+
+inline
+Buffer_ref::Buffer_ref(const Buffer_ref& x)
+  : first_(x.first_), last_(x.last_), owned_(x.owned_), store_(x.store_)
+{
+  if (owned_)
+    rebase();
+}
+
+inline Buffer_ref&
+Buffer_ref::operator=(const Buffer_ref& x)
+{
+  first_ = x.first_;
+  last_ = x.last_;
+  owned_ = x.owned_;
+  store_ = x.store_;
+  if (owned_)
+    rebase();
+  return *this;
+}
+
+inline void
+Buffer_ref::rebase()
+{
+  first_ = store_.data();
+  last_ = first_ + store_.size();
+}
+
+/// \relates Buffer_ref
+bool operator==(const Buffer_ref& a, const Buffer_ref& b);
+
+/// \relates Buffer_ref
+bool operator!=(const Buffer_ref& a, const Buffer_ref& b);
+
+/// \relates Buffer_ref
+inline std::size_t
+bytes(const Buffer_ref& b) { return b.size(); }
+
+/// \relates Buffer_ref
+constexpr bool
+is_valid(const Buffer_ref&) { return true; }
+
+/// \relates Buffer_ref
+Error_condition to_buffer(Buffer_view& v, const Buffer_ref& b);
+
+/// \brief Borrow the remaining bytes of the view.
+/// \relates Buffer_ref
+Error_condition from_buffer(Buffer_view& v, Buffer_ref& b);
+
+/// \brief Borrow the next n bytes of the view. If the view does not have
+/// n bytes available, this returns AVAILABLE_BUFFER.
+/// \relates Buffer_ref
+Error_condition from_buffer(Buffer_view& v, Buffer_ref& b, std::size_t n);
+
+/// \relates Buffer_ref
+std::string to_string(const Buffer_ref&, Formatter&);
+
+
 // -------------------------------------------------------------------------- //
 // Buffer View
 
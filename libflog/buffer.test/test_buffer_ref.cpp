@@ -0,0 +1,91 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <iostream>
+
+#include <libflog/proto/ofp/v1_3/message.hpp>
+
+using namespace flog;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+int main()
+{
+  Buffer frame(32);
+  for (std::size_t i = 0; i < frame.size(); ++i)
+    frame[i] = i;
+
+  // Reading a reference borrows the bytes of the view.
+  {
+    Buffer_view v(frame);
+    Buffer_ref r;
+    if (not from_buffer(v, r, 8))
+      return fail("reference was not read");
+    if (not r.borrowed() or r.data() != frame.data() or r.size() != 8)
+      return fail("reference did not borrow the bytes of the view");
+    if (not from_buffer(v, r))
+      return fail("rest of the view was not read");
+    if (r.data() != frame.data() + 8 or r.size() != 24 or remaining(v) != 0)
+      return fail("reference did not take the rest of the view");
+
+    // Copies of a borrowed reference share its bytes.
+    Buffer_ref c = r;
+    if (not c.borrowed() or c.data() != r.data())
+      return fail("copy did not share the borrowed bytes");
+
+    // Taking ownership copies the bytes out of the frame.
+    c.own();
+    if (c.borrowed() or c.data() == r.data() or c != r)
+      return fail("taking ownership did not copy the bytes");
+    frame[8] = 0xff;
+    if (r[0] != 0xff or c[0] != 8)
+      return fail("owned bytes were changed with the frame");
+    frame[8] = 8;
+
+    Buffer_ref o = Buffer(4);
+    if (o.borrowed() or o.size() != 4)
+      return fail("reference made from a buffer is not owned");
+  }
+
+  // A decoded Packet_in refers to the data in the receive buffer.
+  {
+    using namespace ofp::v1_3;
+    Buffer payload(frame.data(), frame.data() + 20);
+    Packet_in pi(-1, payload.size(), Packet_in::NO_MATCH, 0, 0,
+                 Match(Match::MT_OXM, 4, {}), payload);
+    Buffer buf(bytes(pi));
+    Buffer_view v(buf);
+    if (not to_buffer(v, pi))
+      return fail("packet in was not encoded");
+
+    Packet_in x;
+    Buffer_view w(buf);
+    if (not from_buffer(w, x))
+      return fail("packet in was not decoded");
+    if (not x.data.borrowed() or x.data != pi.data
+        or x.data.end() != buf.data() + buf.size())
+      return fail("decoded data does not refer to the receive buffer");
+
+    Packet_in kept = x;
+    kept.data.own();
+    std::fill(buf.begin(), buf.end(), 0);
+    if (kept.data != pi.data or x.data == pi.data)
+      return fail("owned data was changed with the receive buffer");
+  }
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+// 
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+
+extern "C" {
+#include <errno.h>
+#include <unistd.h>
+}
+
+#include <cstring>
+
+#include "framer.hpp"
+
+namespace flog {
+
+const std::size_t Framer::Header_size;
+const std::size_t Framer::Max_message;
+const std::size_t Framer::Initial_size;
+
+namespace {
+
+// The buffer never grows beyond room for two of the largest messages.
+const std::size_t Max_capacity = 2 * (Framer::Max_message + 1);
+
+} // namespace
+
+std::size_t
+Framer::read()
+{
+  std::size_t total = 0;
+  stalled = false;
+  while(good and not eof) {
+    if(not reserve()) {
+      stalled = true;
+      break;
+    }
+    std::size_t space = buffer.size() - end;
+    ssize_t n = ::read(file_ds, &buffer[end], space);
+    if(n < 0) {
+      if(errno == EINTR)
+        continue;
+      if(errno != EAGAIN and errno != EWOULDBLOCK)
+        good = false;
+      break;
+    }
+    if(n == 0) {
+      eof = true;
+      break;
+    }
+    end += n;
+    total += n;
+    frame();
+
+    // A short read means the socket has been drained.
+    if(std::size_t(n) < space)
+      break;
+  }
+  return total;
+}
+
+std::size_t
+Framer::append(const Byte* first, std::size_t n)
+{
+  std::size_t total = 0;
+  while(good and total < n and reserve()) {
+    std::size_t k = std::min(n - total, buffer.size() - end);
+    std::memcpy(&buffer[end], first + total, k);
+    end += k;
+    total += k;
+    frame();
+  }
+  return total;
+}
+
+// Advance over the complete messages that follow the last one framed.
+void
+Framer::frame()
+{
+  while(end - partial >= Header_size) {
+    std::size_t len = length(partial);
+    if(len < Header_size) {
+      good = false;
+      return;
+    }
+    if(end - partial < len)
+      return;
+    partial += len;
+    ++count;
+  }
+}
+
+// Ensure that there is space at the end of the buffer for more data,
+// and enough for the incomplete message to be received in place.
+bool
+Framer::reserve()
+{
+  std::size_t need = Header_size;
+  if(end - partial >= Header_size)
+    need = length(partial);
+
+  if(end < buffer.size() and partial + need <= buffer.size())
+    return true;
+
+  // Move the unconsumed bytes to the front of the buffer.
+  if(begin > 0) {
+    std::memmove(&buffer[0], &buffer[begin], end - begin);
+    partial -= begin;
+    end -= begin;
+    begin = 0;
+    if(end < buffer.size() and partial + need <= buffer.size())
+      return true;
+  }
+
+  if(buffer.size() >= Max_capacity)
+    return false;
+  std::size_t size = std::max(buffer.size() * 2, partial + need);
+  buffer.resize(std::min(size, Max_capacity));
+  return true;
+}
+
+} // namespace flog
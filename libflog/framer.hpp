@@ -0,0 +1,110 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_FRAMER_HPP
+#define FLOWGRAMMABLE_FRAMER_HPP
+
+#include "buffer.hpp"
+
+namespace flog {
+
+/// \brief Splits a byte stream into OpenFlow messages.
+///
+/// The Framer reads as much as a stream descriptor offers into a single
+/// growable buffer and yields each complete message as a view of that
+/// buffer, delimited by the length field of the message header. Messages
+/// are never copied while they are framed: the buffer is only compacted,
+/// moving the unconsumed bytes to its front, when the message being
+/// received would not fit in the space remaining at its end, and only
+/// grown when compaction is not enough.
+///
+/// Views returned by next() remain valid until the next call to read()
+/// or append().
+///
+/// A header whose length is less than the size of a header cannot be
+/// framed, and puts the framer into a bad state.
+class Framer
+{
+  public:
+
+    /// The size of an OpenFlow header.
+    static const std::size_t Header_size = 8;
+
+    /// The largest message that the header's length field can describe.
+    static const std::size_t Max_message = 65535;
+
+    /// The initial size of the buffer.
+    static const std::size_t Initial_size = 4096;
+
+    explicit Framer(int fd, std::size_t n = Initial_size);
+
+    /// Read from the descriptor until it has no more data, the stream
+    /// ends, or the buffer cannot hold more unconsumed data. Returns the
+    /// number of bytes read.
+    std::size_t read();
+
+    /// Append bytes received by other means, e.g. from a TLS session.
+    /// Returns the number of bytes accepted.
+    std::size_t append(const Byte* first, std::size_t n);
+
+    /// Returns the number of bytes that have been received but not
+    /// consumed by next().
+    std::size_t available() const;
+
+    /// Returns the number of complete messages that are ready.
+    std::size_t ready() const;
+
+    /// Returns a view of the next complete message and consumes it. The
+    /// behavior is undefined if no message is ready.
+    Buffer_view next();
+
+    /// Returns true if the peer closed the stream.
+    bool closed() const;
+
+    /// Returns true if the last read() stopped because the buffer could
+    /// not hold more unconsumed data, rather than because the descriptor
+    /// had no more to offer. Consuming the ready messages makes room to
+    /// read the rest.
+    bool full() const;
+
+    /// Returns the size of the buffer.
+    std::size_t capacity() const;
+
+    /// Returns false if the framer is in a bad state.
+    explicit operator bool() const;
+
+  private:
+
+    std::size_t length(std::size_t pos) const;
+    void frame();
+    bool reserve();
+
+    int file_ds;
+
+    std::size_t begin;    // The first unconsumed byte
+    std::size_t partial;  // The first byte of the first incomplete message
+    std::size_t end;      // One past the last byte received
+    std::size_t count;    // The number of complete messages
+
+    bool eof;
+    bool good;
+    bool stalled;
+    Buffer buffer;
+};
+
+} // namespace flog
+
+#include "framer.ipp"
+
+#endif
@@ -0,0 +1,84 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+// 
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+
+namespace flog {
+
+inline
+Framer::Framer(int fd, std::size_t n)
+  : file_ds(fd), begin(0), partial(0), end(0), count(0), eof(false),
+    good(true), stalled(false), buffer(std::max(n, Header_size))
+{ }
+
+inline std::size_t
+Framer::available() const
+{
+  return end - begin;
+}
+
+inline std::size_t
+Framer::ready() const
+{
+  return count;
+}
+
+inline bool
+Framer::closed() const
+{
+  return eof;
+}
+
+inline bool
+Framer::full() const
+{
+  return stalled;
+}
+
+inline std::size_t
+Framer::capacity() const
+{
+  return buffer.size();
+}
+
+inline
+Framer::operator bool() const
+{
+  return good;
+}
+
+// Returns the length field of the header at pos, which must be received.
+inline std::size_t
+Framer::length(std::size_t pos) const
+{
+  return (std::size_t(buffer[pos + 2]) << 8) | buffer[pos + 3];
+}
+
+inline Buffer_view
+Framer::next()
+{
+  assert(count > 0);
+  std::size_t first = begin;
+  begin += length(begin);
+  --count;
+
+  Buffer_view v(buffer, &buffer[first], &buffer[begin]);
+
+  // Once everything is consumed, receive into the front of the buffer
+  // again without having to compact it.
+  if(begin == end)
+    begin = partial = end = 0;
+  return v;
+}
+
+} // namespace flog
@@ -0,0 +1,120 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+extern "C" {
+#include <unistd.h>
+}
+
+#include <iostream>
+#include <vector>
+
+#include <libflog/framer.hpp>
+
+using namespace flog;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+// Append a message of n bytes whose body bytes all have the value x.
+void
+message(std::vector<Byte>& s, std::size_t n, Byte x)
+{
+  Byte h[] = { 4, 0, Byte(n >> 8), Byte(n & 0xff), 0, 0, 0, x };
+  s.insert(s.end(), h, h + 8);
+  s.insert(s.end(), n - 8, x);
+}
+
+bool
+check(const Buffer_view& v, std::size_t n, Byte x)
+{
+  return remaining(v) == n and v.first[7] == x and v.last[-1] == x;
+}
+
+int main()
+{
+  // Several messages arriving together are framed in place.
+  {
+    std::vector<Byte> s;
+    message(s, 8, 1);
+    message(s, 100, 2);
+    message(s, 16, 3);
+    Framer f(-1, 64);
+    if (f.append(s.data(), s.size()) != s.size())
+      return fail("messages were not appended");
+    if (f.ready() != 3)
+      return fail("messages appended together were not framed");
+    if (not check(f.next(), 8, 1) or not check(f.next(), 100, 2)
+        or not check(f.next(), 16, 3))
+      return fail("messages were not framed in order");
+    if (f.ready() != 0 or f.available() != 0)
+      return fail("framer was not emptied");
+  }
+
+  // A message is not ready until its last byte arrives.
+  {
+    std::vector<Byte> s;
+    message(s, 24, 7);
+    Framer f(-1, 16);
+    for(std::size_t i = 0; i < s.size(); ++i) {
+      if (f.ready() != 0)
+        return fail("partial message was ready");
+      f.append(&s[i], 1);
+    }
+    if (f.ready() != 1 or not check(f.next(), 24, 7))
+      return fail("message was not ready after its last byte");
+  }
+
+  // Large messages are read from a descriptor, growing the buffer.
+  {
+    int p[2];
+    if (::pipe(p) != 0)
+      return fail("pipe");
+    std::vector<Byte> s;
+    message(s, 40000, 5);
+    message(s, 12, 6);
+    Framer f(p[0]);
+    std::size_t sent = 0;
+    while(f.ready() < 2) {
+      std::size_t n = std::min<std::size_t>(s.size() - sent, 8192);
+      if (::write(p[1], &s[sent], n) != ssize_t(n))
+        return fail("write to the pipe");
+      sent += n;
+      if (f.read() != n)
+        return fail("framer did not read what was written");
+    }
+    if (f.capacity() < 40000)
+      return fail("buffer did not grow for a large message");
+    if (not check(f.next(), 40000, 5) or not check(f.next(), 12, 6))
+      return fail("large message was not framed");
+
+    ::close(p[1]);
+    f.read();
+    if (not f.closed())
+      return fail("framer did not see the descriptor close");
+    ::close(p[0]);
+  }
+
+  // A header with an impossible length cannot be framed.
+  {
+    Byte h[] = { 4, 0, 0, 4, 0, 0, 0, 0 };
+    Framer f(-1);
+    f.append(h, sizeof(h));
+    if (f)
+      return fail("impossible length was framed");
+  }
+}
@@ -97,6 +97,29 @@ template<typename T, T K>
   inline bool
   is_valid(const Basic_payload_base<T, K>&) { return true; }
 
+// -------------------------------------------------------------------------- //
+// Variant payloads
+
+/// Prepare the variant payload p to be read as a value of kind k. If p is
+/// initialized, it holds a value of kind j. When j and k are the same, that
+/// value is kept so that reading a message into a recycled object
+/// overwrites it in place and reuses any storage it owns. Otherwise, the
+/// old value is destroyed and a value of kind k is constructed in p.
+///
+/// The payload type P must be testable for initialization, and must
+/// provide construct(p, k) and destroy(p, j).
+template<typename P, typename K>
+  inline void
+  emplace(P& p, K j, K k)
+  {
+    if (p) {
+      if (j == k)
+        return;
+      destroy(p, j);
+    }
+    construct(p, k);
+  }
+
 // -------------------------------------------------------------------------- //
 // State Result
 
@@ -142,6 +165,11 @@ template<typename T, typename D = std::default_delete<T>>
     // Disable copy initialization from message vectors.
     State_result(const Message_vector& v) = delete;
 
+    // Initialize the State_result with a continuation flag and by moving
+    // the vector v into the object.
+    State_result(bool b, Message_vector&& v)
+      : first(b), second(std::move(v)) { }
+
     // Destroy the elements in the result vector by deleting them.
     ~State_result() {
       D dtor;
@@ -0,0 +1,182 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <new>
+#include <sstream>
+
+#include "pool.hpp"
+
+namespace flog {
+
+namespace {
+
+// The number of size classes, 64 bytes through 64KB.
+const std::size_t Classes = 11;
+
+// The most memory a thread keeps on the free list of each class.
+const std::size_t Class_limit = 1 << 20;
+
+// A free block, linked through its first bytes.
+struct Block
+{
+  Block* next;
+};
+
+// Set once the thread's pool is destroyed. Buffers with static storage may
+// still be released after that, and go straight to the system.
+thread_local bool exited = false;
+
+// The free lists of a thread. They are returned to the system when the
+// thread exits.
+struct Pool
+{
+  Pool();
+  ~Pool();
+
+  Block* free[Classes];
+  std::size_t count[Classes];
+  Pool_stats stats;
+};
+
+Pool::Pool()
+  : stats{0, 0, 0, 0}
+{
+  for(std::size_t i = 0; i < Classes; ++i) {
+    free[i] = nullptr;
+    count[i] = 0;
+  }
+}
+
+Pool::~Pool()
+{
+  exited = true;
+  for(std::size_t i = 0; i < Classes; ++i) {
+    while(Block* b = free[i]) {
+      free[i] = b->next;
+      ::operator delete(b);
+    }
+  }
+}
+
+thread_local Pool pool;
+
+// Returns the size class of n bytes, or Classes if n is too large.
+inline std::size_t
+size_class(std::size_t n)
+{
+  if(n > Pool_max_block)
+    return Classes;
+  std::size_t c = 0;
+  for(std::size_t s = Pool_min_block; s < n; s <<= 1)
+    ++c;
+  return c;
+}
+
+inline std::size_t
+class_size(std::size_t c)
+{
+  return Pool_min_block << c;
+}
+
+} // namespace
+
+void*
+pool_allocate(std::size_t n)
+{
+  std::size_t c = size_class(n);
+  if(exited)
+    return ::operator new(c == Classes ? n : class_size(c));
+  if(c == Classes) {
+    ++pool.stats.misses;
+    return ::operator new(n);
+  }
+  if(Block* b = pool.free[c]) {
+    pool.free[c] = b->next;
+    --pool.count[c];
+    ++pool.stats.hits;
+    return b;
+  }
+  ++pool.stats.misses;
+  return ::operator new(class_size(c));
+}
+
+void
+pool_release(void* p, std::size_t n)
+{
+  if(not p)
+    return;
+  if(exited) {
+    ::operator delete(p);
+    return;
+  }
+  std::size_t c = size_class(n);
+  if(c == Classes or pool.count[c] * class_size(c) >= Class_limit) {
+    ++pool.stats.returned;
+    ::operator delete(p);
+    return;
+  }
+  Block* b = static_cast<Block*>(p);
+  b->next = pool.free[c];
+  pool.free[c] = b;
+  ++pool.count[c];
+  ++pool.stats.kept;
+}
+
+const Pool_stats&
+pool_stats()
+{
+  return pool.stats;
+}
+
+double
+hit_rate(const Pool_stats& s)
+{
+  uint64_t n = s.hits + s.misses;
+  return n ? double(s.hits) / n : 0.0;
+}
+
+std::string
+to_string(const Pool_stats& s)
+{
+  std::stringstream ss;
+  ss << "hits " << s.hits;
+  ss << ", misses " << s.misses;
+  ss << ", kept " << s.kept;
+  ss << ", returned " << s.returned;
+  ss << ", hit rate " << hit_rate(s);
+  return ss.str();
+}
+
+double
+hit_rate(const Object_pool_stats& s)
+{
+  uint64_t n = s.hits + s.misses;
+  return n ? double(s.hits) / n : 0.0;
+}
+
+std::string
+to_string(const Object_pool_stats& s)
+{
+  std::stringstream ss;
+  ss << "hits " << s.hits;
+  ss << ", misses " << s.misses;
+  ss << ", kept " << s.kept;
+  ss << ", returned " << s.returned;
+  ss << ", live " << s.live;
+  ss << ", high water " << s.high_water;
+  ss << ", hit rate " << hit_rate(s);
+  return ss.str();
+}
+
+} // namespace flog
@@ -0,0 +1,303 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_POOL_H
+#define FLOWGRAMMABLE_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <utility>
+
+/// \file pool.hpp
+/// A size-class memory pool for message buffers, and pools of objects of
+/// a single type.
+
+namespace flog {
+
+// -------------------------------------------------------------------------- //
+// Pool
+
+/// \brief Counters of the calling thread's pool.
+///
+/// A hit is an allocation served from a free list; a miss is one that had
+/// to call the system allocator, including those too large to be pooled.
+/// Released blocks are either kept on a free list or, when the list is
+/// full or the block is too large, returned to the system.
+struct Pool_stats
+{
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t kept;
+  uint64_t returned;
+};
+
+/// The smallest and largest pooled block sizes. Sizes are rounded up to a
+/// power of two within this range.
+const std::size_t Pool_min_block = 64;
+const std::size_t Pool_max_block = 65536;
+
+/// Allocate a block of at least n bytes from the calling thread's pool.
+void* pool_allocate(std::size_t n);
+
+/// Release a block of n bytes, as previously passed to pool_allocate. The
+/// block may be released by a different thread than allocated it.
+void pool_release(void* p, std::size_t n);
+
+/// Returns the counters of the calling thread's pool.
+const Pool_stats& pool_stats();
+
+/// Returns the fraction of allocations that were served from free lists.
+double hit_rate(const Pool_stats& s);
+
+std::string to_string(const Pool_stats& s);
+
+/// \brief An allocator that draws from the size-class pool.
+///
+/// The allocator is stateless, so that containers using it can exchange
+/// storage freely, and memory can be released through any instance.
+template<typename T>
+  struct Pool_allocator
+  {
+    using value_type = T;
+
+    Pool_allocator() = default;
+
+    template<typename U>
+      Pool_allocator(const Pool_allocator<U>&) { }
+
+    T* allocate(std::size_t n);
+    void deallocate(T* p, std::size_t n);
+  };
+
+template<typename T>
+  inline T*
+  Pool_allocator<T>::allocate(std::size_t n)
+  {
+    return static_cast<T*>(pool_allocate(n * sizeof(T)));
+  }
+
+template<typename T>
+  inline void
+  Pool_allocator<T>::deallocate(T* p, std::size_t n)
+  {
+    pool_release(p, n * sizeof(T));
+  }
+
+template<typename T, typename U>
+  inline bool
+  operator==(const Pool_allocator<T>&, const Pool_allocator<U>&)
+  {
+    return true;
+  }
+
+template<typename T, typename U>
+  inline bool
+  operator!=(const Pool_allocator<T>&, const Pool_allocator<U>&)
+  {
+    return false;
+  }
+
+// -------------------------------------------------------------------------- //
+// Object pool
+
+/// \brief Counters of an object pool on the calling thread.
+///
+/// Hits, misses, kept and returned are counted as for the size-class
+/// pool. Live is the number of objects made and not yet released by the
+/// thread, and the high-water mark is the largest it has been. An object
+/// released by a different thread than made it is counted by each, so live
+/// may be negative on a thread that only releases.
+struct Object_pool_stats
+{
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t kept;
+  uint64_t returned;
+  int64_t live;
+  int64_t high_water;
+};
+
+/// The number of free objects a thread keeps in each object pool, unless
+/// the pool says otherwise.
+const std::size_t Object_pool_limit = 256;
+
+double hit_rate(const Object_pool_stats& s);
+
+std::string to_string(const Object_pool_stats& s);
+
+/// \brief A pool of objects of type T.
+///
+/// Each thread keeps a free list of the storage of at most N released
+/// objects. Objects are constructed when made and destroyed when
+/// released; only their storage is reused. Each instantiation of the
+/// template is a separate pool.
+template<typename T, std::size_t N = Object_pool_limit>
+  struct Object_pool
+  {
+    /// Construct a T from args in storage taken from the pool.
+    template<typename... Args>
+      static T* make(Args&&... args);
+
+    /// Destroy the object p, made by any thread, and keep its storage
+    /// unless the free list is full. p may be null.
+    static void release(const T* p);
+
+    /// Returns the counters of the calling thread's pool.
+    static const Object_pool_stats& stats();
+
+    /// Returns the number of free objects kept by the calling thread.
+    static std::size_t free_count();
+
+  private:
+    struct Block
+    {
+      Block* next;
+    };
+
+    struct Cache
+    {
+      Cache();
+      ~Cache();
+
+      Block* free;
+      std::size_t count;
+      Object_pool_stats stats;
+    };
+
+    static Cache& cache();
+    static bool& exited();
+
+    static void* allocate();
+    static void deallocate(void* p);
+  };
+
+template<typename T, std::size_t N>
+  Object_pool<T, N>::Cache::Cache()
+    : free(nullptr), count(0), stats{0, 0, 0, 0, 0, 0}
+  { }
+
+template<typename T, std::size_t N>
+  Object_pool<T, N>::Cache::~Cache()
+  {
+    exited() = true;
+    while(Block* b = free) {
+      free = b->next;
+      ::operator delete(b);
+    }
+  }
+
+// The cache is destroyed when the thread exits, after which objects with
+// static storage may still be released. The flag is trivially destructible
+// so that it can be read at any time.
+template<typename T, std::size_t N>
+  inline bool&
+  Object_pool<T, N>::exited()
+  {
+    static thread_local bool e = false;
+    return e;
+  }
+
+template<typename T, std::size_t N>
+  inline typename Object_pool<T, N>::Cache&
+  Object_pool<T, N>::cache()
+  {
+    static thread_local Cache c;
+    return c;
+  }
+
+template<typename T, std::size_t N>
+  inline void*
+  Object_pool<T, N>::allocate()
+  {
+    static_assert(sizeof(T) >= sizeof(Block), "object too small to pool");
+    if(exited())
+      return ::operator new(sizeof(T));
+    Cache& c = cache();
+    if(++c.stats.live > c.stats.high_water)
+      c.stats.high_water = c.stats.live;
+    if(Block* b = c.free) {
+      c.free = b->next;
+      --c.count;
+      ++c.stats.hits;
+      return b;
+    }
+    ++c.stats.misses;
+    return ::operator new(sizeof(T));
+  }
+
+template<typename T, std::size_t N>
+  inline void
+  Object_pool<T, N>::deallocate(void* p)
+  {
+    if(exited()) {
+      ::operator delete(p);
+      return;
+    }
+    Cache& c = cache();
+    --c.stats.live;
+    if(c.count >= N) {
+      ++c.stats.returned;
+      ::operator delete(p);
+      return;
+    }
+    Block* b = static_cast<Block*>(p);
+    b->next = c.free;
+    c.free = b;
+    ++c.count;
+    ++c.stats.kept;
+  }
+
+template<typename T, std::size_t N>
+  template<typename... Args>
+    inline T*
+    Object_pool<T, N>::make(Args&&... args)
+    {
+      void* p = allocate();
+      try {
+        return new (p) T(std::forward<Args>(args)...);
+      } catch(...) {
+        deallocate(p);
+        throw;
+      }
+    }
+
+template<typename T, std::size_t N>
+  inline void
+  Object_pool<T, N>::release(const T* p)
+  {
+    if(not p)
+      return;
+    p->~T();
+    deallocate(const_cast<T*>(p));
+  }
+
+template<typename T, std::size_t N>
+  inline const Object_pool_stats&
+  Object_pool<T, N>::stats()
+  {
+    return cache().stats;
+  }
+
+template<typename T, std::size_t N>
+  inline std::size_t
+  Object_pool<T, N>::free_count()
+  {
+    return cache().count;
+  }
+
+} // namespace flog
+
+#endif
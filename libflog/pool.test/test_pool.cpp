@@ -0,0 +1,73 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <iostream>
+#include <thread>
+
+#include <libflog/buffer.hpp>
+
+using namespace flog;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+int main()
+{
+  // Blocks of the same size class are recycled.
+  void* p = pool_allocate(100);
+  pool_release(p, 100);
+  Pool_stats before = pool_stats();
+  void* q = pool_allocate(120);
+  if (q != p or pool_stats().hits != before.hits + 1)
+    return fail("block of the same size class was not recycled");
+  pool_release(q, 120);
+
+  // Large blocks bypass the free lists.
+  before = pool_stats();
+  void* r = pool_allocate(Pool_max_block + 1);
+  pool_release(r, Pool_max_block + 1);
+  if (pool_stats().returned != before.returned + 1)
+    return fail("large block was not returned to the heap");
+
+  // A steady stream of buffers allocates nothing once warmed up.
+  {
+    Buffer small(1000), large(1500);
+  }
+  before = pool_stats();
+  for(int i = 0; i < 1000; ++i) {
+    Buffer b(1000 + i % 500);
+    if (b.size() != std::size_t(1000 + i % 500))
+      return fail("buffer does not have the size allocated");
+  }
+  if (pool_stats().misses != before.misses
+      or pool_stats().hits != before.hits + 1000)
+    return fail("warmed up pool allocated from the heap");
+
+  // Each thread has its own pool.
+  bool fresh = false;
+  std::thread t([&fresh]() {
+    fresh = pool_stats().hits == 0;
+    Buffer b(64);
+  });
+  t.join();
+  if (not fresh)
+    return fail("new thread shares the pool of another");
+
+  if (hit_rate(pool_stats()) <= 0.9)
+    return fail("hit rate is too low");
+}
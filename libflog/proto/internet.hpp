@@ -15,6 +15,8 @@
 #ifndef FLOWGRAMMABLE_INTERNET_H
 #define FLOWGRAMMABLE_INTERNET_H
 
+#include <functional>
+
 #include <libflog/proto/ipv4/ipv4.hpp>
 #include <libflog/proto/ipv6/ipv6.hpp>
 
@@ -77,6 +79,12 @@ Address make_address(Transport t, Network n, const std::string& ip,
 
 std::string to_string(const Address& a);
 
+bool operator==(const Address& a, const Address& b);
+bool operator!=(const Address& a, const Address& b);
+
+/// Returns a hash of the network address, transport and port.
+std::size_t hash(const Address& a);
+
 inline
 Address::Address(const Address& a)
   : network(a.network), transport(a.transport), port(a.port), status(a.status)
@@ -97,7 +105,58 @@ Address::Address(const ipv6::Address& a, Transport t, uint16_t p)
   : network(IPv6), v6(a), transport(t), port(p), status(true)
 { }
 
+inline bool
+operator==(const Address& a, const Address& b)
+{
+  if(a.network != b.network or a.transport != b.transport or a.port != b.port)
+    return false;
+  if(a.network == IPv4)
+    return a.v4 == b.v4;
+  if(a.network == IPv6)
+    return a.v6 == b.v6;
+  return true;
+}
+
+inline bool
+operator!=(const Address& a, const Address& b)
+{
+  return !(a == b);
+}
+
+inline std::size_t
+hash(const Address& a)
+{
+  // FNV-1a over the fields that take part in equality.
+  uint64_t h = 14695981039346656037ull;
+  auto mix = [&h](uint8_t b) { h = (h ^ b) * 1099511628211ull; };
+  mix(a.network);
+  mix(a.transport);
+  mix(a.port >> 8);
+  mix(a.port & 0xff);
+  if(a.network == IPv4) {
+    for(int i = 0; i < 4; ++i)
+      mix(a.v4.addr >> (8 * i));
+  } else if(a.network == IPv6) {
+    for(int i = 0; i < 16; ++i)
+      mix(a.v6.addr[i]);
+  }
+  return h;
+}
+
 } // namespace net
 } // namespace flog
 
+namespace std {
+
+template<>
+  struct hash<flog::net::Address>
+  {
+    std::size_t operator()(const flog::net::Address& a) const
+    {
+      return flog::net::hash(a);
+    }
+  };
+
+} // namespace std
+
 #endif
@@ -20,6 +20,7 @@
 #include <libflog/system/time.hpp>
 #include <libflog/system/exporter.hpp>
 #include <libflog/proto/ofp/message.hpp>
+#include <libflog/proto/ofp/flow_batch.hpp>
 
 namespace flog {
 namespace ofp {
@@ -44,6 +45,18 @@ struct Application {
   /// terminated.
   virtual void fini(const Time& t) { };
 
+  /// Interface batch_complete is invoked when the switch has acknowledged
+  /// a batch of the flow mods sent by the application, if the connection
+  /// batches them. The flow mods of the batch have all been processed, and
+  /// any errors they caused have been received.
+  virtual void batch_complete(const Flow_mod_batch& b, const Time& t) { }
+
+  /// Interface batch_expired is invoked when the switch has not
+  /// acknowledged a batch of flow mods within the barrier timeout. The
+  /// flow mods of the batch may or may not have been applied, and the
+  /// reply to its barrier is passed on if it arrives later.
+  virtual void batch_expired(const Flow_mod_batch& b, const Time& t) { }
+
   /// The queue of messages to be sent.
   Message_vector tx_queue;
 };
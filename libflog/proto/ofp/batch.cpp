@@ -0,0 +1,150 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <new>
+
+#include "batch.hpp"
+
+namespace flog {
+namespace ofp {
+
+namespace {
+
+// The size of the header common to all versions.
+const std::size_t Header_size = 8;
+
+// The versions indexed by the decoders, including the unused version 0.
+const std::size_t Versions = 5;
+
+// Read the message in v into the next slot of S, numbered K. The message
+// is read over the previous contents of the slot if the version supports
+// recycling. Otherwise, the slot is reset first: before 1.3, reading a
+// message over one of a different type assigns to the old payload as if
+// it had the new type.
+template<typename M, Batch_slots<M> Message_batch::* S, uint8_t K,
+         bool Recycle>
+  bool
+  decode_message(Buffer_view& v, Message_batch& b)
+  {
+    Batch_slots<M>& s = b.*S;
+    std::size_t n = s.count;
+    M& m = s.next();
+    if (not Recycle and m.payload) {
+      m.~M();
+      new (&m) M();
+    }
+    if (not from_buffer(v, m)) {
+      --s.count;
+      return false;
+    }
+    b.entries.push_back({K, uint32_t(n)});
+    return true;
+  }
+
+bool
+reject(Buffer_view&, Message_batch&) { return false; }
+
+// The decoders, indexed by the patch of the batch and the version of the
+// message.
+const Batch_decoder decoders[2][Versions] = {
+  {
+    reject,
+    decode_message<v1_0::Message, &Message_batch::m1, 1, false>,
+    decode_message<v1_1::Message, &Message_batch::m2, 2, false>,
+    decode_message<v1_2::Message, &Message_batch::m3, 3, false>,
+    decode_message<v1_3::Message, &Message_batch::m4, 4, true>
+  },
+  {
+    reject,
+    decode_message<v1_0::Message, &Message_batch::m1, 1, false>,
+    decode_message<v1_1::Message, &Message_batch::m2, 2, false>,
+    decode_message<v1_2::Message, &Message_batch::m3, 3, false>,
+    decode_message<v1_3_1::Message, &Message_batch::m5, 5, true>
+  }
+};
+
+// Hint that the bytes at p will be read soon.
+inline void
+prefetch(const Byte* p)
+{
+#if defined(__GNUC__)
+  __builtin_prefetch(p);
+#endif
+}
+
+} // namespace
+
+Common_message
+Message_batch::operator[](std::size_t n) const
+{
+  const Entry& e = entries[n];
+  switch (e.slots) {
+  case 1:
+    return &m1.messages[e.index];
+  case 2:
+    return &m2.messages[e.index];
+  case 3:
+    return &m3.messages[e.index];
+  case 4:
+    return &m4.messages[e.index];
+  default:
+    return &m5.messages[e.index];
+  }
+}
+
+Batch_decoder
+decoder(uint8_t version, uint8_t patch)
+{
+  return version < Versions ? decoders[patch ? 1 : 0][version] : reject;
+}
+
+void
+clear(Message_batch& b)
+{
+  b.entries.clear();
+  b.m1.count = 0;
+  b.m2.count = 0;
+  b.m3.count = 0;
+  b.m4.count = 0;
+  b.m5.count = 0;
+}
+
+bool
+decode(Buffer_view& v, Message_batch& b)
+{
+  const Batch_decoder* table = decoders[b.patch ? 1 : 0];
+  Trust_scope scope(b.trust);
+  while (remaining(v) >= Header_size) {
+    std::size_t n = load<uint16_t>(v.first + 2);
+    if (n < Header_size)
+      return false;
+    if (n > remaining(v))
+      return true;
+
+    // Start loading the next header while this message is decoded.
+    if (n + Header_size <= remaining(v))
+      prefetch(v.first + n);
+
+    uint8_t version = *v.first;
+    Batch_decoder d = version < Versions ? table[version] : reject;
+    Buffer_view m = constrain(v, n);
+    if (not d(m, b))
+      return false;
+    v.first += n;
+  }
+  return true;
+}
+
+} // namespace ofp
+} // namespace flog
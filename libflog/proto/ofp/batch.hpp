@@ -0,0 +1,122 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_PROTO_OFP_BATCH_HPP
+#define FLOWGRAMMABLE_PROTO_OFP_BATCH_HPP
+
+#include <vector>
+
+#include <libflog/proto/ofp/message.hpp>
+
+/// \file batch.hpp
+/// Decoding the many messages of a receive buffer in one call.
+
+namespace flog {
+namespace ofp {
+
+/// \brief The messages of one version held by a batch.
+///
+/// Slots are kept when the batch is cleared, so that the messages of the
+/// next batch are read over them and reuse the storage they own.
+template<typename M>
+  struct Batch_slots
+  {
+    Batch_slots() : count(0) { }
+
+    /// Returns the next unused slot, adding one if needed.
+    M& next();
+
+    std::vector<M> messages;
+    std::size_t count;
+  };
+
+template<typename M>
+  inline M&
+  Batch_slots<M>::next()
+  {
+    if (count == messages.size())
+      messages.emplace_back();
+    return messages[count++];
+  }
+
+/// \brief A sequence of decoded messages of any version.
+///
+/// The messages are kept in the order in which they were received. Each
+/// one is referred to by a Common_message that points into the batch; it
+/// remains valid until the batch is cleared or more messages are decoded
+/// into it, and must not be deleted.
+///
+/// Version 1.3 and 1.3.1 messages share a version number on the wire.
+/// They are decoded as 1.3.1 messages if the batch is constructed with
+/// patch 1, and as 1.3 messages otherwise.
+///
+/// The messages are decoded at the trust level of the batch, which is
+/// that of the connection they were received on.
+struct Message_batch
+{
+  /// The slots holding a message, numbered as the members of
+  /// Common_message::Kind, and its index in those slots.
+  struct Entry
+  {
+    uint8_t slots;
+    uint32_t index;
+  };
+
+  explicit Message_batch(uint8_t p = 0,
+                         Trust_level t = STRUCTURAL_VALIDATION)
+    : patch(p), trust(t)
+  { }
+
+  std::size_t size() const { return entries.size(); }
+  bool empty() const { return entries.empty(); }
+
+  /// Returns the nth message of the batch.
+  Common_message operator[](std::size_t n) const;
+
+  uint8_t patch;
+  Trust_level trust;
+  std::vector<Entry> entries;
+  Batch_slots<v1_0::Message> m1;
+  Batch_slots<v1_1::Message> m2;
+  Batch_slots<v1_2::Message> m3;
+  Batch_slots<v1_3::Message> m4;
+  Batch_slots<v1_3_1::Message> m5;
+};
+
+/// Decode the single message in v, whose version is known, and append it
+/// to the batch. Returns false if the message cannot be decoded.
+using Batch_decoder = bool (*)(Buffer_view& v, Message_batch& b);
+
+/// Returns the decoder of messages with the given version number on the
+/// wire, read as the given patch. If the version is not known, the decoder
+/// returned rejects every message.
+Batch_decoder decoder(uint8_t version, uint8_t patch);
+
+/// Remove the messages from the batch, keeping their storage.
+void clear(Message_batch& b);
+
+/// Decode the messages in v and append them to the batch b. Messages are
+/// read until v is exhausted or holds only part of a message, which is
+/// left in v. Each message is dispatched through a table indexed by its
+/// version.
+///
+/// Returns false if a message has an unknown version, a bad length or
+/// cannot be decoded. That message is left at the front of v, and the
+/// messages before it remain in the batch.
+bool decode(Buffer_view& v, Message_batch& b);
+
+} // namespace ofp
+} // namespace flog
+
+#endif
@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2013 Flowgrammable, LLC.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at:
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an "AS IS"
+# BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+# or implied. See the License for the specific language governing
+# permissions and limitations under the License.
+
+"""Generate OpenFlow codecs from a schema of fixed-size structures.
+
+usage: ofp_codegen.py [--check] <schema> <version> <output>
+
+For each structure in the schema, this writes the to_buffer() and
+from_buffer() functions of the given protocol version (e.g., v1_3). Each
+function checks the bounds of the view once and then reads or writes
+every field at a constant offset, rather than stepping the view through
+the structure one field at a time.
+
+The generated sources are checked in. With --check, the output is not
+written; instead, the script fails if it differs from what would be
+generated.
+"""
+
+import re
+import sys
+
+INTEGERS = {'u8': 1, 'u16': 2, 'u32': 4, 'u64': 8}
+
+
+class Schema_error(Exception):
+    pass
+
+
+class Field:
+    def __init__(self, kind, name, size, offset):
+        self.kind = kind
+        self.name = name
+        self.size = size
+        self.offset = offset
+
+
+class Struct:
+    def __init__(self, name, error):
+        self.name = name
+        self.error = error
+        self.fields = []
+        self.size = 0
+
+    def add(self, kind, name, size):
+        self.fields.append(Field(kind, name, size, self.size))
+        self.size += size
+
+
+def field_size(kind, line):
+    if kind in INTEGERS:
+        return INTEGERS[kind]
+    if kind == 'mac':
+        return 6
+    m = re.match(r'str(\d+)$', kind)
+    if m:
+        return int(m.group(1))
+    raise Schema_error('line %d: unknown type "%s"' % (line, kind))
+
+
+def parse(path):
+    structs = []
+    current = None
+    with open(path) as f:
+        for n, text in enumerate(f, 1):
+            words = text.split('#', 1)[0].split()
+            if not words:
+                continue
+            if words[0] == 'struct':
+                if current or len(words) != 3:
+                    raise Schema_error('line %d: bad struct' % n)
+                current = Struct(words[1], words[2])
+            elif words[0] == 'end':
+                if not current:
+                    raise Schema_error('line %d: unmatched end' % n)
+                structs.append(current)
+                current = None
+            elif not current or len(words) != 2:
+                raise Schema_error('line %d: bad field' % n)
+            elif words[0] == 'pad':
+                current.add('pad', None, int(words[1]))
+            else:
+                current.add(words[0], words[1], field_size(words[0], n))
+    if current:
+        raise Schema_error('struct %s is not terminated' % current.name)
+    return structs
+
+
+def static_asserts(s):
+    out = []
+    for f in s.fields:
+        if f.kind in INTEGERS:
+            out.append('static_assert(sizeof(%s::%s) == %d, "%s::%s");'
+                       % (s.name, f.name, f.size, s.name, f.name))
+    return out
+
+
+def encoder(s):
+    out = ['Error_condition',
+           'to_buffer(Buffer_view& v, const %s& x)' % s.name,
+           '{',
+           '  assert(bytes(x) == %d);' % s.size,
+           '  if (not available(v, %d))' % s.size,
+           '    return %s;' % s.error]
+    if s.fields:
+        out.append('  Byte* p = v.first;')
+    for f in s.fields:
+        at = 'p + %d' % f.offset
+        if f.kind == 'pad':
+            out.append('  std::memset(%s, 0, %d);' % (at, f.size))
+        elif f.kind == 'mac':
+            out.append('  std::memcpy(%s, x.%s.data, 6);' % (at, f.name))
+        elif f.kind.startswith('str'):
+            out.append('  std::memcpy(%s, x.%s.data(), %d);'
+                       % (at, f.name, f.size))
+        else:
+            out.append('  store(%s, x.%s);' % (at, f.name))
+    out += ['  v.first += %d;' % s.size,
+            '  return SUCCESS;',
+            '}']
+    return out
+
+
+def decoder(s):
+    out = ['Error_condition',
+           'from_buffer(Buffer_view& v, %s& x)' % s.name,
+           '{',
+           '  assert(bytes(x) == %d);' % s.size,
+           '  if (not available(v, %d))' % s.size,
+           '    return %s;' % s.error]
+    if any(f.kind != 'pad' for f in s.fields):
+        out.append('  const Byte* p = v.first;')
+    for f in s.fields:
+        at = 'p + %d' % f.offset
+        if f.kind == 'pad':
+            continue
+        elif f.kind == 'mac':
+            out.append('  std::memcpy(x.%s.data, %s, 6);' % (f.name, at))
+        elif f.kind.startswith('str'):
+            out.append('  std::memcpy(x.%s.data(), %s, %d);'
+                       % (f.name, at, f.size))
+        else:
+            out.append('  x.%s = load<decltype(x.%s)>(%s);'
+                       % (f.name, f.name, at))
+    out += ['  v.first += %d;' % s.size,
+            '  return SUCCESS;',
+            '}']
+    return out
+
+
+def generate(structs, schema, version):
+    out = ['// Generated by ofp_codegen.py from %s. Do not edit.' % schema,
+           '',
+           '#include <cstring>',
+           '',
+           '#include <libflog/proto/ofp/%s/message.hpp>' % version,
+           '',
+           'namespace flog {',
+           'namespace ofp {',
+           'namespace %s {' % version]
+    for s in structs:
+        out += ['',
+                '// ' + '-' * 74 + ' //',
+                '// %s (%d bytes)' % (s.name, s.size),
+                '']
+        asserts = static_asserts(s)
+        if asserts:
+            out += asserts + ['']
+        out += encoder(s) + [''] + decoder(s)
+    out += ['',
+            '} // namespace %s' % version,
+            '} // namespace ofp',
+            '} // namespace flog',
+            '']
+    return '\n'.join(out)
+
+
+def main(argv):
+    check = len(argv) == 5 and argv[1] == '--check'
+    if check:
+        argv = argv[:1] + argv[2:]
+    if len(argv) != 4:
+        sys.stderr.write(__doc__)
+        return 1
+    schema, version, output = argv[1:]
+    try:
+        structs = parse(schema)
+    except Schema_error as e:
+        sys.stderr.write('%s: %s\n' % (schema, e))
+        return 1
+    name = schema.replace('\\', '/').rsplit('/', 1)[-1]
+    text = generate(structs, name, version)
+    if check:
+        try:
+            with open(output) as f:
+                current = f.read()
+        except IOError:
+            current = None
+        if current != text:
+            sys.stderr.write('%s is out of date; build the codegen target\n'
+                             % output)
+            return 1
+        return 0
+    with open(output, 'w') as f:
+        f.write(text)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
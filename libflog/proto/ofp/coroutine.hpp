@@ -0,0 +1,214 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_PROTO_OFP_COROUTINE_HPP
+#define FLOWGRAMMABLE_PROTO_OFP_COROUTINE_HPP
+
+#if not defined(__cpp_impl_coroutine)
+#  error "coroutine.hpp requires a compiler with C++20 coroutines"
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+
+#include <libflog/pool.hpp>
+#include <libflog/proto/ofp/session.hpp>
+
+/// \file coroutine.hpp
+/// Awaiting the replies to the requests an application sends to a switch.
+///
+/// The rest of the library is C++11; only translation units compiled as
+/// C++20 can include this header.
+
+namespace flog {
+namespace ofp {
+
+/// \brief A coroutine that is run for its effects.
+///
+/// The coroutine starts when it is called, and runs until it first awaits
+/// a request. After that, it is resumed by the completion of each request
+/// it awaits, directly from the session that received the reply, on the
+/// thread of the reactor running the connection. Its frame is drawn from
+/// the size-class pool, and is released when the coroutine returns. An
+/// exception that escapes the coroutine terminates the program.
+struct Task
+{
+  struct promise_type
+  {
+    Task get_return_object() { return Task(); }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() { }
+    void unhandled_exception() { std::terminate(); }
+
+    static void* operator new(std::size_t n) { return pool_allocate(n); }
+    static void operator delete(void* p, std::size_t n) { pool_release(p, n); }
+  };
+};
+
+/// The completion of a request, and the reply decoded, if one arrived. A
+/// response is true if it carries the expected reply.
+template<typename M>
+  struct Response
+  {
+    explicit operator bool() const
+    {
+      return status == REPLIED or status == MORE;
+    }
+
+    Request_status status;
+    M message;
+  };
+
+/// \brief A request sent to a switch, which can be awaited for its reply.
+///
+/// Making the request registers it in the session's pending table with the
+/// next xid, and queues the message for sending. The reply is expected to
+/// have the type following that of the request, as every request and reply
+/// pair of OpenFlow does. If the table is full or the session is not
+/// established, the request is not sent, and completes as REFUSED.
+///
+/// A multipart request that completes with MORE can be awaited again for
+/// the next part; this must be done before anything else is awaited, or
+/// the part is lost. A request that is destroyed while pending is
+/// forgotten. Requests cannot be copied or moved.
+template<typename M>
+  struct Request
+  {
+    Request(Session& s, Application& a, M* m, const Time& timeout);
+    ~Request();
+
+    Request(const Request&) = delete;
+    Request& operator=(const Request&) = delete;
+
+    bool await_ready() const noexcept { return ready; }
+    void await_suspend(std::coroutine_handle<> h) noexcept { waiter = h; }
+    Response<M> await_resume();
+
+    static void complete(void* context, const Request_result& r,
+                         const Time& t);
+
+    Session& session;
+    uint32_t xid;
+    bool pending;
+    bool ready;
+    std::coroutine_handle<> waiter;
+    Response<M> result;
+  };
+
+/// \brief The switch at the other end of a session, to which an
+/// application sends requests of messages M.
+///
+/// For example:
+///
+///     Task query(Switch<v1_3::Message>& sw)
+///     {
+///       auto stats = co_await sw.request(Multipart_req(Multipart_req_flow{}));
+///       co_await sw.barrier();
+///     }
+///
+/// Requests expire after the switch's timeout, which applies to those made
+/// after it is set.
+template<typename M>
+  struct Switch
+  {
+    using Barrier_req = typename std::remove_reference<
+      decltype(std::declval<M&>().payload.data.barrier_req)>::type;
+
+    Switch(Session& s, Application& a, const Time& t = Time(5))
+      : session(s), app(a), timeout(t)
+    { }
+
+    /// Send a request with the given payload.
+    template<typename T>
+      Request<M> request(T&& payload)
+      {
+        M* m = Object_pool<M>::make(std::forward<T>(payload), uint32_t(0));
+        return Request<M>(session, app, m, timeout);
+      }
+
+    /// Send a barrier request.
+    Request<M> barrier() { return request(Barrier_req()); }
+
+    Session& session;
+    Application& app;
+    Time timeout;
+  };
+
+template<typename M>
+  Request<M>::Request(Session& s, Application& a, M* m, const Time& timeout)
+    : session(s), xid(s.gen()), pending(false), ready(false), waiter(),
+      result()
+  {
+    m->header.xid = xid;
+    uint8_t reply = uint8_t(m->header.type) + 1;
+    if (not expect(s.pending, xid, reply, now() + timeout, complete, this)) {
+      Object_pool<M>::release(m);
+      result.status = REFUSED;
+      ready = true;
+      return;
+    }
+    pending = true;
+    a.send(Common_message(m));
+
+    // A request made outside of the session's handlers is sent as soon as
+    // the connection runs.
+    if (s.connection)
+      wake(*s.connection, now());
+  }
+
+template<typename M>
+  Request<M>::~Request()
+  {
+    if (pending)
+      forget(session.pending, xid);
+  }
+
+template<typename M>
+  inline Response<M>
+  Request<M>::await_resume()
+  {
+    ready = false;
+    return std::move(result);
+  }
+
+// Record the completion, decoding the reply if there is one, and resume
+// the coroutine waiting for it. The request may be destroyed by the
+// coroutine, so it is not touched after.
+template<typename M>
+  void
+  Request<M>::complete(void* context, const Request_result& r, const Time& t)
+  {
+    Request& q = *static_cast<Request*>(context);
+    q.pending = r.status == MORE;
+    q.result.status = r.status;
+    if (r.data) {
+      Buffer none;
+      Byte* first = const_cast<Byte*>(r.data);
+      Buffer_view v(none, first, first + r.size);
+      if (not from_buffer(v, q.result.message))
+        q.result.status = FAILED;
+    }
+    q.ready = true;
+    if (std::coroutine_handle<> h = q.waiter) {
+      q.waiter = nullptr;
+      h.resume();
+    }
+  }
+
+} // namespace ofp
+} // namespace flog
+
+#endif
@@ -0,0 +1,134 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_PROTO_OFP_ENCODER_H
+#define FLOWGRAMMABLE_PROTO_OFP_ENCODER_H
+
+#include <cstring>
+
+#include <libflog/proto/ofp/ofp.hpp>
+
+/// \file encoder.hpp
+/// A growable output region for single-pass encoding.
+
+namespace flog {
+namespace ofp {
+
+// -------------------------------------------------------------------------- //
+// Encoder
+
+/// \brief Appends encoded objects to a buffer in a single traversal.
+///
+/// Encoding through a Buffer_view requires the size of the entire message
+/// up front, and computing it walks every nested sequence of the message
+/// before any byte is written. An encoder instead grows its buffer as
+/// objects are appended. The length field of an enclosing object is
+/// written as a placeholder, remembered by its offset, and back-patched
+/// once the object's contents have been written. For example:
+///
+///     std::size_t start = e.offset();
+///     e.put(type);
+///     e.put(uint16_t(0));            // length, patched below
+///     ...                            // contents
+///     e.patch(start + 2, uint16_t(e.offset() - start));
+///
+/// Pointers into the buffer are invalidated when it grows, so positions
+/// are always held as offsets. The buffer may have spare capacity at its
+/// end while encoding; finish() trims it to the encoded bytes.
+class Encoder
+{
+public:
+  /// Append to the end of the buffer b.
+  explicit Encoder(Buffer& b)
+    : buf_(b), pos_(b.size()) { }
+
+  /// Returns the offset at which the next byte is written.
+  std::size_t offset() const { return pos_; }
+
+  /// Returns a pointer to the byte at offset n.
+  Byte* at(std::size_t n) { return buf_.data() + n; }
+
+  /// Extend the output by n bytes and return a pointer to the first
+  /// of them. The pointer is valid until the output is next extended.
+  Byte* extend(std::size_t n);
+
+  /// Append the scalar x in network byte order.
+  template<typename T>
+    void put(T x) { store(extend(sizeof(T)), x); }
+
+  /// Append n zero bytes.
+  void pad(std::size_t n) { std::memset(extend(n), 0, n); }
+
+  /// Append zero bytes until the output is a multiple of n bytes past
+  /// the offset start.
+  void align(std::size_t start, std::size_t n);
+
+  /// Overwrite the scalar at offset n with x.
+  template<typename T>
+    void patch(std::size_t n, T x) { store(at(n), x); }
+
+  /// Append an object through its to_buffer() operation. This is used for
+  /// objects whose size is cheap to compute, e.g. fixed-size structures.
+  template<typename T, typename... Args>
+    Error_condition write(const T& x, Args... args);
+
+  /// Trim the buffer to the encoded bytes and return it.
+  Buffer& finish();
+
+private:
+  Buffer& buf_;
+  std::size_t pos_;
+};
+
+inline Byte*
+Encoder::extend(std::size_t n)
+{
+  if (pos_ + n > buf_.size()) {
+    std::size_t cap = std::max(2 * buf_.size(), std::size_t(64));
+    buf_.resize(std::max(cap, pos_ + n));
+  }
+  Byte* p = buf_.data() + pos_;
+  pos_ += n;
+  return p;
+}
+
+inline void
+Encoder::align(std::size_t start, std::size_t n)
+{
+  std::size_t r = (pos_ - start) % n;
+  if (r)
+    pad(n - r);
+}
+
+template<typename T, typename... Args>
+  inline Error_condition
+  Encoder::write(const T& x, Args... args)
+  {
+    std::size_t n = bytes(x, args...);
+    Byte* p = extend(n);
+    Buffer_view v(buf_, p, p + n);
+    return to_buffer(v, x, args...);
+  }
+
+inline Buffer&
+Encoder::finish()
+{
+  buf_.resize(pos_);
+  return buf_;
+}
+
+} // namespace ofp
+} // namespace flog
+
+#endif
@@ -0,0 +1,204 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <algorithm>
+
+#include <libflog/proto/ofp/ofp.hpp>
+
+#include "flow_batch.hpp"
+
+namespace flog {
+namespace ofp {
+
+namespace {
+
+// The message types used by the batcher, which are the same in all
+// versions except for the barrier request.
+const uint8_t Error_type = 1;
+const uint8_t Flow_mod_type = 14;
+const uint8_t Barrier_req_v1_0 = 18;
+const uint8_t Barrier_res_v1_0 = 19;
+const uint8_t Barrier_req_v1_1 = 20;
+const uint8_t Barrier_res_v1_1 = 21;
+
+const std::size_t Header_size = 8;
+
+// Returns the next xid after x, wrapping within the upper half of the
+// xid space.
+inline uint32_t
+next_xid(uint32_t x)
+{
+  return x == 0xffffffff ? Flow_batcher::First_xid : x + 1;
+}
+
+// Returns the number of xids from a to b, which are both in the upper
+// half of the xid space.
+inline uint32_t
+span(uint32_t a, uint32_t b)
+{
+  return (b - a) & 0x7fffffff;
+}
+
+// Returns true if x is in the xids of the batch, which end before last.
+inline bool
+contains(const Flow_mod_batch& b, uint32_t last, uint32_t x)
+{
+  return (x & Flow_batcher::First_xid)
+     and span(b.first, x) < span(b.first, last);
+}
+
+} // namespace
+
+const uint32_t Flow_batcher::First_xid;
+
+Flow_batcher::Flow_batcher(const Time& w, std::size_t n)
+  : window(w), limit(n), timeout(), version(0), xid(First_xid), batches(0), open()
+{ }
+
+void
+set_version(Flow_batcher& b, uint8_t version, const Time& timeout)
+{
+  b.version = version;
+  b.timeout = timeout;
+}
+
+bool
+is_flow_mod(const Byte* p, std::size_t n)
+{
+  return n >= Header_size and p[1] == Flow_mod_type;
+}
+
+void
+add(Flow_batcher& b, const Byte* p, std::size_t n, const Time& t)
+{
+  if (not is_open(b)) {
+    b.open.id = ++b.batches;
+    b.open.first = b.xid;
+    b.open.errors = 0;
+    b.open.opened = t;
+  }
+  std::size_t k = b.pending.size();
+  b.pending.insert(b.pending.end(), p, p + n);
+  store(&b.pending[k + 4], b.xid);
+  b.xid = next_xid(b.xid);
+  ++b.open.flow_mods;
+}
+
+bool
+must_seal(const Flow_batcher& b, const Time& t)
+{
+  return is_open(b)
+     and (b.open.flow_mods >= b.limit or t >= deadline(b));
+}
+
+void
+queue_pending(Flow_batcher& b, Output_queue& q)
+{
+  if (b.pending.empty())
+    return;
+  push(q, std::move(b.pending));
+  b.pending = Buffer();
+}
+
+void
+seal(Flow_batcher& b, Output_queue& q, const Time& t)
+{
+  if (not is_open(b))
+    return;
+
+  Byte barrier[Header_size] = {
+    b.version,
+    b.version == 1 ? Barrier_req_v1_0 : Barrier_req_v1_1,
+    0, Header_size
+  };
+  store(barrier + 4, b.xid);
+  b.pending.insert(b.pending.end(), barrier, barrier + Header_size);
+
+  b.open.barrier = b.xid;
+  b.open.expires = b.timeout ? t + b.timeout : Time();
+  b.xid = next_xid(b.xid);
+  b.sealed.push_back(b.open);
+  b.open.flow_mods = 0;
+  queue_pending(b, q);
+}
+
+bool
+acknowledge(Flow_batcher& b, uint32_t xid, Flow_mod_batch& done)
+{
+  // Barriers are answered in order, so the batch is usually the first.
+  auto i = std::find_if(b.sealed.begin(), b.sealed.end(),
+                        [xid](const Flow_mod_batch& s) {
+                          return s.barrier == xid;
+                        });
+  if (i == b.sealed.end())
+    return false;
+  done = *i;
+  b.sealed.erase(i);
+  return true;
+}
+
+bool
+expire(Flow_batcher& b, const Time& t, Flow_mod_batch& done)
+{
+  if (b.sealed.empty())
+    return false;
+  const Flow_mod_batch& s = b.sealed.front();
+  if (not s.expires or t < s.expires)
+    return false;
+  done = s;
+  b.sealed.pop_front();
+  return true;
+}
+
+Time
+next_deadline(const Flow_batcher& b)
+{
+  Time d = is_open(b) ? deadline(b) : Time();
+  if (not b.sealed.empty() and b.sealed.front().expires) {
+    const Time& e = b.sealed.front().expires;
+    if (not d or e < d)
+      d = e;
+  }
+  return d;
+}
+
+void
+count_error(Flow_batcher& b, uint32_t xid)
+{
+  for (Flow_mod_batch& s : b.sealed) {
+    if (contains(s, next_xid(s.barrier), xid)) {
+      ++s.errors;
+      return;
+    }
+  }
+  if (is_open(b) and contains(b.open, b.xid, xid))
+    ++b.open.errors;
+}
+
+bool
+inspect(Flow_batcher& b, const Byte* p, std::size_t n, Flow_mod_batch& done)
+{
+  if (n < Header_size)
+    return false;
+  uint32_t xid = load<uint32_t>(p + 4);
+  if (p[1] == Error_type) {
+    count_error(b, xid);
+    return false;
+  }
+  uint8_t reply = b.version == 1 ? Barrier_res_v1_0 : Barrier_res_v1_1;
+  return p[1] == reply and acknowledge(b, xid, done);
+}
+
+} // namespace ofp
+} // namespace flog
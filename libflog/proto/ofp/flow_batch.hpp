@@ -0,0 +1,140 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_PROTO_OFP_FLOW_BATCH_HPP
+#define FLOWGRAMMABLE_PROTO_OFP_FLOW_BATCH_HPP
+
+#include <deque>
+
+#include <libflog/buffer.hpp>
+#include <libflog/system/time.hpp>
+#include <libflog/system/output.hpp>
+
+/// \file flow_batch.hpp
+/// Coalescing the flow mods sent to a switch into acknowledged batches.
+
+namespace flog {
+namespace ofp {
+
+/// \brief A batch of flow mods, acknowledged by a single barrier.
+///
+/// The flow mods of a batch and its barrier request have consecutive xids,
+/// from first to barrier. An error reply with an xid in that range is
+/// counted against the batch. Once sealed, a batch expires if the reply to
+/// its barrier has not arrived by its deadline.
+struct Flow_mod_batch
+{
+  uint64_t id;          // Batches are numbered from 1 in the order sent
+  uint32_t first;       // The xid of the first flow mod
+  uint32_t barrier;     // The xid of the barrier request
+  uint32_t flow_mods;   // The number of flow mods
+  uint32_t errors;      // The number of error replies to them
+  Time opened;          // When the first flow mod was sent
+  Time expires;         // When the reply to its barrier is due, if ever
+};
+
+/// \brief Coalesces the flow mods sent on a connection.
+///
+/// Flow mods are encoded back to back into one buffer, and restamped with
+/// xids from the upper half of the xid space, which the batcher owns. A
+/// batch is sealed once it holds limit flow mods or the window since its
+/// first one has elapsed: a barrier request is appended, and the buffer
+/// is queued for output as a whole. Sealed batches are remembered until
+/// the reply to their barrier arrives, or until the timeout since they were
+/// sealed has elapsed, when they expire. A batch that expires may or may
+/// not have been applied by the switch. Without a valid timeout, sealed
+/// batches wait for their replies for ever.
+///
+/// Batching is off when the limit is 0.
+struct Flow_batcher
+{
+  /// The first xid given to a flow mod or barrier.
+  static const uint32_t First_xid = 0x80000000;
+
+  Flow_batcher(const Time& w = Time(0, 0), std::size_t n = 0);
+
+  Time window;
+  std::size_t limit;
+  Time timeout;
+
+  uint8_t version;              // The version number on the wire
+  uint32_t xid;                 // The next xid to give
+  uint64_t batches;             // The number of batches opened
+  Flow_mod_batch open;          // The batch being filled, if any flow mods
+  Buffer pending;               // Flow mods not yet queued for output
+  Buffer scratch;               // The message being encoded
+  std::deque<Flow_mod_batch> sealed;
+};
+
+/// Returns true if batching is on.
+inline bool
+enabled(const Flow_batcher& b) { return b.limit != 0; }
+
+/// Returns true if a batch is being filled.
+inline bool
+is_open(const Flow_batcher& b) { return b.open.flow_mods != 0; }
+
+/// Prepare the batcher for messages with the given version number, whose
+/// barriers must be answered within the timeout.
+void set_version(Flow_batcher& b, uint8_t version, const Time& timeout);
+
+/// Returns true if the message of n bytes at p is a flow mod.
+bool is_flow_mod(const Byte* p, std::size_t n);
+
+/// Add the encoded flow mod of n bytes at p to the open batch, opening one
+/// at time t if there is none. The flow mod is given the next xid.
+void add(Flow_batcher& b, const Byte* p, std::size_t n, const Time& t);
+
+/// Returns true if the open batch must be sealed by time t.
+bool must_seal(const Flow_batcher& b, const Time& t);
+
+/// Returns the time by which the open batch must be sealed.
+inline Time
+deadline(const Flow_batcher& b) { return b.open.opened + b.window; }
+
+/// Queue the flow mods that have been added to the open batch, without
+/// sealing it. This is done before any other message is queued, so that
+/// the messages leave in the order they were sent.
+void queue_pending(Flow_batcher& b, Output_queue& q);
+
+/// Seal the open batch, if any, at time t and queue it.
+void seal(Flow_batcher& b, Output_queue& q, const Time& t);
+
+/// If the xid is that of the barrier of a sealed batch, remove the batch
+/// into done and return true.
+bool acknowledge(Flow_batcher& b, uint32_t xid, Flow_mod_batch& done);
+
+/// If the oldest sealed batch has expired by time t, remove it into done
+/// and return true. Batches expire in the order they were sealed.
+bool expire(Flow_batcher& b, const Time& t, Flow_mod_batch& done);
+
+/// Returns the next time the batcher must be run: the deadline of the open
+/// batch or the expiry of the oldest sealed one, whichever comes first. The
+/// time is invalid if there is neither.
+Time next_deadline(const Flow_batcher& b);
+
+/// Count an error reply with the given xid against its batch, if any.
+void count_error(Flow_batcher& b, uint32_t xid);
+
+/// Examine the message of n bytes at p, received on the connection. An
+/// error reply is counted against its batch. If the message is the reply
+/// to the barrier of a batch, the batch is removed into done and true is
+/// returned; the message need not be passed on.
+bool inspect(Flow_batcher& b, const Byte* p, std::size_t n,
+             Flow_mod_batch& done);
+
+} // namespace ofp
+} // namespace flog
+
+#endif
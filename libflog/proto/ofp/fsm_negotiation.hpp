@@ -21,6 +21,7 @@
 #include <libflog/proto/ofp/result_type.hpp>
 #include <libflog/proto/ofp/xid_gen.hpp>
 #include <libflog/proto/ofp/message.hpp>
+#include <libflog/proto/ofp/sink.hpp>
 
 namespace flog {
 namespace ofp {
@@ -52,26 +53,26 @@ template<typename T>
 
 /// state(init) ----> transition(init)
 template<typename T>
-  inline State_result
-  idle_init(Negotiation<T>& n, const Time& t);
+  inline bool
+  idle_init(Negotiation<T>& n, const Time& t, Message_sink& out);
 
 /// state(init) ----> transition(all but init)
 template<typename T>
-  inline State_result
-  idle_fail(Negotiation<T>& n, const Time& t);
+  inline bool
+  idle_fail(Negotiation<T>& n, const Time& t, Message_sink& out);
 
 /// state(wait) ----> transition(fail)
 template<typename T>
-  inline State_result
-  wait_fail(Negotiation<T>& n, const Time& t);
+  inline bool
+  wait_fail(Negotiation<T>& n, const Time& t, Message_sink& out);
 
 template<typename T>
-  inline State_result
-  wait_timer(Negotiation<T>& n, const Time& t);
+  inline bool
+  wait_timer(Negotiation<T>& n, const Time& t, Message_sink& out);
 
 template<typename T>
-  inline State_result
-  idle_timer(Negotiation<T>& n, const Time& t);
+  inline bool
+  idle_timer(Negotiation<T>& n, const Time& t, Message_sink& out);
 
 inline FSM_config::Version
 negotiate_version(const FSM_config& c, FSM_config::Version remote);
@@ -80,54 +81,92 @@ inline FSM_config::Version
 negotiate_version_bitmap(const FSM_config& c, FSM_config::Supported remote);
 
 template<typename T>
-  inline State_result
-  wait_v1_0_hello(Negotiation<T>& n, const Time& t, const v1_0::Message& m);
+  inline bool
+  wait_v1_0_hello(Negotiation<T>& n, const Time& t, const v1_0::Message& m,
+                  Message_sink& out);
 
 template<typename T>
-  inline State_result
-  wait_v1_1_hello(Negotiation<T>& n, const Time& t, const v1_1::Message& m);
+  inline bool
+  wait_v1_1_hello(Negotiation<T>& n, const Time& t, const v1_1::Message& m,
+                  Message_sink& out);
 
 template<typename T>
-  inline State_result
-  wait_v1_2_hello(Negotiation<T>& n, const Time& t, const v1_2::Message& m);
+  inline bool
+  wait_v1_2_hello(Negotiation<T>& n, const Time& t, const v1_2::Message& m,
+                  Message_sink& out);
 
 template<typename T>
-  inline State_result
-  wait_v1_3_hello(Negotiation<T>& n, const Time& t, const v1_3::Message& m);
+  inline bool
+  wait_v1_3_hello(Negotiation<T>& n, const Time& t, const v1_3::Message& m,
+                  Message_sink& out);
 
 template<typename T>
-  inline State_result
-  wait_v1_3_1_hello(Negotiation<T>& n, const Time& t, const v1_3_1::Message& m);
+  inline bool
+  wait_v1_3_1_hello(Negotiation<T>& n, const Time& t, const v1_3_1::Message& m,
+                    Message_sink& out);
 
 /// state(init): pick the transition
 template<typename T>
   State_result
   init(Negotiation<T>& n, const Time& t);
 
+template<typename T>
+  bool
+  init(Negotiation<T>& n, const Time& t, Message_sink& out);
+
 template<typename T>
   State_result
   recv(Negotiation<T>& n, const Time& t, const v1_0::Message& m);
 
+template<typename T>
+  bool
+  recv(Negotiation<T>& n, const Time& t, const v1_0::Message& m,
+       Message_sink& out);
+
 template<typename T>
   State_result
   recv(Negotiation<T>& n, const Time& t, const v1_1::Message& m);
 
+template<typename T>
+  bool
+  recv(Negotiation<T>& n, const Time& t, const v1_1::Message& m,
+       Message_sink& out);
+
 template<typename T>
   State_result
   recv(Negotiation<T>& n, const Time& t, const v1_2::Message& m);
 
+template<typename T>
+  bool
+  recv(Negotiation<T>& n, const Time& t, const v1_2::Message& m,
+       Message_sink& out);
+
 template<typename T>
   State_result
   recv(Negotiation<T>& n, const Time& t, const v1_3::Message& m);
 
+template<typename T>
+  bool
+  recv(Negotiation<T>& n, const Time& t, const v1_3::Message& m,
+       Message_sink& out);
+
 template<typename T>
   State_result
   recv(Negotiation<T>& n, const Time& t, const v1_3_1::Message& m);
 
+template<typename T>
+  bool
+  recv(Negotiation<T>& n, const Time& t, const v1_3_1::Message& m,
+       Message_sink& out);
+
 template<typename T>
   State_result
   time(Negotiation<T>& n, const Time& t);
 
+template<typename T>
+  bool
+  time(Negotiation<T>& n, const Time& t, Message_sink& out);
+
 template<typename T>
   void
   fini(Negotiation<T>& n, const Time& t);
@@ -71,50 +71,51 @@ template<typename T>
 
 /// state(init) ----> transition(init)
 template<typename T>
-  inline State_result
-  idle_init(Negotiation<T>& n, const Time& t)
+  inline bool
+  idle_init(Negotiation<T>& n, const Time& t, Message_sink& out)
   {
     n.state = Negotiation<T>::WAIT;
     n.hello_timer = t + n.config.timers.hello_wait;
 
-    return {true, {T::factory(n.gen).make_hello(n.config.supported)}};
+    out.put(T::factory(n.gen).make_hello(n.config.supported));
+    return true;
   }
 
 /// state(init) ----> transition(all but init)
 template<typename T>
-  inline State_result
-  idle_fail(Negotiation<T>& n, const Time& t)
+  inline bool
+  idle_fail(Negotiation<T>& n, const Time& t, Message_sink& out)
   {
     n.state = Negotiation<T>::FAILURE;
-    return {false, {}};
+    return false;
   }
 
 /// state(wait) ----> transition(fail)
 template<typename T>
-  inline State_result
-  wait_fail(Negotiation<T>& n, const Time& t)
+  inline bool
+  wait_fail(Negotiation<T>& n, const Time& t, Message_sink& out)
   {
     n.state = Negotiation<T>::FAILURE;
-    return {false, {}};
+    return false;
   }
 
 template<typename T>
-  inline State_result
-  wait_timer(Negotiation<T>& n, const Time& t) {
+  inline bool
+  wait_timer(Negotiation<T>& n, const Time& t, Message_sink& out) {
     if (t >= n.hello_timer) {
       n.state = Negotiation<T>::FAILURE;
 
-      return {false, {}};
+      return false;
     }
     else {
-      return {true, {}};
+      return true;
     }
   }
 
 template<typename T>
-  inline State_result
-  idle_timer(Negotiation<T>& n, const Time& t) {
-    return {false, {}};
+  inline bool
+  idle_timer(Negotiation<T>& n, const Time& t, Message_sink& out) {
+    return false;
   }
 
 inline FSM_config::Version
@@ -144,71 +145,80 @@ negotiate_version_bitmap(const FSM_config& c, FSM_config::Supported remote) {
 }
 
 template<typename T>
-  inline State_result
-  wait_v1_0_hello(Negotiation<T>& n, const Time& t, const v1_0::Message& m)
+  inline bool
+  wait_v1_0_hello(Negotiation<T>& n, const Time& t, const v1_0::Message& m,
+                  Message_sink& out)
   {
     if (FSM_config::Unsup != (n.negotiated_version = 
         negotiate_version(n.config, FSM_config::v1_0))) {
       n.state = Negotiation<T>::SUCCESS;
-      return {false, {}};
+      return false;
     }
     else {
       std::cout << FSM_config::Unsup << std::endl;
       std::cout << negotiate_version(n.config, FSM_config::v1_0) << std::endl;
 
       n.state = Negotiation<T>::FAILURE;
-      return {false, {T::factory(n.gen).make_hello_failed()}};
+      out.put(T::factory(n.gen).make_hello_failed());
+      return false;
     }
   }
 
 template<typename T>
-  inline State_result
-  wait_v1_1_hello(Negotiation<T>& n, const Time& t, const v1_1::Message& m)
+  inline bool
+  wait_v1_1_hello(Negotiation<T>& n, const Time& t, const v1_1::Message& m,
+                  Message_sink& out)
   {
     if (FSM_config::Unsup != (n.negotiated_version = 
         negotiate_version(n.config, FSM_config::v1_1))) {
       n.state = Negotiation<T>::SUCCESS;
-      return {false, {}};
+      return false;
     }
     else {
       n.state = Negotiation<T>::FAILURE;
-      return {false, {T::factory(n.gen).make_hello_failed()}};
+      out.put(T::factory(n.gen).make_hello_failed());
+      return false;
     }
   }
 
 template<typename T>
-  inline State_result
-  wait_v1_2_hello(Negotiation<T>& n, const Time& t, const v1_2::Message& m)
+  inline bool
+  wait_v1_2_hello(Negotiation<T>& n, const Time& t, const v1_2::Message& m,
+                  Message_sink& out)
   {
     if (FSM_config::Unsup != (n.negotiated_version = 
         negotiate_version(n.config, FSM_config::v1_2))) {
       n.state = Negotiation<T>::SUCCESS;
-      return {false, {}};
+      return false;
     }
     else {
       n.state = Negotiation<T>::FAILURE;
-      return {false, {T::factory(n.gen).make_hello_failed()}};
+      out.put(T::factory(n.gen).make_hello_failed());
+      return false;
     }
   }
 
 template<typename T>
-  inline State_result
-  wait_v1_3_hello(Negotiation<T>& n, const Time& t, const v1_3::Message& m)
+  inline bool
+  wait_v1_3_hello(Negotiation<T>& n, const Time& t, const v1_3::Message& m,
+                  Message_sink& out)
   {
     if (FSM_config::Unsup != (n.negotiated_version = 
         negotiate_version(n.config, FSM_config::v1_3))) {
       n.state = Negotiation<T>::SUCCESS;
-      return {false, {}};
+      return false;
     }
     else {
       n.state = Negotiation<T>::FAILURE;
-      return {false, {T::factory(n.gen).make_hello_failed()}};
+      out.put(T::factory(n.gen).make_hello_failed());
+      return false;
     }
   }
 
 template<typename T>
-  inline State_result
-  wait_v1_3_1_hello(Negotiation<T>& n, const Time& t, const v1_3_1::Message& m)
+  inline bool
+  wait_v1_3_1_hello(Negotiation<T>& n, const Time& t, const v1_3_1::Message& m,
+                    Message_sink& out)
   {
     if (m.payload.data.hello.elements.size() == 0
         or  std::all_of(m.payload.data.hello.elements.begin(),
@@ -218,11 +228,12 @@ template<typename T>
       if (FSM_config::Unsup != (n.negotiated_version = 
           negotiate_version(n.config, FSM_config::v1_3))) {
         n.state = Negotiation<T>::SUCCESS;
-        return {false, {}};
+        return false;
       }
       else {
         n.state = Negotiation<T>::FAILURE;
-        return {false, {T::factory(n.gen).make_hello_failed()}};
+        out.put(T::factory(n.gen).make_hello_failed());
+        return false;
       }
     }
     else {
@@ -235,114 +246,171 @@ template<typename T>
           negotiate_version_bitmap(n.config, 
           FSM_config::Supported(num)))) {
         n.state = Negotiation<T>::SUCCESS;
-        return {false, {}};
+        return false;
       }
       else {
         n.state = Negotiation<T>::FAILURE;
-        return {false, {T::factory(n.gen).make_hello_failed()}};
+        out.put(T::factory(n.gen).make_hello_failed());
+        return false;
       }
     }  
   }
 
 /// state(init): pick the transition
 template<typename T>
-  State_result
-  init(Negotiation<T>& n, const Time& t) {
+  bool
+  init(Negotiation<T>& n, const Time& t, Message_sink& out) {
     switch (n.state) {
-      case Negotiation<T>::IDLE: return idle_init(n, t);
-      default: return idle_fail(n, t);
+      case Negotiation<T>::IDLE: return idle_init(n, t, out);
+      default: return idle_fail(n, t, out);
     }
   }
 
 template<typename T>
-  State_result
-  recv(Negotiation<T>& n, const Time& t, const v1_0::Message& m) {
+  bool
+  recv(Negotiation<T>& n, const Time& t, const v1_0::Message& m,
+       Message_sink& out) {
     switch (n.state) {
       case Negotiation<T>::WAIT:
         switch(m.header.type) {
-          case v1_0::HELLO: return wait_v1_0_hello(n, t, m);
-          default: return wait_fail(n, t);
+          case v1_0::HELLO: return wait_v1_0_hello(n, t, m, out);
+          default: return wait_fail(n, t, out);
         }
-      default: return idle_fail(n, t);
+      default: return idle_fail(n, t, out);
     }
   }
 
 template<typename T>
-  State_result
-  recv(Negotiation<T>& n, const Time& t, const v1_1::Message& m) {
+  bool
+  recv(Negotiation<T>& n, const Time& t, const v1_1::Message& m,
+       Message_sink& out) {
     switch (n.state) {
       case Negotiation<T>::WAIT:
         switch (m.header.type) {
           case v1_1::HELLO: 
-            return wait_v1_1_hello(n, t, m);
+            return wait_v1_1_hello(n, t, m, out);
           default:
-            return wait_fail(n, t);
+            return wait_fail(n, t, out);
         }
       default:
-        return idle_fail(n, t);
+        return idle_fail(n, t, out);
     }
   }
 
 template<typename T>
-  State_result
-  recv(Negotiation<T>& n, const Time& t, const v1_2::Message& m) {
+  bool
+  recv(Negotiation<T>& n, const Time& t, const v1_2::Message& m,
+       Message_sink& out) {
     switch (n.state) {
       case Negotiation<T>::WAIT:
         switch (m.header.type) {
           case v1_2::HELLO: 
-            return wait_v1_2_hello(n, t, m);
+            return wait_v1_2_hello(n, t, m, out);
           default:
-            return wait_fail(n, t);
+            return wait_fail(n, t, out);
         }
       default:
-        return idle_fail(n, t);
+        return idle_fail(n, t, out);
     }
  }
 
 template<typename T>
-  State_result
-  recv(Negotiation<T>& n, const Time& t, const v1_3::Message& m) {
+  bool
+  recv(Negotiation<T>& n, const Time& t, const v1_3::Message& m,
+       Message_sink& out) {
     switch (n.state) {
       case Negotiation<T>::WAIT:
         switch (m.header.type) {
           case v1_3::HELLO: 
-            return wait_v1_3_hello(n, t, m);
+            return wait_v1_3_hello(n, t, m, out);
           default:
-            return wait_fail(n, t);
+            return wait_fail(n, t, out);
         }
       default:
-        return idle_fail(n, t);
+        return idle_fail(n, t, out);
     }
   }
 
 template<typename T>
-  State_result
-  recv(Negotiation<T>& n, const Time& t, const v1_3_1::Message& m) {
+  bool
+  recv(Negotiation<T>& n, const Time& t, const v1_3_1::Message& m,
+       Message_sink& out) {
     switch (n.state) {
       case Negotiation<T>::WAIT:
         switch (m.header.type) {
           case v1_3_1::HELLO: 
-            return wait_v1_3_1_hello(n, t, m);
+            return wait_v1_3_1_hello(n, t, m, out);
           default:
-            return wait_fail(n, t);
+            return wait_fail(n, t, out);
         }
       default:
-        return idle_fail(n, t);
+        return idle_fail(n, t, out);
     }
   }
 
 
 template<typename T>
-  State_result
-  time(Negotiation<T>& n, const Time& t) {
+  bool
+  time(Negotiation<T>& n, const Time& t, Message_sink& out) {
     switch (n.state) {
       case Negotiation<T>::WAIT:
-        return wait_timer(n, t);
+        return wait_timer(n, t, out);
       default:
-        return idle_timer(n, t);
+        return idle_timer(n, t, out);
     }
   }
 
+// State_result forms of the handlers.
+
+template<typename T>
+  State_result
+  init(Negotiation<T>& n, const Time& t)
+  {
+    return collect([&](Message_sink& out) { return init(n, t, out); });
+  }
+
+template<typename T>
+  State_result
+  recv(Negotiation<T>& n, const Time& t, const v1_0::Message& m)
+  {
+    return collect([&](Message_sink& out) { return recv(n, t, m, out); });
+  }
+
+template<typename T>
+  State_result
+  recv(Negotiation<T>& n, const Time& t, const v1_1::Message& m)
+  {
+    return collect([&](Message_sink& out) { return recv(n, t, m, out); });
+  }
+
+template<typename T>
+  State_result
+  recv(Negotiation<T>& n, const Time& t, const v1_2::Message& m)
+  {
+    return collect([&](Message_sink& out) { return recv(n, t, m, out); });
+  }
+
+template<typename T>
+  State_result
+  recv(Negotiation<T>& n, const Time& t, const v1_3::Message& m)
+  {
+    return collect([&](Message_sink& out) { return recv(n, t, m, out); });
+  }
+
+template<typename T>
+  State_result
+  recv(Negotiation<T>& n, const Time& t, const v1_3_1::Message& m)
+  {
+    return collect([&](Message_sink& out) { return recv(n, t, m, out); });
+  }
+
+template<typename T>
+  State_result
+  time(Negotiation<T>& n, const Time& t)
+  {
+    return collect([&](Message_sink& out) { return time(n, t, out); });
+  }
+
 template<typename T>
   void
   fini(Negotiation<T>& n, const Time& t) {
@@ -0,0 +1,141 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_FSM_TIMERS_H
+#define FLOWGRAMMABLE_FSM_TIMERS_H
+
+#include <libflog/system/timer.hpp>
+
+namespace flog {
+namespace ofp {
+
+///
+/// @brief The timers of a protocol state machine
+///
+/// The feature and echo timers and a timer per outstanding request, of
+/// message type K, are armed on a shared timer wheel, usually that of the
+/// reactor running the connection, which is the only one to advance it.
+/// The request timers are held in a fixed array, so that neither sending
+/// a request nor receiving its reply allocates. A timer that fires is
+/// handled by the next call to the state machine's time handler, and sets
+/// off the alarm, if there is one: typically the timer of the connection
+/// running the state machine, which then calls that handler.
+///
+
+template<typename K>
+  struct FSM_timers
+  {
+    /// The most requests that can be waited on at once.
+    static const std::size_t Max_requests = 8;
+
+    /// The timer of a request, which is in use from when it is added until
+    /// it is removed or its expiry is handled.
+    struct Request_timer : Timer
+    {
+      Request_timer() : xid(0), kind(), used(false) { }
+
+      uint32_t xid;
+      K        kind;
+      bool     used;
+    };
+
+    FSM_timers(Timer_wheel& w)
+      : wheel(w), alarm(nullptr), feature(ring, this), echo(ring, this)
+    {
+      for (auto& r : requests) {
+        r.fire = ring;
+        r.data = this;
+      }
+    }
+
+    FSM_timers(const FSM_timers&) = delete;
+    FSM_timers& operator=(const FSM_timers&) = delete;
+
+    /// Arm the alarm of the timers to go off at once.
+    static void ring(Timer& tm, const Time& now)
+    {
+      FSM_timers& ft = *static_cast<FSM_timers*>(tm.data);
+      if (ft.alarm)
+        arm_by(ft.wheel, *ft.alarm, now);
+    }
+
+    Timer_wheel&          wheel;
+    Timer*                alarm;
+    Timer                 feature;
+    Timer                 echo;
+    Request_timer         requests[Max_requests];
+  };
+
+/// Returns true if the timer has fired and its deadline is not later than
+/// t. The state machines are driven by the time given to their handlers,
+/// which need not be the time at which the wheel was last advanced.
+inline bool
+is_due(const Timer& tm, const Time& t)
+{
+  return tm.expired and tm.deadline <= t;
+}
+
+/// Arm the timer of the request (xid, k), replacing any earlier deadline.
+/// Returns false if as many requests as can be waited on are in use.
+template<typename K>
+  inline bool
+  add_timer(FSM_timers<K>& ft, uint32_t xid, K k, const Time& deadline)
+  {
+    typename FSM_timers<K>::Request_timer* slot = nullptr;
+    for (auto& r : ft.requests) {
+      if (r.used and r.xid == xid and r.kind == k) {
+        slot = &r;
+        break;
+      }
+      if (not r.used and not slot)
+        slot = &r;
+    }
+    if (not slot)
+      return false;
+    slot->xid = xid;
+    slot->kind = k;
+    slot->used = true;
+    arm(ft.wheel, *slot, deadline);
+    return true;
+  }
+
+template<typename K>
+  inline void
+  remove_timer(FSM_timers<K>& ft, uint32_t xid, K k)
+  {
+    for (auto& r : ft.requests) {
+      if (r.used and r.xid == xid and r.kind == k) {
+        cancel(r);
+        r.used = false;
+        return;
+      }
+    }
+  }
+
+template<typename K>
+  inline void
+  clear(FSM_timers<K>& ft)
+  {
+    cancel(ft.feature);
+    cancel(ft.echo);
+    for (auto& r : ft.requests) {
+      cancel(r);
+      r.used = false;
+    }
+  }
+
+} // namespace ofp
+} // namespace flog
+
+#endif
@@ -59,25 +59,26 @@ struct Common_message {
   } ptr;
 };
 
-/// Provides a destructor for common messages.
+/// Provides a destructor for common messages. The message is returned to
+/// the pool of its version, from which the factories make messages.
 struct Common_message::Delete {
   void 
   operator()(Common_message& m) {
     switch (m.version) {
     case 1: 
-      delete m.ptr.m1; 
+      v1_0::Message_pool::release(m.ptr.m1);
       break;
     case 2: 
-      delete m.ptr.m2; 
+      v1_1::Message_pool::release(m.ptr.m2);
       break;
     case 3: 
-      delete m.ptr.m3; 
+      v1_2::Message_pool::release(m.ptr.m3);
       break;
     case 4: 
       if (m.patch == 0)
-        delete m.ptr.m4;
+        v1_3::Message_pool::release(m.ptr.m4);
       else
-        delete m.ptr.m5;
+        v1_3_1::Message_pool::release(m.ptr.m5);
       break;
     }
   }
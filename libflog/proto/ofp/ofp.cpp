@@ -13,4 +13,25 @@
 // permissions and limitations under the License.
 
 
-#include "ofp.hpp"
\ No newline at end of file
+#include "ofp.hpp"
+
+namespace flog {
+namespace ofp {
+
+namespace detail {
+thread_local Trust_level trust = STRUCTURAL_VALIDATION;
+} // namespace detail
+
+std::string
+to_string(Trust_level t)
+{
+  switch (t) {
+  case FULL_VALIDATION: return "full";
+  case STRUCTURAL_VALIDATION: return "structural";
+  case NO_VALIDATION: return "none";
+  default: return "unknown";
+  }
+}
+
+} // namespace ofp
+} // namespace flog
@@ -250,6 +250,138 @@ from_buffer(Buffer_view& v, mpls::Flow_label& fl)
   return true;
 }
 
+// Load and store primitives.
+//
+// These read or write a value directly in its wire representation at p,
+// which need not be aligned. They are used by message views and by the
+// generated codecs, which do not step through a Buffer_view field by
+// field.
+
+template<typename T>
+  inline T
+  load_raw(const Byte* p)
+  {
+    T n;
+    std::memcpy(&n, p, sizeof(T));
+    return Foreign_byte_order::msbf(n);
+  }
+
+template<typename T>
+  inline typename std::enable_if<not std::is_enum<T>::value, T>::type
+  load(const Byte* p) { return load_raw<T>(p); }
+
+// Load for enumeration types.
+template<typename T>
+  inline typename std::enable_if<std::is_enum<T>::value, T>::type
+  load(const Byte* p)
+  {
+    using U = typename std::underlying_type<T>::type;
+    return T(load_raw<U>(p));
+  }
+
+template<typename T>
+  inline void
+  store_raw(Byte* p, T n)
+  {
+    n = Foreign_byte_order::msbf(n);
+    std::memcpy(p, &n, sizeof(T));
+  }
+
+template<typename T>
+  inline typename std::enable_if<not std::is_enum<T>::value>::type
+  store(Byte* p, T n) { store_raw(p, n); }
+
+// Store for enumeration types.
+template<typename T>
+  inline typename std::enable_if<std::is_enum<T>::value>::type
+  store(Byte* p, T x)
+  {
+    using U = typename std::underlying_type<T>::type;
+    store_raw(p, U(x));
+  }
+
+// Minimum size.
+//
+// Returns the number of bytes in the encoding of an empty T. This is the
+// number of bytes that must be available before a T can be read. It does
+// not depend on the object being read into, which may be a recycled
+// value of any size.
+template<typename T>
+  inline std::size_t
+  min_bytes()
+  {
+    static const std::size_t n = bytes(T());
+    return n;
+  }
+
+// -------------------------------------------------------------------------- //
+// Trust level
+
+/// \brief The checks made on a message while it is decoded.
+///
+/// With FULL_VALIDATION, the semantic constraints checked by is_valid()
+/// are checked as each part of the message is read, so that a message
+/// that decodes need not be walked again to validate it. With
+/// STRUCTURAL_VALIDATION, only the form of the message is checked: each
+/// part has a known kind and is exactly as long as its stated length.
+/// NO_VALIDATION skips the bytes that follow the contents of a part
+/// within its stated length, rather than rejecting them. The lengths and
+/// kinds of parts are checked at every level, since reading a message
+/// depends on them.
+///
+/// The trust level is honored by the 1.3 and 1.3.1 decoders.
+enum Trust_level : uint8_t {
+  FULL_VALIDATION,
+  STRUCTURAL_VALIDATION,
+  NO_VALIDATION
+};
+
+std::string to_string(Trust_level t);
+
+namespace detail {
+extern thread_local Trust_level trust;
+} // namespace detail
+
+/// Returns the trust level of the innermost Trust_scope on the calling
+/// thread, or STRUCTURAL_VALIDATION if there is none.
+inline Trust_level
+trust_level() { return detail::trust; }
+
+/// \brief Sets the trust level of the messages decoded by the calling
+/// thread.
+///
+/// Scopes nest; the previous trust level is restored when the scope
+/// ends.
+class Trust_scope
+{
+public:
+  explicit Trust_scope(Trust_level t) : prev_(detail::trust) {
+    detail::trust = t;
+  }
+  ~Trust_scope() { detail::trust = prev_; }
+
+  Trust_scope(const Trust_scope&) = delete;
+  Trust_scope& operator=(const Trust_scope&) = delete;
+
+private:
+  Trust_level prev_;
+};
+
+/// Update the view v to the end of the constrained view c, as update()
+/// does. If c was not read to its end, its remaining bytes are an error
+/// unless the trust level is NO_VALIDATION, in which case they are
+/// skipped.
+inline bool
+update_trusted(Buffer_view& v, const Buffer_view& c)
+{
+  if (update(v, c))
+    return true;
+  if (trust_level() != NO_VALIDATION)
+    return false;
+  v.first = c.last;
+  return true;
+}
+
 } // namespace ofp
 } // namespace flog
 #endif
@@ -0,0 +1,225 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <libflog/proto/ofp/ofp.hpp>
+
+#include "pending.hpp"
+
+namespace flog {
+namespace ofp {
+
+namespace {
+
+// The message types resolved by the table. Error is the same in all
+// versions, but the stats (or multipart) reply moved in 1.1.
+const uint8_t Error_type = 1;
+const uint8_t Stats_reply_v1_0 = 17;
+const uint8_t Stats_reply_v1_1 = 19;
+
+// The flag of a stats reply that is followed by another part.
+const uint16_t Reply_more = 0x0001;
+
+const std::size_t Header_size = 8;
+
+// Returns the home slot of the xid, from the high bits of its product with
+// the golden ratio. This spreads xids that are handed out with a stride as
+// well as consecutive ones.
+inline std::size_t
+home(const Pending_table& p, uint32_t xid)
+{
+  return uint32_t(xid * 2654435769u) >> p.shift;
+}
+
+inline Pending_request&
+request(Pending_table& p, std::size_t slot)
+{
+  return p.requests[p.slots[slot] - 1];
+}
+
+// Returns the slot holding the request with the given xid, or the empty
+// slot where it would be.
+std::size_t
+probe(Pending_table& p, uint32_t xid)
+{
+  std::size_t i = home(p, xid);
+  while (p.slots[i] and request(p, i).xid != xid)
+    i = (i + 1) & p.mask;
+  return i;
+}
+
+// Remove the request in slot i, and shift the requests that follow it
+// back toward their home slots.
+void
+remove(Pending_table& p, std::size_t i)
+{
+  Pending_request& r = request(p, i);
+  cancel(r);
+  p.free.push_back(p.slots[i] - 1);
+  --p.size;
+
+  std::size_t j = i;
+  while (true) {
+    j = (j + 1) & p.mask;
+    if (not p.slots[j])
+      break;
+    // Leave the request in slot j if its home is cyclically in (i, j].
+    std::size_t h = home(p, request(p, j).xid);
+    if (i <= j ? (i < h and h <= j) : (i < h or h <= j))
+      continue;
+    p.slots[i] = p.slots[j];
+    i = j;
+  }
+  p.slots[i] = 0;
+}
+
+// Complete the request in slot i with the status s and the reply m.
+void
+complete(Pending_table& p, std::size_t i, Request_status s,
+         const Byte* m, std::size_t n, const Time& t)
+{
+  Pending_request& r = request(p, i);
+  Request_result result { s, r.xid, m, n };
+  Request_callback done = r.done;
+  void* context = r.context;
+  if (s != MORE)
+    remove(p, i);
+  if (done)
+    done(context, result, t);
+}
+
+void
+expire(Timer& tm, const Time& t)
+{
+  Pending_request& r = static_cast<Pending_request&>(tm);
+  Pending_table& p = *r.table;
+  complete(p, probe(p, r.xid), EXPIRED, nullptr, 0, t);
+  if (p.alarm and p.wheel)
+    arm_by(*p.wheel, *p.alarm, t);
+}
+
+} // namespace
+
+Pending_request::Pending_request()
+  : Timer(expire), table(nullptr), xid(0), reply(0), done(nullptr),
+    context(nullptr)
+{ }
+
+Pending_table::Pending_table(std::size_t n)
+  : wheel(nullptr), alarm(nullptr), version(0), capacity(n), size(0),
+    mask(0), shift(32), requests(new Pending_request[n]), free()
+{
+  std::size_t k = 1;
+  while (k < 2 * n) {
+    k *= 2;
+    --shift;
+  }
+  mask = k - 1;
+  slots.assign(k, 0);
+
+  free.reserve(n);
+  for (std::size_t i = n; i > 0; --i) {
+    requests[i - 1].table = this;
+    free.push_back(i - 1);
+  }
+}
+
+void
+set_version(Pending_table& p, uint8_t version, Timer_wheel& w)
+{
+  p.version = version;
+  p.wheel = &w;
+}
+
+bool
+expect(Pending_table& p, uint32_t xid, uint8_t reply, const Time& deadline,
+       Request_callback cb, void* context)
+{
+  if (p.free.empty() or not p.wheel)
+    return false;
+  std::size_t i = probe(p, xid);
+  if (p.slots[i])
+    return false;
+
+  uint32_t k = p.free.back();
+  p.free.pop_back();
+  p.slots[i] = k + 1;
+  ++p.size;
+
+  Pending_request& r = p.requests[k];
+  r.xid = xid;
+  r.reply = reply;
+  r.done = cb;
+  r.context = context;
+  arm(*p.wheel, r, deadline);
+  return true;
+}
+
+Pending_request*
+find(Pending_table& p, uint32_t xid)
+{
+  std::size_t i = probe(p, xid);
+  return p.slots[i] ? &request(p, i) : nullptr;
+}
+
+bool
+forget(Pending_table& p, uint32_t xid)
+{
+  std::size_t i = probe(p, xid);
+  if (not p.slots[i])
+    return false;
+  remove(p, i);
+  return true;
+}
+
+bool
+resolve(Pending_table& p, const Byte* m, std::size_t n, const Time& t)
+{
+  if (p.size == 0 or n < Header_size)
+    return false;
+  std::size_t i = probe(p, load<uint32_t>(m + 4));
+  if (not p.slots[i])
+    return false;
+
+  Pending_request& r = request(p, i);
+  uint8_t type = m[1];
+  if (type == Error_type) {
+    complete(p, i, FAILED, m, n, t);
+    return true;
+  }
+  if (type != r.reply)
+    return false;
+
+  // A stats reply with the more flag leaves the request pending for the
+  // parts that follow.
+  uint8_t stats = p.version == 1 ? Stats_reply_v1_0 : Stats_reply_v1_1;
+  bool more = type == stats and n >= Header_size + 4
+          and (load<uint16_t>(m + 10) & Reply_more);
+  complete(p, i, more ? MORE : REPLIED, m, n, t);
+  return true;
+}
+
+void
+clear(Pending_table& p, const Time& t)
+{
+  // No request can be made while the table is being cleared.
+  p.wheel = nullptr;
+  for (std::size_t i = 0; i <= p.mask and p.size; ++i) {
+    // Removal can shift another request into this slot.
+    while (p.slots[i])
+      complete(p, i, CANCELLED, nullptr, 0, t);
+  }
+}
+
+} // namespace ofp
+} // namespace flog
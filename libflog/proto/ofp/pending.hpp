@@ -0,0 +1,135 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_PROTO_OFP_PENDING_HPP
+#define FLOWGRAMMABLE_PROTO_OFP_PENDING_HPP
+
+#include <memory>
+#include <vector>
+
+#include <libflog/buffer.hpp>
+#include <libflog/system/timer.hpp>
+
+/// \file pending.hpp
+/// Tracking the requests sent to a switch until they are answered.
+
+namespace flog {
+namespace ofp {
+
+struct Pending_table;
+
+/// How a pending request was completed.
+enum Request_status
+{
+  REPLIED,    // The reply arrived
+  MORE,       // A part of a multipart reply arrived, and more will follow
+  FAILED,     // An error reply arrived
+  EXPIRED,    // The deadline passed before a reply
+  CANCELLED,  // The connection closed before a reply
+  REFUSED     // The request could not be made, and was not sent
+};
+
+/// The completion of a pending request. The reply, if any, is the message
+/// as received, and is only valid for the duration of the callback.
+struct Request_result
+{
+  Request_status status;
+  uint32_t xid;
+  const Byte* data;
+  std::size_t size;
+};
+
+/// The function called when a pending request is completed. The request
+/// has already been removed from the table, unless the status is MORE, so
+/// the callback is free to make new requests, even with the same xid.
+using Request_callback = void (*)(void* context, const Request_result& r,
+                                  const Time& t);
+
+/// A request waiting for its reply, whose timer is armed with its
+/// deadline.
+struct Pending_request : Timer
+{
+  Pending_request();
+
+  Pending_table* table;
+  uint32_t xid;
+  uint8_t reply;
+  Request_callback done;
+  void* context;
+};
+
+/// \brief The requests sent on a connection that are waiting for a reply.
+///
+/// Requests are held in a fixed pool and indexed by xid in an open
+/// addressed hash table with linear probing, which has twice as many
+/// slots as the pool has requests. Removal shifts the entries that follow
+/// back into the hole, so lookup never crosses a tombstone. The timer of
+/// each request is part of it, so that neither adding, resolving nor
+/// expiring a request allocates.
+///
+/// A reply resolves the request with its xid if its type is the expected
+/// reply type, or an error. The callback of a request that expires is
+/// called from the timer wheel, so the messages it sends are queued until
+/// the connection next runs. The expiry sets off the alarm, if there is
+/// one, so that it runs at once.
+struct Pending_table
+{
+  Pending_table(std::size_t n = 256);
+
+  Pending_table(const Pending_table&) = delete;
+  Pending_table& operator=(const Pending_table&) = delete;
+
+  Timer_wheel* wheel;           // Where deadlines are armed
+  Timer* alarm;                 // Armed to go off when a request expires
+  uint8_t version;              // The version number on the wire
+
+  std::size_t capacity;
+  std::size_t size;
+  std::size_t mask;
+  unsigned shift;
+  std::unique_ptr<Pending_request[]> requests;
+  std::vector<uint32_t> slots;  // The index of a request, plus 1
+  std::vector<uint32_t> free;
+};
+
+/// Prepare the table for replies with the given version number, whose
+/// deadlines are armed on the wheel w.
+void set_version(Pending_table& p, uint8_t version, Timer_wheel& w);
+
+/// Wait for a reply of type reply to the request with the given xid, until
+/// the deadline. Returns false if the table is full, or a request with
+/// that xid is already pending.
+bool expect(Pending_table& p, uint32_t xid, uint8_t reply,
+            const Time& deadline, Request_callback cb, void* context);
+
+/// Returns the pending request with the given xid, or nullptr.
+Pending_request* find(Pending_table& p, uint32_t xid);
+
+/// Forget the request with the given xid, without calling its callback.
+/// Returns false if there is no such request.
+bool forget(Pending_table& p, uint32_t xid);
+
+/// If the message of n bytes at m is a reply to a pending request, pass it
+/// to the request's callback and return true; the message need not be
+/// passed on.
+bool resolve(Pending_table& p, const Byte* m, std::size_t n, const Time& t);
+
+/// Cancel every pending request. No requests can be made afterward, until
+/// the version is set again.
+void clear(Pending_table& p, const Time& t);
+
+} // namespace ofp
+} // namespace flog
+
+#endif
@@ -0,0 +1,146 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <algorithm>
+
+#include "service.hpp"
+
+namespace flog {
+namespace ofp {
+
+bool
+Session_service::accept(Reactor& r, socket::Socket&& s, const Time& t)
+{
+  if (not settings.app) {
+    error = "no application";
+    return false;
+  }
+
+  // The connection is deleted when it closes, which may be at once.
+  Session_connection* c = new Session_connection(r, std::move(s), settings);
+  attach(*c, c->session, t);
+  return true;
+}
+
+bool
+Session_service::connect(Reactor& r, const net::Address& remote,
+                         const net::Address& local, const Time& t)
+{
+  if (not settings.app) {
+    error = "no application";
+    return false;
+  }
+  Session_connection* c = new Session_connection(r, remote, local, settings);
+  if (not c->skt) {
+    error = c->skt.error;
+    delete c;
+    return false;
+  }
+
+  // The hello is queued by the session, and sent once the connection is
+  // writable. The connection is deleted when it closes.
+  attach(*c, c->session, t);
+  return true;
+}
+
+bool
+Session_service::add_app(const std::string& name)
+{
+  error.clear();
+
+  // Every plugin of a name shares the application of the thread, which
+  // each would release when unloaded.
+  for (const Loaded_app& a : apps) {
+    if (a.plugin->name == name) {
+      error = "already loaded";
+      return false;
+    }
+  }
+  std::shared_ptr<plugin::Plugin> p(new plugin::Plugin(name));
+  if (not *p) {
+    error = p->error;
+    return false;
+  }
+  auto app = p->get<Application>();
+  if (not app.first) {
+    error = app.second;
+    return false;
+  }
+  error = app.second;
+  settings.app = app.first;
+  settings.plugin = p;
+  apps.push_back(Loaded_app{std::move(p), app.first});
+  return true;
+}
+
+bool
+Session_service::del_app(const std::string& name)
+{
+  error.clear();
+  auto i = std::find_if(apps.begin(), apps.end(), [&](const Loaded_app& a) {
+    return a.plugin->name == name;
+  });
+  if (i == apps.end()) {
+    error = "no such application";
+    return false;
+  }
+  apps.erase(i);
+
+  // The sessions already open keep their application, and its plugin,
+  // until they close. New ones use the latest application left.
+  if (apps.empty()) {
+    settings.app = nullptr;
+    settings.plugin = nullptr;
+    error = "no application left, refusing peers";
+  } else {
+    settings.app = apps.back().app;
+    settings.plugin = apps.back().plugin;
+  }
+  return true;
+}
+
+bool
+Session_service::set_ofp(const config::Ofp& o)
+{
+  switch (o.type) {
+  case config::Ofp::Version:
+    if (o.value < config::v10 or o.value > config::v13) {
+      error = "unknown version";
+      return false;
+    }
+    // The configured and the session versions share their numbering.
+    settings.config.version = FSM_config::Version(o.value);
+    settings.config.supported = FSM_config::Supported(1 << (o.value - 1));
+    return true;
+  case config::Ofp::Echo_interval:
+    settings.config.timers.echo_req_interval = o.time;
+    return true;
+  case config::Ofp::Echo_timeout:
+    settings.config.timers.echo_res_wait = o.time;
+    return true;
+  case config::Ofp::Trust:
+    if (o.value > NO_VALIDATION) {
+      error = "unknown level";
+      return false;
+    }
+    settings.trust = Trust_level(o.value);
+    return true;
+  default:
+    error = "unsupported setting";
+    return false;
+  }
+}
+
+} // namespace ofp
+} // namespace flog
@@ -0,0 +1,62 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_PROTO_OFP_SERVICE_HPP
+#define FLOWGRAMMABLE_PROTO_OFP_SERVICE_HPP
+
+#include <memory>
+#include <vector>
+
+#include <libflog/system/plugin.hpp>
+#include <libflog/system/service.hpp>
+#include <libflog/proto/ofp/session.hpp>
+
+/// \file service.hpp
+/// Running OpenFlow sessions on the connections of a manager.
+
+namespace flog {
+namespace ofp {
+
+/// \brief Runs a session on each connection a manager accepts or
+/// initiates.
+///
+/// Each session is opened with the settings of the service, which the ofp
+/// commands change for the connections made after them. Peers are refused
+/// until an application is loaded. The application of the sessions is the
+/// one of the latest plugin still loaded. A deleted plugin is unloaded once
+/// the last session that uses its application closes.
+struct Session_service : Service
+{
+  /// A loaded plugin and the application it provides.
+  struct Loaded_app
+  {
+    std::shared_ptr<plugin::Plugin> plugin;
+    Application* app;
+  };
+
+  bool accept(Reactor& r, socket::Socket&& s, const Time& t) override;
+  bool connect(Reactor& r, const net::Address& remote,
+               const net::Address& local, const Time& t) override;
+  bool add_app(const std::string& name) override;
+  bool del_app(const std::string& name) override;
+  bool set_ofp(const config::Ofp& o) override;
+
+  Session_settings settings;
+  std::vector<Loaded_app> apps;
+};
+
+} // namespace ofp
+} // namespace flog
+
+#endif
@@ -0,0 +1,517 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <new>
+
+#include "session.hpp"
+
+namespace flog {
+namespace ofp {
+
+namespace {
+
+// Call f with the negotiation of the session, whose type is given by the
+// configured version.
+template<typename F>
+  bool
+  with_negotiation(Session& s, F f)
+  {
+    switch (s.config.version) {
+    case FSM_config::v1_0:
+      return f(s.neg_v1_0);
+    case FSM_config::v1_1:
+      return f(s.neg_v1_1);
+    case FSM_config::v1_2:
+      return f(s.neg_v1_2);
+    case FSM_config::v1_3:
+      return f(s.neg_v1_3);
+    case FSM_config::v1_3_1:
+      return f(s.neg_v1_3_1);
+    default:
+      return false;
+    }
+  }
+
+// The version dependent operations of a session whose state machine, of
+// type F, is the member P. Its messages, of type M, are decoded into the
+// slots S of the batch.
+template<typename M, Batch_slots<M> Message_batch::* S, typename F,
+         F Session::* P>
+  bool
+  recv_version(Session& s, const Time& t, std::size_t first,
+               std::size_t last, Message_sink& out)
+  {
+    const Batch_slots<M>& b = s.batch.*S;
+    F& f = s.*P;
+    for (std::size_t i = first; i < last; ++i) {
+      if (not recv(f, t, b.messages[i], out))
+        return false;
+    }
+    return true;
+  }
+
+template<typename F, F Session::* P>
+  bool
+  time_version(Session& s, const Time& t, Message_sink& out)
+  {
+    return time(s.*P, t, out);
+  }
+
+template<typename F, F Session::* P>
+  void
+  fini_version(Session& s, const Time& t)
+  {
+    fini(s.*P, t);
+  }
+
+// Returns the operations of the version v.
+const Version_ops*
+bind(FSM_config::Version v)
+{
+  static const Version_ops ops[] = {
+    {
+      1, decoder(1, 0), encoder(1, 0), releaser(1, 0),
+      recv_version<v1_0::Message, &Message_batch::m1,
+                   v1_0::FSM_controller, &Session::fsm_v1_0>,
+      time_version<v1_0::FSM_controller, &Session::fsm_v1_0>,
+      fini_version<v1_0::FSM_controller, &Session::fsm_v1_0>
+    },
+    {
+      2, decoder(2, 0), encoder(2, 0), releaser(2, 0),
+      recv_version<v1_1::Message, &Message_batch::m2,
+                   v1_1::FSM_controller, &Session::fsm_v1_1>,
+      time_version<v1_1::FSM_controller, &Session::fsm_v1_1>,
+      fini_version<v1_1::FSM_controller, &Session::fsm_v1_1>
+    },
+    {
+      3, decoder(3, 0), encoder(3, 0), releaser(3, 0),
+      recv_version<v1_2::Message, &Message_batch::m3,
+                   v1_2::FSM_controller, &Session::fsm_v1_2>,
+      time_version<v1_2::FSM_controller, &Session::fsm_v1_2>,
+      fini_version<v1_2::FSM_controller, &Session::fsm_v1_2>
+    },
+    {
+      4, decoder(4, 0), encoder(4, 0), releaser(4, 0),
+      recv_version<v1_3::Message, &Message_batch::m4,
+                   v1_3::FSM_controller, &Session::fsm_v1_3>,
+      time_version<v1_3::FSM_controller, &Session::fsm_v1_3>,
+      fini_version<v1_3::FSM_controller, &Session::fsm_v1_3>
+    },
+    {
+      4, decoder(4, 1), encoder(4, 1), releaser(4, 1),
+      recv_version<v1_3_1::Message, &Message_batch::m5,
+                   v1_3_1::FSM_controller, &Session::fsm_v1_3_1>,
+      time_version<v1_3_1::FSM_controller, &Session::fsm_v1_3_1>,
+      fini_version<v1_3_1::FSM_controller, &Session::fsm_v1_3_1>
+    }
+  };
+  return &ops[v - FSM_config::v1_0];
+}
+
+// Construct the state machine f of version v for the session, bound to the
+// application interface A of that version, and start it.
+template<typename A, typename F>
+  bool
+  start(Session& s, F& f, FSM_config::Version v, Connection& c,
+        const Time& t, Message_sink& out)
+  {
+    A* a = dynamic_cast<A*>(&s.app);
+    if (not a)
+      return false;
+    new (&f) F(s.config, s.gen, *a, c.reactor.timers);
+    s.version = v;
+    s.ops = bind(v);
+    set_version(s.batcher, s.ops->wire, s.config.timers.barrier_res_wait);
+    set_version(s.pending, s.ops->wire, c.reactor.timers);
+    s.state = Session::ESTABLISHED;
+
+    // From here on, the connection is woken by the timers that fire, and
+    // no longer at the end of the hello exchange.
+    f.timers.alarm = &c.timer;
+    s.pending.alarm = &c.timer;
+    unschedule(c.reactor, &c);
+    return init(f, t, out);
+  }
+
+// Start the state machine of the negotiated version v.
+bool
+establish(Session& s, FSM_config::Version v, Connection& c, const Time& t,
+          Message_sink& out)
+{
+  // 1.3 and 1.3.1 share a version number on the wire. The patch of the
+  // batch decides how their messages are decoded, and so which state
+  // machine receives them.
+  if (v >= FSM_config::v1_3)
+    v = s.batch.patch ? FSM_config::v1_3_1 : FSM_config::v1_3;
+
+  switch (v) {
+  case FSM_config::v1_0:
+    return start<v1_0::Application>(s, s.fsm_v1_0, v, c, t, out);
+  case FSM_config::v1_1:
+    return start<v1_1::Application>(s, s.fsm_v1_1, v, c, t, out);
+  case FSM_config::v1_2:
+    return start<v1_2::Application>(s, s.fsm_v1_2, v, c, t, out);
+  case FSM_config::v1_3:
+    return start<v1_3::Application>(s, s.fsm_v1_3, v, c, t, out);
+  case FSM_config::v1_3_1:
+    return start<v1_3_1::Application>(s, s.fsm_v1_3_1, v, c, t, out);
+  default:
+    return false;
+  }
+}
+
+struct Negotiation_init
+{
+  template<typename N>
+    bool operator()(N& n) const { return init(n, t, out); }
+
+  const Time& t;
+  Message_sink& out;
+};
+
+// Run the hello timer, and wake the connection again at its deadline if
+// it has not passed.
+struct Negotiation_time
+{
+  template<typename N>
+    bool operator()(N& n) const
+    {
+      if (not time(n, t, out))
+        return false;
+      wake(c, n.hello_timer);
+      return true;
+    }
+
+  Connection& c;
+  const Time& t;
+  Message_sink& out;
+};
+
+// Pass the message m to the negotiation, and establish the session once
+// the hello exchange succeeds.
+struct Negotiation_recv
+{
+  template<typename N>
+    bool operator()(N& n) const
+    {
+      switch (m.version) {
+      case 1:
+        recv(n, t, *m.ptr.m1, out);
+        break;
+      case 2:
+        recv(n, t, *m.ptr.m2, out);
+        break;
+      case 3:
+        recv(n, t, *m.ptr.m3, out);
+        break;
+      case 4:
+        if (m.patch == 0)
+          recv(n, t, *m.ptr.m4, out);
+        else
+          recv(n, t, *m.ptr.m5, out);
+        break;
+      default:
+        return false;
+      }
+      if (n.state != N::SUCCESS)
+        return false;
+      return establish(s, FSM_config::Version(n.negotiated_version), c, t,
+                       out);
+    }
+
+  Session& s;
+  Connection& c;
+  const Time& t;
+  Common_message m;
+  Message_sink& out;
+};
+
+// Returns true if the message of n bytes at p may be a reply that the
+// session consumes: one to a pending request, or an error or barrier reply
+// to a batch of flow mods.
+bool
+may_consume(Session& s, const Byte* p, std::size_t n)
+{
+  uint32_t xid = load<uint32_t>(p + 4);
+  if (s.pending.size and find(s.pending, xid))
+    return true;
+  return enabled(s.batcher) and xid >= Flow_batcher::First_xid;
+}
+
+// Dispatch the messages of a read in the order they were received. Each
+// held message is offered to the pending table and then to the batcher,
+// once the messages decoded before it have been dispatched. One that
+// neither consumes is decoded, and dispatched on its own.
+bool
+dispatch(Session& s, const Time& t, Message_sink& out)
+{
+  std::size_t first = 0;
+  std::size_t decoded = s.batch.size();
+  for (const Held_message& h : s.held) {
+    if (not s.ops->recv(s, t, first, h.before, out))
+      return false;
+    first = h.before;
+
+    Flow_mod_batch done;
+    const Byte* p = h.view.first;
+    std::size_t n = remaining(h.view);
+    if (resolve(s.pending, p, n, t))
+      continue;
+    if (enabled(s.batcher) and inspect(s.batcher, p, n, done)) {
+      s.app.batch_complete(done, t);
+      continue;
+    }
+    Buffer_view v = h.view;
+    std::size_t k = s.batch.size();
+    if (not s.ops->decode(v, s.batch) or not s.ops->recv(s, t, k, k + 1, out))
+      return false;
+  }
+  return s.ops->recv(s, t, first, decoded, out);
+}
+
+// Fail the sealed batches of flow mods whose barriers were not answered in
+// time.
+void
+expire_batches(Session& s, const Time& t)
+{
+  Flow_mod_batch done;
+  while (expire(s.batcher, t, done))
+    s.app.batch_expired(done, t);
+}
+
+// Seal the open batch of flow mods if it is due, or wake the connection
+// when it or the oldest sealed batch will be. The deadlines of the batcher
+// are the only ones the connection is woken for ahead of time, as the
+// timers that fire wake it at once, so it is cancelled once there are none.
+void
+finish_batch(Session& s, Connection& c, const Time& t)
+{
+  if (must_seal(s.batcher, t))
+    seal(s.batcher, c.output, t);
+  if (Time d = next_deadline(s.batcher))
+    wake(c, d);
+  else if (is_armed(c.timer) and t < c.timer.deadline)
+    unschedule(c.reactor, &c);
+}
+
+// The timers of sessions opened with default settings.
+Timer_config
+default_timers()
+{
+  Timer_config tc;
+  tc.hello_wait = Time(5);
+  tc.echo_req_interval = Time(30);
+  tc.echo_res_wait = Time(5);
+  tc.feature_req_wait = Time(5);
+  tc.feature_res_wait = Time(5);
+  tc.barrier_res_wait = Time(5);
+  return tc;
+}
+
+} // namespace
+
+Session::Session(const FSM_config& c, Application& a, Trust_level t)
+  : state(IDLE), connection(nullptr), config(c), gen(), app(a),
+    batch(c.version == FSM_config::v1_3_1, t), version(FSM_config::Unsup),
+    ops(nullptr), received(0)
+{
+  switch (config.version) {
+  case FSM_config::v1_0:
+    new (&neg_v1_0) Negotiation<v1_0::Message>(config, gen);
+    break;
+  case FSM_config::v1_1:
+    new (&neg_v1_1) Negotiation<v1_1::Message>(config, gen);
+    break;
+  case FSM_config::v1_2:
+    new (&neg_v1_2) Negotiation<v1_2::Message>(config, gen);
+    break;
+  case FSM_config::v1_3:
+    new (&neg_v1_3) Negotiation<v1_3::Message>(config, gen);
+    break;
+  case FSM_config::v1_3_1:
+    new (&neg_v1_3_1) Negotiation<v1_3_1::Message>(config, gen);
+    break;
+  default:
+    state = CLOSED;
+    break;
+  }
+}
+
+Session::~Session()
+{
+  switch (config.version) {
+  case FSM_config::v1_0:
+    neg_v1_0.~Negotiation();
+    break;
+  case FSM_config::v1_1:
+    neg_v1_1.~Negotiation();
+    break;
+  case FSM_config::v1_2:
+    neg_v1_2.~Negotiation();
+    break;
+  case FSM_config::v1_3:
+    neg_v1_3.~Negotiation();
+    break;
+  case FSM_config::v1_3_1:
+    neg_v1_3_1.~Negotiation();
+    break;
+  default:
+    break;
+  }
+
+  switch (version) {
+  case FSM_config::v1_0:
+    fsm_v1_0.~FSM_controller();
+    break;
+  case FSM_config::v1_1:
+    fsm_v1_1.~FSM_controller();
+    break;
+  case FSM_config::v1_2:
+    fsm_v1_2.~FSM_controller();
+    break;
+  case FSM_config::v1_3:
+    fsm_v1_3.~FSM_controller();
+    break;
+  case FSM_config::v1_3_1:
+    fsm_v1_3_1.~FSM_controller();
+    break;
+  default:
+    break;
+  }
+}
+
+bool
+Session::open(Connection& c, const Time& t)
+{
+  if (state != IDLE)
+    return false;
+  state = NEGOTIATING;
+  connection = &c;
+  Output_sink out(c.output);
+  if (not with_negotiation(*this, Negotiation_init{t, out}))
+    return false;
+  wake(c, t + config.timers.hello_wait);
+  return true;
+}
+
+bool
+Session::recv(Connection& c, Framer& f, const Time& t)
+{
+  // The hello exchange takes a message at a time, of any version. Those
+  // that follow it in the same read are left for the negotiated version.
+  while (state == NEGOTIATING and f.ready()) {
+    clear(batch);
+    Buffer_view v = f.next();
+    if (not decode(v, batch))
+      return false;
+    ++received;
+    Output_sink out(c.output);
+    Negotiation_recv r{*this, c, t, batch[0], out};
+    if (not with_negotiation(*this, r))
+      return false;
+  }
+  if (not f.ready())
+    return true;
+  if (state != ESTABLISHED)
+    return false;
+
+  // Decode everything that was read before acting on any of it, so that
+  // the messages are dispatched from a batch that is hot in the cache.
+  // The replies the session may consume are held back, in place.
+  clear(batch);
+  held.clear();
+  Trust_scope scope(batch.trust);
+  while (f.ready()) {
+    Buffer_view v = f.next();
+    if (*v.first != ops->wire)
+      return false;
+    ++received;
+    if (may_consume(*this, v.first, remaining(v))) {
+      held.push_back({batch.size(), v});
+      continue;
+    }
+    if (not ops->decode(v, batch))
+      return false;
+  }
+
+  // The messages sent by the callbacks of resolved requests follow those
+  // sent by the state machine.
+  Output_sink out(c.output, ops->encode, ops->release);
+  if (not enabled(batcher))
+    return dispatch(*this, t, out) and flush(app.tx_queue, out);
+
+  Batching_sink bout(out, batcher, t);
+  if (not dispatch(*this, t, bout))
+    return false;
+  flush(app.tx_queue, bout);
+  finish_batch(*this, c, t);
+  return true;
+}
+
+bool
+Session::time(Connection& c, const Time& t)
+{
+  switch (state) {
+  case NEGOTIATING: {
+    Output_sink out(c.output);
+    return with_negotiation(*this, Negotiation_time{c, t, out});
+  }
+  case ESTABLISHED: {
+    // The messages queued by the callbacks of expired requests and
+    // batches are sent from here.
+    Output_sink out(c.output, ops->encode, ops->release);
+    if (not enabled(batcher))
+      return ops->time(*this, t, out) and flush(app.tx_queue, out);
+    expire_batches(*this, t);
+    Batching_sink bout(out, batcher, t);
+    if (not ops->time(*this, t, bout))
+      return false;
+    flush(app.tx_queue, bout);
+    finish_batch(*this, c, t);
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+void
+Session::close(Connection& c, const Time& t)
+{
+  clear(pending, t);
+  if (state == ESTABLISHED)
+    ops->fini(*this, t);
+  state = CLOSED;
+  connection = nullptr;
+}
+
+Session_settings::Session_settings()
+  : config(FSM_config::v1_3, FSM_config::a1_3, default_timers()),
+    app(nullptr), trust(STRUCTURAL_VALIDATION)
+{ }
+
+std::string
+to_string(Session::State s)
+{
+  switch (s) {
+  case Session::IDLE: return "IDLE";
+  case Session::NEGOTIATING: return "NEGOTIATING";
+  case Session::ESTABLISHED: return "ESTABLISHED";
+  case Session::CLOSED: return "CLOSED";
+  default: return "unknown";
+  }
+}
+
+} // namespace ofp
+} // namespace flog
@@ -0,0 +1,237 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_PROTO_OFP_SESSION_HPP
+#define FLOWGRAMMABLE_PROTO_OFP_SESSION_HPP
+
+#include <memory>
+
+#include <libflog/system/connection.hpp>
+#include <libflog/system/plugin.hpp>
+#include <libflog/proto/ofp/application.hpp>
+#include <libflog/proto/ofp/batch.hpp>
+#include <libflog/proto/ofp/fsm_negotiation.hpp>
+#include <libflog/proto/ofp/pending.hpp>
+#include <libflog/proto/ofp/v1_0/state.hpp>
+#include <libflog/proto/ofp/v1_1/state.hpp>
+#include <libflog/proto/ofp/v1_2/state.hpp>
+#include <libflog/proto/ofp/v1_3/state.hpp>
+#include <libflog/proto/ofp/v1_3_1/state.hpp>
+
+/// \file session.hpp
+/// The controller side of an OpenFlow connection.
+
+namespace flog {
+namespace ofp {
+
+struct Session;
+
+/// \brief The operations of a session that depend on its version.
+///
+/// Once a version is negotiated, the session is bound to the table of that
+/// version, so that the messages it receives and sends are decoded,
+/// dispatched to the state machine and the application, encoded and
+/// released without switching on the version of each one.
+struct Version_ops
+{
+  /// The version number of the messages on the wire.
+  uint8_t wire;
+
+  Batch_decoder decode;
+  Message_encoder encode;
+  Message_releaser release;
+
+  /// Pass the messages of the session's batch, from first up to last, to
+  /// its state machine.
+  bool (*recv)(Session& s, const Time& t, std::size_t first,
+               std::size_t last, Message_sink& out);
+
+  /// Run the timers of the session's state machine.
+  bool (*time)(Session& s, const Time& t, Message_sink& out);
+
+  /// Stop the session's state machine.
+  void (*fini)(Session& s, const Time& t);
+};
+
+/// A message of a read that is not decoded with the others, because it may
+/// be a reply that the session consumes itself. It is viewed in place, in
+/// the connection's framer.
+struct Held_message
+{
+  std::size_t before;   // The number of messages decoded before it
+  Buffer_view view;
+};
+
+/// \brief The controller side of an OpenFlow connection.
+///
+/// A session negotiates a version with the switch at the other end of a
+/// connection and then runs the controller state machine of that version,
+/// which passes the messages it receives to the application. The messages
+/// of each read are decoded in place from the connection's framer into a
+/// batch, at the trust level of the session. The messages sent by the state
+/// machine and queued by the application are encoded straight into the
+/// connection's output.
+///
+/// If its batcher is enabled, the flow mods sent by the application are
+/// coalesced into batches, each closed by a barrier request. The replies
+/// to those barriers are consumed by the session, which reports each
+/// completed batch to the application. A batch whose barrier is not
+/// answered within the barrier timeout of the configuration is reported as
+/// expired instead.
+///
+/// The replies to requests the application has registered in the pending
+/// table are passed to their callbacks instead of the state machine. The
+/// requests still pending when the session closes are cancelled.
+///
+/// The messages of a read are handled in the order they were received, so
+/// that the callback of a request, or the completion of a batch, follows
+/// the handling of every message before its reply. The replies that the
+/// session may consume are held back from decoding, and offered to the
+/// pending table and the batcher as their turn comes.
+///
+/// The session wakes its connection only when it has a deadline to meet:
+/// the end of the hello exchange, the deadline of a batch, or a timer
+/// of the state machine or of a pending request, which sets off the
+/// connection's timer as it fires. The messages the application queues
+/// outside of the session's handlers are sent when the connection next
+/// runs; waking it with the current time sends them at once.
+///
+/// The hello exchange accepts a hello of any version. After it, the
+/// session only accepts messages of the negotiated version, which it
+/// handles through the operations bound for that version.
+///
+/// The application must implement the Application interface of every
+/// version that can be negotiated. The session fails if the negotiated
+/// version is not one the application supports. A message that cannot be
+/// decoded, or that is not expected in the state of the session, fails it
+/// too, and a failed session is closed with its connection; it cannot be
+/// opened again.
+struct Session : Protocol
+{
+  enum State { IDLE, NEGOTIATING, ESTABLISHED, CLOSED };
+
+  Session(const FSM_config& c, Application& a,
+          Trust_level t = STRUCTURAL_VALIDATION);
+  ~Session();
+
+  Session(const Session&) = delete;
+  Session& operator=(const Session&) = delete;
+
+  bool open(Connection& c, const Time& t) override;
+  bool recv(Connection& c, Framer& f, const Time& t) override;
+  bool time(Connection& c, const Time& t) override;
+  void close(Connection& c, const Time& t) override;
+
+  State state;
+  Connection* connection;
+  FSM_config config;
+  Xid_generator<uint32_t> gen;
+  Application& app;
+  Message_batch batch;
+
+  /// The negotiated version and its operations, valid once the session
+  /// is established.
+  FSM_config::Version version;
+  const Version_ops* ops;
+
+  /// The number of messages received.
+  uint64_t received;
+
+  /// The batches of flow mods sent.
+  Flow_batcher batcher;
+
+  /// The messages of the current read held back from decoding.
+  std::vector<Held_message> held;
+
+  /// The requests waiting for a reply.
+  Pending_table pending;
+
+  // The hello exchange, of the version given by the configuration.
+  union {
+    Negotiation<v1_0::Message> neg_v1_0;
+    Negotiation<v1_1::Message> neg_v1_1;
+    Negotiation<v1_2::Message> neg_v1_2;
+    Negotiation<v1_3::Message> neg_v1_3;
+    Negotiation<v1_3_1::Message> neg_v1_3_1;
+  };
+
+  // The state machine of the negotiated version, live once the session is
+  // established.
+  union {
+    v1_0::FSM_controller fsm_v1_0;
+    v1_1::FSM_controller fsm_v1_1;
+    v1_2::FSM_controller fsm_v1_2;
+    v1_3::FSM_controller fsm_v1_3;
+    v1_3_1::FSM_controller fsm_v1_3_1;
+  };
+};
+
+std::string to_string(Session::State s);
+
+/// \brief How sessions are opened on the connections a reactor accepts
+/// and initiates.
+///
+/// No session can be opened until an application is loaded. The
+/// application is shared by every session opened with the settings, and
+/// each of their connections keeps the plugin that provides it loaded.
+struct Session_settings
+{
+  Session_settings();
+
+  FSM_config config;
+  Application* app;
+  std::shared_ptr<plugin::Plugin> plugin;
+  Trust_level trust;
+};
+
+/// \brief A connection that runs a session of its own.
+///
+/// The connection is made by the reactor's acceptors and managers, and
+/// owns itself: it is deleted, with its session, when it is closed. The
+/// plugin of the session's application is released after the session, so
+/// that it is unloaded once no session uses it.
+struct Session_connection : Connection
+{
+  Session_connection(Reactor& r, socket::Socket&& s,
+                     const Session_settings& ss);
+  Session_connection(Reactor& r, const net::Address& d,
+                     const net::Address& s, const Session_settings& ss);
+
+  std::shared_ptr<plugin::Plugin> plugin;
+  Session session;
+};
+
+inline
+Session_connection::Session_connection(Reactor& r, socket::Socket&& s,
+                                       const Session_settings& ss)
+  : Connection(r, std::move(s)), plugin(ss.plugin),
+    session(ss.config, *ss.app, ss.trust)
+{
+  self_owned = true;
+}
+
+inline
+Session_connection::Session_connection(Reactor& r, const net::Address& d,
+                                       const net::Address& s,
+                                       const Session_settings& ss)
+  : Connection(r, d, s), plugin(ss.plugin),
+    session(ss.config, *ss.app, ss.trust)
+{
+  self_owned = true;
+}
+
+} // namespace ofp
+} // namespace flog
+
+#endif
@@ -0,0 +1,159 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <libflog/proto/ofp/v1_3/encoder.hpp>
+
+#include "sink.hpp"
+
+namespace flog {
+namespace ofp {
+
+namespace {
+
+// Encode m into b through its to_buffer() operation.
+template<typename T>
+  inline bool
+  encode_message(Buffer& b, const T& m)
+  {
+    b.resize(bytes(m));
+    Buffer_view v(b);
+    return to_buffer(v, m);
+  }
+
+inline bool
+encode_message(Buffer& b, const v1_3::Message& m)
+{
+  return v1_3::encode(b, m);
+}
+
+bool
+encode_any(Buffer& b, Common_message m)
+{
+  switch (m.version) {
+  case 1:
+    return encode_message(b, *m.ptr.m1);
+  case 2:
+    return encode_message(b, *m.ptr.m2);
+  case 3:
+    return encode_message(b, *m.ptr.m3);
+  case 4:
+    if (m.patch == 0)
+      return encode_message(b, *m.ptr.m4);
+    else
+      return encode_message(b, *m.ptr.m5);
+  default:
+    return false;
+  }
+}
+
+void
+release_any(Common_message m)
+{
+  Common_message::Delete()(m);
+}
+
+// Encode or release a message known to be of type M, held by the member P
+// of the pointer union.
+template<typename M, const M* Common_message::Kind::* P>
+  bool
+  encode_version(Buffer& b, Common_message m)
+  {
+    return encode_message(b, *(m.ptr.*P));
+  }
+
+template<typename M, const M* Common_message::Kind::* P>
+  void
+  release_version(Common_message m)
+  {
+    Object_pool<M>::release(m.ptr.*P);
+  }
+
+} // namespace
+
+Message_encoder
+encoder(uint8_t version, uint8_t patch)
+{
+  switch (version) {
+  case 1:
+    return encode_version<v1_0::Message, &Common_message::Kind::m1>;
+  case 2:
+    return encode_version<v1_1::Message, &Common_message::Kind::m2>;
+  case 3:
+    return encode_version<v1_2::Message, &Common_message::Kind::m3>;
+  case 4:
+    if (patch == 0)
+      return encode_version<v1_3::Message, &Common_message::Kind::m4>;
+    else
+      return encode_version<v1_3_1::Message, &Common_message::Kind::m5>;
+  default:
+    return encode_any;
+  }
+}
+
+Message_releaser
+releaser(uint8_t version, uint8_t patch)
+{
+  switch (version) {
+  case 1:
+    return release_version<v1_0::Message, &Common_message::Kind::m1>;
+  case 2:
+    return release_version<v1_1::Message, &Common_message::Kind::m2>;
+  case 3:
+    return release_version<v1_2::Message, &Common_message::Kind::m3>;
+  case 4:
+    if (patch == 0)
+      return release_version<v1_3::Message, &Common_message::Kind::m4>;
+    else
+      return release_version<v1_3_1::Message, &Common_message::Kind::m5>;
+  default:
+    return release_any;
+  }
+}
+
+void
+Output_sink::put(Common_message m)
+{
+  Buffer b;
+  if (encode(b, m))
+    push(queue, std::move(b));
+  else
+    ++failures;
+  release(m);
+}
+
+void
+Batching_sink::put(Common_message m)
+{
+  Buffer& b = batcher.scratch;
+  b.clear();
+  bool ok = out.encode(b, m);
+  out.release(m);
+  if (not ok) {
+    ++out.failures;
+    return;
+  }
+
+  if (is_flow_mod(b.data(), b.size())) {
+    add(batcher, b.data(), b.size(), now);
+    if (must_seal(batcher, now))
+      seal(batcher, out.queue, now);
+  } else {
+    queue_pending(batcher, out.queue);
+    push(out.queue, std::move(b));
+    b = Buffer();
+  }
+}
+
+} // namespace ofp
+} // namespace flog
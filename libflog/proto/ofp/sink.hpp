@@ -0,0 +1,143 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_PROTO_OFP_SINK_HPP
+#define FLOWGRAMMABLE_PROTO_OFP_SINK_HPP
+
+#include <libflog/system/output.hpp>
+#include <libflog/proto/ofp/message.hpp>
+#include <libflog/proto/ofp/flow_batch.hpp>
+
+/// \file sink.hpp
+/// Destinations for the messages emitted by the protocol state machines.
+
+namespace flog {
+namespace ofp {
+
+/// \brief The destination of messages sent by a state machine.
+///
+/// The state machine handlers put each message they send into a sink
+/// given by the caller, rather than returning them in a State_result. A
+/// sink takes ownership of the messages put into it, and releases them
+/// with Common_message::Delete once it is done with them.
+struct Message_sink
+{
+  virtual ~Message_sink() { }
+
+  /// Accept the message m.
+  virtual void put(Common_message m) = 0;
+};
+
+/// \brief A sink that collects messages into a vector.
+///
+/// This adapts the sink form of the handlers to those returning a
+/// State_result, which takes the collected messages.
+struct Message_vector_sink : Message_sink
+{
+  void put(Common_message m) override { messages.push_back(m); }
+
+  Message_vector messages;
+};
+
+/// Encode the message m into the buffer b.
+using Message_encoder = bool (*)(Buffer& b, Common_message m);
+
+/// Return the message m to the pool of its version.
+using Message_releaser = void (*)(Common_message m);
+
+/// Returns the encoder of the messages with the given version number and
+/// patch. The encoder does not examine the version of the messages given
+/// to it. If the version is not known, the encoder returned accepts
+/// messages of any version.
+Message_encoder encoder(uint8_t version, uint8_t patch);
+
+/// Returns the releaser of the messages with the given version number and
+/// patch, as for encoder().
+Message_releaser releaser(uint8_t version, uint8_t patch);
+
+/// \brief A sink that encodes messages into an output queue.
+///
+/// Each message is encoded into a buffer, appended to the queue and
+/// returned to its pool, so that sending a reply does not keep any
+/// message object alive. A message that cannot be encoded is dropped and
+/// counted.
+///
+/// A sink that is given the encoder and releaser of one version accepts
+/// only messages of that version, and does not switch on the version of
+/// each one.
+struct Output_sink : Message_sink
+{
+  Output_sink(Output_queue& q)
+    : Output_sink(q, encoder(0, 0), releaser(0, 0))
+  { }
+
+  Output_sink(Output_queue& q, Message_encoder e, Message_releaser r)
+    : queue(q), encode(e), release(r), failures(0)
+  { }
+
+  void put(Common_message m) override;
+
+  Output_queue& queue;
+  Message_encoder encode;
+  Message_releaser release;
+  uint64_t failures;
+};
+
+/// \brief A sink that coalesces flow mods into batches.
+///
+/// Messages are encoded as by the output sink it wraps. Flow mods are
+/// added to the open batch of the batcher, which is sealed as soon as it
+/// is full; other messages are queued after the flow mods sent before
+/// them. The batcher is responsible for sealing a batch when its window
+/// elapses.
+struct Batching_sink : Message_sink
+{
+  Batching_sink(Output_sink& o, Flow_batcher& b, const Time& t)
+    : out(o), batcher(b), now(t)
+  { }
+
+  void put(Common_message m) override;
+
+  Output_sink& out;
+  Flow_batcher& batcher;
+  const Time& now;
+};
+
+/// Put the messages of v into the sink, leaving v empty. The capacity of
+/// v is kept for the messages queued next. Returns true so that handlers
+/// can return its result.
+inline bool
+flush(Message_vector& v, Message_sink& out)
+{
+  for (Common_message m : v)
+    out.put(m);
+  v.clear();
+  return true;
+}
+
+/// Call f with a vector sink and return its result and the messages it
+/// put into the sink as a State_result.
+template<typename F>
+  inline State_result
+  collect(F f)
+  {
+    Message_vector_sink out;
+    bool b = f(out);
+    return State_result(b, std::move(out.messages));
+  }
+
+} // namespace ofp
+} // namespace flog
+
+#endif
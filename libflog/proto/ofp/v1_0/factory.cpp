@@ -24,7 +24,7 @@ template<typename T, typename... Args>
   Message* 
   make(uint32_t xid, Args&&... args) { 
     using Tag = typename T::Tag;
-    return new Message(xid, Tag(), std::forward<Args>(args)...); 
+    return Message_pool::make(xid, Tag(), std::forward<Args>(args)...);
   }
 
 /// \brief Make a version 1.0 hello message
@@ -1283,13 +1283,12 @@ from_buffer(Buffer_view& v, Packet_in& pi) {
   from_buffer(v, pi.reason);
   pad(v, 1);
 
-  // Allocating the buffer depends on whether the length is non-zero.
   if (pi.total_len == 0)
     return SUCCESS;
-  pi.data = Buffer(pi.total_len);
 
-  // Availability is checked in this call.
-  if (not from_buffer(v, pi.data))
+  // The data is borrowed from the view. Availability is checked in this
+  // call.
+  if (not from_buffer(v, pi.data, pi.total_len))
     return AVAILABLE_PACKET_IN;
   return SUCCESS; 
 }
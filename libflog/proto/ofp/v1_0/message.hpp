@@ -1395,50 +1395,50 @@ struct Error : Payload_base<ERROR>
   
   /// Constructs a hello failed Error message. Initialize the error message with
   /// a Hello_failed code f and the error buffer b.
-  Error(Hello_failed c, const Greedy_buffer& b) 
+  Error(Hello_failed c, const Buffer_ref& b) 
     : type(HELLO_FAILED), code(c), data() { }
   
   /// Constructs a bad request Error message. Initialize the error message with
   /// a Bad_request code f and the error buffer b.
-  Error(Bad_request c, const Greedy_buffer& b) 
+  Error(Bad_request c, const Buffer_ref& b) 
     : type(BAD_REQUEST), code(c), data() { }
   
   /// Constructs a bad action Error message. Initialize the error message with
   /// a Bad_action code f and the error buffer b.
-  Error(Bad_action c, const Greedy_buffer& b) 
+  Error(Bad_action c, const Buffer_ref& b) 
     : type(BAD_ACTION), code(c), data() { }
   
   /// Constructs a flow modification Error message. Initialize the error message
   /// with a Flow_mod_failed code f and the error buffer b.
-  Error(Flow_mod_failed c, const Greedy_buffer& b) 
+  Error(Flow_mod_failed c, const Buffer_ref& b) 
     : type(FLOW_MOD_FAILED), code(c), data() { }
   
   /// Constructs a port modification Error message. Initialize the error message
   /// with a Port_mod_failed code f and the error buffer b.
-  Error(Port_mod_failed c, const Greedy_buffer& b) 
+  Error(Port_mod_failed c, const Buffer_ref& b) 
     : type(PORT_MOD_FAILED), code(c), data() { }
   
   /// Constructs a queue operation Error message. Initialize the error message
   /// with a Queue_op_failed code f and the error buffer b.
-  Error(Queue_op_failed c, const Greedy_buffer& b) 
+  Error(Queue_op_failed c, const Buffer_ref& b) 
     : type(QUEUE_OP_FAILED), code(c), data() { }
 
   /// Constructs an Error Message from an Error_code. Initialize the error
   /// message with a type and code based on the Error_code c.
   ///
   /// \todo Implement me.
-  Error(Error_code c, const Greedy_buffer& b);
+  Error(Error_code c, const Buffer_ref& b);
 
   /// Constructs an error from an Error::Type and code. Initialize the error
   /// message with error type t, the error Code c, and the error buffer b. Note
   /// that the value is ill-formed if c  is not a valid code for the error type
   /// t.
-  Error(Type t, uint16_t c, const Greedy_buffer& b)
+  Error(Type t, uint16_t c, const Buffer_ref& b)
     : type(t), code(c), data(b) { assert(is_valid(*this)); }
 
   Type type;          ///< The error category
   Code code;          ///< The error code
-  Greedy_buffer data; ///< The uninterpreted offending message
+  Buffer_ref data; ///< The uninterpreted offending message
 };
 
 /// Returns true when the arguments compare equal. Two Error messages compare
@@ -1495,7 +1495,7 @@ Error_condition is_valid(Error::Queue_op_failed c);
 /// Validates the length of uninterpreted data
 ///
 /// \\relates Error::Greedy_buffer
-Error_condition is_valid(Error::Type t,const Greedy_buffer& data);
+Error_condition is_valid(Error::Type t,const Buffer_ref& data);
 
 /// Validates the value of an Error message.
 ///
@@ -1940,14 +1940,14 @@ struct Packet_in : Payload_base<PACKET_IN>
   Packet_in() = default;
   
   /// Construct a Packet_in message with value of all the fields
-  Packet_in(uint32_t id, uint16_t l, uint16_t p, Reason r, const Buffer& b)
+  Packet_in(uint32_t id, uint16_t l, uint16_t p, Reason r, const Buffer_ref& b)
     : buffer_id(id), total_len(l), in_port(p), reason(r), data(b) { }
 
   uint32_t buffer_id;
   uint16_t total_len;
   uint16_t in_port; 
   Reason   reason;
-  Buffer   data;
+  Buffer_ref data;
 };
 
 /// Returns true when two Packet_in are totally equal. 
@@ -2162,13 +2162,13 @@ struct Packet_out : Payload_base<PACKET_OUT>
   
   /// Construct a Port_out message with value of all the fields and an
   /// initializer list for actions
-  Packet_out(Greedy_buffer pkt, Port::Id port, std::initializer_list<Action>);
+  Packet_out(Buffer_ref pkt, Port::Id port, std::initializer_list<Action>);
 
   uint32_t buffer_id;
   Port::Id in_port;
   uint16_t actions_len;
   Sequence<Action> actions;
-  Greedy_buffer data;
+  Buffer_ref data;
 };
 
 /// Returns true when two Packet_out are totally equal. 
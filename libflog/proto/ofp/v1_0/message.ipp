@@ -766,7 +766,7 @@ is_valid(Error::Type t, Error::Code c) {
 }
 
 inline Error_condition
-is_valid(Error::Type t, const Greedy_buffer& data)
+is_valid(Error::Type t, const Buffer_ref& data)
 {
   if ( t != Error::HELLO_FAILED)
   {
@@ -1220,7 +1220,7 @@ Packet_out::Packet_out(uint32_t buf,
 /// Initialize the Packet_out message with packet data, the ingress port
 /// for flowtable lookup, and a sequence of actions for the packet.
 inline
-Packet_out::Packet_out(Greedy_buffer pkt, 
+Packet_out::Packet_out(Buffer_ref pkt, 
                        Port::Id port, 
                        std::initializer_list<Action> list)
   : buffer_id(-1), in_port(port), actions(list), data(pkt)
@@ -1616,18 +1616,21 @@ template<typename T, typename Tag>
   Message::Message(T&& p)
     : header(std::forward<T>(p)) {
     construct(payload, Tag(), std::forward<T>(p));
+    payload.init = true;
   }
 
 template<typename T, typename Tag>
   Message::Message(T&& p, uint32_t id)
     : header(std::forward<T>(p), id) { 
-      construct(payload, Tag(), std::forward<T>(p)); 
+      construct(payload, Tag(), std::forward<T>(p));
+      payload.init = true;
     }
 
 template<typename Tag, typename... Args>
   Message::Message(uint32_t id, Tag t, Args&&... args)
     : header(t.value) {
       construct(payload, t, std::forward<Args>(args)...);
+      payload.init = true;
       header.xid = id;
     }
 
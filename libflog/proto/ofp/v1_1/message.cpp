@@ -2664,9 +2664,8 @@ from_buffer(Buffer_view& v, Packet_in& pi)
   
   if (pi.total_len == 0)
     return SUCCESS;
-  pi.data = Buffer(pi.total_len);
   
-  if (not from_buffer(v, pi.data))
+  if (not from_buffer(v, pi.data, pi.total_len))
     return AVAILABLE_PACKET_IN;
   return SUCCESS;
 }
@@ -1618,7 +1618,7 @@ std::size_t bytes(const Instruction& a);
 
 Error_condition is_valid(const Instruction& a);
 
-Error_condition is_valid(const Sequence<Instruction> i);
+Error_condition is_valid(const Sequence<Instruction>& i);
 
 Error_condition to_buffer(Buffer_view& v, const Instruction& a);
 
@@ -2354,69 +2354,69 @@ struct Error : Payload_base<ERROR>
   
   /// Constructs a hello failed Error message. Initialize the error message with
   /// a Hello_failed code f and the error buffer b.
-  Error(Hello_failed f, const Greedy_buffer& b)
+  Error(Hello_failed f, const Buffer_ref& b)
     : type(HELLO_FAILED), code(f), data() { }
   
   /// Constructs a bad request Error message. Initialize the error message with
   /// a Bad_request code f and the error buffer b.
-  Error(Bad_request f, const Greedy_buffer& b)
+  Error(Bad_request f, const Buffer_ref& b)
     : type(BAD_REQUEST), code(f), data() { }
   
   /// Constructs a bad action Error messasge. Initialize the error message with
   /// a Bad_action code f and the error buffer b.
-  Error(Bad_action f, const Greedy_buffer& b)
+  Error(Bad_action f, const Buffer_ref& b)
     : type(BAD_ACTION), code(f), data() { }
   
   /// Constructs a bad instruction Error messasge. Initialize the error message with
   /// a Bad_instruction code f and the error buffer b.
-  Error(Bad_instruction f, const Greedy_buffer& b)
+  Error(Bad_instruction f, const Buffer_ref& b)
     : type(BAD_INSTRUCTION), code(f), data() { }
   
   /// Constructs a bad match Error messasge. Initialize the error message with
   /// a Bad_match code f and the error buffer b.
-  Error(Bad_match f, const Greedy_buffer& b)
+  Error(Bad_match f, const Buffer_ref& b)
     : type(BAD_MATCH), code(f), data() { }
   
   /// Constructs a flow modification Error message. Initialize the error message
   /// with a Flow_mod_failed code f and the error buffer b.
-  Error(Flow_mod_failed f, const Greedy_buffer& b)
+  Error(Flow_mod_failed f, const Buffer_ref& b)
     : type(FLOW_MOD_FAILED), code(f), data() { }
   
   /// Constructs a group modification Error message. Initialize the error message
   /// with a Group_mod_failed code f and the error buffer b.
-  Error(Group_mod_failed f, const Greedy_buffer& b)
+  Error(Group_mod_failed f, const Buffer_ref& b)
     : type(GROUP_MOD_FAILED), code(f), data() { }
   
   /// Constructs a port modification Error message. Initialize the error message
   /// with a Port_mod_failed code f and the error buffer b.
-  Error(Port_mod_failed f, const Greedy_buffer& b)
+  Error(Port_mod_failed f, const Buffer_ref& b)
     : type(PORT_MOD_FAILED), code(f), data() { }
   
   /// Constructs a table modification Error message. Initialize the error message
   /// with a Table_mod_failed code f and the error buffer b.
-  Error(Table_mod_failed f, const Greedy_buffer& b)
+  Error(Table_mod_failed f, const Buffer_ref& b)
     : type(TABLE_MOD_FAILED), code(f), data() { }
   
   /// Constructs a queue operation Error message. Initialize the error message
   /// with a Queue_op_failed code f and the error buffer b.
-  Error(Queue_op_failed f, const Greedy_buffer& b)
+  Error(Queue_op_failed f, const Buffer_ref& b)
     : type(QUEUE_OP_FAILED), code(f), data() { }
 
   /// Constructs a Switch config failed Error message. Initialize the error message
   /// with a Switch_config_failed code f and the error buffer b.
-  Error(Switch_config_failed f, const Greedy_buffer& b)
+  Error(Switch_config_failed f, const Buffer_ref& b)
     : type(SWITCH_CONFIG_FAILED), code(f), data() { }
   
   /// Constructs an error from an Error::Type and code. Initialize the error
   /// message with error type t, the error Code c, and the error buffer b. Note
   /// that the value is ill-formed if c  is not a valid code for the error type
   /// t.
-  Error(Type t, uint16_t c, const Greedy_buffer& b)
+  Error(Type t, uint16_t c, const Buffer_ref& b)
     : type(t), code(c), data(b) { assert(is_valid(*this)); }
 
   Type type;
   Code code;
-  Greedy_buffer data; ///<Variable-length data. Interpreted based on the type and code.
+  Buffer_ref data; ///<Variable-length data. Interpreted based on the type and code.
 };
 
 /// Returns true when the arguments compare equal. Two Error messages compare
@@ -2972,7 +2972,7 @@ struct Packet_in : Payload_base<PACKET_IN>
 
   /// Construct a Packet_in message with value of all the fields
   Packet_in(uint32_t bid, uint32_t ip, uint32_t ipp, uint16_t tl,
-            Reason r, uint8_t tid, Buffer d)
+            Reason r, uint8_t tid, Buffer_ref d)
     : buffer_id(bid), in_port(ip), in_phy_port(ipp), total_len(tl),
       reason(r), tbl_id(tid), data(d) { }
 
@@ -2982,7 +2982,7 @@ struct Packet_in : Payload_base<PACKET_IN>
   uint16_t total_len;
   Reason   reason;
   uint8_t  tbl_id;
-  Buffer   data;
+  Buffer_ref data;
 };
 
 /// Returns true when two Packet_in are totally equal. 
@@ -3195,14 +3195,14 @@ struct Packet_out : Payload_base<PACKET_OUT>
 
   /// Construct a Port_out message with value of all the fields
   Packet_out(uint32_t bid, uint32_t ip, uint16_t al, Sequence<Action> a,
-             Greedy_buffer d)
+             Buffer_ref d)
     : buffer_id(bid), in_port(ip), actions_len(al), actions(a), data(d) { }
 
   uint32_t buffer_id;
   uint32_t in_port;
   uint16_t actions_len;
   Sequence<Action> actions;
-  Greedy_buffer data;
+  Buffer_ref data;
 };
 
 
@@ -3596,7 +3596,7 @@ Error_condition is_valid(const Table_mod::Config c);
 /// Validates the value of a Table_mod message. 
 ///
 /// \relates Table_mod
-Error_condition is_valid(const Table_mod tm);
+Error_condition is_valid(const Table_mod& tm);
 
 /// Writes a Table_mod message into a Buffer_view. If the write does not
 /// succeed, the result will containt a code representing the specific cause of
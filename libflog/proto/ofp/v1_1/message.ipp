@@ -1128,7 +1128,7 @@ inline Error_condition
 is_valid(const Instruction& a) { return is_valid(a.payload, a.header.type); }
 
 inline Error_condition
-is_valid(const Sequence<Instruction> i) {
+is_valid(const Sequence<Instruction>& i) {
   for (auto iter = i.begin(); iter != i.end(); iter++)
   {
     if(Error_decl err = is_valid(*iter))
@@ -2120,7 +2120,7 @@ is_valid(const Table_mod::Config c) {
 }
 
 inline Error_condition
-is_valid(const Table_mod tm) { return is_valid(tm.config); }
+is_valid(const Table_mod& tm) { return is_valid(tm.config); }
 
 // -------------------------------------------------------------------------- //
 // Stats type
@@ -3151,6 +3151,7 @@ template<typename Tag, typename... Args>
   Message::Message(uint32_t id, Tag t, Args&&... args)
     : header(t.value) {
       construct(payload, t, std::forward<Args>(args)...);
+      payload.init = true;
       header.xid = id;
     }
 
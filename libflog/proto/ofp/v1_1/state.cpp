@@ -25,72 +25,64 @@ namespace ofp {
 namespace v1_1 {
 
 template<typename T>
-inline State_result
-estb_echo_interval(T& sm, const Time& t) {
+inline bool
+estb_echo_interval(T& sm, const Time& t, Message_sink& out) {
   const Message *m = Message::factory(sm.gen).make_echo_req();
-  State_result rlt(true);
-  
-  rlt.second.push_back(m);
 
-  add_timer(sm, ECHO_REQ, 0, t + sm.config.timers.echo_res_wait);
-  sm.echo_timer = t + sm.config.timers.echo_req_interval;
+  bool waiting = add_timer(sm, ECHO_REQ, m->header.xid,
+                           t + sm.config.timers.echo_res_wait);
+  arm(sm.timers.wheel, sm.timers.echo, t + sm.config.timers.echo_req_interval);
+  out.put(m);
 
-  return reset(rlt);
+  // A switch that has left this many echo requests unanswered has failed.
+  if (not waiting)
+    return estb_echo_timeout(sm, t, out);
+  return true;
 }
 
 template<typename T>
-inline State_result
-estb_time(T& sm, const Time& t) {
-  State_result rlt;
-
+inline bool
+estb_time(T& sm, const Time& t, Message_sink& out) {
   // Check echo timer
-  if (t >= sm.echo_timer) {
-    append(rlt.second, std::move(estb_echo_interval(sm, t).second));
+  if (is_due(sm.timers.echo, t)) {
+    if (not estb_echo_interval(sm, t, out))
+      return false;
   }
 
-  // Check other timers
-  auto it = sm.timer.begin();
-  while (it != sm.timer.end()) {
-    if (t >= (*it).second) {
-      State_result r;
-      switch ((*it).first.second) {
-        case ECHO_REQ:
-          r = estb_echo_timeout(sm, t);
-          break;
-        default:
-          r = estb_default_timeout(sm, t);
-      }
-      // Notice that `it' may have been invalid here due to 
-      // clear() of timer in the timeout handler. Only use
-      // `it' if timeout handler returns true.
-      append(rlt.second, std::move(r.second));
-      if (r.first == false) {
-        rlt.first = false;
-        return std::move(rlt);
-      }
-      else {
-        it = sm.timer.erase(it);
-      }
-    }
-    else {
-      ++it;
+  // Check the request timers that have fired. A timer whose deadline is
+  // still ahead of t is kept for a later call.
+  for (auto& r : sm.timers.requests) {
+    if (not r.used or not is_due(r, t))
+      continue;
+    r.used = false;
+    bool ok;
+    switch (r.kind) {
+      case ECHO_REQ:
+        ok = estb_echo_timeout(sm, t, out);
+        break;
+      default:
+        ok = estb_default_timeout(sm, t, out);
     }
+    // A failing timeout handler clears all timers.
+    if (not ok)
+      return false;
   }
-  rlt.first = true;
 
-  return reset(rlt);
+  return true;
 }
 
 template<typename T>
-State_result time_impl(T& sm, const Time& t) {
+bool time_impl(T& sm, const Time& t, Message_sink& out) {
+  // The timers that expired by t have been fired by the reactor advancing
+  // its wheel; the state machine only reads them.
   switch (sm.state) {
     case FSM_controller::FEATURE_WAIT:
-      if (t >= sm.feature_timer)
-        return wait_timeout(sm, t);
+      if (is_due(sm.timers.feature, t))
+        return wait_timeout(sm, t, out);
       else
         return true;
     case FSM_controller::ESTABLISHED: 
-      return estb_time(sm, t);
+      return estb_time(sm, t, out);
     default:
       return false;
   }
@@ -121,44 +113,46 @@ inline void
 state_machine_fail(FSM_switch& s, const Time& t) 
 {
   s.state = FSM_switch::FAIL;
-  s.timer.clear();
+  clear(s.timers);
 }
 
-inline void
+inline bool
 add_timer(FSM_switch& s, Message_type t, uint32_t xid, const Time& to) 
 {
-  s.timer.insert({{xid, t}, to});
+  return add_timer(s.timers, xid, t, to);
 }
 
 inline void
 remove_timer(FSM_switch& s, uint32_t xid, Message_type t) 
 {
-  s.timer.erase({xid, t});
+  remove_timer(s.timers, xid, t);
 }
 
-inline State_result
-idle_init(FSM_switch& s, const Time& t) 
+inline bool
+idle_init(FSM_switch& s, const Time& t, Message_sink& out) 
 {
   s.state = FSM_switch::FEATURE_WAIT;
-  s.feature_timer = t + s.config.timers.feature_req_wait;
+  arm(s.timers.wheel, s.timers.feature, t + s.config.timers.feature_req_wait);
   s.agent.init(t);
 
-  return {};
+  return true;
 }
 
-inline State_result
-default_init(FSM_switch& s, const Time& t) 
+inline bool
+default_init(FSM_switch& s, const Time& t, Message_sink& out) 
 {
   state_machine_fail(s, t);
 
   return false;
 }
 
-inline State_result
-wait_feature_req(FSM_switch& s, const Time& t, const Message& m)
+inline bool
+wait_feature_req(FSM_switch& s, const Time& t, const Message& m,
+                 Message_sink& out)
 {
   s.state = FSM_switch::ESTABLISHED;
-  s.echo_timer = t + s.config.timers.echo_req_interval;
+  cancel(s.timers.feature);
+  arm(s.timers.wheel, s.timers.echo, t + s.config.timers.echo_req_interval);
 
   Factory factory(s.gen);
 
@@ -181,160 +175,172 @@ wait_feature_req(FSM_switch& s, const Time& t, const Message& m)
     ports.back().name = port.name;
   }
 
-  Message_vector v {
+  out.put(
     factory.make_feature_res(s.config.feature.datapath_id,
                              s.config.feature.n_buffers, 
                              s.config.feature.n_tables, 
                              s.config.feature.capabilities, 
                              ports)
-  };
-  return std::move(v);
+  );
+  return true;
 }
 
-inline State_result
-wait_default_message(FSM_switch& s, const Time& t, const Message& m)
+inline bool
+wait_default_message(FSM_switch& s, const Time& t, const Message& m,
+                     Message_sink& out)
 {
   state_machine_fail(s, t);
 
   return false;
 }
 
-inline State_result
-wait_timeout(FSM_switch& s, const Time& t) 
+inline bool
+wait_timeout(FSM_switch& s, const Time& t, Message_sink& out) 
 {
   state_machine_fail(s, t);
 
   return false;
 }
 
-inline State_result
-estb_echo_req(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_echo_req(FSM_switch& s, const Time& t, const Message& m,
+              Message_sink& out) {
   Factory fact (s.gen);
-  Message_vector v {
-    fact.make_echo_res()
-  };
-  return std::move(v);
+  out.put(fact.make_echo_res());
+  return true;
 
 }
 
-inline State_result
-estb_echo_res(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_echo_res(FSM_switch& s, const Time& t, const Message& m,
+              Message_sink& out) {
   remove_timer(s, m.header.xid, ECHO_REQ);
 
   return true;
 }
 
-inline State_result
-estb_experimenter(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_experimenter(FSM_switch& s, const Time& t, const Message& m,
+                  Message_sink& out) {
   s.agent.experimenter(m.payload.data.experimenter, t);
 
-  return reset(s.agent.tx_queue);
+  return flush(s.agent.tx_queue, out);
 }
 
-inline State_result
-estb_feature_req(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_feature_req(FSM_switch& s, const Time& t, const Message& m,
+                 Message_sink& out) {
   s.agent.feature_request(m.payload.data.feature_req, t);
 
-  return reset(s.agent.tx_queue);
+  return flush(s.agent.tx_queue, out);
 }
 
-inline State_result
-estb_get_config_req(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_get_config_req(FSM_switch& s, const Time& t, const Message& m,
+                    Message_sink& out) {
   s.agent.get_config_request(m.payload.data.get_config_req, t);
 
-  return reset(s.agent.tx_queue);
+  return flush(s.agent.tx_queue, out);
 }
 
-inline State_result
-estb_set_config(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_set_config(FSM_switch& s, const Time& t, const Message& m,
+                Message_sink& out) {
   s.agent.set_config(m.payload.data.set_config, t);
 
-  return reset(s.agent.tx_queue);
+  return flush(s.agent.tx_queue, out);
 }
 
-inline State_result
-estb_packet_out(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_packet_out(FSM_switch& s, const Time& t, const Message& m,
+                Message_sink& out) {
   s.agent.packet_out(m.payload.data.packet_out, t);
 
-  return reset(s.agent.tx_queue);
+  return flush(s.agent.tx_queue, out);
 }
 
-inline State_result
-estb_flow_mod(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_flow_mod(FSM_switch& s, const Time& t, const Message& m,
+              Message_sink& out) {
   s.agent.flow_mod(m.payload.data.flow_mod, t);
 
-  return reset(s.agent.tx_queue);
+  return flush(s.agent.tx_queue, out);
 }
 
-inline State_result
-estb_group_mod(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_group_mod(FSM_switch& s, const Time& t, const Message& m,
+               Message_sink& out) {
   s.agent.group_mod(m.payload.data.group_mod, t);
 
-  return reset(s.agent.tx_queue);
+  return flush(s.agent.tx_queue, out);
 }
 
-inline State_result
-estb_port_mod(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_port_mod(FSM_switch& s, const Time& t, const Message& m,
+              Message_sink& out) {
   s.agent.port_mod(m.payload.data.port_mod, t);
 
-  return reset(s.agent.tx_queue);
+  return flush(s.agent.tx_queue, out);
 }
 
-inline State_result
-estb_table_mod(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_table_mod(FSM_switch& s, const Time& t, const Message& m,
+               Message_sink& out) {
   s.agent.table_mod(m.payload.data.table_mod, t);
 
-  return reset(s.agent.tx_queue);
+  return flush(s.agent.tx_queue, out);
 }
 
-inline State_result
-estb_stats_req(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_stats_req(FSM_switch& s, const Time& t, const Message& m,
+               Message_sink& out) {
   s.agent.stats_request(m.payload.data.stats_req, t);
 
-  return reset(s.agent.tx_queue);
+  return flush(s.agent.tx_queue, out);
 }
 
-inline State_result
-estb_barrier_req(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_barrier_req(FSM_switch& s, const Time& t, const Message& m,
+                 Message_sink& out) {
   s.agent.barrier_request(m.payload.data.barrier_req, t);
 
-  return reset(s.agent.tx_queue);
+  return flush(s.agent.tx_queue, out);
 }
 
-inline State_result
-estb_queue_get_config_req(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_queue_get_config_req(FSM_switch& s, const Time& t, const Message& m,
+                          Message_sink& out) {
   s.agent.queue_get_config_request(m.payload.data.queue_get_config_req, t);
 
-  return reset(s.agent.tx_queue);
+  return flush(s.agent.tx_queue, out);
 }
 
-inline State_result
-estb_default_message(FSM_switch& s, const Time& t, const Message& m) {
+inline bool
+estb_default_message(FSM_switch& s, const Time& t, const Message& m,
+                     Message_sink& out) {
   return true;
 }
 
-inline State_result
-estb_echo_timeout(FSM_switch& s, const Time& t) {
+inline bool
+estb_echo_timeout(FSM_switch& s, const Time& t, Message_sink& out) {
   state_machine_fail(s, t);
 
-  Message_vector v;
   return false;
 }
 
-inline State_result
-estb_default_timeout(FSM_switch& s, const Time& t) {
-  Message_vector v;
-  return std::move(v);
+inline bool
+estb_default_timeout(FSM_switch& s, const Time& t, Message_sink& out) {
+  return true;
 }
 
-State_result 
-init(FSM_switch& s, const Time& t)
+bool
+init(FSM_switch& s, const Time& t, Message_sink& out)
 {
   switch (s.state) {
   case FSM_switch::IDLE:
-    return idle_init(s, t);
+    return idle_init(s, t, out);
   default:
-    return default_init(s, t);
+    return default_init(s, t, out);
   }
 }
 
@@ -342,54 +348,54 @@ State_result
 fini(FSM_switch& s, const Time& t)
 {
   s.state = FSM_switch::IDLE;
-  s.timer.clear();
+  clear(s.timers);
   s.agent.fini(t);
   return false;
 }
 
-State_result 
-recv(FSM_switch& s, const Time& t, const Message& m)
+bool
+recv(FSM_switch& s, const Time& t, const Message& m, Message_sink& out)
 {
   switch (s.state) {
   case FSM_switch::FEATURE_WAIT:
     switch (m.header.type) {
     case FEATURE_REQ:
-      return wait_feature_req(s, t, m) ;
+      return wait_feature_req(s, t, m, out);
     default: 
-      return wait_default_message(s, t, m);
+      return wait_default_message(s, t, m, out);
     }
   case FSM_switch::ESTABLISHED:
     switch (m.header.type) {
     case ECHO_REQ:
-      return estb_echo_req(s, t, m);
+      return estb_echo_req(s, t, m, out);
     case ECHO_RES:
-      return estb_echo_res(s, t, m);
+      return estb_echo_res(s, t, m, out);
     case EXPERIMENTER:
-      return estb_experimenter(s, t, m);
+      return estb_experimenter(s, t, m, out);
     case FEATURE_REQ:
-      return estb_feature_req(s, t, m);
+      return estb_feature_req(s, t, m, out);
     case GET_CONFIG_REQ:
-      return estb_get_config_req(s, t, m);
+      return estb_get_config_req(s, t, m, out);
     case SET_CONFIG:
-      return estb_set_config(s, t, m);
+      return estb_set_config(s, t, m, out);
     case PACKET_OUT:
-      return estb_packet_out(s, t, m);
+      return estb_packet_out(s, t, m, out);
     case FLOW_MOD:
-      return estb_flow_mod(s, t, m);
+      return estb_flow_mod(s, t, m, out);
     case GROUP_MOD:
-      return estb_group_mod(s, t, m);
+      return estb_group_mod(s, t, m, out);
     case PORT_MOD:
-      return estb_port_mod(s, t, m);
+      return estb_port_mod(s, t, m, out);
     case TABLE_MOD:
-      return estb_table_mod(s, t, m);
+      return estb_table_mod(s, t, m, out);
     case STATS_REQ:
-      return estb_stats_req(s, t, m);
+      return estb_stats_req(s, t, m, out);
     case BARRIER_REQ:
-      return estb_barrier_req(s, t, m);
+      return estb_barrier_req(s, t, m, out);
     case QUEUE_GET_CONFIG_REQ:
-      return estb_queue_get_config_req(s, t, m);
+      return estb_queue_get_config_req(s, t, m, out);
     default:
-      return estb_default_message(s, t, m);
+      return estb_default_message(s, t, m, out);
     }
   default:
     state_machine_fail(s, t);
@@ -397,10 +403,10 @@ recv(FSM_switch& s, const Time& t, const Message& m)
   }
 }
 
-State_result 
-time(FSM_switch& s, const Time& t)
+bool
+time(FSM_switch& s, const Time& t, Message_sink& out)
 {
-  return time_impl(s, t);
+  return time_impl(s, t, out);
 }
 
 std::string 
@@ -425,169 +431,185 @@ std::string to_string(const FSM_controller& fc)
 inline void
 state_machine_fail(FSM_controller& c, const Time& t) {
   c.state = FSM_controller::FAIL;
-  c.timer.clear();
+  clear(c.timers);
 }
 
-inline void 
+inline bool
 add_timer(FSM_controller& c, Message_type t, uint32_t xid, const Time& to) {
-  c.timer.insert({{xid, t}, to});
+  return add_timer(c.timers, xid, t, to);
 }
 
 inline void
 remove_timer(FSM_controller& c, uint32_t xid, Message_type t) {
-  c.timer.erase({xid, t});
+  remove_timer(c.timers, xid, t);
 }
 
-inline State_result
-idle_init(FSM_controller& c, const Time& t) {
+inline bool
+idle_init(FSM_controller& c, const Time& t, Message_sink& out) {
   c.state = FSM_controller::FEATURE_WAIT;
-  c.feature_timer = t + c.config.timers.feature_res_wait;
+  arm(c.timers.wheel, c.timers.feature, t + c.config.timers.feature_res_wait);
   c.app.init(t);
 
-  return std::move(Message::factory(c.gen).make_feature_req());
+  out.put(Message::factory(c.gen).make_feature_req());
+  return true;
 }
 
-inline State_result
-default_init(FSM_controller& c, const Time& t) {
+inline bool
+default_init(FSM_controller& c, const Time& t, Message_sink& out) {
   state_machine_fail(c, t);
 
   return false;
 }
 
-inline State_result
-wait_recv_feature_res(FSM_controller& c, const Time& t, const Message& m)
+inline bool
+wait_recv_feature_res(FSM_controller& c, const Time& t, const Message& m,
+                      Message_sink& out)
 {
   c.state = FSM_controller::ESTABLISHED;
-  c.echo_timer = t + c.config.timers.echo_req_interval;
+  cancel(c.timers.feature);
+  arm(c.timers.wheel, c.timers.echo, t + c.config.timers.echo_req_interval);
 
   c.app.feature_response(m.payload.data.feature_res, t);
 
-  return reset(c.app.tx_queue);
+  return flush(c.app.tx_queue, out);
 }
 
-inline State_result
-wait_default_message(FSM_controller& c, const Time& t, const Message& m)
+inline bool
+wait_default_message(FSM_controller& c, const Time& t, const Message& m,
+                     Message_sink& out)
 {
   state_machine_fail(c, t);
 
   return false;
 }
 
-inline State_result
-wait_timeout(FSM_controller& c, const Time& t) {
+inline bool
+wait_timeout(FSM_controller& c, const Time& t, Message_sink& out) {
   state_machine_fail(c, t);
 
   return false;
 }
 
-inline State_result
-estb_echo_req(FSM_controller& c, const Time& t, const Message& m) {
+inline bool
+estb_echo_req(FSM_controller& c, const Time& t, const Message& m,
+              Message_sink& out) {
   // FIXME: Don't use the factory this way.
   const Message *r = Message::factory(c.gen).make_echo_res();
-  Message_vector v {r};
-  
-  return std::move(v);
+  out.put(r);
+  return true;
 }
 
-inline State_result
-estb_echo_res(FSM_controller& c, const Time& t, const Message& m) {
+inline bool
+estb_echo_res(FSM_controller& c, const Time& t, const Message& m,
+              Message_sink& out) {
   remove_timer(c, m.header.xid, ECHO_REQ);
   return true;
 }
 
-inline State_result
-estb_error(FSM_controller& c, const Time& t, const Message& m) {
+inline bool
+estb_error(FSM_controller& c, const Time& t, const Message& m,
+           Message_sink& out) {
   c.app.error(m.payload.data.error, t);
-  return reset(c.app.tx_queue);
+  return flush(c.app.tx_queue, out);
 }
 
-inline State_result
-estb_experimenter(FSM_controller& c, const Time& t, const Message& m) {
+inline bool
+estb_experimenter(FSM_controller& c, const Time& t, const Message& m,
+                  Message_sink& out) {
   c.app.experimenter(m.payload.data.experimenter, t);
 
-  return reset(c.app.tx_queue);
+  return flush(c.app.tx_queue, out);
 }
 
-inline State_result
-estb_feature_res(FSM_controller& c, const Time& t, const Message& m) {
+inline bool
+estb_feature_res(FSM_controller& c, const Time& t, const Message& m,
+                 Message_sink& out) {
   c.app.feature_response(m.payload.data.feature_res, t);
 
-  return reset(c.app.tx_queue);
+  return flush(c.app.tx_queue, out);
 }
 
-inline State_result
-estb_get_config_res(FSM_controller& c, const Time& t, const Message& m) {
+inline bool
+estb_get_config_res(FSM_controller& c, const Time& t, const Message& m,
+                    Message_sink& out) {
   c.app.get_config_response(m.payload.data.get_config_res, t);
 
-  return reset(c.app.tx_queue);
+  return flush(c.app.tx_queue, out);
 }
 
-inline State_result
-estb_packet_in(FSM_controller& c, const Time& t, const Message& m) {
+inline bool
+estb_packet_in(FSM_controller& c, const Time& t, const Message& m,
+               Message_sink& out) {
   c.app.packet_in(m.payload.data.packet_in, t);
 
-  return reset(c.app.tx_queue);
+  return flush(c.app.tx_queue, out);
 }
 
-inline State_result
-estb_flow_removed(FSM_controller& c, const Time& t, const Message& m) {
+inline bool
+estb_flow_removed(FSM_controller& c, const Time& t, const Message& m,
+                  Message_sink& out) {
   c.app.flow_removed(m.payload.data.flow_removed, t);
 
-  return reset(c.app.tx_queue);
+  return flush(c.app.tx_queue, out);
 }
 
-inline State_result
-estb_port_status(FSM_controller& c, const Time& t, const Message& m) {
+inline bool
+estb_port_status(FSM_controller& c, const Time& t, const Message& m,
+                 Message_sink& out) {
   c.app.port_status(m.payload.data.port_status, t);
-  return reset(c.app.tx_queue);
+  return flush(c.app.tx_queue, out);
 }
 
-inline State_result
-estb_stats_res(FSM_controller& c, const Time& t, const Message& m) {
+inline bool
+estb_stats_res(FSM_controller& c, const Time& t, const Message& m,
+               Message_sink& out) {
   c.app.stats_response(m.payload.data.stats_res, t);
 
-  return reset(c.app.tx_queue);
+  return flush(c.app.tx_queue, out);
 }
 
-inline State_result
-estb_barrier_res(FSM_controller& c, const Time& t, const Message& m) {
+inline bool
+estb_barrier_res(FSM_controller& c, const Time& t, const Message& m,
+                 Message_sink& out) {
   c.app.barrier_response(m.payload.data.barrier_res, t);
 
-  return reset(c.app.tx_queue);
+  return flush(c.app.tx_queue, out);
 }
 
-inline State_result
-estb_queue_get_config_res(FSM_controller& c, const Time& t, const Message& m) {
+inline bool
+estb_queue_get_config_res(FSM_controller& c, const Time& t, const Message& m,
+                          Message_sink& out) {
   c.app.queue_get_config_response(m.payload.data.queue_get_config_res, t);
 
-  return reset(c.app.tx_queue);
+  return flush(c.app.tx_queue, out);
 }
 
-inline State_result
-estb_default_message(FSM_controller& c, const Time& t, const Message& m) {
+inline bool
+estb_default_message(FSM_controller& c, const Time& t, const Message& m,
+                     Message_sink& out) {
   return true;
 }
 
-inline State_result
-estb_echo_timeout(FSM_controller& c, const Time& t) {
+inline bool
+estb_echo_timeout(FSM_controller& c, const Time& t, Message_sink& out) {
   state_machine_fail(c, t);
 
   return false;
 }
 
-inline State_result
-estb_default_timeout(FSM_controller& c, const Time& t) {
+inline bool
+estb_default_timeout(FSM_controller& c, const Time& t, Message_sink& out) {
   return true;
 }
 
-State_result 
-init(FSM_controller& c, const Time& t)
+bool
+init(FSM_controller& c, const Time& t, Message_sink& out)
 {
   switch (c.state) {
   case FSM_controller::IDLE:
-    return idle_init(c, t);
+    return idle_init(c, t, out);
   default:
-    return default_init(c, t);
+    return default_init(c, t, out);
   }
 }
 
@@ -595,47 +617,47 @@ State_result
 fini(FSM_controller& c, const Time& t)
 {
   c.state = FSM_controller::IDLE;
-  c.timer.clear();
+  clear(c.timers);
   c.app.fini(t);
   
   return false;
 }
 
-State_result 
-recv(FSM_controller& c, const Time& t, const Message& m)
+bool
+recv(FSM_controller& c, const Time& t, const Message& m, Message_sink& out)
 {
   switch (c.state) {
   case FSM_controller::FEATURE_WAIT:
     switch (m.header.type) {
     case FEATURE_RES:
-      return wait_recv_feature_res(c, t, m) ;
+      return wait_recv_feature_res(c, t, m, out);
     default: 
-      return wait_default_message(c, t, m);
+      return wait_default_message(c, t, m, out);
     }
   case FSM_controller::ESTABLISHED:
     switch (m.header.type) {
     case ERROR:
-      return estb_error(c, t, m);
+      return estb_error(c, t, m, out);
     case EXPERIMENTER:
-      return estb_experimenter(c, t, m);
+      return estb_experimenter(c, t, m, out);
     case FEATURE_RES:
-      return estb_feature_res(c, t, m);
+      return estb_feature_res(c, t, m, out);
     case GET_CONFIG_RES:
-      return estb_get_config_res(c, t, m);
+      return estb_get_config_res(c, t, m, out);
     case PACKET_IN:
-      return estb_packet_in(c, t, m);
+      return estb_packet_in(c, t, m, out);
     case FLOW_REMOVED:
-      return estb_flow_removed(c, t, m);
+      return estb_flow_removed(c, t, m, out);
     case PORT_STATUS:
-      return estb_port_status(c, t, m);
+      return estb_port_status(c, t, m, out);
     case STATS_RES:
-      return estb_stats_res(c, t, m);
+      return estb_stats_res(c, t, m, out);
     case BARRIER_RES:
-      return estb_barrier_res(c, t, m);
+      return estb_barrier_res(c, t, m, out);
     case QUEUE_GET_CONFIG_RES:
-      return estb_queue_get_config_res(c, t, m);
+      return estb_queue_get_config_res(c, t, m, out);
     default:
-      return estb_default_message(c, t, m);
+      return estb_default_message(c, t, m, out);
     }
   default:
     state_machine_fail(c, t);
@@ -643,11 +665,49 @@ recv(FSM_controller& c, const Time& t, const Message& m)
   }
 }
 
-State_result 
+bool
+time(FSM_controller& c, const Time& t, Message_sink& out)
+{
+  return time_impl(c, t, out);
+}
+// State_result forms of the handlers.
+
+State_result
+init(FSM_switch& s, const Time& t)
+{
+  return collect([&](Message_sink& out) { return init(s, t, out); });
+}
+
+State_result
+recv(FSM_switch& s, const Time& t, const Message& m)
+{
+  return collect([&](Message_sink& out) { return recv(s, t, m, out); });
+}
+
+State_result
+time(FSM_switch& s, const Time& t)
+{
+  return collect([&](Message_sink& out) { return time(s, t, out); });
+}
+
+State_result
+init(FSM_controller& c, const Time& t)
+{
+  return collect([&](Message_sink& out) { return init(c, t, out); });
+}
+
+State_result
+recv(FSM_controller& c, const Time& t, const Message& m)
+{
+  return collect([&](Message_sink& out) { return recv(c, t, m, out); });
+}
+
+State_result
 time(FSM_controller& c, const Time& t)
 {
-  return time_impl(c, t);
+  return collect([&](Message_sink& out) { return time(c, t, out); });
 }
+
 } // namespace v1_1
 } // anmespace ofp 
 } // namespace flog
@@ -4047,8 +4047,7 @@ from_buffer(Buffer_view& v, Packet_in& pi)
   if (pi.total_len == 0)
     return SUCCESS;
 
-  pi.data = Buffer(pi.total_len);
-  if(Error_decl err = from_buffer(v, pi.data))
+  if(Error_decl err = from_buffer(v, pi.data, pi.total_len))
     return err;
   return SUCCESS;
 }
@@ -1566,7 +1566,7 @@ Error_condition is_valid(const OXM_entry& e);
 uint64_t OXM_entry_field_flag(const OXM_entry_field& f);
 
 /// \relates OXM_entry
-Error_condition is_valid(const Sequence<OXM_entry> r); 
+Error_condition is_valid(const Sequence<OXM_entry>& r); 
 
 /// \relates OXM_entry
 Error_condition to_buffer(Buffer_view&, const OXM_entry&);
@@ -2663,7 +2663,7 @@ std::size_t bytes(const Instruction& a);
 /// \relates Instruction
 Error_condition is_valid(const Instruction& a);
 /// \relates Instruction
-Error_condition is_valid(const Sequence<Instruction> i);
+Error_condition is_valid(const Sequence<Instruction>& i);
 
 /// \relates Instruction
 Error_condition to_buffer(Buffer_view& v, const Instruction& a);
@@ -3530,52 +3530,52 @@ struct Error : Payload_base<ERROR>
 
   Error() = default;
 
-  Error(Hello_failed f, const Greedy_buffer& b) 
+  Error(Hello_failed f, const Buffer_ref& b) 
     : type(HELLO_FAILED), code(f), data() { }
   
-  Error(Bad_request f, const Greedy_buffer& b) 
+  Error(Bad_request f, const Buffer_ref& b) 
     : type(BAD_REQUEST), code(f), data() { }
   
-  Error(Bad_action f, const Greedy_buffer& b) 
+  Error(Bad_action f, const Buffer_ref& b) 
     : type(BAD_ACTION), code(f), data() { }
   
-  Error(Bad_instruction f, const Greedy_buffer& b) 
+  Error(Bad_instruction f, const Buffer_ref& b) 
     : type(BAD_INSTRUCTION), code(f), data() { }
   
-  Error(Bad_match f, const Greedy_buffer& b) 
+  Error(Bad_match f, const Buffer_ref& b) 
     : type(BAD_MATCH), code(f), data() { }
   
-  Error(Flow_mod_failed f, const Greedy_buffer& b) 
+  Error(Flow_mod_failed f, const Buffer_ref& b) 
     : type(FLOW_MOD_FAILED), code(f), data() { }
   
-  Error(Group_mod_failed f, const Greedy_buffer& b) 
+  Error(Group_mod_failed f, const Buffer_ref& b) 
     : type(GROUP_MOD_FAILED), code(f), data() { }
   
-  Error(Port_mod_failed f, const Greedy_buffer& b) 
+  Error(Port_mod_failed f, const Buffer_ref& b) 
     : type(PORT_MOD_FAILED), code(f), data() { }
   
-  Error(Table_mod_failed f, const Greedy_buffer& b) 
+  Error(Table_mod_failed f, const Buffer_ref& b) 
     : type(TABLE_MOD_FAILED), code(f), data() { }
   
-  Error(Queue_op_failed f, const Greedy_buffer& b) 
+  Error(Queue_op_failed f, const Buffer_ref& b) 
     : type(QUEUE_OP_FAILED), code(f), data() { }
   
-  Error(Switch_config_failed f, const Greedy_buffer& b) 
+  Error(Switch_config_failed f, const Buffer_ref& b) 
     : type(SWITCH_CONFIG_FAILED), code(f), data() { }
   
-  Error(Role_request_failed f, const Greedy_buffer& b) 
+  Error(Role_request_failed f, const Buffer_ref& b) 
     : type(ROLE_REQUEST_FAILED), code(f), data() { }
 
   /// Initialize the error message with error type t and the error
   /// code c. Note that the value is ill-formed if c is not a valid
   /// code for the error type t.
-  Error(Type t, uint16_t c, const Greedy_buffer& b)
+  Error(Type t, uint16_t c, const Buffer_ref& b)
     : type(t), code(c), data(b) { assert(is_valid(*this)); }
 
   Type type;
   Code code;
   uint32_t experimenter_id; //only used for experimenter error
-  Greedy_buffer data;
+  Buffer_ref data;
 };
 
 // Equality comparison
@@ -4010,7 +4010,7 @@ struct Packet_in : Payload_base<PACKET_IN>
 
   Packet_in() = default;
   Packet_in(uint32_t bid, uint16_t tl,
-            Reason_type r, uint8_t tid, Match m, Buffer d)
+            Reason_type r, uint8_t tid, Match m, Buffer_ref d)
   : buffer_id(bid), total_len(tl), reason(r), tbl_id(tid), match(m), data(d) { }
 
   uint32_t buffer_id;
@@ -4018,7 +4018,7 @@ struct Packet_in : Payload_base<PACKET_IN>
   Reason_type reason;
   uint8_t tbl_id;
   Match match;
-  Buffer data;
+  Buffer_ref data;
 };
 
 // Equality comparison
@@ -4181,14 +4181,14 @@ struct Packet_out : Payload_base<PACKET_OUT>
 {
   Packet_out() = default;
   Packet_out(uint32_t bid, uint32_t ip, uint16_t al, Sequence<Action> a,
-             Greedy_buffer d) 
+             Buffer_ref d) 
   : buffer_id(bid), in_port(ip), actions_len(al), actions(a), data(d) { }
 
   uint32_t buffer_id;
   uint32_t in_port;
   uint16_t actions_len;
   Sequence<Action> actions;
-  Greedy_buffer data;
+  Buffer_ref data;
 };
 
 // Equality comparison
@@ -4539,7 +4539,7 @@ Error_condition is_valid(const Table_mod::Config_type c);
 /// Validates the value of a Table_mod message. 
 ///
 /// \relates Table_mod
-Error_condition is_valid(const Table_mod tm);
+Error_condition is_valid(const Table_mod& tm);
 
 /// Writes a Table_mod message into a Buffer_view. If the write does not
 /// succeed, the result will containt a code representing the specific cause of
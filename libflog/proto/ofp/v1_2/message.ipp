@@ -1028,7 +1028,7 @@ OXM_entry_field_flag(const OXM_entry_field& f) {
 }
 
 inline Error_condition
-is_valid(const Sequence<OXM_entry> r) {
+is_valid(const Sequence<OXM_entry>& r) {
   for (auto iter = r.begin(); iter != r.end(); iter++) {
     if(Error_decl err = is_valid(*iter))
       return err;
@@ -1044,7 +1044,7 @@ is_valid(const Sequence<OXM_entry> r) {
 
     switch (type) {
     case OXM_EF_IN_PORT:
-      flag &= OXM_entry_field_flag(OXM_EF_IN_PHY_PORT);
+      flag |= OXM_entry_field_flag(OXM_EF_IN_PHY_PORT);
       break;
 
     case OXM_EF_ETH_TYPE:
@@ -1988,7 +1988,7 @@ inline Error_condition
 is_valid(const Instruction& a) { return is_valid(a.payload, a.header.type); }
 
 inline Error_condition
-is_valid(const Sequence<Instruction> i)
+is_valid(const Sequence<Instruction>& i)
 {
   for (auto iter = i.begin(); iter != i.end(); iter++)
   {
@@ -3277,7 +3277,7 @@ is_valid(const Table_mod::Config_type c)
 }
 
 inline Error_condition
-is_valid(const Table_mod tm) { return is_valid(tm.config); }
+is_valid(const Table_mod& tm) { return is_valid(tm.config); }
 
 // -------------------------------------------------------------------------- //
 // Stats type
@@ -4471,6 +4471,7 @@ template<typename Tag, typename... Args>
   Message::Message(uint32_t id, Tag t, Args&&... args)
     : header(t.value) {
       construct(payload, t, std::forward<Args>(args)...);
+      payload.init = true;
       header.xid = id;
     }
 
@@ -0,0 +1,106 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <iostream>
+
+#include <libflog/proto/ofp/batch.hpp>
+
+using namespace flog;
+using namespace flog::ofp;
+
+// Messages of several versions, followed by the first half of a header.
+const Byte stream[] = {
+  0x01, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x01, // 1.0 hello
+  0x03, 0x02, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x02, // 1.2 echo request
+  0xde, 0xad, 0xbe, 0xef,
+  0x04, 0x0d, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x03, // 1.3 packet out
+  0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01,
+  0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x02,
+  0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0xde, 0xad, 0xbe, 0xef,
+  0x04, 0x14, 0x00, 0x08, 0x00, 0x00, 0x00, 0x04, // 1.3 barrier request
+  0x04, 0x02, 0x00, 0x10                          // partial
+};
+
+// A message of an unknown version between two hellos.
+const Byte bad[] = {
+  0x02, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x01,
+  0x07, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x02,
+  0x02, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x03
+};
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+int main()
+{
+  Buffer buf(std::begin(stream), std::end(stream));
+
+  // The complete messages are decoded in order, and the partial one is
+  // left in the view.
+  Message_batch b;
+  Buffer_view v(buf);
+  if (not decode(v, b))
+    return fail("stream was not decoded");
+  if (b.size() != 4 or remaining(v) != 4)
+    return fail("partial message was not left in the view");
+  if (b[0].version != 1 or b[0].ptr.m1->header.type != v1_0::HELLO)
+    return fail("1.0 hello was not decoded");
+  if (b[1].version != 3 or b[1].ptr.m3->header.xid != 2)
+    return fail("1.2 echo request was not decoded");
+  if (b[2].version != 4 or b[2].patch != 0
+      or b[2].ptr.m4->header.type != v1_3::PACKET_OUT)
+    return fail("1.3 packet out was not decoded");
+  if (b[3].ptr.m4->header.type != v1_3::BARRIER_REQ)
+    return fail("1.3 barrier request was not decoded");
+
+  // Decoding again reuses the slots of the batch.
+  {
+    const v1_3::Message* m = b[2].ptr.m4;
+    clear(b);
+    Buffer_view v(buf);
+    if (not decode(v, b))
+      return fail("stream was not decoded again");
+    if (b.size() != 4 or b[2].ptr.m4 != m)
+      return fail("slots of the batch were not reused");
+  }
+
+  // Version 4 messages are read as 1.3.1 in a batch of that patch.
+  {
+    Message_batch p(1);
+    Buffer_view v(buf);
+    if (not decode(v, p))
+      return fail("stream was not decoded as 1.3.1");
+    if (p[2].version != 4 or p[2].patch != 1
+        or p[2].ptr.m5->header.type != v1_3_1::PACKET_OUT)
+      return fail("1.3.1 packet out was not decoded");
+  }
+
+  // Decoding stops at a message that cannot be read, leaving it in the
+  // view.
+  {
+    Buffer junk(std::begin(bad), std::end(bad));
+    Buffer_view v(junk);
+    clear(b);
+    if (decode(v, b))
+      return fail("unknown version was decoded");
+    if (b.size() != 1 or remaining(v) != 16 or v.first[0] != 0x07)
+      return fail("decoding did not stop at the unknown version");
+  }
+}
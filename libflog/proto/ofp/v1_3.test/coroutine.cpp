@@ -0,0 +1,218 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+#include <iostream>
+#include <vector>
+
+#include <libflog/proto/ofp/coroutine.hpp>
+#include <libflog/proto/ofp/v1_3/encoder.hpp>
+
+using namespace flog;
+using namespace flog::ofp;
+using namespace flog::ofp::v1_3;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+const uint64_t Datapath = 42;
+
+struct Controller : v1_3::Application
+{
+  void init(const Time& t) { }
+
+  void barrier_response(const Barrier_res& br, const Time& t)
+  {
+    ++barriers;
+  }
+
+  uint64_t barriers = 0;
+};
+
+// Append the encoding of m to b.
+bool
+add(Buffer& b, const Message& m)
+{
+  Buffer e;
+  if (not encode(e, m))
+    return false;
+  b.insert(b.end(), e.begin(), e.end());
+  return true;
+}
+
+// Send all n bytes at p on the socket fd.
+bool
+send_all(int fd, const void* p, std::size_t n)
+{
+  return ::send(fd, p, n, 0) == ssize_t(n);
+}
+
+// A switch that answers feature requests and its first barrier request,
+// and ignores everything else.
+struct Peer
+{
+  Peer(int fd) : fd(fd), input(fd) { }
+
+  void read()
+  {
+    input.read();
+    while (input.ready()) {
+      Buffer_view v = input.next();
+      uint32_t xid = load<uint32_t>(v.first + 4);
+      Buffer reply;
+      bool ok = true;
+      if (v.first[1] == FEATURE_REQ)
+        ok = add(reply, Message(xid, Feature_res::Tag(), Datapath, 0, 1, 0,
+                                Feature_res::Capability_type(0), 0));
+      else if (v.first[1] == BARRIER_REQ and ++barriers == 1)
+        ok = add(reply, Message(xid, Barrier_res::Tag()));
+      if (not ok or (not reply.empty()
+                     and not send_all(fd, reply.data(), reply.size())))
+        failed = true;
+    }
+  }
+
+  int fd;
+  Framer input;
+  uint64_t barriers = 0;
+  bool failed = false;
+};
+
+// Run the reactor and the peer until done returns true, or a few seconds
+// pass.
+template<typename F>
+  bool
+  run(Reactor& r, Peer& p, F done)
+  {
+    Time limit = now() + Time(5);
+    while (not done()) {
+      if (p.failed or limit < now())
+        return false;
+      process(r);
+      p.read();
+    }
+    return true;
+  }
+
+// What the script saw.
+struct Outcome
+{
+  std::vector<Request_status> status;
+  uint64_t datapath = 0;
+  bool done = false;
+};
+
+Task
+script(Switch<Message>& sw, Outcome& o)
+{
+  auto b = co_await sw.barrier();
+  o.status.push_back(b.status);
+
+  auto f = co_await sw.request(Feature_req());
+  o.status.push_back(f.status);
+  if (f)
+    o.datapath = f.message.payload.data.feature_res.datapath_id;
+
+  // The switch does not answer these.
+  sw.timeout = Time(0, 20000);
+  auto g = co_await sw.request(Get_config_req());
+  o.status.push_back(g.status);
+
+  sw.timeout = Time(5);
+  auto c = co_await sw.barrier();
+  o.status.push_back(c.status);
+  o.done = true;
+}
+
+int main()
+{
+  int sv[2];
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+    return fail("socketpair");
+  ::fcntl(sv[1], F_SETFL, ::fcntl(sv[1], F_GETFL) | O_NONBLOCK);
+
+  Timer_config tc;
+  tc.hello_wait = Time(5);
+  tc.echo_req_interval = Time(60);
+  tc.echo_res_wait = Time(5);
+  tc.feature_res_wait = Time(5);
+  FSM_config config(FSM_config::v1_3, FSM_config::a1_3, tc);
+
+  Logger logger("/dev/null");
+  Reactor reactor(logger, Time(0, 1000));
+  Controller app;
+  Session s(config, app);
+  Connection c(reactor, socket::Socket(net::TCP, nullptr, nullptr, sv[0]));
+  Peer peer(sv[1]);
+  Switch<Message> sw(s, app);
+  Outcome o;
+
+  // Requests cannot be made before the session is established.
+  script(sw, o);
+  if (o.status.size() != 4 or not o.done)
+    return fail("script did not run to the end");
+  for (Request_status r : o.status) {
+    if (r != REFUSED)
+      return fail("request was made before the session was established");
+  }
+  o = Outcome();
+
+  attach(c, s, now());
+  Buffer hello;
+  if (not add(hello, Message(1, Hello::Tag()))
+      or not add(hello, Message(2, Feature_res::Tag(), 1, 0, 1, 0,
+                                   Feature_res::Capability_type(0), 0)))
+    return fail("hello was not encoded");
+  if (not send_all(sv[1], hello.data(), hello.size()))
+    return fail("hello was not sent");
+  if (not run(reactor, peer, [&] { return s.state == Session::ESTABLISHED; }))
+    return fail("session was not established");
+
+  // The frame of the script comes from the pool. It suspends at its first
+  // request, and is resumed by each reply in turn.
+  Pool_stats before = pool_stats();
+  script(sw, o);
+  if (pool_stats().hits + pool_stats().misses
+      <= before.hits + before.misses)
+    return fail("frame was not drawn from the pool");
+  if (not o.status.empty() or s.pending.size != 1)
+    return fail("script did not suspend at its first request");
+  if (not run(reactor, peer, [&] { return o.status.size() >= 3; }))
+    return fail("requests were not completed");
+  if (o.status[0] != REPLIED or app.barriers != 0)
+    return fail("barrier reply did not resume the script");
+  if (o.status[1] != REPLIED or o.datapath != Datapath)
+    return fail("feature reply was not decoded");
+  if (o.status[2] != EXPIRED)
+    return fail("unanswered request did not expire");
+
+  // The last request is cancelled by closing the connection, and the
+  // script runs to the end.
+  if (not run(reactor, peer, [&] { return peer.barriers >= 2; }))
+    return fail("last barrier request was not sent");
+  close(c, now(), "done");
+  if (not o.done or o.status[3] != CANCELLED or s.pending.size != 0)
+    return fail("pending request was not cancelled by closing");
+
+  ::close(sv[1]);
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <iostream>
+
+#include <libflog/proto/ofp/v1_3/encoder.hpp>
+
+using namespace flog;
+using namespace flog::ofp::v1_3;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+// A Flow_mod matching on the ingress port and ethertype, with an
+// Apply_actions instruction holding an output and a set_field action.
+const Byte flow_mod[] = {
+  0x04, 0x0e, 0x00, 0x70, 0x00, 0x00, 0x00, 0x01, // header
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, // cookie
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // cookie mask
+  0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x80, 0x00, // table, command, ...
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, // buffer id, out port
+  0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, // out group, flags
+  0x00, 0x01, 0x00, 0x12,                         // match
+  0x80, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x07, // in_port
+  0x80, 0x00, 0x0a, 0x02, 0x08, 0x00,             // eth_type
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,             // match padding
+  0x00, 0x04, 0x00, 0x28, 0x00, 0x00, 0x00, 0x00, // apply actions
+  0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x02, // output
+  0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x19, 0x00, 0x10, 0x80, 0x00, 0x0a, 0x02, // set_field eth_type
+  0x86, 0xdd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// A Packet_out with one output action and 4 bytes of packet data.
+const Byte packet_out[] = {
+  0x04, 0x0d, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x2b, // header
+  0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01, // buffer id, in_port
+  0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // actions length
+  0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x02, // output
+  0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0xde, 0xad, 0xbe, 0xef                          // data
+};
+
+// Decode the message in buf into m. The buffer must outlive the message.
+bool
+decode(Buffer& buf, Message& m)
+{
+  Buffer_view v(buf);
+  return from_buffer(v, m);
+}
+
+bool
+equal(const Buffer& b, const Byte* first, const Byte* last)
+{
+  return b.size() == std::size_t(last - first)
+     and std::equal(first, last, b.begin());
+}
+
+int main()
+{
+  // A decoded Flow_mod encodes to the same bytes as to_buffer().
+  {
+    Buffer in(std::begin(flow_mod), std::end(flow_mod));
+    Message m;
+    if (not decode(in, m))
+      return fail("flow mod was not decoded");
+    Buffer buf;
+    if (not encode(buf, m))
+      return fail("flow mod was not encoded");
+    if (not equal(buf, std::begin(flow_mod), std::end(flow_mod)))
+      return fail("flow mod was not encoded to the bytes decoded");
+
+    Buffer old(bytes(m));
+    Buffer_view v(old);
+    if (not to_buffer(v, m))
+      return fail("flow mod was not written by to_buffer");
+    if (buf != old)
+      return fail("encoding differs from to_buffer");
+  }
+
+  // Lengths are back-patched, not copied from the message.
+  {
+    Buffer in(std::begin(flow_mod), std::end(flow_mod));
+    Message m;
+    if (not decode(in, m))
+      return fail("flow mod was not decoded");
+    Flow_mod& fm = m.payload.data.flow_mod;
+    m.header.length = 0;
+    fm.match.length = 0;
+    for (Instruction& i : fm.instructions) {
+      i.header.length = 0;
+      for (Action& a : i.payload.data.apply_actions.actions)
+        a.header.length = 0;
+    }
+    for (OXM_entry& e : fm.match.rules)
+      e.header.length = 0;
+
+    Buffer buf;
+    if (not encode(buf, m))
+      return fail("flow mod was not encoded");
+    if (not equal(buf, std::begin(flow_mod), std::end(flow_mod)))
+      return fail("lengths were not back-patched");
+  }
+
+  // Messages are appended to the buffer.
+  {
+    Buffer in(std::begin(packet_out), std::end(packet_out));
+    Message m;
+    if (not decode(in, m))
+      return fail("packet out was not decoded");
+    Packet_out& po = m.payload.data.packet_out;
+    m.header.length = 0;
+    po.actions_len = 0;
+
+    Buffer buf(3);
+    if (not encode(buf, m))
+      return fail("packet out was not encoded");
+    if (buf.size() != 3 + sizeof(packet_out)
+        or not std::equal(std::begin(packet_out), std::end(packet_out),
+                          buf.begin() + 3))
+      return fail("packet out was not appended to the buffer");
+  }
+}
@@ -0,0 +1,239 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+#include <iostream>
+#include <vector>
+
+#include <libflog/proto/ofp/session.hpp>
+#include <libflog/proto/ofp/v1_3/encoder.hpp>
+
+using namespace flog;
+using namespace flog::ofp;
+using namespace flog::ofp::v1_3;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+const uint64_t Packets = 1000;
+const std::size_t Limit = 64;
+
+// Sends a flow mod for every packet, and records the batches completed.
+struct Installer : v1_3::Application
+{
+  void init(const Time& t) { }
+
+  void packet_in(const Packet_in& pi, const Time& t)
+  {
+    send(Message_pool::make(0, Flow_mod::Tag()));
+  }
+
+  void barrier_response(const Barrier_res& br, const Time& t)
+  {
+    ++barriers;
+  }
+
+  void error(const Error& e, const Time& t)
+  {
+    ++errors;
+  }
+
+  void batch_complete(const Flow_mod_batch& b, const Time& t)
+  {
+    batches.push_back(b);
+  }
+
+  void batch_expired(const Flow_mod_batch& b, const Time& t)
+  {
+    expired.push_back(b);
+  }
+
+  std::vector<Flow_mod_batch> batches;
+  std::vector<Flow_mod_batch> expired;
+  uint64_t barriers = 0;
+  uint64_t errors = 0;
+};
+
+// A switch that answers each barrier request while answering is true, and
+// fails the first flow mod it receives. Its replies are queued behind the rest of its script.
+struct Peer
+{
+  Peer(int fd) : fd(fd), input(fd), sent(0) { }
+
+  void read()
+  {
+    input.read();
+    while (input.ready()) {
+      Buffer_view v = input.next();
+      Byte reply[12] = { 4, 0, 0, 8, v.first[4], v.first[5], v.first[6],
+                         v.first[7] };
+      if (v.first[1] == FLOW_MOD) {
+        if (++flow_mods == 1) {
+          reply[1] = ERROR;
+          reply[3] = 12;
+          reply[9] = 5;               // Flow mod failed
+          script.insert(script.end(), reply, reply + 12);
+        }
+      } else if (v.first[1] == BARRIER_REQ and answering) {
+        ++barriers;
+        reply[1] = BARRIER_RES;
+        script.insert(script.end(), reply, reply + 8);
+      }
+    }
+  }
+
+  // Send as much of the script as the socket accepts.
+  void write()
+  {
+    while (sent < script.size()) {
+      ssize_t n = ::send(fd, &script[sent], script.size() - sent,
+                         MSG_DONTWAIT);
+      if (n <= 0)
+        break;
+      sent += n;
+    }
+  }
+
+  int fd;
+  Framer input;
+  Buffer script;
+  std::size_t sent;
+  uint64_t flow_mods = 0;
+  uint64_t barriers = 0;
+  bool answering = true;
+};
+
+// Append the encoding of m to b.
+bool
+add(Buffer& b, const Message& m)
+{
+  Buffer e;
+  if (not encode(e, m))
+    return false;
+  b.insert(b.end(), e.begin(), e.end());
+  return true;
+}
+
+// Run the reactor and the peer until done returns true, or a few seconds
+// pass.
+template<typename F>
+  bool
+  run(Reactor& r, Peer& p, F done)
+  {
+    Time limit = now() + Time(5);
+    while (not done()) {
+      if (limit < now())
+        return false;
+      p.write();
+      process(r);
+      p.read();
+    }
+    return true;
+  }
+
+int main()
+{
+  int sv[2];
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+    return fail("socketpair");
+  ::fcntl(sv[1], F_SETFL, ::fcntl(sv[1], F_GETFL) | O_NONBLOCK);
+
+  Timer_config tc;
+  tc.hello_wait = Time(5);
+  tc.echo_req_interval = Time(60);
+  tc.echo_res_wait = Time(5);
+  tc.feature_res_wait = Time(5);
+  FSM_config config(FSM_config::v1_3, FSM_config::a1_3, tc);
+
+  Logger logger("/dev/null");
+  Reactor reactor(logger, Time(0, 1000));
+  Installer app;
+  Session s(config, app);
+  s.batcher = Flow_batcher(Time(0, 0), Limit);
+  Connection c(reactor, socket::Socket(net::TCP, nullptr, nullptr, sv[0]));
+  Peer peer(sv[1]);
+
+  // Establish the session, then send the packets.
+  attach(c, s, now());
+  if (not add(peer.script, Message(1, Hello::Tag()))
+      or not add(peer.script, Message(2, Feature_res::Tag(), 1, 0, 1, 0,
+                                         Feature_res::Capability_type(0), 0)))
+    return fail("hello was not encoded");
+  if (not run(reactor, peer, [&] { return s.state == Session::ESTABLISHED; }))
+    return fail("session was not established");
+
+  uint64_t calls = c.output.calls;
+  for (uint64_t i = 0; i < Packets; ++i) {
+    if (not add(peer.script, Message(3 + i, Packet_in::Tag())))
+      return fail("packet was not encoded");
+  }
+  if (not run(reactor, peer, [&] {
+        return peer.flow_mods == Packets
+           and app.batches.size() == peer.barriers
+           and s.batcher.sealed.empty();
+      }))
+    return fail("batches were not acknowledged");
+
+  // Every flow mod was sent in a batch closed by a barrier, in far fewer
+  // writes than flow mods. Each barrier was answered, and the replies were
+  // not passed to the application.
+  uint64_t flow_mods = 0;
+  uint64_t errors = 0;
+  for (std::size_t i = 0; i < app.batches.size(); ++i) {
+    const Flow_mod_batch& b = app.batches[i];
+    if (b.id != i + 1 or b.flow_mods > Limit)
+      return fail("batches were not numbered or limited");
+    if (b.barrier != b.first + b.flow_mods)
+      return fail("barrier did not follow the flow mods of its batch");
+    flow_mods += b.flow_mods;
+    errors += b.errors;
+  }
+  if (flow_mods != Packets or app.batches.size() < Packets / Limit)
+    return fail("flow mods were not sent in batches");
+  if (c.output.calls - calls >= Packets / 4)
+    return fail("batches were not written together");
+  if (app.barriers != 0)
+    return fail("barrier replies reached the application");
+
+  // The error was counted against the first batch, and also passed on.
+  if (errors != 1 or app.batches[0].errors != 1 or app.errors != 1)
+    return fail("error was not counted against its batch");
+  if (not app.expired.empty())
+    return fail("acknowledged batch expired");
+
+  // A batch whose barrier is not answered expires, and is forgotten.
+  peer.answering = false;
+  s.batcher.timeout = Time(0, 20000);
+  std::size_t batches = app.batches.size();
+  if (not add(peer.script, Message(3 + Packets, Packet_in::Tag())))
+    return fail("packet was not encoded");
+  if (not run(reactor, peer, [&] { return not app.expired.empty(); }))
+    return fail("unacknowledged batch did not expire");
+  if (app.expired.size() != 1 or app.expired[0].flow_mods != 1
+      or app.expired[0].id != batches + 1)
+    return fail("expired batch was not reported");
+  if (not s.batcher.sealed.empty() or app.batches.size() != batches)
+    return fail("expired batch was not removed");
+
+  ::close(sv[1]);
+}
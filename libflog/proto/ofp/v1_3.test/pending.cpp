@@ -0,0 +1,369 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include <libflog/proto/ofp/session.hpp>
+#include <libflog/proto/ofp/v1_3/encoder.hpp>
+
+using namespace flog;
+using namespace flog::ofp;
+using namespace flog::ofp::v1_3;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+// The completions of requests, in the order they happened.
+struct Completions
+{
+  std::vector<Request_status> status;
+  std::vector<uint32_t> xids;
+};
+
+void
+record(void* context, const Request_result& r, const Time& t)
+{
+  Completions& done = *static_cast<Completions*>(context);
+  done.status.push_back(r.status);
+  done.xids.push_back(r.xid);
+}
+
+// The header of a message of the given type and xid, followed by the
+// flags of a multipart reply.
+struct Reply
+{
+  Reply(uint8_t type, uint32_t xid, uint16_t flags = 0)
+    : bytes { 4, type, 0, 16, Byte(xid >> 24), Byte(xid >> 16),
+              Byte(xid >> 8), Byte(xid), 0, 0, Byte(flags >> 8),
+              Byte(flags), 0, 0, 0, 0 }
+  { }
+
+  Byte bytes[16];
+};
+
+bool
+resolve(Pending_table& p, const Reply& r)
+{
+  return resolve(p, r.bytes, sizeof(r.bytes), Time(0));
+}
+
+int
+test_table()
+{
+  Timer_wheel wheel;
+  Pending_table p(4);
+  Completions done;
+  set_version(p, 4, wheel);
+
+  // The table holds as many requests as it was made for, each with a
+  // distinct xid.
+  for (uint32_t x = 1; x <= 4; ++x) {
+    if (not expect(p, x, BARRIER_RES, Time(10), record, &done))
+      return fail("request was refused by a table with room");
+  }
+  if (expect(p, 5, BARRIER_RES, Time(10), record, &done))
+    return fail("request was accepted by a full table");
+  if (p.size != 4 or not find(p, 3) or find(p, 5))
+    return fail("requests were not found by xid");
+
+  // A reply of the expected type resolves its request. Other messages
+  // with the xid are passed on, but an error resolves it.
+  if (not resolve(p, Reply(BARRIER_RES, 2)))
+    return fail("reply did not resolve its request");
+  if (resolve(p, Reply(PACKET_IN, 1)))
+    return fail("message of another type resolved a request");
+  if (resolve(p, Reply(BARRIER_RES, 9)))
+    return fail("reply to no request resolved one");
+  if (not resolve(p, Reply(ERROR, 3)))
+    return fail("error did not resolve its request");
+  if (done.status.size() != 2
+      or done.status[0] != REPLIED or done.xids[0] != 2
+      or done.status[1] != FAILED or done.xids[1] != 3)
+    return fail("completions were not reported");
+  if (p.size != 2 or find(p, 2))
+    return fail("resolved requests were not removed");
+  if (expect(p, 1, 0, Time(10), record, &done))
+    return fail("request was accepted with a pending xid");
+
+  // A multipart reply stays pending until its last part.
+  if (not expect(p, 7, MULTIPART_RES, Time(10), record, &done))
+    return fail("multipart request was refused");
+  if (not resolve(p, Reply(MULTIPART_RES, 7, 1))
+      or not resolve(p, Reply(MULTIPART_RES, 7, 1)))
+    return fail("part of a multipart reply was not resolved");
+  if (not find(p, 7) or done.status.back() != MORE)
+    return fail("multipart request did not stay pending");
+  if (not resolve(p, Reply(MULTIPART_RES, 7)))
+    return fail("last part of a multipart reply was not resolved");
+  if (find(p, 7) or done.status.back() != REPLIED)
+    return fail("multipart request was not completed");
+
+  // A request expires when the wheel passes its deadline, and one that is
+  // forgotten is not reported.
+  if (not expect(p, 8, BARRIER_RES, Time(1), record, &done))
+    return fail("request was refused by a table with room");
+  if (not forget(p, 4) or forget(p, 4))
+    return fail("request was not forgotten once");
+  advance(wheel, Time(2));
+  if (done.status.back() != EXPIRED or done.xids.back() != 8)
+    return fail("request did not expire");
+  if (p.size != 1 or not find(p, 1))
+    return fail("other requests did not stay pending");
+
+  // Clearing cancels the rest, after which nothing can be added.
+  std::size_t n = done.status.size();
+  clear(p, Time(3));
+  if (done.status.size() != n + 1 or done.status.back() != CANCELLED)
+    return fail("pending request was not cancelled");
+  if (p.size != 0 or expect(p, 1, 0, Time(10), record, &done))
+    return fail("request was accepted by a cleared table");
+  return 0;
+}
+
+// Add and remove many requests with colliding xids, checking the table
+// against a set.
+int
+test_probing()
+{
+  Timer_wheel wheel;
+  Pending_table p(64);
+  set_version(p, 4, wheel);
+  std::set<uint32_t> live;
+  uint32_t seed = 1;
+  for (int i = 0; i < 100000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    uint32_t x = (seed >> 16) % 256 * 4096;
+    if (live.count(x)) {
+      if (not find(p, x) or not forget(p, x))
+        return fail("pending request was not found");
+      live.erase(x);
+    } else if (live.size() < 64) {
+      if (not expect(p, x, BARRIER_RES, Time(10), nullptr, nullptr))
+        return fail("request was refused by a table with room");
+      live.insert(x);
+    }
+    if (p.size != live.size())
+      return fail("table size differs from the set");
+  }
+  for (uint32_t x = 0; x < 256 * 4096; x += 4096) {
+    if ((find(p, x) != nullptr) != (live.count(x) != 0))
+      return fail("table contents differ from the set");
+  }
+  if (wheel.size != live.size())
+    return fail("timers of removed requests are still armed");
+  return 0;
+}
+
+struct Controller : v1_3::Application
+{
+  void init(const Time& t) { }
+
+  void packet_in(const Packet_in& pi, const Time& t)
+  {
+    ++packets;
+  }
+
+  void barrier_response(const Barrier_res& br, const Time& t)
+  {
+    ++barriers;
+  }
+
+  uint64_t packets = 0;
+  uint64_t barriers = 0;
+};
+
+// The number of packets the application had received when a request was
+// completed.
+struct Order
+{
+  Controller* app;
+  int64_t packets;
+};
+
+void
+record_order(void* context, const Request_result& r, const Time& t)
+{
+  Order& o = *static_cast<Order*>(context);
+  o.packets = o.app->packets;
+}
+
+// Send all n bytes at p on the socket fd.
+bool
+send_all(int fd, const void* p, std::size_t n)
+{
+  return ::send(fd, p, n, 0) == ssize_t(n);
+}
+
+// A switch that answers barrier requests while answering is true.
+struct Peer
+{
+  Peer(int fd) : fd(fd), input(fd) { }
+
+  void read()
+  {
+    input.read();
+    while (input.ready()) {
+      Buffer_view v = input.next();
+      if (v.first[1] == BARRIER_REQ and answering) {
+        Reply r(BARRIER_RES, load<uint32_t>(v.first + 4));
+        r.bytes[3] = 8;
+        if (not send_all(fd, r.bytes, 8))
+          failed = true;
+      }
+    }
+  }
+
+  int fd;
+  Framer input;
+  bool answering = true;
+  bool failed = false;
+};
+
+// Run the reactor and the peer until done returns true, or a few seconds
+// pass.
+template<typename F>
+  bool
+  run(Reactor& r, Peer& p, F done)
+  {
+    Time limit = now() + Time(5);
+    while (not done()) {
+      if (p.failed or limit < now())
+        return false;
+      process(r);
+      p.read();
+    }
+    return true;
+  }
+
+// Append the encoding of m to b.
+bool
+add(Buffer& b, const Message& m)
+{
+  Buffer e;
+  if (not encode(e, m))
+    return false;
+  b.insert(b.end(), e.begin(), e.end());
+  return true;
+}
+
+// Register a barrier request with the session, and send it.
+bool
+barrier(Session& s, Controller& app, Completions& done, const Time& timeout)
+{
+  uint32_t xid = s.gen();
+  if (not expect(s.pending, xid, BARRIER_RES, now() + timeout, record, &done))
+    return false;
+  app.send(Message_pool::make(xid, Barrier_req::Tag()));
+  wake(*s.connection, now());
+  return true;
+}
+
+int
+test_session()
+{
+  int sv[2];
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+    return fail("socketpair");
+  ::fcntl(sv[1], F_SETFL, ::fcntl(sv[1], F_GETFL) | O_NONBLOCK);
+
+  Timer_config tc;
+  tc.hello_wait = Time(5);
+  tc.echo_req_interval = Time(60);
+  tc.echo_res_wait = Time(5);
+  tc.feature_res_wait = Time(5);
+  FSM_config config(FSM_config::v1_3, FSM_config::a1_3, tc);
+
+  Logger logger("/dev/null");
+  Reactor reactor(logger, Time(0, 1000));
+  Controller app;
+  Session s(config, app);
+  Connection c(reactor, socket::Socket(net::TCP, nullptr, nullptr, sv[0]));
+  Peer peer(sv[1]);
+  Completions done;
+
+  attach(c, s, now());
+  Buffer script;
+  if (not add(script, Message(1, Hello::Tag()))
+      or not add(script, Message(2, Feature_res::Tag(), 1, 0, 1, 0,
+                                    Feature_res::Capability_type(0), 0)))
+    return fail("script was not encoded");
+  if (not send_all(sv[1], script.data(), script.size()))
+    return fail("script was not sent");
+  if (not run(reactor, peer, [&] { return s.state == Session::ESTABLISHED; }))
+    return fail("session was not established");
+
+  // The reply reaches the callback of the request, not the application.
+  if (not barrier(s, app, done, Time(5)))
+    return fail("barrier request was refused");
+  if (not run(reactor, peer, [&] { return not done.status.empty(); }))
+    return fail("barrier request was not completed");
+  if (done.status[0] != REPLIED or app.barriers != 0)
+    return fail("barrier reply did not reach the callback");
+
+  // A request that is not answered expires.
+  peer.answering = false;
+  if (not barrier(s, app, done, Time(0, 20000)))
+    return fail("barrier request was refused");
+  if (not run(reactor, peer, [&] { return done.status.size() == 2; }))
+    return fail("barrier request was not completed");
+  if (done.status[1] != EXPIRED or s.pending.size != 0)
+    return fail("unanswered request did not expire");
+
+  // A reply is handled after the messages that precede it in the same
+  // read.
+  Order order { &app, -1 };
+  uint32_t xid = s.gen();
+  if (not expect(s.pending, xid, BARRIER_RES, now() + Time(5), record_order,
+                 &order))
+    return fail("barrier request was refused");
+  Buffer packets;
+  if (not add(packets, Message(0, Packet_in::Tag()))
+      or not add(packets, Message(xid, Barrier_res::Tag()))
+      or not add(packets, Message(0, Packet_in::Tag())))
+    return fail("packets were not encoded");
+  if (not send_all(sv[1], packets.data(), packets.size()))
+    return fail("packets were not sent");
+  if (not run(reactor, peer, [&] { return app.packets == 2; }))
+    return fail("packets did not reach the application");
+  if (order.packets != 1)
+    return fail("reply was not handled in the order received");
+
+  // Those still pending when the connection closes are cancelled.
+  if (not barrier(s, app, done, Time(5)))
+    return fail("barrier request was refused");
+  close(c, now(), "done");
+  if (done.status.size() != 3 or done.status[2] != CANCELLED)
+    return fail("pending request was not cancelled by closing");
+
+  ::close(sv[1]);
+  return 0;
+}
+
+int main()
+{
+  if (test_table() or test_probing() or test_session())
+    return -1;
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <iostream>
+
+#include <libflog/proto/ofp/message.hpp>
+
+using namespace flog;
+using namespace flog::ofp;
+using namespace flog::ofp::v1_3;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+// Returns the result of replying to n echo requests.
+ofp::State_result
+echo(Factory& f, int n)
+{
+  ofp::Message_vector v;
+  for(int i = 0; i < n; ++i)
+    v.push_back(f.make_echo_res());
+  return std::move(v);
+}
+
+int main()
+{
+  Xid_generator<uint32_t> gen;
+  Factory f(gen);
+
+  // Messages released by a state result are made again from the pool.
+  {
+    echo(f, 4);
+    Object_pool_stats before = Message_pool::stats();
+    if (Message_pool::free_count() != 4)
+      return fail("released messages were not kept");
+    {
+      ofp::State_result r = echo(f, 3);
+      if (r.second[0].version != 4 or r.second[0].patch != 0)
+        return fail("message was made with the wrong version");
+    }
+    const Object_pool_stats& s = Message_pool::stats();
+    if (s.hits != before.hits + 3 or s.misses != before.misses)
+      return fail("messages were not made from the pool");
+    if (s.live != before.live or Message_pool::free_count() != 4)
+      return fail("messages were not released to the pool");
+  }
+
+  // The free list is bounded, and the high-water mark records the most
+  // messages made at once.
+  {
+    echo(f, Object_pool_limit + 10);
+    const Object_pool_stats& s = Message_pool::stats();
+    if (Message_pool::free_count() != Object_pool_limit or s.returned != 10)
+      return fail("free list was not bounded");
+    if (s.high_water != int64_t(Object_pool_limit + 10) or s.live != 0)
+      return fail("high-water mark was not recorded");
+  }
+
+  // Each version has its own pool.
+  if (v1_0::Message_pool::stats().hits != 0
+      or v1_3_1::Message_pool::stats().hits != 0)
+    return fail("versions share a pool");
+}
@@ -0,0 +1,133 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <iostream>
+
+#include <libflog/arena.hpp>
+#include <libflog/proto/ofp/v1_3/encoder.hpp>
+
+using namespace flog;
+using namespace flog::ofp::v1_3;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+// A Flow_mod matching on the ingress port and ethertype, with an
+// Apply_actions instruction holding an output and a set_field action.
+const Byte flow_mod[] = {
+  0x04, 0x0e, 0x00, 0x70, 0x00, 0x00, 0x00, 0x01, // header
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, // cookie
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // cookie mask
+  0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x80, 0x00, // table, command, ...
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, // buffer id, out port
+  0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, // out group, flags
+  0x00, 0x01, 0x00, 0x12,                         // match
+  0x80, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x07, // in_port
+  0x80, 0x00, 0x0a, 0x02, 0x08, 0x00,             // eth_type
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,             // match padding
+  0x00, 0x04, 0x00, 0x28, 0x00, 0x00, 0x00, 0x00, // apply actions
+  0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x02, // output
+  0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x19, 0x00, 0x10, 0x80, 0x00, 0x0a, 0x02, // set_field eth_type
+  0x86, 0xdd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// A Packet_out with one output action and 4 bytes of packet data.
+const Byte packet_out[] = {
+  0x04, 0x0d, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x2b, // header
+  0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01, // buffer id, in_port
+  0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // actions length
+  0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x02, // output
+  0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0xde, 0xad, 0xbe, 0xef                          // data
+};
+
+// Read the message in buf into m, which may hold a previous message.
+bool
+decode(Buffer& buf, Message& m)
+{
+  Buffer_view v(buf);
+  return from_buffer(v, m);
+}
+
+// Returns true when reading buf into r gives the same message as reading
+// it into a new object.
+bool
+recycles(Buffer& buf, Message& r)
+{
+  Message m;
+  return decode(buf, m) and decode(buf, r) and r == m;
+}
+
+int main()
+{
+  Buffer fm(std::begin(flow_mod), std::end(flow_mod));
+  Buffer po(std::begin(packet_out), std::end(packet_out));
+
+  // The same Flow_mod with one match entry, and two output actions.
+  Buffer small;
+  {
+    Message m;
+    if (not decode(fm, m))
+      return fail("flow mod was not decoded");
+    Flow_mod& f = m.payload.data.flow_mod;
+    f.match.rules.pop_back();
+    Action_sequence& as = f.instructions[0].payload.data.apply_actions.actions;
+    as.pop_back();
+    as.push_back(as.front());
+    if (not encode(small, m))
+      return fail("smaller flow mod was not encoded");
+  }
+
+  // The same Flow_mod with an empty match.
+  Buffer empty;
+  {
+    Message m;
+    if (not decode(fm, m))
+      return fail("flow mod was not decoded");
+    m.payload.data.flow_mod.match.rules.clear();
+    if (not encode(empty, m))
+      return fail("flow mod with an empty match was not encoded");
+  }
+
+  // Messages, sequences and the elements of sequences can be read over
+  // values of the same or a different kind.
+  Message r;
+  if (not recycles(fm, r) or not recycles(small, r))
+    return fail("flow mod was not read over another");
+  if (r.payload.data.flow_mod.match.rules.size() != 1)
+    return fail("longer match was not shortened");
+  if (not recycles(empty, r) or not r.payload.data.flow_mod.match.rules.empty())
+    return fail("match was not emptied");
+  if (not recycles(fm, r) or not recycles(po, r) or not recycles(fm, r))
+    return fail("message was not read over one of another kind");
+
+  // Reading the same message again allocates nothing.
+  {
+    Arena a;
+    Arena_scope scope(a);
+    Message x;
+    if (not decode(fm, x) or not decode(small, x))
+      return fail("messages were not decoded");
+    std::size_t n = a.used();
+    if (not decode(fm, x) or not decode(small, x))
+      return fail("messages were not decoded again");
+    if (a.used() != n)
+      return fail("reading the same message again allocated");
+  }
+}
@@ -0,0 +1,217 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+#include <iostream>
+
+#include <libflog/proto/ofp/session.hpp>
+#include <libflog/proto/ofp/v1_3/encoder.hpp>
+
+using namespace flog;
+using namespace flog::ofp;
+using namespace flog::ofp::v1_3;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+const uint64_t Packets = 100000;
+const uint64_t Barrier_interval = 100;
+
+// Counts what the switch sends, and sends a barrier request after every
+// Barrier_interval packets.
+struct Counter : v1_3::Application
+{
+  void init(const Time& t) { }
+
+  void feature_response(const Feature_res& fr, const Time& t)
+  {
+    ++features;
+  }
+
+  void packet_in(const Packet_in& pi, const Time& t)
+  {
+    if (++packets % Barrier_interval == 0)
+      send(Message_pool::make(xid++, Barrier_req::Tag()));
+  }
+
+  uint64_t features = 0;
+  uint64_t packets = 0;
+  uint32_t xid = 1000;
+};
+
+// The switch at the other end of the connection, which plays a fixed
+// script and counts the messages it receives by type.
+struct Peer
+{
+  Peer(int fd) : fd(fd), input(fd), sent(0), counts() { }
+
+  // Read and count everything the controller has sent.
+  void read()
+  {
+    input.read();
+    while (input.ready()) {
+      Buffer_view v = input.next();
+      ++counts[v.first[1]];
+    }
+  }
+
+  // Send as much of the script as the socket accepts.
+  void write()
+  {
+    while (sent < script.size()) {
+      ssize_t n = ::send(fd, &script[sent], script.size() - sent,
+                         MSG_DONTWAIT);
+      if (n <= 0)
+        break;
+      sent += n;
+    }
+  }
+
+  bool done() const { return sent == script.size(); }
+
+  int fd;
+  Framer input;
+  Buffer script;
+  std::size_t sent;
+  uint64_t counts[256];
+};
+
+// Append the encoding of m to b.
+bool
+add(Buffer& b, const Message& m)
+{
+  Buffer e;
+  if (not encode(e, m))
+    return false;
+  b.insert(b.end(), e.begin(), e.end());
+  return true;
+}
+
+// Run the reactor and the peer until done returns true, or a few seconds
+// pass.
+template<typename F>
+  bool
+  run(Reactor& r, Peer& p, F done)
+  {
+    Time limit = now() + Time(5);
+    while (not done()) {
+      if (limit < now())
+        return false;
+      p.write();
+      process(r);
+      p.read();
+    }
+    return true;
+  }
+
+int main()
+{
+  int sv[2];
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+    return fail("socketpair");
+  ::fcntl(sv[1], F_SETFL, ::fcntl(sv[1], F_GETFL) | O_NONBLOCK);
+
+  Timer_config tc;
+  tc.hello_wait = Time(5);
+  tc.echo_req_interval = Time(60);
+  tc.echo_res_wait = Time(5);
+  tc.feature_res_wait = Time(5);
+  FSM_config config(FSM_config::v1_3, FSM_config::a1_3, tc);
+
+  Logger logger("/dev/null");
+  Reactor reactor(logger, Time(0, 1000));
+  Counter app;
+  Session s(config, app);
+  Connection c(reactor, socket::Socket(net::TCP, nullptr, nullptr, sv[0]));
+  Peer peer(sv[1]);
+
+  // The controller opens with a hello, and wakes the connection when it
+  // is due.
+  attach(c, s, now());
+  if (s.state != Session::NEGOTIATING)
+    return fail("session did not start negotiating");
+  if (not is_armed(c.timer) or now() + tc.hello_wait < c.timer.deadline)
+    return fail("connection was not woken for the hello");
+  peer.read();
+  if (peer.counts[HELLO] != 1)
+    return fail("controller did not send a hello");
+
+  // The switch answers with a hello, its features and a stream of packets,
+  // all of which arrive while the controller is still negotiating.
+  bool ok = add(peer.script, Message(1, Hello::Tag()))
+        and add(peer.script, Message(2, Feature_res::Tag(), 1, 0, 1, 0,
+                                     Feature_res::Capability_type(0), 0));
+  for (uint64_t i = 0; ok and i < Packets; ++i)
+    ok = add(peer.script, Message(3 + i, Packet_in::Tag()));
+  if (not ok)
+    return fail("script was not encoded");
+
+  Time start = now();
+  if (not run(reactor, peer, [&] {
+        return peer.done() and app.packets == Packets;
+      }))
+    return fail("packets did not reach the application");
+  Time elapsed = now() - start;
+
+  // The session negotiated 1.3, asked for features, and every packet
+  // reached the application. Its barrier requests reached the switch.
+  if (s.state != Session::ESTABLISHED or s.version != FSM_config::v1_3)
+    return fail("session did not negotiate 1.3");
+  if (not s.ops or s.ops->wire != 4)
+    return fail("session was not bound to the 1.3 operations");
+  if (s.received != Packets + 2)
+    return fail("session did not count the messages received");
+  if (app.features != 1 or app.packets != Packets)
+    return fail("application did not receive every message");
+  if (not run(reactor, peer, [&] {
+        return peer.counts[BARRIER_REQ] == Packets / Barrier_interval;
+      }))
+    return fail("barrier requests did not reach the switch");
+  if (peer.counts[FEATURE_REQ] != 1)
+    return fail("controller did not ask for features once");
+  if (not c.output.status
+      or c.output.sent != Packets / Barrier_interval + 2)
+    return fail("output did not count the messages sent");
+
+  // Nothing is due before the echo timer fires, so the connection is not
+  // woken until then.
+  if (is_armed(c.timer))
+    return fail("idle connection is still woken");
+
+  double seconds = elapsed.sec + elapsed.usec / 1e6;
+  std::cout << Packets << " packets in " << seconds << "s, "
+            << uint64_t(Packets / seconds) << " per second\n";
+
+  // A message of another version than the one negotiated closes the
+  // connection, and the state machine with it.
+  const Byte hello[] = { 0x01, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x09 };
+  if (::send(sv[1], hello, sizeof(hello), 0) != ssize_t(sizeof(hello)))
+    return fail("hello was not sent");
+  process(reactor);
+  if (c.status or s.state != Session::CLOSED)
+    return fail("message of another version did not close the session");
+  if (reader(reactor, sv[0]) != nullptr)
+    return fail("closed connection is still subscribed");
+
+  ::close(sv[1]);
+}
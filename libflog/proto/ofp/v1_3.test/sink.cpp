@@ -0,0 +1,122 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <iostream>
+
+#include <libflog/proto/ofp/v1_3/state.hpp>
+
+using namespace flog;
+using namespace flog::ofp;
+using namespace flog::ofp::v1_3;
+
+struct Test_agent : v1_3::Agent
+{
+  void init(const Time& t) { }
+
+  // Acknowledge each barrier through the agent's queue.
+  void barrier_request(const Barrier_req& br, const Time& t)
+  {
+    send(Message_pool::make(xid, Barrier_res::Tag()));
+  }
+
+  uint32_t xid = 7;
+};
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+int main()
+{
+  Timer_config tc;
+  tc.echo_req_interval = Time(5);
+  tc.echo_res_wait = Time(2);
+  tc.feature_req_wait = Time(5);
+
+  Test_agent a;
+  Xid_generator<uint32_t> gen;
+  Timer_wheel wheel;
+  FSM_config c(FSM_config::v1_3, FSM_config::a1_3, tc);
+  FSM_switch s(c, gen, a, wheel);
+  Factory f(gen);
+
+  Output_queue q;
+  Output_sink out(q);
+
+  bool ok = init(s, Time(0), out);
+  if (not ok or not empty(q))
+    return fail("init sent a message");
+
+  // The feature reply is encoded straight into the queue.
+  Message* m = f.make_feature_req();
+  ok = recv(s, Time(1), *m, out);
+  Message_pool::release(m);
+  if (not ok or s.state != FSM_switch::ESTABLISHED)
+    return fail("switch did not reach ESTABLISHED state");
+  if (q.buffers.size() != 1 or q.buffers[0][1] != FEATURE_RES)
+    return fail("feature reply was not queued");
+
+  // Replies queued by the agent are passed on to the sink.
+  Message br(1, Barrier_req::Tag());
+  ok = recv(s, Time(2), br, out);
+  if (not ok or q.buffers.size() != 2 or q.buffers[1][1] != BARRIER_RES)
+    return fail("barrier reply was not queued");
+  if (not a.tx_queue.empty())
+    return fail("agent queue was not flushed");
+
+  // Once the pool is warm, answering echo requests makes no new messages,
+  // and leaves none alive.
+  Message er(2, Echo_req::Tag());
+  if (not recv(s, Time(2), er, out))
+    return fail("echo request was refused");
+  Object_pool_stats before = Message_pool::stats();
+  for (int i = 0; i < 100; ++i) {
+    if (not recv(s, Time(2), er, out))
+      return fail("echo request was refused");
+  }
+  const Object_pool_stats& after = Message_pool::stats();
+  if (after.misses != before.misses or after.hits != before.hits + 100)
+    return fail("echo replies were not made from the pool");
+  if (after.live != 0)
+    return fail("echo replies were left alive");
+  if (q.buffers.size() != 103 or out.failures != 0)
+    return fail("echo replies were not queued");
+
+  // The echo timer sends a request through the sink, once the wheel has
+  // been advanced past it, as the reactor would.
+  advance(wheel, Time(6, 1));
+  ok = time(s, Time(6, 1), out);
+  if (not ok or q.buffers.size() != 104 or q.buffers[103][1] != ECHO_REQ)
+    return fail("echo timer did not send a request");
+
+  // The State_result forms collect the same messages.
+  ofp::State_result r = recv(s, Time(6), er);
+  if (not r.first or r.second.size() != 1)
+    return fail("State_result did not collect the reply");
+
+  // A sink bound to the operations of 1.3 encodes the same replies.
+  Output_sink bound(q, encoder(4, 0), releaser(4, 0));
+  auto live = Message_pool::stats().live;
+  ok = recv(s, Time(6), er, bound);
+  if (not ok or q.buffers.size() != 105)
+    return fail("bound sink did not queue the reply");
+  if (q.buffers[104][1] != q.buffers[102][1]
+      or q.buffers[104].size() != q.buffers[102].size())
+    return fail("bound sink encoded a different reply");
+  if (Message_pool::stats().live != live)
+    return fail("bound sink did not release the reply");
+}
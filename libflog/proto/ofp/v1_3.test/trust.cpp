@@ -0,0 +1,103 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <iostream>
+
+#include <libflog/proto/ofp/v1_3/message.hpp>
+
+using namespace flog;
+using namespace flog::ofp;
+using namespace flog::ofp::v1_3;
+
+// A Flow_mod matching on the ingress port and ethertype, with an
+// Apply_actions instruction holding an output and a set_field action.
+const Byte flow_mod[] = {
+  0x04, 0x0e, 0x00, 0x70, 0x00, 0x00, 0x00, 0x01, // header
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, // cookie
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // cookie mask
+  0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x80, 0x00, // table, command, ...
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, // buffer id, out port
+  0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, // out group, flags
+  0x00, 0x01, 0x00, 0x12,                         // match
+  0x80, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x07, // in_port
+  0x80, 0x00, 0x0a, 0x02, 0x08, 0x00,             // eth_type
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,             // match padding
+  0x00, 0x04, 0x00, 0x28, 0x00, 0x00, 0x00, 0x00, // apply actions
+  0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x02, // output
+  0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x19, 0x00, 0x10, 0x80, 0x00, 0x0a, 0x02, // set_field eth_type
+  0x86, 0xdd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// A Barrier_req followed by 4 bytes within its length.
+const Byte barrier[] = {
+  0x04, 0x14, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x02,
+  0x00, 0x00, 0x00, 0x00
+};
+
+// Decode buf at the trust level t.
+bool
+decode(Buffer& buf, Message& m, Trust_level t)
+{
+  Trust_scope scope(t);
+  Buffer_view v(buf);
+  return from_buffer(v, m) and remaining(v) == 0;
+}
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+int main()
+{
+  Buffer fm(std::begin(flow_mod), std::end(flow_mod));
+  Message m;
+  if (not decode(fm, m, FULL_VALIDATION))
+    return fail("flow mod was refused by full validation");
+  if (not decode(fm, m, STRUCTURAL_VALIDATION))
+    return fail("flow mod was refused by structural validation");
+  if (not decode(fm, m, NO_VALIDATION))
+    return fail("flow mod was refused without validation");
+  if (trust_level() != STRUCTURAL_VALIDATION)
+    return fail("trust level was not restored");
+
+  // A bad command is only rejected by full validation.
+  Buffer bad = fm;
+  bad[25] = 0x09;
+  if (not decode(bad, m, STRUCTURAL_VALIDATION) or is_valid(m))
+    return fail("bad command was refused by structural validation");
+  if (decode(bad, m, FULL_VALIDATION))
+    return fail("bad command was accepted by full validation");
+
+  // So is a field whose prerequisites are not met: the ethertype is
+  // replaced by a TCP source port.
+  Buffer prereq = fm;
+  const Byte tcp_src[] = { 0x80, 0x00, 0x1a, 0x02, 0x00, 0x50 };
+  std::copy(std::begin(tcp_src), std::end(tcp_src), prereq.begin() + 60);
+  if (not decode(prereq, m, STRUCTURAL_VALIDATION) or is_valid(m))
+    return fail("missing prerequisite was refused by structural validation");
+  if (decode(prereq, m, FULL_VALIDATION))
+    return fail("missing prerequisite was accepted by full validation");
+
+  // Bytes following the contents of a message are skipped only when the
+  // message is trusted.
+  Buffer br(std::begin(barrier), std::end(barrier));
+  if (decode(br, m, STRUCTURAL_VALIDATION))
+    return fail("trailing bytes were accepted by structural validation");
+  if (not decode(br, m, NO_VALIDATION) or m.header.type != BARRIER_REQ)
+    return fail("trailing bytes were refused without validation");
+}
@@ -0,0 +1,246 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <iostream>
+
+#include <libflog/proto/ofp/v1_3/view.hpp>
+
+using namespace flog;
+using namespace flog::ofp::v1_3;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+// A Packet_in whose match has the ingress port 7 and an IPv4 ethertype,
+// followed by 14 bytes of packet data.
+const Byte packet_in[] = {
+  0x04, 0x0a, 0x00, 0x40, 0x00, 0x00, 0x00, 0x2a, // header
+  0xff, 0xff, 0xff, 0xff, 0x00, 0x0e, 0x00, 0x03, // buffer id, length, ...
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, // cookie
+  0x00, 0x01, 0x00, 0x12,                         // match
+  0x80, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x07, // in_port
+  0x80, 0x00, 0x0a, 0x02, 0x08, 0x00,             // eth_type
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,             // match padding
+  0x00, 0x00,                                     // padding
+  0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, // data
+  0x09, 0x0a, 0x0b, 0x0c, 0x08, 0x00
+};
+
+// A Packet_out with two output actions and 4 bytes of packet data.
+const Byte packet_out[] = {
+  0x04, 0x0d, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x2b, // header
+  0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01, // buffer id, in_port
+  0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // actions length
+  0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x02, // output
+  0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x10, 0xff, 0xff, 0xff, 0xfd, // output
+  0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0xde, 0xad, 0xbe, 0xef                          // data
+};
+
+// A Flow_mod whose match has the ingress port 7 and a masked IPv4 source,
+// with goto table, write metadata, apply actions and meter instructions.
+const Byte flow_mod[] = {
+  0x04, 0x0e, 0x00, 0x88, 0x00, 0x00, 0x00, 0x2c, // header
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, // cookie
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, // cookie mask
+  0x01, 0x00, 0x00, 0x0a, 0x00, 0x1e, 0x80, 0x00, // table, command, ...
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, // buffer id, out port
+  0xff, 0xff, 0xff, 0xff, 0x00, 0x01, 0x00, 0x00, // out group, flags
+  0x00, 0x01, 0x00, 0x18,                         // match
+  0x80, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x07, // in_port
+  0x80, 0x00, 0x17, 0x08, 0x0a, 0x00, 0x00, 0x01, // ipv4_src/mask
+  0xff, 0xff, 0xff, 0x00,
+  0x00, 0x01, 0x00, 0x08, 0x02, 0x00, 0x00, 0x00, // goto table
+  0x00, 0x02, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, // write metadata
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0x00, 0x04, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, // apply actions
+  0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x02, // output
+  0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x06, 0x00, 0x08, 0x00, 0x00, 0x00, 0x09  // meter
+};
+
+Buffer
+make_buffer(const Byte* first, const Byte* last)
+{
+  return Buffer(first, last);
+}
+
+int main()
+{
+  // Fields of a Packet_in are read from the wire.
+  {
+    Buffer buf = make_buffer(std::begin(packet_in), std::end(packet_in));
+    Buffer_view v(buf);
+    Packet_in_view pi;
+    if (not from_buffer(v, pi) or remaining(v) != 0)
+      return fail("packet in view was not bound");
+
+    if (pi.xid() != 42 or pi.buffer_id() != 0xffffffff
+        or pi.total_len() != 14 or pi.reason() != Packet_in::NO_MATCH
+        or pi.tbl_id() != 3 or pi.cookie() != 9)
+      return fail("fields of the packet in were not read");
+
+    Match_view m = pi.match();
+    if (m.type() != Match::MT_OXM or bytes(m) != 24
+        or std::distance(m.begin(), m.end()) != 2)
+      return fail("match of the packet in was not read");
+
+    auto i = find(m, OXM_EF_IN_PORT);
+    if (i == m.end() or (*i).value<uint32_t>() != 7)
+      return fail("ingress port was not found");
+    auto j = find(m, OXM_EF_ETH_TYPE);
+    if (j == m.end() or (*j).value<uint16_t>() != 0x0800)
+      return fail("ethertype was not found");
+    if (find(m, OXM_EF_IPV4_SRC) != m.end())
+      return fail("missing field was found");
+
+    Buffer_ref data = pi.data();
+    if (not data.borrowed() or data.size() != 14
+        or data.data() != buf.data() + 50 or data[0] != 1)
+      return fail("data does not refer to the packet in");
+
+    // The view agrees with the decoded message.
+    Message msg;
+    Buffer_view w(buf);
+    if (not from_buffer(w, msg))
+      return fail("packet in was not decoded");
+    const Packet_in& x = msg.payload.data.packet_in;
+    if (x.buffer_id != pi.buffer_id() or x.cookie != pi.cookie()
+        or x.match.rules.size() != 2 or x.data != data)
+      return fail("view does not agree with the decoded message");
+  }
+
+  // Actions of a Packet_out are visited in order.
+  {
+    Buffer buf = make_buffer(std::begin(packet_out), std::end(packet_out));
+    Buffer_view v(buf);
+    Packet_out_view po;
+    if (not from_buffer(v, po))
+      return fail("packet out view was not bound");
+    if (po.xid() != 43 or po.in_port() != 1 or po.actions_len() != 32)
+      return fail("fields of the packet out were not read");
+
+    uint32_t ports[2];
+    int n = 0;
+    for (Action_view a : po.actions()) {
+      if (n == 2 or a.type() != ACTION_OUTPUT or bytes(a) != 16)
+        return fail("action was not an output");
+      ports[n++] = ofp::load<uint32_t>(a.payload());
+    }
+    if (n != 2 or ports[0] != 2 or ports[1] != 0xfffffffd
+        or size(po.actions()) != 2)
+      return fail("actions were not visited in order");
+    if (po.data().size() != 4 or po.data()[0] != 0xde)
+      return fail("data of the packet out was not read");
+  }
+
+  // Fields, match and instructions of a Flow_mod are read from the wire.
+  {
+    Buffer buf = make_buffer(std::begin(flow_mod), std::end(flow_mod));
+    Buffer_view v(buf);
+    Flow_mod_view fm;
+    if (not from_buffer(v, fm) or remaining(v) != 0)
+      return fail("flow mod view was not bound");
+
+    if (fm.xid() != 44 or fm.cookie() != 0x11
+        or fm.cookie_mask() != 0xffffffffffffffff or fm.table_id() != 1
+        or fm.command() != Flow_mod::ADD or fm.idle_timeout() != 10
+        or fm.hard_timeout() != 30 or fm.priority() != 0x8000
+        or fm.buffer_id() != 0xffffffff or fm.out_port() != 0xffffffff
+        or fm.out_group() != 0xffffffff or fm.flags() != 1)
+      return fail("fields of the flow mod were not read");
+
+    // A masked entry is found by the field it matches.
+    Match_view m = fm.match();
+    auto i = find(m, OXM_EF_IPV4_SRC);
+    if (i == m.end() or not (*i).has_mask()
+        or (*i).value<uint32_t>() != 0x0a000001
+        or ofp::load<uint32_t>((*i).payload() + 4) != 0xffffff00)
+      return fail("masked ipv4 source was not found");
+    if (find(m, OXM_EF_IPV4_SRC_MASK) != i)
+      return fail("masked field did not find the same entry");
+    auto j = find(m, OXM_EF_IN_PORT);
+    if (j == m.end() or (*j).has_mask() or (*j).value<uint32_t>() != 7)
+      return fail("ingress port was not found");
+
+    Instruction_sequence_view is = fm.instructions();
+    if (size(is) != 4 or bytes(is) != 64)
+      return fail("instructions were not read");
+    auto k = is.begin();
+    if ((*k).type() != INSTRUCTION_GOTO_TABLE or (*k).table_id() != 2)
+      return fail("goto table was not read");
+    ++k;
+    if ((*k).type() != INSTRUCTION_WRITE_METADATA or (*k).metadata() != 5
+        or (*k).metadata_mask() != 0xffffffffffffffff)
+      return fail("write metadata was not read");
+    ++k;
+    if ((*k).type() != INSTRUCTION_APPLY_ACTIONS or size((*k).actions()) != 1
+        or (*(*k).actions().begin()).type() != ACTION_OUTPUT)
+      return fail("apply actions was not read");
+    ++k;
+    if ((*k).type() != INSTRUCTION_METER or (*k).meter_id() != 9)
+      return fail("meter was not read");
+
+    // The view agrees with the decoded message.
+    Message msg;
+    Buffer_view w(buf);
+    if (not from_buffer(w, msg))
+      return fail("flow mod was not decoded");
+    const Flow_mod& x = msg.payload.data.flow_mod;
+    if (x.cookie != fm.cookie() or x.priority != fm.priority()
+        or x.match.rules.size() != 2 or x.instructions.size() != 4)
+      return fail("view does not agree with the decoded message");
+  }
+
+  // Framing errors are caught when the view is bound.
+  {
+    Buffer buf = make_buffer(std::begin(packet_in), std::end(packet_in));
+    buf[27] = 0x40; // the match overruns the message
+    Buffer_view v(buf);
+    Packet_in_view pi;
+    if (from_buffer(v, pi))
+      return fail("overrunning match was bound");
+
+    Buffer short_buf = make_buffer(packet_in, packet_in + 30);
+    Buffer_view s(short_buf);
+    if (from_buffer(s, pi).code != AVAILABLE_PAYLOAD)
+      return fail("short packet in was bound");
+
+    Buffer out = make_buffer(std::begin(packet_out), std::end(packet_out));
+    out[27] = 0x30; // the first action overruns the action list
+    Buffer_view o(out);
+    Packet_out_view po;
+    if (from_buffer(o, po))
+      return fail("overrunning action was bound");
+
+    Buffer fm_buf = make_buffer(std::begin(flow_mod), std::end(flow_mod));
+    fm_buf[83] = 0x10; // the write metadata instruction is too short
+    Buffer_view f(fm_buf);
+    Flow_mod_view fm;
+    if (from_buffer(f, fm).code != BAD_INSTRUCTION_LENGTH)
+      return fail("short instruction was bound");
+
+    Buffer fa_buf = make_buffer(std::begin(flow_mod), std::end(flow_mod));
+    fa_buf[115] = 0x18; // the output overruns the apply actions
+    Buffer_view g(fa_buf);
+    if (from_buffer(g, fm).code != AVAILABLE_ACTION_PAYLOAD)
+      return fail("overrunning action of an instruction was bound");
+  }
+}
@@ -0,0 +1,295 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include "encoder.hpp"
+
+namespace flog {
+namespace ofp {
+namespace v1_3 {
+
+namespace {
+
+// Back-patch the 16-bit length at offset n + 2 of an object starting at
+// offset n, which is the layout of most variable-length objects.
+inline void
+patch_length(Encoder& e, std::size_t n)
+{
+  e.patch(n + 2, uint16_t(e.offset() - n));
+}
+
+// -------------------------------------------------------------------------- //
+// Match
+
+Error_condition
+encode(Encoder& e, const OXM_entry& x)
+{
+  e.put(x.header.oxm_class);
+  e.put(x.header.field);
+  e.put(uint8_t(0));
+  std::size_t start = e.offset();
+
+  Error_condition err;
+  if (x.header.oxm_class == OXM_entry_class::OXM_EXPERIMENTER)
+    err = e.write(x.experimenter);
+  else
+    err = e.write(x.payload, x.header.field);
+
+  e.patch(start - 1, uint8_t(e.offset() - start));
+  return err;
+}
+
+Error_condition
+encode(Encoder& e, const Match& m)
+{
+  std::size_t start = e.offset();
+  e.put(m.type);
+  e.put(uint16_t(0));
+  for (const OXM_entry& x : m.rules) {
+    if (Error_decl err = encode(e, x))
+      return err;
+  }
+
+  // The length excludes the padding.
+  patch_length(e, start);
+  e.align(start, 8);
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Actions
+
+Error_condition
+encode(Encoder& e, const Action& a)
+{
+  std::size_t start = e.offset();
+  e.put(a.header.type);
+  e.put(uint16_t(0));
+  if (a.header.type == ACTION_EXPERIMENTER)
+    e.put(a.header.experimenter);
+
+  if (a.header.type == ACTION_SET_FIELD) {
+    if (Error_decl err = encode(e, a.payload.data.set_field.oxm))
+      return err;
+    e.align(start, 8);
+  } else {
+    if (Error_decl err = e.write(a.payload, a.header.type))
+      return err;
+  }
+
+  patch_length(e, start);
+  return SUCCESS;
+}
+
+// Encode the actions of a Packet_out, instruction or bucket.
+template<typename S>
+  Error_condition
+  encode_actions(Encoder& e, const S& s)
+  {
+    for (const Action& a : s) {
+      if (Error_decl err = encode(e, a))
+        return err;
+    }
+    return SUCCESS;
+  }
+
+// -------------------------------------------------------------------------- //
+// Instructions
+
+Error_condition
+encode(Encoder& e, const Instruction& i)
+{
+  std::size_t start = e.offset();
+  e.put(i.header.type);
+  e.put(uint16_t(0));
+  if (i.header.type == INSTRUCTION_EXPERIMENTER)
+    e.put(i.header.experimenter_id);
+
+  Error_condition err;
+  switch (i.header.type) {
+  case INSTRUCTION_WRITE_ACTIONS:
+    e.pad(4);
+    err = encode_actions(e, i.payload.data.write_actions.actions);
+    break;
+  case INSTRUCTION_APPLY_ACTIONS:
+    e.pad(4);
+    err = encode_actions(e, i.payload.data.apply_actions.actions);
+    break;
+  case INSTRUCTION_CLEAR_ACTIONS:
+    e.pad(4);
+    err = encode_actions(e, i.payload.data.clear_actions.actions);
+    break;
+  default:
+    err = e.write(i.payload, i.header.type);
+    break;
+  }
+
+  patch_length(e, start);
+  return err;
+}
+
+// -------------------------------------------------------------------------- //
+// Messages
+
+Error_condition
+encode(Encoder& e, const Packet_in& pi)
+{
+  e.put(pi.buffer_id);
+  e.put(pi.total_len);
+  e.put(pi.reason);
+  e.put(pi.tbl_id);
+  e.put(pi.cookie);
+  if (Error_decl err = encode(e, pi.match))
+    return err;
+  e.pad(2);
+  return e.write(pi.data);
+}
+
+Error_condition
+encode(Encoder& e, const Flow_removed& fr)
+{
+  e.put(fr.cookie);
+  e.put(fr.priority);
+  e.put(fr.reason);
+  e.put(fr.table_id);
+  e.put(fr.duration_sec);
+  e.put(fr.duration_nsec);
+  e.put(fr.idle_timeout);
+  e.put(fr.hard_timeout);
+  e.put(fr.packet_count);
+  e.put(fr.byte_count);
+  return encode(e, fr.match);
+}
+
+Error_condition
+encode(Encoder& e, const Packet_out& po)
+{
+  e.put(po.buffer_id);
+  e.put(po.in_port);
+  std::size_t len = e.offset();
+  e.put(uint16_t(0));
+  e.pad(6);
+
+  std::size_t start = e.offset();
+  if (Error_decl err = encode_actions(e, po.actions))
+    return err;
+  e.patch(len, uint16_t(e.offset() - start));
+
+  return e.write(po.data);
+}
+
+Error_condition
+encode(Encoder& e, const Flow_mod& fm)
+{
+  e.put(fm.cookie);
+  e.put(fm.cookie_mask);
+  e.put(fm.table_id);
+  e.put(fm.command);
+  e.put(fm.idle_timeout);
+  e.put(fm.hard_timeout);
+  e.put(fm.priority);
+  e.put(fm.buffer_id);
+  e.put(fm.out_port);
+  e.put(fm.out_group);
+  e.put(fm.flags);
+  e.pad(2);
+
+  if (Error_decl err = encode(e, fm.match))
+    return err;
+  for (const Instruction& i : fm.instructions) {
+    if (Error_decl err = encode(e, i))
+      return err;
+  }
+  return SUCCESS;
+}
+
+Error_condition
+encode(Encoder& e, const Bucket& b)
+{
+  std::size_t start = e.offset();
+  e.put(uint16_t(0));
+  e.put(b.weight);
+  e.put(b.watch_port);
+  e.put(b.watch_group);
+  e.pad(4);
+  if (Error_decl err = encode_actions(e, b.actions))
+    return err;
+
+  // The bucket length is its first field.
+  e.patch(start, uint16_t(e.offset() - start));
+  return SUCCESS;
+}
+
+Error_condition
+encode(Encoder& e, const Group_mod& gm)
+{
+  e.put(gm.command);
+  e.put(gm.type);
+  e.pad(1);
+  e.put(gm.group_id);
+  for (const Bucket& b : gm.buckets) {
+    if (Error_decl err = encode(e, b))
+      return err;
+  }
+  return SUCCESS;
+}
+
+Error_condition
+encode(Encoder& e, const Payload& p, Message_type t)
+{
+  switch (t) {
+  case PACKET_IN: return encode(e, p.data.packet_in);
+  case FLOW_REMOVED: return encode(e, p.data.flow_removed);
+  case PACKET_OUT: return encode(e, p.data.packet_out);
+  case FLOW_MOD: return encode(e, p.data.flow_mod);
+  case GROUP_MOD: return encode(e, p.data.group_mod);
+  default: return e.write(p, t);
+  }
+}
+
+} // namespace
+
+// -------------------------------------------------------------------------- //
+// Message
+
+Error_condition
+encode(Encoder& e, const Message& m)
+{
+  std::size_t start = e.offset();
+  e.put(m.header.version);
+  e.put(m.header.type);
+  e.put(uint16_t(0));
+  e.put(m.header.xid);
+
+  if (Error_decl err = encode(e, m.payload, m.header.type))
+    return err;
+
+  std::size_t n = e.offset() - start;
+  if (n > 0xffff)
+    return BAD_MESSAGE_LENGTH;
+  patch_length(e, start);
+  return SUCCESS;
+}
+
+Error_condition
+encode(Buffer& b, const Message& m)
+{
+  Encoder e(b);
+  Error_condition err = encode(e, m);
+  e.finish();
+  return err;
+}
+
+} // namespace v1_3
+} // namespace ofp
+} // namespace flog
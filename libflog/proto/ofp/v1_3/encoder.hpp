@@ -0,0 +1,50 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_PROTO_OFP_V1_3_ENCODER_H
+#define FLOWGRAMMABLE_PROTO_OFP_V1_3_ENCODER_H
+
+#include <libflog/proto/ofp/encoder.hpp>
+#include <libflog/proto/ofp/v1_3/message.hpp>
+
+/// \file encoder.hpp
+/// Single-pass encoding of OpenFlow v1.3 messages.
+///
+/// These functions write a message in one traversal of its object tree.
+/// The lengths of the message header, matches, OXM entries, actions,
+/// instructions, buckets and the actions of a Packet_out are computed
+/// from the bytes actually written and back-patched, so the length fields
+/// stored in the message are ignored. Payloads without nested sequences
+/// are written through their to_buffer() operations.
+
+namespace flog {
+namespace ofp {
+namespace v1_3 {
+
+/// Appends the encoding of m to the encoder's output.
+///
+/// \relates Message
+Error_condition encode(Encoder& e, const Message& m);
+
+/// Appends the encoding of m to the buffer b. If an error occurs, the
+/// contents of b past its original size are unspecified.
+///
+/// \relates Message
+Error_condition encode(Buffer& b, const Message& m);
+
+} // namespace v1_3
+} // namespace ofp
+} // namespace flog
+
+#endif
@@ -88,7 +88,7 @@ to_buffer(Buffer_view& v, const Hello& h)
 Error_condition
 from_buffer(Buffer_view& v, Hello& h)
 {
-  if (not available(v, bytes(h)))
+  if (not available(v, min_bytes<Hello>()))
     return AVAILABLE_HELLO;
   from_buffer(v, h.data);
   return SUCCESS;
@@ -126,7 +126,7 @@ to_buffer(Buffer_view& v, const Error& e)
 Error_condition
 from_buffer(Buffer_view& v, Error& e)
 {
-  if (not available(v, bytes(e)))
+  if (not available(v, min_bytes<Error>()))
     return AVAILABLE_ERROR;
   from_buffer(v, e.type);
   from_buffer(v, e.code);
@@ -442,7 +442,7 @@ to_buffer(Buffer_view& v, const Experimenter& e)
 Error_condition
 from_buffer(Buffer_view& v, Experimenter& e)
 {
-  if (not available(v, bytes(e)))
+  if (not available(v, min_bytes<Experimenter>()))
     return AVAILABLE_EXPERIMENTER;
   from_buffer(v, e.experimenter_id);
   from_buffer(v, e.experimenter_type);
@@ -1448,7 +1448,7 @@ to_buffer(Buffer_view& v, const OXM_entry_ipv6_exthdr& ie)
 Error_condition
 from_buffer(Buffer_view& v, OXM_entry_ipv6_exthdr& ie)
 {
-  if (not available(v, bytes(ie)))
+  if (not available(v, min_bytes<OXM_entry_ipv6_exthdr>()))
     return AVAILABLE_OXM_ENTRY_IPV6_EXTHDR;
   from_buffer(v, ie.flag);
   return SUCCESS;
@@ -1482,7 +1482,7 @@ to_buffer(Buffer_view& v, const OXM_entry_ipv6_exthdr_mask& iem)
 Error_condition
 from_buffer(Buffer_view& v, OXM_entry_ipv6_exthdr_mask& iem)
 {
-  if (not available(v, bytes(iem)))
+  if (not available(v, min_bytes<OXM_entry_ipv6_exthdr_mask>()))
     return AVAILABLE_OXM_ENTRY_IPV6_EXTHDR_MASK;
   from_buffer(v, iem.flag);
   from_buffer(v, iem.mask);
@@ -2328,7 +2328,7 @@ is_valid(const OXM_entry_payload& p, OXM_entry_field f)
 }
 
 // Bytes
-inline std::size_t
+std::size_t
 bytes(const OXM_entry_payload& p, OXM_entry_field f)
 {
   if (not p)
@@ -2610,7 +2610,7 @@ to_buffer(Buffer_view& v, const OXM_experimenter& e)
 Error_condition
 from_buffer(Buffer_view& v, OXM_experimenter& e)
 {
-  if (not available(v, bytes(e)))
+  if (not available(v, min_bytes<OXM_experimenter>()))
     return AVAILABLE_OXM_EXPERIMENTER;
   from_buffer(v, e.experimenter);
   return SUCCESS;
@@ -2660,17 +2660,16 @@ to_buffer(Buffer_view& v, const OXM_entry& e)
 Error_condition
 from_buffer(Buffer_view& v, OXM_entry& e)
 {
-  if (not available(v, bytes(e)))
+  OXM_entry::Header h;
+  if (not available(v, min_bytes<OXM_entry>()))
     return AVAILABLE_OXM_ENTRY_HEADER;
 
-  if (Error_decl err = from_buffer(v, e.header))
+  if (Error_decl err = from_buffer(v, h))
     return err;
 
-  if (e.header.oxm_class != OXM_entry_class::OXM_EXPERIMENTER) {
-    OXM_entry::Payload p;
-    construct(p, e.header.field);
-    assign(e.payload, std::move(p), e.header.field);
-  }
+  if (h.oxm_class != OXM_entry_class::OXM_EXPERIMENTER)
+    emplace(e.payload, e.header.field, h.field);
+  e.header = h;
   //else
   //  e.experimenter = OXM_experimenter;
 
@@ -2693,9 +2692,11 @@ from_buffer(Buffer_view& v, OXM_entry& e)
       return err;
   }
   
-  if(not update(v, c))
+  if(not update_trusted(v, c))
     return EXCESS_OXM;
-  
+
+  if (trust_level() == FULL_VALIDATION)
+    return is_valid(e);
   return SUCCESS;
 }
 
@@ -2753,15 +2754,22 @@ to_buffer(Buffer_view& v, const Match& m)
 Error_condition
 from_buffer(Buffer_view& v, Match& m)
 {
-  if (not available(v, bytes(m)))
+  if (not available(v, min_bytes<Match>()))
     return AVAILABLE_MATCH;
 
   from_buffer(v, m.type);
   from_buffer(v, m.length);
 //  pad(v,4); //in wiki but not in spec
 
+  bool full = trust_level() == FULL_VALIDATION;
+  if (full) {
+    if (Error_decl err = is_valid(m.type))
+      return err;
+  }
+
   std::size_t n = m.length - 4;
   if (n == 0) {
+    m.rules.clear();
     pad(v,4);
     return SUCCESS;
   }
@@ -2772,9 +2780,15 @@ from_buffer(Buffer_view& v, Match& m)
   if (Error_decl err = from_buffer(c, m.rules))
     return err;
 //  return update(v, c);
-  if (not update(v, c))
+  if (not update_trusted(v, c))
     return EXCESS_MATCH;
 
+  // The entries were checked as they were read.
+  if (full) {
+    if (Error_decl err = check_prerequisites(m.rules))
+      return err;
+  }
+
   uint8_t padding = 8 - (m.length % 8);
   if (padding == 8)
     return SUCCESS;
@@ -2824,28 +2838,6 @@ to_string(Action_type t)
 // -------------------------------------------------------------------------- //
 // Action: Output
 
-Error_condition
-to_buffer(Buffer_view& v, const Action_output& ao)
-{
-  if (not available(v, bytes(ao)))
-    return AVAILABLE_ACTION_OUTPUT;
-  to_buffer(v, ao.port);
-  to_buffer(v, ao.max_len);
-  pad(v, 6);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Action_output& ao)
-{
-  if (not available(v, bytes(ao)))
-    return AVAILABLE_ACTION_OUTPUT;
-  from_buffer(v, ao.port);
-  from_buffer(v, ao.max_len);
-  pad(v, 6);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Action_output& ao, Formatter& f)
 {
@@ -2860,45 +2852,9 @@ to_string(const Action_output& ao, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Action: Copy ttl out
 
-Error_condition
-to_buffer(Buffer_view& v, const Action_copy_ttl_out& acto)
-{
-  if (not available(v, bytes(acto)))
-    return AVAILABLE_ACTION_COPY_TTL_OUT;
-  pad(v, 4);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Action_copy_ttl_out& acto)
-{
-  if (not available(v, bytes(acto)))
-    return AVAILABLE_ACTION_COPY_TTL_OUT;
-  pad(v, 4);
-  return SUCCESS;
-}
-
 // -------------------------------------------------------------------------- //
 // Action: Copy ttl in
 
-Error_condition
-to_buffer(Buffer_view& v, const Action_copy_ttl_in& acti)
-{
-  if (not available(v, bytes(acti)))
-    return AVAILABLE_ACTION_COPY_TTL_IN;
-  pad(v, 4);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Action_copy_ttl_in& acti)
-{
-  if (not available(v, bytes(acti)))
-    return AVAILABLE_ACTION_COPY_TTL_IN;
-  pad(v, 4);
-  return SUCCESS;
-}
-
 // -------------------------------------------------------------------------- //
 // Action: Set mpls ttl
 
@@ -2990,45 +2946,9 @@ to_string(const Action_set_queue& asq, Formatter& f)
   return ss.str();
 }
 
-Error_condition
-to_buffer(Buffer_view& v, const Action_set_queue& asq)
-{
-  if (not available(v, bytes(asq)))
-    return AVAILABLE_ACTION_SET_QUEUE;
-  to_buffer(v, asq.queue_id);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Action_set_queue& asq)
-{
-  if (not available(v, bytes(asq)))
-    return AVAILABLE_ACTION_SET_QUEUE;
-  from_buffer(v, asq.queue_id);
-  return SUCCESS;
-}
-
 // -------------------------------------------------------------------------- //
 // Action: Group
 
-Error_condition
-to_buffer(Buffer_view& v, const Action_group& ag)
-{
-  if (not available(v, bytes(ag)))
-    return AVAILABLE_ACTION_GROUP;
-  to_buffer(v, ag.group_id);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Action_group& ag)
-{
-  if (not available(v, bytes(ag)))
-    return AVAILABLE_ACTION_GROUP;
-  from_buffer(v, ag.group_id);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Action_group& ag, Formatter& f)
 {
@@ -3089,7 +3009,7 @@ to_buffer(Buffer_view& v, const Action_set_field& sf)
 Error_condition
 from_buffer(Buffer_view& v, Action_set_field& sf)
 {
-  if (not available(v, bytes(sf)))
+  if (not available(v, min_bytes<Action_set_field>()))
     return AVAILABLE_ACTION_SET_FIELD;
 
   if(Error_decl err = from_buffer(v, sf.oxm))
@@ -3132,24 +3052,6 @@ to_string(const Action_push_pbb& app, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Action: Pop PBB
 
-Error_condition
-to_buffer(Buffer_view& v, const Action_pop_pbb& app)
-{
-  if (not available(v, bytes(app)))
-    return AVAILABLE_ACTION_POP_PBB;
-  pad(v, 4);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Action_pop_pbb& app)
-{
-  if (not available(v, bytes(app)))
-    return AVAILABLE_ACTION_POP_PBB;
-  pad(v, 4);
-  return SUCCESS;
-}
-
 // -------------------------------------------------------------------------- //
 // Action: Experimenter
 
@@ -3178,7 +3080,7 @@ to_buffer(Buffer_view& v, const Action_experimenter& ae)
 Error_condition
 from_buffer(Buffer_view& v, Action_experimenter& ae)
 {
-  if (not available(v, bytes(ae)))
+  if (not available(v, min_bytes<Action_experimenter>()))
     return false;
 
   from_buffer(v, ae.experimenter);
@@ -3316,6 +3218,31 @@ assign(Action_payload& a, const Action_payload& b, Action_type t)
   return a;
 }
 
+void
+destroy(Action_payload& p, Action_type t)
+{
+  switch (t) {
+  case ACTION_OUTPUT: p.data.output.~Action_output(); break;
+  case ACTION_COPY_TTL_OUT: p.data.copy_ttl_out.~Action_copy_ttl_out(); break;
+  case ACTION_COPY_TTL_IN: p.data.copy_ttl_in.~Action_copy_ttl_in(); break;
+  case ACTION_SET_MPLS_TTL: p.data.set_mpls_ttl.~Action_set_mpls_ttl(); break;
+  case ACTION_DEC_MPLS_TTL: p.data.dec_mpls_ttl.~Action_dec_mpls_ttl(); break;
+  case ACTION_PUSH_VLAN: p.data.push_vlan.~Action_push_vlan(); break;
+  case ACTION_POP_VLAN: p.data.pop_vlan.~Action_pop_vlan(); break;
+  case ACTION_PUSH_MPLS: p.data.push_mpls.~Action_push_mpls(); break;
+  case ACTION_POP_MPLS: p.data.pop_mpls.~Action_pop_mpls(); break;
+  case ACTION_SET_QUEUE: p.data.set_queue.~Action_set_queue(); break;
+  case ACTION_GROUP: p.data.group.~Action_group(); break;
+  case ACTION_SET_NW_TTL: p.data.set_nw_ttl.~Action_set_nw_ttl(); break;
+  case ACTION_DEC_NW_TTL: p.data.dec_nw_ttl.~Action_dec_nw_ttl(); break;
+  case ACTION_SET_FIELD: p.data.set_field.~Action_set_field(); break;
+  case ACTION_PUSH_PBB: p.data.push_pbb.~Action_push_pbb(); break;
+  case ACTION_POP_PBB: p.data.pop_pbb.~Action_pop_pbb(); break;
+  case ACTION_EXPERIMENTER: p.data.experimenter.~Action_experimenter(); break;
+  default: return;
+  }
+}
+
 bool
 equal(const Action_payload& a, const Action_payload& b,
               Action_type t1, Action_type t2)
@@ -3544,19 +3471,19 @@ to_buffer(Buffer_view& v, const Action& a)
 Error_condition
 from_buffer(Buffer_view& v, Action& a)
 {
-  if (not available(v, bytes(a.header)))
+  Action::Header h = a.header;
+  if (not available(v, bytes(h)))
     return AVAILABLE_ACTION_HEADER;
-  from_buffer(v, a.header);
+  from_buffer(v, h);
 
-  if (a.header.length < bytes(a.header))
+  if (h.length < bytes(h))
     return BAD_ACTION_LENGTH;
 
-  if (Error_decl err = is_valid(a.header.type))
+  if (Error_decl err = is_valid(h.type))
     return err;
 
-  Action::Payload p;
-  construct(p, a.header.type);
-  assign(a.payload, std::move(p), a.header.type);
+  emplace(a.payload, a.header.type, h.type);
+  a.header = h;
 
   std::size_t n = a.header.length - bytes(a.header);
   if (remaining(v) < n)
@@ -3566,7 +3493,7 @@ from_buffer(Buffer_view& v, Action& a)
   if (Error_decl err = from_buffer(c, a.payload, a.header.type))
     return err;
   
-  if(not update(v, c))
+  if(not update_trusted(v, c))
     return EXCESS_ACTION;
   
   return SUCCESS;
@@ -3606,26 +3533,6 @@ to_string(Instruction_type t)
 // -------------------------------------------------------------------------- //
 // Instruction: Goto table
 
-Error_condition
-to_buffer(Buffer_view& v, const Instruction_goto_table& igt)
-{
-  if (not available(v, bytes(igt)))
-    return AVAILABLE_INSTRUCTION_GOTO_TABLE;
-  to_buffer(v, igt.table_id);
-  pad(v, 3);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Instruction_goto_table& igt)
-{
-  if (not available(v, bytes(igt)))
-    return AVAILABLE_INSTRUCTION_GOTO_TABLE;
-  from_buffer(v, igt.table_id);
-  pad(v, 3);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Instruction_goto_table& igt, Formatter& f)
 {
@@ -3639,28 +3546,6 @@ to_string(const Instruction_goto_table& igt, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Instruction: Write metadata
 
-Error_condition
-to_buffer(Buffer_view& v, const Instruction_write_metadata& iwm)
-{
-  if (not available(v, bytes(iwm)))
-    return AVAILABLE_INSTRUCTION_WRITE_METADATA;
-  pad(v, 4);
-  to_buffer(v, iwm.metadata);
-  to_buffer(v, iwm.metadata_mask);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Instruction_write_metadata& iwm)
-{
-  if (not available(v, bytes(iwm)))
-    return AVAILABLE_INSTRUCTION_WRITE_METADATA;
-  pad(v, 4);
-  from_buffer(v, iwm.metadata);
-  from_buffer(v, iwm.metadata_mask);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Instruction_write_metadata& iwm, Formatter& f)
 {
@@ -3714,24 +3599,6 @@ to_string(const Instruction_clear_actions& ica, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Instruction: Meter
 
-Error_condition
-to_buffer(Buffer_view& v, const Instruction_meter& im)
-{
-  if (not available(v, bytes(im)))
-    return AVAILABLE_INSTRUCTION_METER;
-  to_buffer(v, im.meter_id);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Instruction_meter& im)
-{
-  if (not available(v, bytes(im)))
-    return AVAILABLE_INSTRUCTION_METER;
-  from_buffer(v, im.meter_id);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Instruction_meter& im, Formatter& f)
 {
@@ -3761,7 +3628,7 @@ to_buffer(Buffer_view& v, const Instruction_experimenter& ie)
 Error_condition
 from_buffer(Buffer_view& v, Instruction_experimenter& ie)
 {
-  if (not available(v, bytes(ie)))
+  if (not available(v, min_bytes<Instruction_experimenter>()))
     return false;
 
   from_buffer(v, ie.experimenter_id);
@@ -4143,22 +4010,25 @@ to_buffer(Buffer_view& v, const Instruction& i)
 Error_condition
 from_buffer(Buffer_view& v, Instruction& i)
 {
-  if (not available(v, bytes(i.header)))
+  Instruction::Header h = i.header;
+  if (not available(v, bytes(h)))
     return AVAILABLE_INSTRUCTION_HEADER;
-  from_buffer(v, i.header);
+  from_buffer(v, h);
   
-  if (i.header.length < bytes(i.header))
+  if (h.length < bytes(h))
     return BAD_INSTRUCTION_LENGTH;
 
-  if (Error_decl err = is_valid(i.header.type))
-    return err;
-  
-  if (Error_decl err = is_valid(i.header))
+  if (Error_decl err = is_valid(h.type))
     return err;
 
-  Instruction::Payload p;
-  construct(p, i.header.type);
-  assign(i.payload, std::move(p), i.header.type);
+  Trust_level t = trust_level();
+  if (t != NO_VALIDATION) {
+    if (Error_decl err = is_valid(h))
+      return err;
+  }
+
+  emplace(i.payload, i.header.type, h.type);
+  i.header = h;
 
   std::size_t n = i.header.length - bytes(i.header);
   if (remaining(v) < n)
@@ -4168,9 +4038,11 @@ from_buffer(Buffer_view& v, Instruction& i)
   if (Error_decl err = from_buffer(c, i.payload, i.header.type))
     return err;
   
-  if(not update(v, c))
+  if(not update_trusted(v, c))
     return EXCESS_INSTRUCTION;
-  
+
+  if (t == FULL_VALIDATION)
+    return is_valid(i);
   return SUCCESS;
 }
 
@@ -4189,50 +4061,6 @@ to_string(const Instruction& i, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Port
 
-Error_condition
-to_buffer(Buffer_view& v, const Port& p)
-{
-  if (not available(v, bytes(p)))
-    return AVAILABLE_PORT;
-  to_buffer(v, p.port_id);
-  pad(v, 4);
-  to_buffer(v, p.hw_addr);
-  pad(v, 2);
-  to_buffer(v, p.name);
-  to_buffer(v, p.config);
-  to_buffer(v, p.state);
-  to_buffer(v, p.curr);
-  to_buffer(v, p.advertised);
-  to_buffer(v, p.supported);
-  to_buffer(v, p.peer);
-  to_buffer(v, p.curr_speed);
-  to_buffer(v, p.max_speed);
-
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Port& p)
-{
-  if (not available(v, bytes(p)))
-    return AVAILABLE_PORT;
-  from_buffer(v, p.port_id);
-  pad(v, 4);
-  from_buffer(v, p.hw_addr);
-  pad(v, 2);
-  from_buffer(v, p.name);
-  from_buffer(v, p.config);
-  from_buffer(v, p.state);
-  from_buffer(v, p.curr);
-  from_buffer(v, p.advertised);
-  from_buffer(v, p.supported);
-  from_buffer(v, p.peer);
-  from_buffer(v, p.curr_speed);
-  from_buffer(v, p.max_speed);
-
-  return SUCCESS;
-}
-
 std::string
 to_string(const Port& p, Formatter& f)
 {
@@ -4326,36 +4154,6 @@ to_string(Port::Features_value fv)
 // -------------------------------------------------------------------------- //
 // Feature response
 
-Error_condition
-to_buffer(Buffer_view& v, const Feature_res& fr)
-{
-  if (not available(v, bytes(fr)))
-    return AVAILABLE_FEATURE_RES;
-  to_buffer(v, fr.datapath_id);
-  to_buffer(v, fr.n_buffers);
-  to_buffer(v, fr.n_tbls);
-  to_buffer(v, fr.aux_id);
-  pad(v, 2);
-  to_buffer(v, fr.capabilities);
-  to_buffer(v, fr.reserved);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Feature_res& fr)
-{
-  if (not available(v, bytes(fr)))
-    return AVAILABLE_FEATURE_RES;
-  from_buffer(v, fr.datapath_id);
-  from_buffer(v, fr.n_buffers);
-  from_buffer(v, fr.n_tbls);
-  from_buffer(v, fr.aux_id);
-  pad(v, 2);
-  from_buffer(v, fr.capabilities);
-  from_buffer(v, fr.reserved);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Feature_res& fr, Formatter& f)
 {
@@ -4474,7 +4272,7 @@ to_buffer(Buffer_view& v, const Packet_in& pi)
 Error_condition
 from_buffer(Buffer_view& v, Packet_in& pi)
 {
-  if (not available(v, bytes(pi)))
+  if (not available(v, min_bytes<Packet_in>()))
     return AVAILABLE_PACKET_IN;
   from_buffer(v, pi.buffer_id);
   from_buffer(v, pi.total_len);
@@ -4493,8 +4291,7 @@ from_buffer(Buffer_view& v, Packet_in& pi)
   if (pi.total_len == 0)
     return SUCCESS;
 
-  pi.data = Buffer(pi.total_len);
-  from_buffer(v, pi.data);
+  from_buffer(v, pi.data, pi.total_len);
   return SUCCESS;
 }
 
@@ -4553,7 +4350,7 @@ to_buffer(Buffer_view& v, const Flow_removed& fr)
 Error_condition
 from_buffer(Buffer_view& v, Flow_removed& fr)
 {
-  if (not available(v, bytes(fr)))
+  if (not available(v, min_bytes<Flow_removed>()))
     return AVAILABLE_FLOW_REMOVED;
   from_buffer(v, fr.cookie);
   from_buffer(v, fr.priority);
@@ -4619,7 +4416,7 @@ to_buffer(Buffer_view& v, const Port_status& ps)
 Error_condition
 from_buffer(Buffer_view& v, Port_status& ps)
 {
-  if (not available(v, bytes(ps)))
+  if (not available(v, min_bytes<Port_status>()))
     return AVAILABLE_PORT_STATUS;
   from_buffer(v, ps.reason);
   pad(v, 7);
@@ -4674,7 +4471,7 @@ to_buffer(Buffer_view& v, const Packet_out& po)
 Error_condition
 from_buffer(Buffer_view& v, Packet_out& po)
 {
-  if (not available(v, bytes(po)))
+  if (not available(v, min_bytes<Packet_out>()))
     return AVAILABLE_PACKET_OUT;
   from_buffer(v, po.buffer_id);
   from_buffer(v, po.in_port);
@@ -4744,7 +4541,7 @@ to_buffer(Buffer_view& v, const Flow_mod& fm)
 Error_condition
 from_buffer(Buffer_view& v, Flow_mod& fm)
 {
-  if (not available(v, bytes(fm)))
+  if (not available(v, min_bytes<Flow_mod>()))
     return AVAILABLE_FLOW_MOD;
 
   from_buffer(v, fm.cookie);
@@ -4760,10 +4557,27 @@ from_buffer(Buffer_view& v, Flow_mod& fm)
   from_buffer(v, fm.flags);
   pad(v, 2);
 
+  // Reject a bad command before reading the rest of the message. The
+  // match and instructions are checked as they are read.
+  bool full = trust_level() == FULL_VALIDATION;
+  if (full) {
+    if (Error_decl err = is_valid(fm.command))
+      return err;
+    if (Error_decl err = is_valid(fm.command, fm.table_id))
+      return err;
+    if (Error_decl err = is_valid(fm.flags))
+      return err;
+  }
+
   if (Error_decl err = from_buffer(v, fm.match))
     return err;
 
-  return from_buffer(v, fm.instructions);
+  if (Error_decl err = from_buffer(v, fm.instructions))
+    return err;
+
+  if (full)
+    return check_instruction_set(fm.instructions);
+  return SUCCESS;
 }
 
 std::string
@@ -4839,7 +4653,7 @@ to_buffer(Buffer_view& v, const Bucket& b)
 Error_condition
 from_buffer(Buffer_view& v, Bucket& b)
 {
-  if (not available(v, bytes(b)))
+  if (not available(v, min_bytes<Bucket>()))
     return AVAILABLE_BUCKET;
   from_buffer(v, b.len);
   from_buffer(v, b.weight);
@@ -4897,7 +4711,7 @@ to_buffer(Buffer_view& v, const Group_mod& gm)
 Error_condition
 from_buffer(Buffer_view& v, Group_mod& gm)
 {
-  if (not available(v, bytes(gm)))
+  if (not available(v, min_bytes<Group_mod>()))
     return AVAILABLE_GROUP_MOD;
 
   from_buffer(v, gm.command);
@@ -4948,38 +4762,6 @@ to_string(Group_mod::Type tv)
 // -------------------------------------------------------------------------- //
 // Port mod
 
-Error_condition
-to_buffer(Buffer_view& v, const Port_mod& pm)
-{
-  if (not available(v, bytes(pm)))
-    return AVAILABLE_PORT_MOD;
-  to_buffer(v, pm.port);
-  pad(v, 4);
-  to_buffer(v, pm.hw_addr);
-  pad(v, 2);
-  to_buffer(v, pm.config);
-  to_buffer(v, pm.mask);
-  to_buffer(v, pm.advertise);
-  pad(v, 4);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Port_mod& pm)
-{
-  if (not available(v, bytes(pm)))
-    return AVAILABLE_PORT_MOD;
-  from_buffer(v, pm.port);
-  pad(v, 4);
-  from_buffer(v, pm.hw_addr);
-  pad(v, 2);
-  from_buffer(v, pm.config);
-  from_buffer(v, pm.mask);
-  from_buffer(v, pm.advertise);
-  pad(v, 4);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Port_mod& pm, Formatter& f)
 {
@@ -5036,28 +4818,6 @@ to_string(Port_mod::Features_type ft)
 // -------------------------------------------------------------------------- //
 // Table mod
 
-Error_condition
-to_buffer(Buffer_view& v, const Table_mod& tm)
-{
-  if (not available(v, bytes(tm)))
-    return AVAILABLE_TABLE_MOD;
-  to_buffer(v, tm.table_id);
-  pad(v, 3);
-  to_buffer(v, tm.config);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Table_mod& tm)
-{
-  if (not available(v, bytes(tm)))
-    return AVAILABLE_TABLE_MOD;
-  from_buffer(v, tm.table_id);
-  pad(v, 3);
-  from_buffer(v, tm.config);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Table_mod& tm, Formatter& f)
 {
@@ -5154,26 +4914,6 @@ to_string(const Multipart_req_aggregate& sra, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Multipart Request: Port
 
-Error_condition
-to_buffer(Buffer_view& v, const Multipart_req_port& srp)
-{
-  if (not available(v, bytes(srp)))
-    return AVAILABLE_MULTIPART_REQ_PORT;
-  to_buffer(v, srp.port_no);
-  pad(v, 4);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Multipart_req_port& srp)
-{
-  if (not available(v, bytes(srp)))
-    return AVAILABLE_MULTIPART_REQ_PORT;
-  from_buffer(v, srp.port_no);
-  pad(v, 4);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Multipart_req_port& srp, Formatter& f)
 {
@@ -5189,26 +4929,6 @@ to_string(const Multipart_req_port& srp, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Multipart Request: Queue
 
-Error_condition
-to_buffer(Buffer_view& v, const Multipart_req_queue& srq)
-{
-  if (not available(v, bytes(srq)))
-    return AVAILABLE_MULTIPART_REQ_QUEUE;
-  to_buffer(v, srq.port_no);
-  to_buffer(v, srq.queue_id);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Multipart_req_queue& srq)
-{
-  if (not available(v, bytes(srq)))
-    return AVAILABLE_MULTIPART_REQ_QUEUE;
-  from_buffer(v, srq.port_no);
-  from_buffer(v, srq.queue_id);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Multipart_req_queue& srq, Formatter& f)
 {
@@ -5225,26 +4945,6 @@ to_string(const Multipart_req_queue& srq, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Multipart Request: Group
 
-Error_condition
-to_buffer(Buffer_view& v, const Multipart_req_group& srg)
-{
-  if (not available(v, bytes(srg)))
-    return AVAILABLE_MULTIPART_REQ_GROUP;
-  to_buffer(v, srg.group_id);
-  pad(v, 4);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Multipart_req_group& srg)
-{
-  if (not available(v, bytes(srg)))
-    return AVAILABLE_MULTIPART_REQ_GROUP;
-  from_buffer(v, srg.group_id);
-  pad(v, 4);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Multipart_req_group& srg, Formatter& f)
 {
@@ -6228,16 +5928,16 @@ to_buffer(Buffer_view& v, const Table_feature_property& tfp)
 Error_condition
 from_buffer(Buffer_view& v, Table_feature_property& tfp)
 {
-  if (not available(v, bytes(tfp.header)))
+  Table_feature_property::Header h = {};
+  if (not available(v, bytes(h)))
     return AVAILABLE_TABLE_FEATURE_PROPERTY;
-  from_buffer(v, tfp.header);
+  from_buffer(v, h);
 
-  if (Error_decl err = is_valid(tfp.header.type))
+  if (Error_decl err = is_valid(h.type))
     return err;
 
-  Table_feature_property::Payload p;
-  construct(p, tfp.header.type);
-  assign(tfp.payload, std::move(p), tfp.header.type);
+  emplace(tfp.payload, tfp.header.type, h.type);
+  tfp.header = h;
 
   if (Error_decl err = is_valid(tfp.header))
     return err;
@@ -6305,7 +6005,7 @@ to_buffer(Buffer_view& v, const Multipart_req_table_feature& mrtf)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_req_table_feature& mrtf)
 {
-  if (not available(v, bytes(mrtf)))
+  if (not available(v, min_bytes<Multipart_req_table_feature>()))
     return AVAILABLE_MULTIPART_REQ_TABLE_FEATURE;
 
   from_buffer(v, mrtf.length);
@@ -6374,7 +6074,7 @@ to_buffer(Buffer_view& v, const Multipart_req_table_features& mrtf)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_req_table_features& mrtf)
 {
-  if (not available(v, bytes(mrtf)))
+  if (not available(v, min_bytes<Multipart_req_table_features>()))
     return AVAILABLE_MULTIPART_RES_TABLE_FEATURES;
   return from_buffer(v, mrtf.table_features);
 }
@@ -6407,7 +6107,7 @@ to_buffer(Buffer_view& v, const Multipart_req_experimenter& mre)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_req_experimenter& mre)
 {
-  if (not available(v, bytes(mre)))
+  if (not available(v, min_bytes<Multipart_req_experimenter>()))
     return AVAILABLE_MULTIPART_RES_EXPERIMENTER;
   from_buffer(v, mre.experimenter_id);
   from_buffer(v, mre.exp_type);
@@ -6909,16 +6609,16 @@ to_buffer(Buffer_view& v, const Multipart_req& r)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_req& r)
 {
-  if (not available(v, bytes(r.header)))
+  Multipart_req::Header h = {};
+  if (not available(v, bytes(h)))
     return AVAILABLE_MULTIPART_HEADER;
-  from_buffer(v, r.header);
+  from_buffer(v, h);
 
-  if (Error_decl err = is_valid(r.header.type))
+  if (Error_decl err = is_valid(h.type))
     return err;
 
-  Multipart_req::Payload p;
-  construct(p, r.header.type);
-  assign(r.payload, std::move(p), r.header.type);
+  emplace(r.payload, r.header.type, h.type);
+  r.header = h;
 
   return from_buffer(v, r.payload, r.header.type);
 }
@@ -6942,34 +6642,6 @@ to_string(const Multipart_req& r, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Multipart Response Description
 
-Error_condition
-to_buffer(Buffer_view& v, const Multipart_res_desc& d)
-{
-  if (not available(v, bytes(d)))
-    return AVAILABLE_MULTIPART_RES_DESC;
-  to_buffer(v, d.mfr_desc);
-  to_buffer(v, d.hw_desc);
-  to_buffer(v, d.sw_desc);
-  to_buffer(v, d.serial_num);
-  to_buffer(v, d.dp_desc);
-
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Multipart_res_desc& d)
-{
-  if (not available (v, bytes(d)))
-    return AVAILABLE_MULTIPART_RES_DESC;
-  from_buffer(v, d.mfr_desc);
-  from_buffer(v, d.hw_desc);
-  from_buffer(v, d.sw_desc);
-  from_buffer(v, d.serial_num);
-  from_buffer(v, d.dp_desc);
-
-  return SUCCESS;
-}
-
 std::string to_string(const Multipart_res_desc& d, Formatter& f)
 {
   std::stringstream ss;
@@ -7017,7 +6689,7 @@ to_buffer(Buffer_view& v, const Multipart_res_flow& f)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_flow& f)
 {
-  if (not available (v, bytes(f)))
+  if (not available(v, min_bytes<Multipart_res_flow>()))
     return AVAILABLE_MULTIPART_RES_FLOW;
 
   from_buffer(v, f.length);
@@ -7045,8 +6717,12 @@ from_buffer(Buffer_view& v, Multipart_res_flow& f)
 
   if (Error_decl err = from_buffer(c, f.instructions))
     return err;
-  if (not update(v, c))
+  if (not update_trusted(v, c))
     return EXCESS_MULTIPART_RES_FLOW;
+
+  // The match and instructions were checked as they were read.
+  if (trust_level() == FULL_VALIDATION)
+    return check_instruction_set(f.instructions);
   return SUCCESS;
 }
 
@@ -7088,7 +6764,7 @@ to_buffer(Buffer_view& v, const Multipart_res_flows& mrf)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_flows& mrf)
 {
-  if (not available (v, bytes(mrf)))
+  if (not available(v, min_bytes<Multipart_res_flows>()))
     return AVAILABLE_MULTIPART_RES_FLOWS;
   return from_buffer(v, mrf.flows);
 }
@@ -7237,7 +6913,7 @@ to_buffer(Buffer_view& v, const Multipart_res_ports& mrp)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_ports& mrp)
 {
-  if (not available(v, bytes(mrp)))
+  if (not available(v, min_bytes<Multipart_res_ports>()))
     return AVAILABLE_MULTIPART_RES_PORTS;
   return from_buffer(v, mrp.ports);
 }
@@ -7257,36 +6933,6 @@ to_string(const Multipart_res_ports& mrp, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Multipart Response Queue
 
-Error_condition
-to_buffer(Buffer_view& v, const Multipart_res_queue& q)
-{
-  if (not available(v, bytes(q)))
-    return AVAILABLE_MULTIPART_RES_QUEUE;
-  to_buffer(v, q.port_no);
-  to_buffer(v, q.queue_id);
-  to_buffer(v, q.tx_bytes);
-  to_buffer(v, q.tx_packets);
-  to_buffer(v, q.tx_errors);
-  to_buffer(v, q.duration_sec);
-  to_buffer(v, q.duration_nsec);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Multipart_res_queue& q)
-{
-  if (not available(v, bytes(q)))
-    return AVAILABLE_MULTIPART_RES_QUEUE;
-  from_buffer(v, q.port_no);
-  from_buffer(v, q.queue_id);
-  from_buffer(v, q.tx_bytes);
-  from_buffer(v, q.tx_packets);
-  from_buffer(v, q.tx_errors);
-  from_buffer(v, q.duration_sec);
-  from_buffer(v, q.duration_nsec);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Multipart_res_queue& q, Formatter& f)
 {
@@ -7319,7 +6965,7 @@ to_buffer(Buffer_view& v, const Multipart_res_queues& mrq)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_queues& mrq)
 {
-  if (not available(v, bytes(mrq)))
+  if (not available(v, min_bytes<Multipart_res_queues>()))
     return AVAILABLE_MULTIPART_RES_QUEUES;
   return from_buffer(v, mrq.queues);
 }
@@ -7339,32 +6985,6 @@ to_string(const Multipart_res_queues& mrq, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Multipart Response Table
 
-Error_condition
-to_buffer(Buffer_view& v, const Multipart_res_table& t)
-{
-  if (not available(v, bytes(t)))
-    return AVAILABLE_MULTIPART_RES_TABLE;
-  to_buffer(v, t.table_id);
-  pad(v, 3);
-  to_buffer(v, t.active_count);
-  to_buffer(v, t.lookup_count);
-  to_buffer(v, t.matched_count);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Multipart_res_table& t)
-{
-  if (not available(v, bytes(t)))
-    return AVAILABLE_MULTIPART_RES_TABLE;
-  from_buffer(v, t.table_id);
-  pad(v, 3);
-  from_buffer(v, t.active_count);
-  from_buffer(v, t.lookup_count);
-  from_buffer(v, t.matched_count);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Multipart_res_table& t, Formatter& f)
 {
@@ -7394,7 +7014,7 @@ to_buffer(Buffer_view& v, const Multipart_res_tables& mrt)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_tables& mrt)
 {
-  if (not available (v, bytes(mrt)))
+  if (not available(v, min_bytes<Multipart_res_tables>()))
     return AVAILABLE_MULTIPART_RES_TABLES;
   return from_buffer(v, mrt.tables);
 }
@@ -7414,26 +7034,6 @@ to_string(const Multipart_res_tables& mrt, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Bucket counter
 
-Error_condition
-to_buffer(Buffer_view& v, const Bucket_counter& bc)
-{
-  if (not available(v, bytes(bc)))
-    return AVAILABLE_BUCKET_COUNTER;
-  to_buffer(v, bc.packet_count);
-  to_buffer(v, bc.byte_count);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Bucket_counter& bc)
-{
-  if (not available(v, bytes(bc)))
-    return AVAILABLE_BUCKET_COUNTER;
-  from_buffer(v, bc.packet_count);
-  from_buffer(v, bc.byte_count);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Bucket_counter& bc, Formatter& f)
 {
@@ -7470,7 +7070,7 @@ to_buffer(Buffer_view& v, const Multipart_res_group& g)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_group& g)
 {
-  if (not available (v, bytes(g)))
+  if (not available(v, min_bytes<Multipart_res_group>()))
     return AVAILABLE_MULTIPART_RES_GROUP;
 
   from_buffer(v, g.length);
@@ -7530,7 +7130,7 @@ to_buffer(Buffer_view& v, const Multipart_res_groups& mrg)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_groups& mrg)
 {
-  if (not available (v, bytes(mrg)))
+  if (not available(v, min_bytes<Multipart_res_groups>()))
     return AVAILABLE_MULTIPART_RES_GROUPS;
   return from_buffer(v, mrg.groups);
 }
@@ -7565,7 +7165,7 @@ to_buffer(Buffer_view& v, const Multipart_res_group_desc& gd)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_group_desc& gd)
 {
-  if (not available (v, bytes(gd)))
+  if (not available(v, min_bytes<Multipart_res_group_desc>()))
     return AVAILABLE_MULTIPART_RES_GROUP_DESC;
   from_buffer(v, gd.length);
   from_buffer(v, gd.type);
@@ -7614,7 +7214,7 @@ to_buffer(Buffer_view& v, const Multipart_res_group_descs& mrgd)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_group_descs& mrgd)
 {
-  if (not available (v, bytes(mrgd)))
+  if (not available(v, min_bytes<Multipart_res_group_descs>()))
     return AVAILABLE_MULTIPART_RES_GROUP_DESCS;
   return from_buffer(v, mrgd.group_descs);
 }
@@ -7709,26 +7309,6 @@ to_string(const Multipart_res_group_features& gf, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Meter band stats
 
-Error_condition
-to_buffer(Buffer_view& v, const Meter_band_stats& mbs)
-{
-  if (not available(v, bytes(mbs)))
-    return AVAILABLE_METER_BAND_STATS;
-  to_buffer(v, mbs.packet_band_count);
-  to_buffer(v, mbs.byte_band_count);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Meter_band_stats& mbs)
-{
-  if (not available(v, bytes(mbs)))
-    return AVAILABLE_METER_BAND_STATS;
-  from_buffer(v, mbs.packet_band_count);
-  from_buffer(v, mbs.byte_band_count);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Meter_band_stats& mbs, Formatter& f)
 {
@@ -7765,7 +7345,7 @@ to_buffer(Buffer_view& v, const Multipart_res_meter& mrm)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_meter& mrm)
 {
-  if (not available(v, bytes(mrm)))
+  if (not available(v, min_bytes<Multipart_res_meter>()))
     return AVAILABLE_MULTIPART_RES_METER;
   from_buffer(v, mrm.meter_id);
   from_buffer(v, mrm.len);
@@ -7822,7 +7402,7 @@ to_buffer(Buffer_view& v, const Multipart_res_meters& mrm)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_meters& mrm)
 {
-  if (not available (v, bytes(mrm)))
+  if (not available(v, min_bytes<Multipart_res_meters>()))
     return AVAILABLE_MULTIPART_RES_METERS;
   return from_buffer(v, mrm.meters);
 }
@@ -7856,47 +7436,9 @@ to_string(Meter_band_type t)
 // -------------------------------------------------------------------------- //
 // Meter band: drop
 
-Error_condition
-to_buffer(Buffer_view& v, const Meter_band_drop& mbd)
-{
-  if (not available(v, bytes(mbd)))
-    return AVAILABLE_METER_BAND_DROP;
-  pad(v, 4);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Meter_band_drop& mbd)
-{
-  if (not available(v, bytes(mbd)))
-    return AVAILABLE_METER_BAND_DROP;
-  pad(v, 4);
-  return SUCCESS;
-}
-
 // -------------------------------------------------------------------------- //
 // Meter band: dscp remark
 
-Error_condition
-to_buffer(Buffer_view& v, const Meter_band_dscp_remark& mbdr)
-{
-  if (not available(v, bytes(mbdr)))
-    return AVAILABLE_METER_BAND_DSCP_REMARK;
-  to_buffer(v, mbdr.prec_level);
-  pad(v, 3);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Meter_band_dscp_remark& mbdr)
-{
-  if (not available(v, bytes(mbdr)))
-    return AVAILABLE_METER_BAND_DSCP_REMARK;
-  from_buffer(v, mbdr.prec_level);
-  pad(v, 3);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Meter_band_dscp_remark& mbdr, Formatter& f)
 {
@@ -7922,7 +7464,7 @@ to_buffer(Buffer_view& v, const Meter_band_experimenter& mbe)
 Error_condition
 from_buffer(Buffer_view& v, Meter_band_experimenter& mbe)
 {
-  if (not available(v, bytes(mbe)))
+  if (not available(v, min_bytes<Meter_band_experimenter>()))
     return AVAILABLE_METER_BAND_EXPERIMENTER;
   from_buffer(v, mbe.experimenter_id);
   return SUCCESS;
@@ -7998,6 +7540,19 @@ assign(Meter_band_payload& a, const Meter_band_payload& b, Meter_band_type t)
   return a;
 }
 
+void
+destroy(Meter_band_payload& p, Meter_band_type t)
+{
+  switch (t) {
+  case METER_BAND_DROP: p.data.drop.~Meter_band_drop(); break;
+  case METER_BAND_DSCP_REMARK:
+    p.data.dscp_remark.~Meter_band_dscp_remark(); break;
+  case METER_BAND_EXPERIMENTER:
+    p.data.experimenter.~Meter_band_experimenter(); break;
+  default: return;
+  }
+}
+
 bool
 equal(const Meter_band_payload& a, const Meter_band_payload& b,
       Meter_band_type t1, Meter_band_type t2)
@@ -8148,16 +7703,16 @@ to_buffer(Buffer_view& v, const Meter_band& mb)
 Error_condition
 from_buffer(Buffer_view& v, Meter_band& mb)
 {
-  if (not available(v, bytes(mb.header)))
+  Meter_band::Header h = {};
+  if (not available(v, bytes(h)))
     return AVAILABLE_METER_BAND_HEADER;
-  from_buffer(v, mb.header);
+  from_buffer(v, h);
 
-  if (Error_decl err = is_valid(mb.header.type))
+  if (Error_decl err = is_valid(h.type))
    return err;
 
-  Meter_band::Payload p;
-  construct(p, mb.header.type);
-  assign(mb.payload, std::move(p), mb.header.type);
+  emplace(mb.payload, mb.header.type, h.type);
+  mb.header = h;
 
   if (Error_decl err = is_valid(mb.header))
     return err;
@@ -8205,7 +7760,7 @@ to_buffer(Buffer_view& v, const Multipart_res_meter_config& mrmc)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_meter_config& mrmc)
 {
-  if (not available(v, bytes(mrmc)))
+  if (not available(v, min_bytes<Multipart_res_meter_config>()))
     return AVAILABLE_MULTIPART_RES_METER_CONFIG;
   from_buffer(v, mrmc.len);
   from_buffer(v, mrmc.flags);
@@ -8255,7 +7810,7 @@ to_buffer(Buffer_view& v, const Multipart_res_meter_configs& mrmc)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_meter_configs& mrmc)
 {
-  if (not available (v, bytes(mrmc)))
+  if (not available(v, min_bytes<Multipart_res_meter_configs>()))
     return AVAILABLE_MULTIPART_RES_METER_CONFIGS;
   return from_buffer(v, mrmc.meter_configs);
 }
@@ -8275,34 +7830,6 @@ to_string(const Multipart_res_meter_configs& mrmc, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Multipart Response: Meter features
 
-Error_condition
-to_buffer(Buffer_view& v, const Multipart_res_meter_features& mrmf)
-{
-  if (not available(v, bytes(mrmf)))
-    return AVAILABLE_MULTIPART_RES_METER_FEATURES;
-  to_buffer(v, mrmf.max_meter);
-  to_buffer(v, mrmf.band_type);
-  to_buffer(v, mrmf.capabilities);
-  to_buffer(v, mrmf.max_bands);
-  to_buffer(v, mrmf.max_color);
-  pad(v, 2);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Multipart_res_meter_features& mrmf)
-{
-  if (not available(v, bytes(mrmf)))
-    return AVAILABLE_MULTIPART_RES_METER_FEATURES;
-  from_buffer(v, mrmf.max_meter);
-  from_buffer(v, mrmf.band_type);
-  from_buffer(v, mrmf.capabilities);
-  from_buffer(v, mrmf.max_bands);
-  from_buffer(v, mrmf.max_color);
-  pad(v, 2);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Multipart_res_meter_features& mrmf, Formatter& f)
 {
@@ -8355,7 +7882,7 @@ to_buffer(Buffer_view& v, const Multipart_res_table_feature& mrtf)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_table_feature& mrtf)
 {
-  if (not available(v, bytes(mrtf)))
+  if (not available(v, min_bytes<Multipart_res_table_feature>()))
     return AVAILABLE_MULTIPART_RES_TABLE_FEATURE;
 
   from_buffer(v, mrtf.length);
@@ -8426,7 +7953,7 @@ to_buffer(Buffer_view& v, const Multipart_res_table_features& mrtf)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_table_features& mrtf)
 {
-  if (not available(v, bytes(mrtf)))
+  if (not available(v, min_bytes<Multipart_res_table_features>()))
     return AVAILABLE_MULTIPART_RES_TABLE_FEATURES;
   return from_buffer(v, mrtf.table_features);
 }
@@ -8457,7 +7984,7 @@ to_buffer(Buffer_view& v, const Multipart_res_port_desc& mrpd)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_port_desc& mrpd)
 {
-  if (not available(v, bytes(mrpd)))
+  if (not available(v, min_bytes<Multipart_res_port_desc>()))
     return AVAILABLE_MULTIPART_RES_PORT_DESC;
   return from_buffer(v, mrpd.ports);
 }
@@ -8490,7 +8017,7 @@ to_buffer(Buffer_view& v, const Multipart_res_experimenter& mre)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res_experimenter& mre)
 {
-  if (not available(v, bytes(mre)))
+  if (not available(v, min_bytes<Multipart_res_experimenter>()))
     return AVAILABLE_MULTIPART_RES_EXPERIMENTER;
   from_buffer(v, mre.experimenter_id);
   from_buffer(v, mre.exp_type);
@@ -8942,17 +8469,17 @@ to_buffer(Buffer_view& v, const Multipart_res& r)
 Error_condition
 from_buffer(Buffer_view& v, Multipart_res& r)
 {
-  if (not available(v, bytes(r)))
+  Multipart_res::Header h;
+  if (not available(v, min_bytes<Multipart_res>()))
     return AVAILABLE_MULTIPART_HEADER;
-  from_buffer(v, r.header);
+  from_buffer(v, h);
 
   // Check that the payload is valid.
-  if (Error_decl err = is_valid(r.header.type))
+  if (Error_decl err = is_valid(h.type))
     return err;
 
-  Multipart_res::Payload p;
-  construct(p, r.header.type);
-  assign(r.payload, std::move(p), r.header.type);
+  emplace(r.payload, r.header.type, h.type);
+  r.header = h;
 
   // Construct the payload.
   return from_buffer(v, r.payload, r.header.type);
@@ -8975,26 +8502,6 @@ to_string(const Multipart_res& sr, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Queue Get Config Request
 
-Error_condition
-to_buffer(Buffer_view& v, const Queue_get_config_req& qgcr)
-{
-  if (not available(v, bytes(qgcr)))
-    return AVAILABLE_QUEUE_GET_CONFIG_REQ;
-  to_buffer(v, qgcr.port);
-  pad(v, 4);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Queue_get_config_req& qgcr)
-{
-  if (not available(v, bytes(qgcr)))
-    return AVAILABLE_QUEUE_GET_CONFIG_REQ;
-  from_buffer(v, qgcr.port);
-  pad(v, 4);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Queue_get_config_req& qgcr, Formatter& f)
 {
@@ -9059,26 +8566,6 @@ to_string(const Queue_property_header& h, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Queue property min rate
 
-Error_condition
-to_buffer(Buffer_view& v, const Queue_property_min_rate& mr)
-{
-  if (not available(v, bytes(mr)))
-    return AVAILABLE_QUEUE_PROPERTY_MIN_RATE;
-  to_buffer(v, mr.rate);
-  pad(v, 6);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Queue_property_min_rate& mr)
-{
-  if (not available(v, bytes(mr)))
-    return AVAILABLE_QUEUE_PROPERTY_MIN_RATE;
-  from_buffer(v, mr.rate);
-  pad(v, 6);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Queue_property_min_rate& mr, Formatter& f)
 {
@@ -9094,26 +8581,6 @@ to_string(const Queue_property_min_rate& mr, Formatter& f)
 // -------------------------------------------------------------------------- //
 // Queue property: max rate
 
-Error_condition
-to_buffer(Buffer_view& v, const Queue_property_max_rate& mr)
-{
-  if (not available(v, bytes(mr)))
-    return AVAILABLE_QUEUE_PROPERTY_MAX_RATE;
-  to_buffer(v, mr.rate);
-  pad(v, 6);
-  return SUCCESS;
-}
-
-Error_condition
-from_buffer(Buffer_view& v, Queue_property_max_rate& mr)
-{
-  if (not available(v, bytes(mr)))
-    return AVAILABLE_QUEUE_PROPERTY_MAX_RATE;
-  from_buffer(v, mr.rate);
-  pad(v, 6);
-  return SUCCESS;
-}
-
 std::string
 to_string(const Queue_property_max_rate& mr, Formatter& f)
 {
@@ -9142,7 +8609,7 @@ to_buffer(Buffer_view& v, const Queue_property_experimenter& e)
 Error_condition
 from_buffer(Buffer_view& v, Queue_property_experimenter& e)
 {
-  if (not available(v, bytes(e)))
+  if (not available(v, min_bytes<Queue_property_experimenter>()))
     return AVAILABLE_QUEUE_PROPERTY_EXPERIMENTER;
   from_buffer(v, e.experimenter);
   pad(v, 4);
@@ -9223,6 +8690,20 @@ assign(Queue_property_payload& a, const Queue_property_payload& b,
   return a;
 }
 
+void
+destroy(Queue_property_payload& p, Queue_property_type t)
+{
+  switch (t) {
+  case QUEUE_PROPERTY_MIN_RATE: p.data.min_rate.~Queue_property_min_rate();
+    break;
+  case QUEUE_PROPERTY_MAX_RATE: p.data.max_rate.~Queue_property_max_rate();
+    break;
+  case QUEUE_PROPERTY_EXPERIMENTER:
+    p.data.experimenter.~Queue_property_experimenter(); break;
+  default: return;
+  }
+}
+
 bool
 equal(const Queue_property_payload& a, const Queue_property_payload& b,
       Queue_property_type t1, Queue_property_type t2)
@@ -9329,16 +8810,16 @@ to_buffer(Buffer_view& v, const Queue_property& qp)
 Error_condition
 from_buffer(Buffer_view& v, Queue_property& qp)
 {
-  if (not available(v, bytes(qp.header)))
+  Queue_property::Header h = {};
+  if (not available(v, bytes(h)))
     return AVAILABLE_QUEUE_PROPERTY_HEADER;
 
-  from_buffer(v, qp.header);
-  if (Error_decl err = is_valid(qp.header))
+  from_buffer(v, h);
+  if (Error_decl err = is_valid(h))
     return err;
   
-  Queue_property::Payload p;
-  construct(p, qp.header.property);
-  assign(qp.payload, std::move(p), qp.header.property);
+  emplace(qp.payload, qp.header.property, h.property);
+  qp.header = h;
   //construct(qp.payload, qp.header.property);
 
   // Ensure that we can constrain the view.
@@ -9389,14 +8870,14 @@ to_buffer(Buffer_view& v, const Queue& q)
 Error_condition
 from_buffer(Buffer_view& v, Queue& q)
 {
-  if (not available(v, bytes(q)))
+  if (not available(v, min_bytes<Queue>()))
     return AVAILABLE_QUEUE;
   from_buffer(v, q.queue_id);
   from_buffer(v, q.port);
   from_buffer(v, q.length);
   pad(v, 6);
 
-  std::size_t n = q.length - bytes(q);
+  std::size_t n = q.length - min_bytes<Queue>();
   if (remaining(v) < n)
     return AVAILABLE_QUEUE_PROPERTIES;
 
@@ -9442,7 +8923,7 @@ to_buffer(Buffer_view& v, const Queue_get_config_res& qgcr)
 Error_condition
 from_buffer(Buffer_view& v, Queue_get_config_res& qgcr)
 {
-  if (not available(v, bytes(qgcr)))
+  if (not available(v, min_bytes<Queue_get_config_res>()))
     return AVAILABLE_QUEUE_GET_CONFIG_RES;
   from_buffer(v, qgcr.port);
   pad(v, 4);
@@ -9567,7 +9048,7 @@ to_buffer(Buffer_view& v, const Meter_mod& mm)
 Error_condition
 from_buffer(Buffer_view& v, Meter_mod& mm)
 {
-  if (not available(v, bytes(mm)))
+  if (not available(v, min_bytes<Meter_mod>()))
     return AVAILABLE_METER_MOD;
   from_buffer(v, mm.command);
   from_buffer(v, mm.flags);
@@ -10285,22 +9766,48 @@ to_buffer(Buffer_view& v, const Message& m)
   return to_buffer(v, m.payload, m.header.type);
 }
 
+namespace {
+
+// Check the constraints of the payload p, of kind t, that are not checked
+// while it is read. The parts of matches, instructions and flow
+// modifications are checked as they are read under full validation.
+Error_condition
+check_decoded(const Payload& p, Message_type t)
+{
+  switch (t) {
+  case FLOW_MOD:
+    return SUCCESS;
+  case PACKET_IN:
+    return is_valid(p.data.packet_in.reason);
+  case FLOW_REMOVED:
+    return is_valid(p.data.flow_removed.reason);
+  case MULTIPART_RES:
+    if (p.data.multipart_res.header.type == MULTIPART_FLOW)
+      return is_valid(p.data.multipart_res.header);
+    return is_valid(p, t);
+  default:
+    return is_valid(p, t);
+  }
+}
+
+} // namespace
+
 Error_condition
 from_buffer(Buffer_view& v, Message& m)
 {
-  if (not available(v, bytes(m.header)))
+  Header h = {};
+  if (not available(v, bytes(h)))
     return AVAILABLE_HEADER;
-  from_buffer(v, m.header);
+  from_buffer(v, h);
   
-  if (m.header.length < bytes(m.header))
+  if (h.length < bytes(h))
     return BAD_MESSAGE_LENGTH;
   
-  if (Error_decl err = is_valid(m.header.type))
+  if (Error_decl err = is_valid(h.type))
     return err;
   
-  Payload p;
-  construct(p, m.header.type);
-  assign(m.payload, std::move(p), m.header.type);
+  emplace(m.payload, m.header.type, h.type);
+  m.header = h;
 
   std::size_t n = m.header.length - bytes(m.header);
   if (not available(v, n))
@@ -10310,9 +9817,11 @@ from_buffer(Buffer_view& v, Message& m)
   if (Error_decl err = from_buffer(c, m.payload, m.header.type))
     return err;
   
-  if (not update(v, c))
+  if (not update_trusted(v, c))
     return EXCESS_PAYLOAD;
 
+  if (trust_level() == FULL_VALIDATION)
+    return check_decoded(m.payload, m.header.type);
   return SUCCESS;
 }
 
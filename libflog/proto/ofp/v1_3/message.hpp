@@ -24,6 +24,7 @@
 #include <libflog/buffer.hpp>
 #include <libflog/message.hpp>
 #include <libflog/sequence.hpp>
+#include <libflog/small_sequence.hpp>
 #include <libflog/proto/ofp/ofp.hpp>
 #include <libflog/proto/ofp/xid_gen.hpp>
 
@@ -1886,8 +1887,17 @@ Error_condition is_valid(const OXM_entry& e);
 /// \relates OXM_entry
 uint64_t OXM_entry_field_flag(const OXM_entry_field& f);
 
+/// The entries of a match. Most matches have few enough entries to be
+/// stored inline.
+using OXM_entry_sequence = Small_sequence<OXM_entry, 6>;
+
+/// \relates OXM_entry
+Error_condition is_valid(const OXM_entry_sequence& r);
+
 /// \relates OXM_entry
-Error_condition is_valid(const Sequence<OXM_entry> r);
+/// Check the prerequisites of the fields in r, and that no field appears
+/// more than once. The entries themselves are not checked.
+Error_condition check_prerequisites(const OXM_entry_sequence& r);
 
 /// \relates OXM_entry
 Error_condition to_buffer(Buffer_view&, const OXM_entry&);
@@ -1920,7 +1930,7 @@ struct Match
 
   Type type;
   uint16_t length;
-  Sequence<OXM_entry> rules;
+  OXM_entry_sequence rules;
 };
 
 /// Returns true when the arguments compare equal. Two match values 
@@ -2435,6 +2445,9 @@ template<typename Tag, typename... Args>
 Action_payload& assign(Action_payload&, const Action_payload&,
                        Action_type);
 
+/// \relates Action_payload
+void destroy(Action_payload&, Action_type);
+
 /// \relates Action_payload
 bool equal(const Action_payload&, const Action_payload&, Action_type,
            Action_type);
@@ -2547,6 +2560,10 @@ Error_condition from_buffer(Buffer_view& v, const Action& a);
 /// \relates Action
 std::string to_string(const Action& a, Formatter& f);
 
+/// The actions of an instruction or bucket. Most have few enough actions
+/// to be stored inline.
+using Action_sequence = Small_sequence<Action, 3>;
+
 // -------------------------------------------------------------------------- //
 // Instruction type
 
@@ -2652,7 +2669,7 @@ template <Instruction_type K>
 
     explicit Instruction_action(const Sequence<Action>& a) : actions(a) { }
 
-    Sequence<Action> actions;
+    Action_sequence actions;
   };
 
 /// \relates Instruction_action
@@ -2914,7 +2931,12 @@ std::size_t bytes(const Instruction& a);
 Error_condition is_valid(const Instruction& a);
 
 /// \relates Instruction
-Error_condition is_valid(const Sequence<Instruction> i);
+Error_condition is_valid(const Sequence<Instruction>& i);
+
+/// \relates Instruction
+/// Check that no kind of instruction appears more than once in i. The
+/// instructions themselves are not checked.
+Error_condition check_instruction_set(const Sequence<Instruction>& i);
 
 /// \relates Instruction
 Error_condition to_buffer(Buffer_view& v, const Instruction& a);
@@ -3283,6 +3305,9 @@ Queue_property_payload& assign(Queue_property_payload&,
                                const Queue_property_payload&,
                                Queue_property_type);
 
+/// \relates Queue_property_payload
+void destroy(Queue_property_payload&, Queue_property_type);
+
 /// \relates Queue_property_payload
 bool equal(const Queue_property_payload&, const Queue_property_payload&,
            Queue_property_type, Queue_property_type);
@@ -3432,7 +3457,7 @@ struct Bucket
   uint16_t weight;
   uint32_t watch_port;
   uint32_t watch_group;
-  Sequence<Action> actions;
+  Action_sequence actions;
 };
 
 /// \relates Bucket
@@ -3918,84 +3943,84 @@ struct Error : Payload_base<ERROR>
 
   /// Constructs a hello failed Error message. Initialize the error message with
   /// a Hello_failed code f and the error buffer b.
-  Error(Hello_failed f, const Greedy_buffer& b)
+  Error(Hello_failed f, const Buffer_ref& b)
     : type(HELLO_FAILED), code(f), data() { }
 
   /// Constructs a bad request Error message. Initialize the error message with
   /// a Bad_request code f and the error buffer b.
-  Error(Bad_request f, const Greedy_buffer& b)
+  Error(Bad_request f, const Buffer_ref& b)
     : type(BAD_REQUEST), code(f), data() { }
 
   /// Constructs a bad action Error message. Initialize the error message with
   /// a Bad_action code f and the error buffer b.
-  Error(Bad_action f, const Greedy_buffer& b)
+  Error(Bad_action f, const Buffer_ref& b)
     : type(BAD_ACTION), code(f), data() { }
 
   /// Constructs a bad action Error message. Initialize the error message with
   /// a Bad_instruction code f and the error buffer b.
-  Error(Bad_instruction f, const Greedy_buffer& b)
+  Error(Bad_instruction f, const Buffer_ref& b)
     : type(BAD_INSTRUCTION), code(f), data() { }
 
   /// Constructs a bad action Error message. Initialize the error message with
   /// a Bad_match code f and the error buffer b.
-  Error(Bad_match f, const Greedy_buffer& b)
+  Error(Bad_match f, const Buffer_ref& b)
     : type(BAD_MATCH), code(f), data() { }
 
   /// Constructs a flow modification Error message. Initialize the error message
   /// with a Flow_mod_failed code f and the error buffer b.
-  Error(Flow_mod_failed f, const Greedy_buffer& b)
+  Error(Flow_mod_failed f, const Buffer_ref& b)
     : type(FLOW_MOD_FAILED), code(f), data() { }
 
   /// Constructs a bad action Error message. Initialize the error message with
   /// a Group_mod_failed code f and the error buffer b.
-  Error(Group_mod_failed f, const Greedy_buffer& b)
+  Error(Group_mod_failed f, const Buffer_ref& b)
     : type(GROUP_MOD_FAILED), code(f), data() { }
 
   /// Constructs a port modification Error message. Initialize the error message
   /// with a Port_mod_failed code f and the error buffer b.
-  Error(Port_mod_failed f, const Greedy_buffer& b)
+  Error(Port_mod_failed f, const Buffer_ref& b)
     : type(PORT_MOD_FAILED), code(f), data() { }
 
   /// Constructs a bad action Error message. Initialize the error message with
   /// a Table_mod_failed code f and the error buffer b.
-  Error(Table_mod_failed f, const Greedy_buffer& b)
+  Error(Table_mod_failed f, const Buffer_ref& b)
     : type(TABLE_MOD_FAILED), code(f), data() { }
 
   /// Constructs a queue operation Error message. Initialize the error message
   /// with a Queue_op_failed code f and the error buffer b.
-  Error(Queue_op_failed f, const Greedy_buffer& b)
+  Error(Queue_op_failed f, const Buffer_ref& b)
     : type(QUEUE_OP_FAILED), code(f), data() { }
 
   /// Constructs a bad action Error message. Initialize the error message with
   /// a Switch_config_failed code f and the error buffer b.
-  Error(Switch_config_failed f, const Greedy_buffer& b)
+  Error(Switch_config_failed f, const Buffer_ref& b)
     : type(SWITCH_CONFIG_FAILED), code(f), data() { }
 
   /// Constructs a bad action Error message. Initialize the error message with
   /// a Role_request_failed code f and the error buffer b.
-  Error(Role_request_failed f, const Greedy_buffer& b)
+  Error(Role_request_failed f, const Buffer_ref& b)
     : type(ROLE_REQUEST_FAILED), code(f), data() { }
 
   /// Constructs a bad action Error message. Initialize the error message with
   /// a Meter_mod_failed code f and the error buffer b.
-  Error(Meter_mod_failed f, const Greedy_buffer& b)
+  Error(Meter_mod_failed f, const Buffer_ref& b)
     : type(METER_MOD_FAILED), code(f), data() { }
 
   /// Constructs a bad action Error message. Initialize the error message with
   /// a Table_features_failed code f and the error buffer b.
-  Error(Table_features_failed f, const Greedy_buffer& b)
+  Error(Table_features_failed f, const Buffer_ref& b)
     : type(TABLE_FEATURES_FAILED), code(f), data() { }
 
   /// Initialize the error message with error type t and the error
   /// code c. Note that the value is ill-formed if c is not a valid
   /// code for the error type t.
-  Error(Type t, uint16_t c, const Greedy_buffer& b)
+  Error(Type t, uint16_t c, const Buffer_ref& b)
     : type(t), code(c), data(b) { assert(is_valid(*this)); }
 
   Type type;
   uint16_t code;
   uint32_t experimenter_id; //only used for experimenter error
-  Greedy_buffer data;
+  Buffer_ref data;
 };
 
 /// Returns true when the arguments compare equal. Two Error messages compare
@@ -4605,7 +4630,7 @@ struct Packet_in : Payload_base<PACKET_IN>
 
   Packet_in() = default;
   Packet_in(uint32_t bid, uint16_t tl, Reason_type r, uint8_t tid,
-            uint64_t c, Match m, Buffer b)
+            uint64_t c, Match m, Buffer_ref b)
     : buffer_id(bid), total_len(tl), reason(r), tbl_id(tid), cookie(c),
       match(m), data(b) { }
 
@@ -4615,7 +4640,7 @@ struct Packet_in : Payload_base<PACKET_IN>
   uint8_t tbl_id;
   uint64_t cookie;
   Match match;
-  Buffer data;
+  Buffer_ref data;
 };
 
 /// Returns true when the messages compare equal.
@@ -4833,14 +4858,14 @@ struct Packet_out : Payload_base<PACKET_OUT>
 {
   Packet_out() = default;
   Packet_out(uint32_t bid, uint32_t ip, uint16_t al, Sequence<Action> a,
-             Greedy_buffer d)
+             Buffer_ref d)
     : buffer_id(bid), in_port(ip), actions_len(al), actions(a), data(d) { }
 
   uint32_t buffer_id;
   uint32_t in_port;
   uint16_t actions_len;
   Sequence<Action> actions;
-  Greedy_buffer data;
+  Buffer_ref data;
 };
 
 /// Returns true when the messages compare equal.
@@ -5321,7 +5346,7 @@ Error_condition is_valid(const Table_mod::Config_type c);
 /// Validates the value of a Table_mod message.
 ///
 /// \relates Table_mod
-Error_condition is_valid(const Table_mod tm);
+Error_condition is_valid(const Table_mod& tm);
 
 /// Writes a Table_mod value to a Buffer_view.
 ///
@@ -7481,6 +7506,9 @@ void construct(Meter_band_payload&, const Meter_band_payload&,
 Meter_band_payload& assign(Meter_band_payload&, const Meter_band_payload&,
                            Meter_band_type);
 
+/// \relates Meter_band_payload
+void destroy(Meter_band_payload&, Meter_band_type);
+
 /// \relates Meter_band_payload
 bool equal(const Meter_band_payload&, const Meter_band_payload&,
            Meter_band_type, Meter_band_type);
@@ -8373,7 +8401,7 @@ Error_condition is_valid(const Meter_mod::Id_value i);
 /// Validates the value of a Meter_mod message.
 ///
 /// \relates Meter_mod
-Error_condition is_valid(const Meter_mod mm);
+Error_condition is_valid(const Meter_mod& mm);
 
 /// Writes a Meter_mod value to a Buffer_view.
 ///
@@ -1016,12 +1016,16 @@ OXM_entry_field_flag(const OXM_entry_field& f) {
 }
 
 inline Error_condition
-is_valid(const Sequence<OXM_entry> r) {
+is_valid(const OXM_entry_sequence& r) {
   for (auto iter = r.begin(); iter != r.end(); iter++) {
     if(Error_decl err = is_valid(*iter))
       return err;
   }
+  return check_prerequisites(r);
+}
 
+inline Error_condition
+check_prerequisites(const OXM_entry_sequence& r) {
   // Prerequisite and conflict constraints
   uint64_t flag = 0x000000400000007D;
 
@@ -1032,7 +1036,7 @@ is_valid(const Sequence<OXM_entry> r) {
 
     switch (type) {
     case OXM_EF_IN_PORT:
-      flag &= OXM_entry_field_flag(OXM_EF_IN_PHY_PORT);
+      flag |= OXM_entry_field_flag(OXM_EF_IN_PHY_PORT);
       break;
 
     case OXM_EF_ETH_TYPE:
@@ -1752,7 +1756,7 @@ template <Instruction_type K>
 template <Instruction_type K>
   Error_condition from_buffer(Buffer_view& v, Instruction_action<K>& ia)
   {
-    if (not available(v, bytes(ia)))
+    if (not available(v, min_bytes<Instruction_action<K>>()))
       return available_error<Instruction_type, K>::value;
 
     pad(v, 4);
@@ -1911,13 +1915,17 @@ inline Error_condition
 is_valid(const Instruction& a) { return is_valid(a.payload, a.header.type); }
 
 inline Error_condition
-is_valid(const Sequence<Instruction> i) {
+is_valid(const Sequence<Instruction>& i) {
   for (auto iter = i.begin(); iter != i.end(); iter++)
   {
     if(Error_decl err = is_valid(*iter))
       return err;
   }
+  return check_instruction_set(i);
+}
 
+inline Error_condition
+check_instruction_set(const Sequence<Instruction>& i) {
   uint8_t flag = 0;
  
   for (auto iter = i.begin(); iter != i.end(); iter++)
@@ -2993,7 +3001,7 @@ is_valid(const Table_mod::Config_type c) {
 }
 
 inline Error_condition
-is_valid(const Table_mod tm) { return is_valid(tm.config); }
+is_valid(const Table_mod& tm) { return is_valid(tm.config); }
 
 
 
@@ -3067,7 +3075,7 @@ template<Multipart_type K>
   inline Error_condition
   from_buffer(Buffer_view& v, Multipart_req_flow_base<K>& f)
   {
-    if (not available(v, bytes(f)))
+    if (not available(v, min_bytes<Multipart_req_flow_base<K>>()))
       return multipart_available_error<MULTIPART_REQ, K>::value;
 
     from_buffer(v, f.table_id);
@@ -3261,7 +3269,8 @@ template<Table_feature_property_type K>
 template<Table_feature_property_type K>
   Error_condition from_buffer(Buffer_view& v,
                    Table_feature_property_instructions_base<K>& ib) {
-    if (not available(v, bytes(ib)))
+    if (not available(v,
+          min_bytes<Table_feature_property_instructions_base<K>>()))
       return available_error<Table_feature_property_type,K>::value;
     return from_buffer(v, ib.instructions);
   }
@@ -3360,7 +3369,8 @@ template<Table_feature_property_type K>
 template<Table_feature_property_type K>
   Error_condition from_buffer(Buffer_view& v,
                    Table_feature_property_next_tables_base<K>& ntb) {
-    if (not available(v, bytes(ntb)))
+    if (not available(v,
+          min_bytes<Table_feature_property_next_tables_base<K>>()))
       return available_error<Table_feature_property_type, K>::value;
     return from_buffer(v, ntb.next_table_ids);
   }
@@ -3421,7 +3431,7 @@ template<Table_feature_property_type K>
 template<Table_feature_property_type K>
   Error_condition from_buffer(Buffer_view& v,
                    Table_feature_property_actions_base<K>& ab) {
-    if (not available(v, bytes(ab)))
+    if (not available(v, min_bytes<Table_feature_property_actions_base<K>>()))
       return available_error<Table_feature_property_type, K>::value;
     return from_buffer(v, ab.actions);
   }
@@ -3490,7 +3500,7 @@ template<Table_feature_property_type K>
 template<Table_feature_property_type K>
   Error_condition from_buffer(Buffer_view& v,
                    Table_feature_property_oxm_base<K>& ob) {
-    if (not available(v, bytes(ob)))
+    if (not available(v, min_bytes<Table_feature_property_oxm_base<K>>()))
       return available_error<Table_feature_property_type, K>::value;
     return from_buffer(v, ob.oxms);
   }
@@ -3541,7 +3551,8 @@ template<Table_feature_property_type K>
 template<Table_feature_property_type K>
   Error_condition from_buffer(Buffer_view& v,
                    Table_feature_property_experimenter_base<K>& eb) {
-    if (not available(v, bytes(eb)))
+    if (not available(v,
+          min_bytes<Table_feature_property_experimenter_base<K>>()))
       return available_error<Table_feature_property_type, K>::value;
     return from_buffer(v, eb.data);
   }
@@ -4880,7 +4891,7 @@ is_valid(const Meter_mod::Id_value i) {
 }
 
 inline Error_condition
-is_valid(const Meter_mod mm)
+is_valid(const Meter_mod& mm)
 {
   if (Error_decl err = is_valid(mm.command))
     return err;
@@ -5117,18 +5128,21 @@ template<typename T, typename Tag>
   Message::Message(T&& p)
     : header(std::forward<T>(p)) {
     construct(payload, Tag(), std::forward<T>(p));
+    payload.init = true;
   }
 
 template<typename T, typename Tag>
   Message::Message(T&& p, uint32_t id)
     : header(std::forward<T>(p), id) { 
-      construct(payload, Tag(), std::forward<T>(p)); 
+      construct(payload, Tag(), std::forward<T>(p));
+      payload.init = true;
     }
 
 template<typename Tag, typename... Args>
   Message::Message(uint32_t id, Tag t, Args&&... args)
     : header(t.value) {
       construct(payload, t, std::forward<Args>(args)...);
+      payload.init = true;
       header.xid = id;
     }
 
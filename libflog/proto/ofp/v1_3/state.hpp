@@ -20,8 +20,10 @@
 #include <utility>
 
 #include <libflog/proto/ofp/fsm_config.hpp>
+#include <libflog/proto/ofp/fsm_timers.hpp>
 #include <libflog/proto/ofp/xid_gen.hpp>
 #include <libflog/proto/ofp/message.hpp>
+#include <libflog/proto/ofp/sink.hpp>
 
 #include "message.hpp"
 #include "application.hpp"
@@ -39,15 +41,14 @@ struct FSM_switch
 
   FSM_switch(const FSM_config& c, 
              Xid_generator<uint32_t>& g,
-             Agent& a)
-    : state(IDLE), role(R_EQUAL), config(c), gen(g), agent(a) { }
+             Agent& a,
+             Timer_wheel& w)
+    : state(IDLE), role(R_EQUAL), config(c), timers(w), gen(g), agent(a) { }
 
   State                       state;
   Role                        role;
   const FSM_config&           config;
-  std::map<Timer_id, Time>    timer;
-  Time                        feature_timer;
-  Time                        echo_timer;
+  FSM_timers<Message_type>    timers;
   Xid_generator<uint32_t>&    gen;
   Agent&                      agent;
 };
@@ -66,18 +67,23 @@ State_result fini(FSM_switch& s, const Time& t);
 State_result recv(FSM_switch& s, const Time& t, const Message& m);
 State_result time(FSM_switch& s, const Time& t);
 
+// These forms put the messages to be sent into the sink out, and return
+// false when the state machine stops.
+bool init(FSM_switch& s, const Time& t, Message_sink& out);
+bool recv(FSM_switch& s, const Time& t, const Message& m, Message_sink& out);
+bool time(FSM_switch& s, const Time& t, Message_sink& out);
+
 struct FSM_controller 
 {
   enum State { IDLE, FEATURE_WAIT, ESTABLISHED, FAIL };
 
-  FSM_controller(const FSM_config& c, Xid_generator<uint32_t>& g, Application& a)
-    : state(IDLE), config(c), gen(g), app(a) { }
+  FSM_controller(const FSM_config& c, Xid_generator<uint32_t>& g, Application& a,
+                 Timer_wheel& w)
+    : state(IDLE), config(c), timers(w), gen(g), app(a) { }
 
   State                       state;
   const FSM_config&           config;
-  std::map<Timer_id, Time>    timer;
-  Time                        feature_timer;
-  Time                        echo_timer;
+  FSM_timers<Message_type>    timers;
   Xid_generator<uint32_t>&    gen;
   Application&                app;
 };
@@ -96,6 +102,12 @@ State_result fini(FSM_controller& c, const Time& t);
 State_result recv(FSM_controller& c, const Time& t, const Message& m);
 State_result time(FSM_controller& c, const Time& t);
 
+// These forms put the messages to be sent into the sink out, and return
+// false when the state machine stops.
+bool init(FSM_controller& c, const Time& t, Message_sink& out);
+bool recv(FSM_controller& c, const Time& t, const Message& m, Message_sink& out);
+bool time(FSM_controller& c, const Time& t, Message_sink& out);
+
 } // namespace v1_3
 } // namespace ofp
 } // namespace flog
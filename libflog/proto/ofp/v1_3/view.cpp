@@ -0,0 +1,233 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include "view.hpp"
+
+namespace flog {
+namespace ofp {
+namespace v1_3 {
+
+namespace {
+
+// Offsets of the variable-length parts of messages, including the header.
+const std::size_t Packet_in_base = 24;
+const std::size_t Packet_out_base = 24;
+const std::size_t Flow_mod_base = 48;
+
+// The shortest Packet_in has an empty match and two bytes of padding.
+const std::size_t Packet_in_min = Packet_in_base + 8 + 2;
+
+// The shortest Flow_mod has an empty match and no instructions.
+const std::size_t Flow_mod_min = Flow_mod_base + 8;
+
+// Check the header of a message of type t whose length is at least n
+// bytes, and that the entire message is in the view. On success, last is
+// set to the end of the message.
+Error_condition
+check_header(Buffer_view& v, Message_type t, std::size_t n, Byte*& last)
+{
+  if (not available(v, bytes(Header())))
+    return AVAILABLE_HEADER;
+  if (v.first[0] != VERSION)
+    return BAD_VERSION;
+  if (v.first[1] != t)
+    return BAD_MESSAGE;
+  std::size_t len = load<uint16_t>(v.first + 2);
+  if (len < n)
+    return BAD_MESSAGE_LENGTH;
+  if (not available(v, len))
+    return AVAILABLE_PAYLOAD;
+  last = v.first + len;
+  return SUCCESS;
+}
+
+Error_condition
+check_entries(const Byte* p, const Byte* last)
+{
+  while (p != last) {
+    if (last - p < 4)
+      return AVAILABLE_OXM_ENTRY_HEADER;
+    std::size_t n = bytes(OXM_entry_view(p));
+    if (std::size_t(last - p) < n)
+      return AVAILABLE_OXM_ENTRY_PAYLOAD;
+    p += n;
+  }
+  return SUCCESS;
+}
+
+Error_condition
+check_match(const Byte* p, const Byte* last)
+{
+  if (last - p < 4)
+    return AVAILABLE_MATCH;
+  Match_view m(p);
+  if (m.length() < 4)
+    return BAD_MATCH_LENGTH;
+  if (std::size_t(last - p) < bytes(m))
+    return AVAILABLE_MATCH_PADDING;
+  return check_entries(p + 4, p + m.length());
+}
+
+Error_condition
+check_actions(const Byte* p, const Byte* last)
+{
+  while (p != last) {
+    if (last - p < 4)
+      return AVAILABLE_ACTION_HEADER;
+    std::size_t n = bytes(Action_view(p));
+    if (n < 4)
+      return BAD_ACTION_LENGTH;
+    if (std::size_t(last - p) < n)
+      return AVAILABLE_ACTION_PAYLOAD;
+    p += n;
+  }
+  return SUCCESS;
+}
+
+// Returns the least length of an instruction of type t, whose payload
+// holds at least its fixed fields.
+std::size_t
+instruction_min(Instruction_type t)
+{
+  switch (t) {
+  case INSTRUCTION_WRITE_METADATA: return 24;
+  case INSTRUCTION_GOTO_TABLE:
+  case INSTRUCTION_WRITE_ACTIONS:
+  case INSTRUCTION_APPLY_ACTIONS:
+  case INSTRUCTION_CLEAR_ACTIONS:
+  case INSTRUCTION_METER:
+  case INSTRUCTION_EXPERIMENTER: return 8;
+  default: return 4;
+  }
+}
+
+Error_condition
+check_instructions(const Byte* p, const Byte* last)
+{
+  while (p != last) {
+    if (last - p < 4)
+      return AVAILABLE_INSTRUCTION_HEADER;
+    Instruction_view i(p);
+    std::size_t n = bytes(i);
+    if (n < instruction_min(i.type()))
+      return BAD_INSTRUCTION_LENGTH;
+    if (std::size_t(last - p) < n)
+      return AVAILABLE_INSTRUCTION_PAYLOAD;
+    switch (i.type()) {
+    case INSTRUCTION_WRITE_ACTIONS:
+    case INSTRUCTION_APPLY_ACTIONS:
+      if (Error_decl err = check_actions(p + 8, p + n))
+        return err;
+      break;
+    default:
+      break;
+    }
+    p += n;
+  }
+  return SUCCESS;
+}
+
+} // namespace
+
+// -------------------------------------------------------------------------- //
+// Match view
+
+Match_view::iterator
+find(const Match_view& m, OXM_entry_field f)
+{
+  return std::find_if(m.begin(), m.end(), [f](const OXM_entry_view& e) {
+    return e.oxm_class() == OPEN_FLOW_BASIC and (e.field() & ~1) == (f & ~1);
+  });
+}
+
+// -------------------------------------------------------------------------- //
+// Packet in view
+
+Error_condition
+from_buffer(Buffer_view& v, Packet_in_view& pi)
+{
+  Byte* last;
+  if (Error_decl err = check_header(v, PACKET_IN, Packet_in_min, last))
+    return err;
+
+  Byte* first = v.first;
+  if (Error_decl err = check_match(first + Packet_in_base, last))
+    return err;
+
+  // The match is followed by two bytes of padding.
+  Match_view m(first + Packet_in_base);
+  Byte* packet = first + Packet_in_base + bytes(m) + 2;
+  if (packet > last)
+    return AVAILABLE_PACKET_IN_PADDING;
+
+  pi.first = first;
+  pi.packet = packet;
+  pi.last = last;
+  v.first = last;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Packet out view
+
+Error_condition
+from_buffer(Buffer_view& v, Packet_out_view& po)
+{
+  Byte* last;
+  if (Error_decl err = check_header(v, PACKET_OUT, Packet_out_base, last))
+    return err;
+
+  Byte* first = v.first;
+  std::size_t n = load<uint16_t>(first + 16);
+  if (std::size_t(last - first) < Packet_out_base + n)
+    return BAD_PACKET_OUT_LENGTH;
+  Byte* actions = first + Packet_out_base;
+  if (Error_decl err = check_actions(actions, actions + n))
+    return err;
+
+  po.first = first;
+  po.last = last;
+  v.first = last;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Flow mod view
+
+Error_condition
+from_buffer(Buffer_view& v, Flow_mod_view& fm)
+{
+  Byte* last;
+  if (Error_decl err = check_header(v, FLOW_MOD, Flow_mod_min, last))
+    return err;
+
+  Byte* first = v.first;
+  if (Error_decl err = check_match(first + Flow_mod_base, last))
+    return err;
+
+  Match_view m(first + Flow_mod_base);
+  Byte* instrs = first + Flow_mod_base + bytes(m);
+  if (Error_decl err = check_instructions(instrs, last))
+    return err;
+
+  fm.first = first;
+  fm.instrs = instrs;
+  fm.last = last;
+  v.first = last;
+  return SUCCESS;
+}
+
+} // namespace v1_3
+} // namespace ofp
+} // namespace flog
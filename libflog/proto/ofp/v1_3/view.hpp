@@ -0,0 +1,296 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_PROTO_OFP_V1_3_VIEW_H
+#define FLOWGRAMMABLE_PROTO_OFP_V1_3_VIEW_H
+
+#include <libflog/proto/ofp/view.hpp>
+#include <libflog/proto/ofp/v1_3/message.hpp>
+
+/// \file view.hpp
+/// Read-only views of OpenFlow v1.3 messages in their wire representation.
+///
+/// Decoding a Message builds the entire object tree, including the entries
+/// of a match and every action, even when only a field or two are read. A
+/// view instead checks the framing of a message once, when it is bound to
+/// a buffer, and then reads each field from the wire bytes on access.
+/// Entries of a match, instructions and actions are visited by iterators
+/// that never allocate.
+///
+/// Views are provided for the messages on the hot path of a controller:
+/// Packet_in, Packet_out and Flow_mod. Other messages are decoded.
+///
+/// A view refers to the buffer it was bound to, which must outlive it.
+
+namespace flog {
+namespace ofp {
+namespace v1_3 {
+
+// -------------------------------------------------------------------------- //
+// OXM entry view
+
+/// A view of an encoded OXM entry.
+struct OXM_entry_view
+{
+  explicit OXM_entry_view(const Byte* p)
+    : first(p) { }
+
+  OXM_entry_class oxm_class() const { return load<OXM_entry_class>(first); }
+
+  /// Returns the field. Fields carrying a mask have the low bit set.
+  OXM_entry_field field() const { return OXM_entry_field(first[2]); }
+
+  /// Returns true if the payload is a value followed by a mask.
+  bool has_mask() const { return first[2] & 1; }
+
+  /// Returns the length of the payload.
+  uint8_t length() const { return first[3]; }
+
+  const Byte* payload() const { return first + 4; }
+
+  /// Returns the leading bytes of the payload as a value of type T.
+  template<typename T>
+    T value() const { return load<T>(payload()); }
+
+  const Byte* first;
+};
+
+/// \relates OXM_entry_view
+inline std::size_t
+bytes(const OXM_entry_view& e) { return 4 + e.length(); }
+
+// -------------------------------------------------------------------------- //
+// Action view
+
+/// A view of an encoded action.
+struct Action_view
+{
+  explicit Action_view(const Byte* p)
+    : first(p) { }
+
+  Action_type type() const { return load<Action_type>(first); }
+  uint16_t length() const { return load<uint16_t>(first + 2); }
+
+  const Byte* payload() const { return first + 4; }
+
+  const Byte* first;
+};
+
+/// \relates Action_view
+inline std::size_t
+bytes(const Action_view& a) { return a.length(); }
+
+using Action_sequence_view = Wire_sequence<Action_view>;
+
+// -------------------------------------------------------------------------- //
+// Instruction view
+
+/// \brief A view of an encoded instruction.
+///
+/// The accessors of a payload field may only be called on instructions
+/// of the types that carry it.
+struct Instruction_view
+{
+  explicit Instruction_view(const Byte* p)
+    : first(p) { }
+
+  Instruction_type type() const { return load<Instruction_type>(first); }
+  uint16_t length() const { return load<uint16_t>(first + 2); }
+
+  const Byte* payload() const { return first + 4; }
+
+  /// Returns the table of a goto table instruction.
+  uint8_t table_id() const { return first[4]; }
+
+  /// Returns the metadata of a write metadata instruction.
+  uint64_t metadata() const { return load<uint64_t>(first + 8); }
+  uint64_t metadata_mask() const { return load<uint64_t>(first + 16); }
+
+  /// Returns the actions of a write, apply or clear actions instruction.
+  Action_sequence_view actions() const {
+    return Action_sequence_view(first + 8, first + length());
+  }
+
+  /// Returns the meter of a meter instruction.
+  uint32_t meter_id() const { return load<uint32_t>(first + 4); }
+
+  const Byte* first;
+};
+
+/// \relates Instruction_view
+inline std::size_t
+bytes(const Instruction_view& i) { return i.length(); }
+
+using Instruction_sequence_view = Wire_sequence<Instruction_view>;
+
+// -------------------------------------------------------------------------- //
+// Match view
+
+/// A view of an encoded match.
+struct Match_view
+{
+  using iterator = Wire_iterator<OXM_entry_view>;
+
+  explicit Match_view(const Byte* p)
+    : first(p) { }
+
+  Match::Type type() const { return load<Match::Type>(first); }
+
+  /// Returns the length of the match, excluding padding.
+  uint16_t length() const { return load<uint16_t>(first + 2); }
+
+  iterator begin() const { return iterator(first + 4); }
+  iterator end() const { return iterator(first + length()); }
+
+  const Byte* first;
+};
+
+/// Returns the encoded length of the match, including padding.
+///
+/// \relates Match_view
+inline std::size_t
+bytes(const Match_view& m) { return (m.length() + 7) / 8 * 8; }
+
+/// Returns the first entry for the field f, whether or not it carries a
+/// mask, or the end of the match if there is none.
+///
+/// \relates Match_view
+Match_view::iterator find(const Match_view& m, OXM_entry_field f);
+
+// -------------------------------------------------------------------------- //
+// Packet in view
+
+/// \brief A view of an encoded Packet_in message.
+///
+/// For example, to find the ingress port of a packet without decoding
+/// the message:
+///
+///     Packet_in_view pi;
+///     if (from_buffer(v, pi)) {
+///       auto i = find(pi.match(), OXM_EF_IN_PORT);
+///       if (i != pi.match().end())
+///         port = (*i).value<uint32_t>();
+///     }
+struct Packet_in_view
+{
+  Packet_in_view()
+    : first(nullptr), packet(nullptr), last(nullptr) { }
+
+  uint32_t xid() const { return load<uint32_t>(first + 4); }
+
+  uint32_t buffer_id() const { return load<uint32_t>(first + 8); }
+  uint16_t total_len() const { return load<uint16_t>(first + 12); }
+  Packet_in::Reason_type reason() const {
+    return Packet_in::Reason_type(first[14]);
+  }
+  uint8_t tbl_id() const { return first[15]; }
+  uint64_t cookie() const { return load<uint64_t>(first + 16); }
+
+  Match_view match() const { return Match_view(first + 24); }
+
+  /// Returns the packet, borrowed from the underlying buffer.
+  Buffer_ref data() const { return Buffer_ref(packet, last); }
+
+  Byte* first;  ///< The start of the message
+  Byte* packet; ///< The start of the packet data
+  Byte* last;   ///< The end of the message
+};
+
+/// Binds the view to the message at the front of v and advances v past
+/// it. This checks the framing of the header, the match and its entries,
+/// but does not validate field values.
+///
+/// \relates Packet_in_view
+Error_condition from_buffer(Buffer_view& v, Packet_in_view& pi);
+
+// -------------------------------------------------------------------------- //
+// Packet out view
+
+/// A view of an encoded Packet_out message.
+struct Packet_out_view
+{
+  Packet_out_view()
+    : first(nullptr), last(nullptr) { }
+
+  uint32_t xid() const { return load<uint32_t>(first + 4); }
+
+  uint32_t buffer_id() const { return load<uint32_t>(first + 8); }
+  uint32_t in_port() const { return load<uint32_t>(first + 12); }
+  uint16_t actions_len() const { return load<uint16_t>(first + 16); }
+
+  Action_sequence_view actions() const {
+    return Action_sequence_view(first + 24, first + 24 + actions_len());
+  }
+
+  /// Returns the packet, borrowed from the underlying buffer.
+  Buffer_ref data() const {
+    return Buffer_ref(first + 24 + actions_len(), last);
+  }
+
+  Byte* first; ///< The start of the message
+  Byte* last;  ///< The end of the message
+};
+
+/// Binds the view to the message at the front of v and advances v past
+/// it. This checks the framing of the header and of each action.
+///
+/// \relates Packet_out_view
+Error_condition from_buffer(Buffer_view& v, Packet_out_view& po);
+
+// -------------------------------------------------------------------------- //
+// Flow mod view
+
+/// A view of an encoded Flow_mod message.
+struct Flow_mod_view
+{
+  Flow_mod_view()
+    : first(nullptr), instrs(nullptr), last(nullptr) { }
+
+  uint32_t xid() const { return load<uint32_t>(first + 4); }
+
+  uint64_t cookie() const { return load<uint64_t>(first + 8); }
+  uint64_t cookie_mask() const { return load<uint64_t>(first + 16); }
+  uint8_t table_id() const { return first[24]; }
+  Flow_mod::Command command() const { return Flow_mod::Command(first[25]); }
+  uint16_t idle_timeout() const { return load<uint16_t>(first + 26); }
+  uint16_t hard_timeout() const { return load<uint16_t>(first + 28); }
+  uint16_t priority() const { return load<uint16_t>(first + 30); }
+  uint32_t buffer_id() const { return load<uint32_t>(first + 32); }
+  uint32_t out_port() const { return load<uint32_t>(first + 36); }
+  uint32_t out_group() const { return load<uint32_t>(first + 40); }
+  Flow_mod::Flags flags() const { return load<Flow_mod::Flags>(first + 44); }
+
+  Match_view match() const { return Match_view(first + 48); }
+
+  Instruction_sequence_view instructions() const {
+    return Instruction_sequence_view(instrs, last);
+  }
+
+  Byte* first;  ///< The start of the message
+  Byte* instrs; ///< The start of the instructions
+  Byte* last;   ///< The end of the message
+};
+
+/// Binds the view to the message at the front of v and advances v past
+/// it. This checks the framing of the header, the match and its entries,
+/// and of each instruction and the actions it carries.
+///
+/// \relates Flow_mod_view
+Error_condition from_buffer(Buffer_view& v, Flow_mod_view& fm);
+
+} // namespace v1_3
+} // namespace ofp
+} // namespace flog
+
+#endif
@@ -0,0 +1,915 @@
+// Generated by ofp_codegen.py from v1_3.schema. Do not edit.
+
+#include <cstring>
+
+#include <libflog/proto/ofp/v1_3_1/message.hpp>
+
+namespace flog {
+namespace ofp {
+namespace v1_3_1 {
+
+// -------------------------------------------------------------------------- //
+// Action_output (12 bytes)
+
+static_assert(sizeof(Action_output::port) == 4, "Action_output::port");
+static_assert(sizeof(Action_output::max_len) == 2, "Action_output::max_len");
+
+Error_condition
+to_buffer(Buffer_view& v, const Action_output& x)
+{
+  assert(bytes(x) == 12);
+  if (not available(v, 12))
+    return AVAILABLE_ACTION_OUTPUT;
+  Byte* p = v.first;
+  store(p + 0, x.port);
+  store(p + 4, x.max_len);
+  std::memset(p + 6, 0, 6);
+  v.first += 12;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Action_output& x)
+{
+  assert(bytes(x) == 12);
+  if (not available(v, 12))
+    return AVAILABLE_ACTION_OUTPUT;
+  const Byte* p = v.first;
+  x.port = load<decltype(x.port)>(p + 0);
+  x.max_len = load<decltype(x.max_len)>(p + 4);
+  v.first += 12;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Action_copy_ttl_out (4 bytes)
+
+Error_condition
+to_buffer(Buffer_view& v, const Action_copy_ttl_out& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_ACTION_COPY_TTL_OUT;
+  Byte* p = v.first;
+  std::memset(p + 0, 0, 4);
+  v.first += 4;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Action_copy_ttl_out& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_ACTION_COPY_TTL_OUT;
+  v.first += 4;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Action_copy_ttl_in (4 bytes)
+
+Error_condition
+to_buffer(Buffer_view& v, const Action_copy_ttl_in& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_ACTION_COPY_TTL_IN;
+  Byte* p = v.first;
+  std::memset(p + 0, 0, 4);
+  v.first += 4;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Action_copy_ttl_in& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_ACTION_COPY_TTL_IN;
+  v.first += 4;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Action_set_queue (4 bytes)
+
+static_assert(sizeof(Action_set_queue::queue_id) == 4, "Action_set_queue::queue_id");
+
+Error_condition
+to_buffer(Buffer_view& v, const Action_set_queue& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_ACTION_SET_QUEUE;
+  Byte* p = v.first;
+  store(p + 0, x.queue_id);
+  v.first += 4;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Action_set_queue& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_ACTION_SET_QUEUE;
+  const Byte* p = v.first;
+  x.queue_id = load<decltype(x.queue_id)>(p + 0);
+  v.first += 4;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Action_group (4 bytes)
+
+static_assert(sizeof(Action_group::group_id) == 4, "Action_group::group_id");
+
+Error_condition
+to_buffer(Buffer_view& v, const Action_group& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_ACTION_GROUP;
+  Byte* p = v.first;
+  store(p + 0, x.group_id);
+  v.first += 4;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Action_group& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_ACTION_GROUP;
+  const Byte* p = v.first;
+  x.group_id = load<decltype(x.group_id)>(p + 0);
+  v.first += 4;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Action_pop_pbb (4 bytes)
+
+Error_condition
+to_buffer(Buffer_view& v, const Action_pop_pbb& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_ACTION_POP_PBB;
+  Byte* p = v.first;
+  std::memset(p + 0, 0, 4);
+  v.first += 4;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Action_pop_pbb& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_ACTION_POP_PBB;
+  v.first += 4;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Instruction_goto_table (4 bytes)
+
+static_assert(sizeof(Instruction_goto_table::table_id) == 1, "Instruction_goto_table::table_id");
+
+Error_condition
+to_buffer(Buffer_view& v, const Instruction_goto_table& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_INSTRUCTION_GOTO_TABLE;
+  Byte* p = v.first;
+  store(p + 0, x.table_id);
+  std::memset(p + 1, 0, 3);
+  v.first += 4;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Instruction_goto_table& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_INSTRUCTION_GOTO_TABLE;
+  const Byte* p = v.first;
+  x.table_id = load<decltype(x.table_id)>(p + 0);
+  v.first += 4;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Instruction_write_metadata (20 bytes)
+
+static_assert(sizeof(Instruction_write_metadata::metadata) == 8, "Instruction_write_metadata::metadata");
+static_assert(sizeof(Instruction_write_metadata::metadata_mask) == 8, "Instruction_write_metadata::metadata_mask");
+
+Error_condition
+to_buffer(Buffer_view& v, const Instruction_write_metadata& x)
+{
+  assert(bytes(x) == 20);
+  if (not available(v, 20))
+    return AVAILABLE_INSTRUCTION_WRITE_METADATA;
+  Byte* p = v.first;
+  std::memset(p + 0, 0, 4);
+  store(p + 4, x.metadata);
+  store(p + 12, x.metadata_mask);
+  v.first += 20;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Instruction_write_metadata& x)
+{
+  assert(bytes(x) == 20);
+  if (not available(v, 20))
+    return AVAILABLE_INSTRUCTION_WRITE_METADATA;
+  const Byte* p = v.first;
+  x.metadata = load<decltype(x.metadata)>(p + 4);
+  x.metadata_mask = load<decltype(x.metadata_mask)>(p + 12);
+  v.first += 20;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Instruction_meter (4 bytes)
+
+static_assert(sizeof(Instruction_meter::meter_id) == 4, "Instruction_meter::meter_id");
+
+Error_condition
+to_buffer(Buffer_view& v, const Instruction_meter& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_INSTRUCTION_METER;
+  Byte* p = v.first;
+  store(p + 0, x.meter_id);
+  v.first += 4;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Instruction_meter& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_INSTRUCTION_METER;
+  const Byte* p = v.first;
+  x.meter_id = load<decltype(x.meter_id)>(p + 0);
+  v.first += 4;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Port (64 bytes)
+
+static_assert(sizeof(Port::port_id) == 4, "Port::port_id");
+static_assert(sizeof(Port::config) == 4, "Port::config");
+static_assert(sizeof(Port::state) == 4, "Port::state");
+static_assert(sizeof(Port::curr) == 4, "Port::curr");
+static_assert(sizeof(Port::advertised) == 4, "Port::advertised");
+static_assert(sizeof(Port::supported) == 4, "Port::supported");
+static_assert(sizeof(Port::peer) == 4, "Port::peer");
+static_assert(sizeof(Port::curr_speed) == 4, "Port::curr_speed");
+static_assert(sizeof(Port::max_speed) == 4, "Port::max_speed");
+
+Error_condition
+to_buffer(Buffer_view& v, const Port& x)
+{
+  assert(bytes(x) == 64);
+  if (not available(v, 64))
+    return AVAILABLE_PORT;
+  Byte* p = v.first;
+  store(p + 0, x.port_id);
+  std::memset(p + 4, 0, 4);
+  std::memcpy(p + 8, x.hw_addr.data, 6);
+  std::memset(p + 14, 0, 2);
+  std::memcpy(p + 16, x.name.data(), 16);
+  store(p + 32, x.config);
+  store(p + 36, x.state);
+  store(p + 40, x.curr);
+  store(p + 44, x.advertised);
+  store(p + 48, x.supported);
+  store(p + 52, x.peer);
+  store(p + 56, x.curr_speed);
+  store(p + 60, x.max_speed);
+  v.first += 64;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Port& x)
+{
+  assert(bytes(x) == 64);
+  if (not available(v, 64))
+    return AVAILABLE_PORT;
+  const Byte* p = v.first;
+  x.port_id = load<decltype(x.port_id)>(p + 0);
+  std::memcpy(x.hw_addr.data, p + 8, 6);
+  std::memcpy(x.name.data(), p + 16, 16);
+  x.config = load<decltype(x.config)>(p + 32);
+  x.state = load<decltype(x.state)>(p + 36);
+  x.curr = load<decltype(x.curr)>(p + 40);
+  x.advertised = load<decltype(x.advertised)>(p + 44);
+  x.supported = load<decltype(x.supported)>(p + 48);
+  x.peer = load<decltype(x.peer)>(p + 52);
+  x.curr_speed = load<decltype(x.curr_speed)>(p + 56);
+  x.max_speed = load<decltype(x.max_speed)>(p + 60);
+  v.first += 64;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Queue_property_min_rate (8 bytes)
+
+static_assert(sizeof(Queue_property_min_rate::rate) == 2, "Queue_property_min_rate::rate");
+
+Error_condition
+to_buffer(Buffer_view& v, const Queue_property_min_rate& x)
+{
+  assert(bytes(x) == 8);
+  if (not available(v, 8))
+    return AVAILABLE_QUEUE_PROPERTY_MIN_RATE;
+  Byte* p = v.first;
+  store(p + 0, x.rate);
+  std::memset(p + 2, 0, 6);
+  v.first += 8;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Queue_property_min_rate& x)
+{
+  assert(bytes(x) == 8);
+  if (not available(v, 8))
+    return AVAILABLE_QUEUE_PROPERTY_MIN_RATE;
+  const Byte* p = v.first;
+  x.rate = load<decltype(x.rate)>(p + 0);
+  v.first += 8;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Queue_property_max_rate (8 bytes)
+
+static_assert(sizeof(Queue_property_max_rate::rate) == 2, "Queue_property_max_rate::rate");
+
+Error_condition
+to_buffer(Buffer_view& v, const Queue_property_max_rate& x)
+{
+  assert(bytes(x) == 8);
+  if (not available(v, 8))
+    return AVAILABLE_QUEUE_PROPERTY_MAX_RATE;
+  Byte* p = v.first;
+  store(p + 0, x.rate);
+  std::memset(p + 2, 0, 6);
+  v.first += 8;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Queue_property_max_rate& x)
+{
+  assert(bytes(x) == 8);
+  if (not available(v, 8))
+    return AVAILABLE_QUEUE_PROPERTY_MAX_RATE;
+  const Byte* p = v.first;
+  x.rate = load<decltype(x.rate)>(p + 0);
+  v.first += 8;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Bucket_counter (16 bytes)
+
+static_assert(sizeof(Bucket_counter::packet_count) == 8, "Bucket_counter::packet_count");
+static_assert(sizeof(Bucket_counter::byte_count) == 8, "Bucket_counter::byte_count");
+
+Error_condition
+to_buffer(Buffer_view& v, const Bucket_counter& x)
+{
+  assert(bytes(x) == 16);
+  if (not available(v, 16))
+    return AVAILABLE_BUCKET_COUNTER;
+  Byte* p = v.first;
+  store(p + 0, x.packet_count);
+  store(p + 8, x.byte_count);
+  v.first += 16;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Bucket_counter& x)
+{
+  assert(bytes(x) == 16);
+  if (not available(v, 16))
+    return AVAILABLE_BUCKET_COUNTER;
+  const Byte* p = v.first;
+  x.packet_count = load<decltype(x.packet_count)>(p + 0);
+  x.byte_count = load<decltype(x.byte_count)>(p + 8);
+  v.first += 16;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Feature_res (24 bytes)
+
+static_assert(sizeof(Feature_res::datapath_id) == 8, "Feature_res::datapath_id");
+static_assert(sizeof(Feature_res::n_buffers) == 4, "Feature_res::n_buffers");
+static_assert(sizeof(Feature_res::n_tbls) == 1, "Feature_res::n_tbls");
+static_assert(sizeof(Feature_res::aux_id) == 1, "Feature_res::aux_id");
+static_assert(sizeof(Feature_res::capabilities) == 4, "Feature_res::capabilities");
+static_assert(sizeof(Feature_res::reserved) == 4, "Feature_res::reserved");
+
+Error_condition
+to_buffer(Buffer_view& v, const Feature_res& x)
+{
+  assert(bytes(x) == 24);
+  if (not available(v, 24))
+    return AVAILABLE_FEATURE_RES;
+  Byte* p = v.first;
+  store(p + 0, x.datapath_id);
+  store(p + 8, x.n_buffers);
+  store(p + 12, x.n_tbls);
+  store(p + 13, x.aux_id);
+  std::memset(p + 14, 0, 2);
+  store(p + 16, x.capabilities);
+  store(p + 20, x.reserved);
+  v.first += 24;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Feature_res& x)
+{
+  assert(bytes(x) == 24);
+  if (not available(v, 24))
+    return AVAILABLE_FEATURE_RES;
+  const Byte* p = v.first;
+  x.datapath_id = load<decltype(x.datapath_id)>(p + 0);
+  x.n_buffers = load<decltype(x.n_buffers)>(p + 8);
+  x.n_tbls = load<decltype(x.n_tbls)>(p + 12);
+  x.aux_id = load<decltype(x.aux_id)>(p + 13);
+  x.capabilities = load<decltype(x.capabilities)>(p + 16);
+  x.reserved = load<decltype(x.reserved)>(p + 20);
+  v.first += 24;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Port_mod (32 bytes)
+
+static_assert(sizeof(Port_mod::port) == 4, "Port_mod::port");
+static_assert(sizeof(Port_mod::config) == 4, "Port_mod::config");
+static_assert(sizeof(Port_mod::mask) == 4, "Port_mod::mask");
+static_assert(sizeof(Port_mod::advertise) == 4, "Port_mod::advertise");
+
+Error_condition
+to_buffer(Buffer_view& v, const Port_mod& x)
+{
+  assert(bytes(x) == 32);
+  if (not available(v, 32))
+    return AVAILABLE_PORT_MOD;
+  Byte* p = v.first;
+  store(p + 0, x.port);
+  std::memset(p + 4, 0, 4);
+  std::memcpy(p + 8, x.hw_addr.data, 6);
+  std::memset(p + 14, 0, 2);
+  store(p + 16, x.config);
+  store(p + 20, x.mask);
+  store(p + 24, x.advertise);
+  std::memset(p + 28, 0, 4);
+  v.first += 32;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Port_mod& x)
+{
+  assert(bytes(x) == 32);
+  if (not available(v, 32))
+    return AVAILABLE_PORT_MOD;
+  const Byte* p = v.first;
+  x.port = load<decltype(x.port)>(p + 0);
+  std::memcpy(x.hw_addr.data, p + 8, 6);
+  x.config = load<decltype(x.config)>(p + 16);
+  x.mask = load<decltype(x.mask)>(p + 20);
+  x.advertise = load<decltype(x.advertise)>(p + 24);
+  v.first += 32;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Table_mod (8 bytes)
+
+static_assert(sizeof(Table_mod::table_id) == 1, "Table_mod::table_id");
+static_assert(sizeof(Table_mod::config) == 4, "Table_mod::config");
+
+Error_condition
+to_buffer(Buffer_view& v, const Table_mod& x)
+{
+  assert(bytes(x) == 8);
+  if (not available(v, 8))
+    return AVAILABLE_TABLE_MOD;
+  Byte* p = v.first;
+  store(p + 0, x.table_id);
+  std::memset(p + 1, 0, 3);
+  store(p + 4, x.config);
+  v.first += 8;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Table_mod& x)
+{
+  assert(bytes(x) == 8);
+  if (not available(v, 8))
+    return AVAILABLE_TABLE_MOD;
+  const Byte* p = v.first;
+  x.table_id = load<decltype(x.table_id)>(p + 0);
+  x.config = load<decltype(x.config)>(p + 4);
+  v.first += 8;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Queue_get_config_req (8 bytes)
+
+static_assert(sizeof(Queue_get_config_req::port) == 4, "Queue_get_config_req::port");
+
+Error_condition
+to_buffer(Buffer_view& v, const Queue_get_config_req& x)
+{
+  assert(bytes(x) == 8);
+  if (not available(v, 8))
+    return AVAILABLE_QUEUE_GET_CONFIG_REQ;
+  Byte* p = v.first;
+  store(p + 0, x.port);
+  std::memset(p + 4, 0, 4);
+  v.first += 8;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Queue_get_config_req& x)
+{
+  assert(bytes(x) == 8);
+  if (not available(v, 8))
+    return AVAILABLE_QUEUE_GET_CONFIG_REQ;
+  const Byte* p = v.first;
+  x.port = load<decltype(x.port)>(p + 0);
+  v.first += 8;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Meter_band_drop (4 bytes)
+
+Error_condition
+to_buffer(Buffer_view& v, const Meter_band_drop& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_METER_BAND_DROP;
+  Byte* p = v.first;
+  std::memset(p + 0, 0, 4);
+  v.first += 4;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Meter_band_drop& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_METER_BAND_DROP;
+  v.first += 4;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Meter_band_dscp_remark (4 bytes)
+
+static_assert(sizeof(Meter_band_dscp_remark::prec_level) == 1, "Meter_band_dscp_remark::prec_level");
+
+Error_condition
+to_buffer(Buffer_view& v, const Meter_band_dscp_remark& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_METER_BAND_DSCP_REMARK;
+  Byte* p = v.first;
+  store(p + 0, x.prec_level);
+  std::memset(p + 1, 0, 3);
+  v.first += 4;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Meter_band_dscp_remark& x)
+{
+  assert(bytes(x) == 4);
+  if (not available(v, 4))
+    return AVAILABLE_METER_BAND_DSCP_REMARK;
+  const Byte* p = v.first;
+  x.prec_level = load<decltype(x.prec_level)>(p + 0);
+  v.first += 4;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Meter_band_stats (16 bytes)
+
+static_assert(sizeof(Meter_band_stats::packet_band_count) == 8, "Meter_band_stats::packet_band_count");
+static_assert(sizeof(Meter_band_stats::byte_band_count) == 8, "Meter_band_stats::byte_band_count");
+
+Error_condition
+to_buffer(Buffer_view& v, const Meter_band_stats& x)
+{
+  assert(bytes(x) == 16);
+  if (not available(v, 16))
+    return AVAILABLE_METER_BAND_STATS;
+  Byte* p = v.first;
+  store(p + 0, x.packet_band_count);
+  store(p + 8, x.byte_band_count);
+  v.first += 16;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Meter_band_stats& x)
+{
+  assert(bytes(x) == 16);
+  if (not available(v, 16))
+    return AVAILABLE_METER_BAND_STATS;
+  const Byte* p = v.first;
+  x.packet_band_count = load<decltype(x.packet_band_count)>(p + 0);
+  x.byte_band_count = load<decltype(x.byte_band_count)>(p + 8);
+  v.first += 16;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Multipart_req_port (8 bytes)
+
+static_assert(sizeof(Multipart_req_port::port_no) == 4, "Multipart_req_port::port_no");
+
+Error_condition
+to_buffer(Buffer_view& v, const Multipart_req_port& x)
+{
+  assert(bytes(x) == 8);
+  if (not available(v, 8))
+    return AVAILABLE_MULTIPART_REQ_PORT;
+  Byte* p = v.first;
+  store(p + 0, x.port_no);
+  std::memset(p + 4, 0, 4);
+  v.first += 8;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Multipart_req_port& x)
+{
+  assert(bytes(x) == 8);
+  if (not available(v, 8))
+    return AVAILABLE_MULTIPART_REQ_PORT;
+  const Byte* p = v.first;
+  x.port_no = load<decltype(x.port_no)>(p + 0);
+  v.first += 8;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Multipart_req_queue (8 bytes)
+
+static_assert(sizeof(Multipart_req_queue::port_no) == 4, "Multipart_req_queue::port_no");
+static_assert(sizeof(Multipart_req_queue::queue_id) == 4, "Multipart_req_queue::queue_id");
+
+Error_condition
+to_buffer(Buffer_view& v, const Multipart_req_queue& x)
+{
+  assert(bytes(x) == 8);
+  if (not available(v, 8))
+    return AVAILABLE_MULTIPART_REQ_QUEUE;
+  Byte* p = v.first;
+  store(p + 0, x.port_no);
+  store(p + 4, x.queue_id);
+  v.first += 8;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Multipart_req_queue& x)
+{
+  assert(bytes(x) == 8);
+  if (not available(v, 8))
+    return AVAILABLE_MULTIPART_REQ_QUEUE;
+  const Byte* p = v.first;
+  x.port_no = load<decltype(x.port_no)>(p + 0);
+  x.queue_id = load<decltype(x.queue_id)>(p + 4);
+  v.first += 8;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Multipart_req_group (8 bytes)
+
+static_assert(sizeof(Multipart_req_group::group_id) == 4, "Multipart_req_group::group_id");
+
+Error_condition
+to_buffer(Buffer_view& v, const Multipart_req_group& x)
+{
+  assert(bytes(x) == 8);
+  if (not available(v, 8))
+    return AVAILABLE_MULTIPART_REQ_GROUP;
+  Byte* p = v.first;
+  store(p + 0, x.group_id);
+  std::memset(p + 4, 0, 4);
+  v.first += 8;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Multipart_req_group& x)
+{
+  assert(bytes(x) == 8);
+  if (not available(v, 8))
+    return AVAILABLE_MULTIPART_REQ_GROUP;
+  const Byte* p = v.first;
+  x.group_id = load<decltype(x.group_id)>(p + 0);
+  v.first += 8;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Multipart_res_desc (1056 bytes)
+
+Error_condition
+to_buffer(Buffer_view& v, const Multipart_res_desc& x)
+{
+  assert(bytes(x) == 1056);
+  if (not available(v, 1056))
+    return AVAILABLE_MULTIPART_RES_DESC;
+  Byte* p = v.first;
+  std::memcpy(p + 0, x.mfr_desc.data(), 256);
+  std::memcpy(p + 256, x.hw_desc.data(), 256);
+  std::memcpy(p + 512, x.sw_desc.data(), 256);
+  std::memcpy(p + 768, x.serial_num.data(), 32);
+  std::memcpy(p + 800, x.dp_desc.data(), 256);
+  v.first += 1056;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Multipart_res_desc& x)
+{
+  assert(bytes(x) == 1056);
+  if (not available(v, 1056))
+    return AVAILABLE_MULTIPART_RES_DESC;
+  const Byte* p = v.first;
+  std::memcpy(x.mfr_desc.data(), p + 0, 256);
+  std::memcpy(x.hw_desc.data(), p + 256, 256);
+  std::memcpy(x.sw_desc.data(), p + 512, 256);
+  std::memcpy(x.serial_num.data(), p + 768, 32);
+  std::memcpy(x.dp_desc.data(), p + 800, 256);
+  v.first += 1056;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Multipart_res_table (24 bytes)
+
+static_assert(sizeof(Multipart_res_table::table_id) == 1, "Multipart_res_table::table_id");
+static_assert(sizeof(Multipart_res_table::active_count) == 4, "Multipart_res_table::active_count");
+static_assert(sizeof(Multipart_res_table::lookup_count) == 8, "Multipart_res_table::lookup_count");
+static_assert(sizeof(Multipart_res_table::matched_count) == 8, "Multipart_res_table::matched_count");
+
+Error_condition
+to_buffer(Buffer_view& v, const Multipart_res_table& x)
+{
+  assert(bytes(x) == 24);
+  if (not available(v, 24))
+    return AVAILABLE_MULTIPART_RES_TABLE;
+  Byte* p = v.first;
+  store(p + 0, x.table_id);
+  std::memset(p + 1, 0, 3);
+  store(p + 4, x.active_count);
+  store(p + 8, x.lookup_count);
+  store(p + 16, x.matched_count);
+  v.first += 24;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Multipart_res_table& x)
+{
+  assert(bytes(x) == 24);
+  if (not available(v, 24))
+    return AVAILABLE_MULTIPART_RES_TABLE;
+  const Byte* p = v.first;
+  x.table_id = load<decltype(x.table_id)>(p + 0);
+  x.active_count = load<decltype(x.active_count)>(p + 4);
+  x.lookup_count = load<decltype(x.lookup_count)>(p + 8);
+  x.matched_count = load<decltype(x.matched_count)>(p + 16);
+  v.first += 24;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Multipart_res_queue (40 bytes)
+
+static_assert(sizeof(Multipart_res_queue::port_no) == 4, "Multipart_res_queue::port_no");
+static_assert(sizeof(Multipart_res_queue::queue_id) == 4, "Multipart_res_queue::queue_id");
+static_assert(sizeof(Multipart_res_queue::tx_bytes) == 8, "Multipart_res_queue::tx_bytes");
+static_assert(sizeof(Multipart_res_queue::tx_packets) == 8, "Multipart_res_queue::tx_packets");
+static_assert(sizeof(Multipart_res_queue::tx_errors) == 8, "Multipart_res_queue::tx_errors");
+static_assert(sizeof(Multipart_res_queue::duration_sec) == 4, "Multipart_res_queue::duration_sec");
+static_assert(sizeof(Multipart_res_queue::duration_nsec) == 4, "Multipart_res_queue::duration_nsec");
+
+Error_condition
+to_buffer(Buffer_view& v, const Multipart_res_queue& x)
+{
+  assert(bytes(x) == 40);
+  if (not available(v, 40))
+    return AVAILABLE_MULTIPART_RES_QUEUE;
+  Byte* p = v.first;
+  store(p + 0, x.port_no);
+  store(p + 4, x.queue_id);
+  store(p + 8, x.tx_bytes);
+  store(p + 16, x.tx_packets);
+  store(p + 24, x.tx_errors);
+  store(p + 32, x.duration_sec);
+  store(p + 36, x.duration_nsec);
+  v.first += 40;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Multipart_res_queue& x)
+{
+  assert(bytes(x) == 40);
+  if (not available(v, 40))
+    return AVAILABLE_MULTIPART_RES_QUEUE;
+  const Byte* p = v.first;
+  x.port_no = load<decltype(x.port_no)>(p + 0);
+  x.queue_id = load<decltype(x.queue_id)>(p + 4);
+  x.tx_bytes = load<decltype(x.tx_bytes)>(p + 8);
+  x.tx_packets = load<decltype(x.tx_packets)>(p + 16);
+  x.tx_errors = load<decltype(x.tx_errors)>(p + 24);
+  x.duration_sec = load<decltype(x.duration_sec)>(p + 32);
+  x.duration_nsec = load<decltype(x.duration_nsec)>(p + 36);
+  v.first += 40;
+  return SUCCESS;
+}
+
+// -------------------------------------------------------------------------- //
+// Multipart_res_meter_features (16 bytes)
+
+static_assert(sizeof(Multipart_res_meter_features::max_meter) == 4, "Multipart_res_meter_features::max_meter");
+static_assert(sizeof(Multipart_res_meter_features::band_type) == 4, "Multipart_res_meter_features::band_type");
+static_assert(sizeof(Multipart_res_meter_features::capabilities) == 4, "Multipart_res_meter_features::capabilities");
+static_assert(sizeof(Multipart_res_meter_features::max_bands) == 1, "Multipart_res_meter_features::max_bands");
+static_assert(sizeof(Multipart_res_meter_features::max_color) == 1, "Multipart_res_meter_features::max_color");
+
+Error_condition
+to_buffer(Buffer_view& v, const Multipart_res_meter_features& x)
+{
+  assert(bytes(x) == 16);
+  if (not available(v, 16))
+    return AVAILABLE_MULTIPART_RES_METER_FEATURES;
+  Byte* p = v.first;
+  store(p + 0, x.max_meter);
+  store(p + 4, x.band_type);
+  store(p + 8, x.capabilities);
+  store(p + 12, x.max_bands);
+  store(p + 13, x.max_color);
+  std::memset(p + 14, 0, 2);
+  v.first += 16;
+  return SUCCESS;
+}
+
+Error_condition
+from_buffer(Buffer_view& v, Multipart_res_meter_features& x)
+{
+  assert(bytes(x) == 16);
+  if (not available(v, 16))
+    return AVAILABLE_MULTIPART_RES_METER_FEATURES;
+  const Byte* p = v.first;
+  x.max_meter = load<decltype(x.max_meter)>(p + 0);
+  x.band_type = load<decltype(x.band_type)>(p + 4);
+  x.capabilities = load<decltype(x.capabilities)>(p + 8);
+  x.max_bands = load<decltype(x.max_bands)>(p + 12);
+  x.max_color = load<decltype(x.max_color)>(p + 13);
+  v.first += 16;
+  return SUCCESS;
+}
+
+} // namespace v1_3_1
+} // namespace ofp
+} // namespace flog
@@ -17,6 +17,7 @@
 
 #include <forward_list>
 
+#include <libflog/pool.hpp>
 #include <libflog/proto/ofp/xid_gen.hpp>
 
 namespace flog {
@@ -28,6 +29,10 @@ enum Message_type : uint8_t;
 
 struct Message;
 
+/// The pool from which the factory makes messages. Messages made by the
+/// factory are released to it by Common_message::Delete.
+using Message_pool = Object_pool<Message>;
+
 /// \brief The factory that generates version 1.3.1 messages
 ///
 /// \todo Make the factory refer to an allocator, owned by the state
@@ -0,0 +1,124 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_PROTO_OFP_VIEW_H
+#define FLOWGRAMMABLE_PROTO_OFP_VIEW_H
+
+#include <iterator>
+
+#include <libflog/proto/ofp/ofp.hpp>
+
+/// \file view.hpp
+/// Iteration over sequences of wire-encoded, variable-length objects.
+
+namespace flog {
+namespace ofp {
+
+// -------------------------------------------------------------------------- //
+// Wire iterator
+
+/// \brief A forward iterator over a sequence of encoded objects.
+///
+/// The value type T is a view of a single object: it is constructed from
+/// a pointer to the object's first byte, and bytes(T) returns the object's
+/// encoded length. The sequence must have been validated so that every
+/// object lies within it and has a non-zero length; iteration never
+/// checks bounds and never allocates.
+template<typename T>
+  class Wire_iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = T;
+
+    Wire_iterator()
+      : p(nullptr) { }
+
+    explicit Wire_iterator(const Byte* x)
+      : p(x) { }
+
+    T operator*() const { return T(p); }
+
+    Wire_iterator& operator++();
+    Wire_iterator operator++(int);
+
+    bool operator==(const Wire_iterator& x) const { return p == x.p; }
+    bool operator!=(const Wire_iterator& x) const { return p != x.p; }
+
+  private:
+    const Byte* p;
+  };
+
+template<typename T>
+  inline Wire_iterator<T>&
+  Wire_iterator<T>::operator++()
+  {
+    p += bytes(T(p));
+    return *this;
+  }
+
+template<typename T>
+  inline Wire_iterator<T>
+  Wire_iterator<T>::operator++(int)
+  {
+    Wire_iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+// -------------------------------------------------------------------------- //
+// Wire sequence
+
+/// \brief A validated range of encoded objects.
+template<typename T>
+  struct Wire_sequence
+  {
+    using iterator = Wire_iterator<T>;
+
+    Wire_sequence()
+      : first(nullptr), last(nullptr) { }
+
+    Wire_sequence(const Byte* f, const Byte* l)
+      : first(f), last(l) { }
+
+    iterator begin() const { return iterator(first); }
+    iterator end() const { return iterator(last); }
+
+    bool empty() const { return first == last; }
+
+    const Byte* first;
+    const Byte* last;
+  };
+
+/// Returns the number of objects in the sequence. This is linear in the
+/// length of the sequence.
+template<typename T>
+  inline std::size_t
+  size(const Wire_sequence<T>& s)
+  {
+    return std::distance(s.begin(), s.end());
+  }
+
+/// Returns the number of encoded bytes in the sequence.
+template<typename T>
+  inline std::size_t
+  bytes(const Wire_sequence<T>& s) { return s.last - s.first; }
+
+} // namespace ofp
+} // namespace flog
+
+#endif
@@ -19,20 +19,29 @@
 #include <sstream>
 #include <numeric>
 
+#include "arena.hpp"
 #include "buffer.hpp"
 
 namespace flog {
 
-template<typename T>
-  struct Sequence : public std::vector<T> 
+/// \brief A sequence of protocol objects.
+///
+/// By default, the storage of a sequence comes from the arena of the
+/// current scope, if any (see arena.hpp), so that all of the sequences of
+/// a decoded message are released together.
+template<typename T, typename A = Allocator<T>>
+  struct Sequence : public std::vector<T, A>
   {
-    using std::vector<T>::vector;
+    using std::vector<T, A>::vector;
   };
 
-// Bytes
-template<typename T>
-  inline std::size_t 
-  bytes(const Sequence<T>& s) 
+// The operations on sequences are shared with Small_sequence, and are
+// defined for any sequence container S.
+namespace detail {
+
+template<typename S>
+  inline std::size_t
+  sequence_bytes(const S& s)
   {
     std::size_t result = 0;
     for (auto itr = s.begin(); itr != s.end(); ++itr) {
@@ -41,10 +50,9 @@ template<typename T>
     return result;
   }
 
-// To/from buffer
-template<typename T>
+template<typename S>
   Error_condition
-  to_buffer(Buffer_view& v, const Sequence<T>& s) 
+  sequence_to_buffer(Buffer_view& v, const S& s)
   {
     auto iter = s.begin();
     auto end = s.end();
@@ -56,40 +64,49 @@ template<typename T>
     return iter == end ? SUCCESS : EXCESS_SEQUENCE;
   }
 
-template<typename T>
+template<typename S>
   Error_condition
-  from_buffer(Buffer_view& v, Sequence<T>& s) 
+  sequence_from_buffer(Buffer_view& v, S& s)
   {
     // Continue reading until no more T objects can be constructed. 
     // Note that availability is necessary to construct a T object,
     // but it is not sufficient. If T contains a variant whose total
     // size is determined during from_buffer, then we may not be able 
     // to fully read a T object. Hence the nested check on from_buffer.
+    //
+    // Elements already in the sequence are read over in place, so that
+    // reading into a recycled sequence reuses them. Elements beyond
+    // those read are removed.
+    std::size_t n = 0;
+    Error_condition err;
     while (remaining(v)) {
-      T t;
-      if (Error_decl err = from_buffer(v, t))
-        return err;
-      s.push_back(std::move(t));
+      if (n == s.size())
+        s.emplace_back();
+      err = from_buffer(v, s[n]);
+      if (not err)
+        break;
+      ++n;
     }
-    return SUCCESS;
+    while (s.size() > n)
+      s.pop_back();
+    return err;
   }
 
-// Is valid
-template<typename T>
+template<typename S>
   Error_condition
-  is_valid(const Sequence<T>& s)
+  sequence_is_valid(const S& s)
   {
     for (const auto& x : s) {
-      if (auto err = is_valid(x))
+      auto err = is_valid(x);
+      if (not err)
         return err;
     }
     return SUCCESS;
   }
 
-// To string
-template<typename T>
+template<typename S>
   inline std::string 
-  to_string(const Sequence<T>& s, Formatter& f) 
+  sequence_to_string(const S& s, Formatter& f)
   {
     std::stringstream ss;
     for (auto itr = s.begin(); itr != s.end(); ++itr) {
@@ -98,6 +115,41 @@ template<typename T>
     return ss.str();
   }
 
+} // namespace detail
+
+// Bytes
+template<typename T, typename A>
+  inline std::size_t 
+  bytes(const Sequence<T, A>& s) { return detail::sequence_bytes(s); }
+
+// To/from buffer
+template<typename T, typename A>
+  inline Error_condition
+  to_buffer(Buffer_view& v, const Sequence<T, A>& s) 
+  {
+    return detail::sequence_to_buffer(v, s);
+  }
+
+template<typename T, typename A>
+  inline Error_condition
+  from_buffer(Buffer_view& v, Sequence<T, A>& s) 
+  {
+    return detail::sequence_from_buffer(v, s);
+  }
+
+// Is valid
+template<typename T, typename A>
+  inline Error_condition
+  is_valid(const Sequence<T, A>& s) { return detail::sequence_is_valid(s); }
+
+// To string
+template<typename T, typename A>
+  inline std::string 
+  to_string(const Sequence<T, A>& s, Formatter& f) 
+  {
+    return detail::sequence_to_string(s, f);
+  }
+
 } // namespace flog
 
 #endif
@@ -0,0 +1,129 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <iostream>
+#include <string>
+
+#include <libflog/small_sequence.hpp>
+
+using namespace flog;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+// Counts the live objects, so that leaks and double destruction show up.
+struct Counted
+{
+  static int live;
+
+  Counted(int n = 0) : value(n) { ++live; }
+  Counted(const Counted& x) : value(x.value) { ++live; }
+  ~Counted() { --live; }
+
+  Counted& operator=(const Counted& x) { value = x.value; return *this; }
+
+  int value;
+};
+
+int Counted::live = 0;
+
+bool
+operator==(const Counted& a, const Counted& b) { return a.value == b.value; }
+
+int main()
+{
+  using Small = Small_sequence<Counted, 2>;
+
+  // Elements are inline up to the capacity, and spill beyond it.
+  {
+    Small s;
+    s.push_back(1);
+    s.push_back(2);
+    if (not s.is_local() or s.size() != 2)
+      return fail("elements were not inline");
+    s.push_back(3);
+    if (s.is_local() or s.capacity() < 3)
+      return fail("elements did not spill");
+    if (s[0].value != 1 or s[2].value != 3)
+      return fail("elements were not kept when spilling");
+
+    // Appending an element of the sequence itself survives the growth.
+    s.push_back(s[0]);
+    if (s.size() != 4 or s[3].value != 1)
+      return fail("element of the sequence was not appended");
+  }
+  if (Counted::live != 0)
+    return fail("elements were leaked");
+
+  // Copies and moves, inline and spilled.
+  {
+    Small a { 1, 2 };
+    Small b { 1, 2, 3 };
+    Small c = a;
+    Small d = b;
+    if (c != a or d != b or c == d)
+      return fail("copies are not equal");
+
+    Small e = std::move(a);
+    Small f = std::move(b);
+    if (not a.empty() or not b.empty() or e != c or f != d)
+      return fail("moves did not take the elements");
+
+    e = f;
+    f = std::move(c);
+    if (e != d or f.size() != 2)
+      return fail("assignments did not replace the elements");
+  }
+  if (Counted::live != 0)
+    return fail("elements were leaked");
+
+  // Conversion from a sequence.
+  {
+    Sequence<Counted> s { 4, 5, 6 };
+    Small t = s;
+    if (t.size() != 3 or t[2].value != 6)
+      return fail("sequence was not converted");
+  }
+  if (Counted::live != 0)
+    return fail("elements were leaked");
+
+  // Spilled elements are allocated from the arena of the scope.
+  {
+    Arena a;
+    {
+      Arena_scope scope(a);
+      Small_sequence<int, 2> s { 1, 2 };
+      if (a.used() != 0)
+        return fail("inline elements were allocated");
+      s.push_back(3);
+      if (a.used() == 0)
+        return fail("spilled elements were not allocated from the arena");
+    }
+    a.reset();
+  }
+
+  // Sequences of strings, which are not trivially copyable.
+  {
+    Small_sequence<std::string, 1> s;
+    s.push_back("a");
+    s.push_back("b");
+    Small_sequence<std::string, 1> t = std::move(s);
+    if (t.size() != 2 or t[1] != "b")
+      return fail("strings were not moved");
+  }
+}
@@ -0,0 +1,329 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_SMALL_SEQUENCE_H
+#define FLOWGRAMMABLE_SMALL_SEQUENCE_H
+
+#include <algorithm>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+
+#include "sequence.hpp"
+
+/// \file small_sequence.hpp
+/// A sequence with inline capacity.
+
+namespace flog {
+
+// -------------------------------------------------------------------------- //
+// Small sequence
+
+/// \brief A sequence that stores up to N elements inline.
+///
+/// Most matches carry a handful of OXM entries, and most instructions and
+/// buckets a few actions. A small sequence holds that many elements within
+/// the object that contains it, so decoding a typical message allocates no
+/// storage for them. Longer sequences spill to storage obtained from an
+/// Allocator, which is the arena of the current scope if there is one.
+///
+/// A small sequence can be constructed from a Sequence, and otherwise
+/// supports the subset of the vector interface used by messages.
+template<typename T, std::size_t N>
+  class Small_sequence
+  {
+    static_assert(N > 0, "a small sequence needs inline capacity");
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    Small_sequence()
+      : first_(local()), size_(0), cap_(N) { }
+
+    Small_sequence(std::initializer_list<T> l);
+
+    /// Copy the elements of s.
+    template<typename A>
+      Small_sequence(const Sequence<T, A>& s);
+
+    // Copy semantics
+    Small_sequence(const Small_sequence& x);
+    Small_sequence& operator=(const Small_sequence& x);
+
+    // Move semantics
+    Small_sequence(Small_sequence&& x);
+    Small_sequence& operator=(Small_sequence&& x);
+
+    ~Small_sequence();
+
+    // Iterators
+    iterator begin() { return first_; }
+    iterator end() { return first_ + size_; }
+    const_iterator begin() const { return first_; }
+    const_iterator end() const { return first_ + size_; }
+
+    // Capacity
+    bool empty() const { return size_ == 0; }
+    size_type size() const { return size_; }
+    size_type capacity() const { return cap_; }
+    void reserve(size_type n);
+
+    /// Returns true when the elements are stored inline.
+    bool is_local() const { return first_ == local(); }
+
+    // Element access
+    T& operator[](size_type n) { return first_[n]; }
+    const T& operator[](size_type n) const { return first_[n]; }
+    T& front() { return *first_; }
+    const T& front() const { return *first_; }
+    T& back() { return first_[size_ - 1]; }
+    const T& back() const { return first_[size_ - 1]; }
+    T* data() { return first_; }
+    const T* data() const { return first_; }
+
+    // Modifiers
+    void push_back(const T& x) { emplace_back(x); }
+    void push_back(T&& x) { emplace_back(std::move(x)); }
+
+    template<typename... Args>
+      void emplace_back(Args&&... args);
+
+    void pop_back();
+    void clear();
+
+  private:
+    using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    T* local() { return reinterpret_cast<T*>(local_); }
+    const T* local() const { return reinterpret_cast<const T*>(local_); }
+
+    void release();
+    void steal(Small_sequence& x);
+
+    T* first_;
+    size_type size_;
+    size_type cap_;
+    Allocator<T> alloc_;
+    Storage local_[N];
+  };
+
+template<typename T, std::size_t N>
+  Small_sequence<T, N>::Small_sequence(std::initializer_list<T> l)
+    : Small_sequence()
+  {
+    reserve(l.size());
+    for (const T& x : l)
+      emplace_back(x);
+  }
+
+template<typename T, std::size_t N>
+  template<typename A>
+    Small_sequence<T, N>::Small_sequence(const Sequence<T, A>& s)
+      : Small_sequence()
+    {
+      reserve(s.size());
+      for (const T& x : s)
+        emplace_back(x);
+    }
+
+template<typename T, std::size_t N>
+  Small_sequence<T, N>::Small_sequence(const Small_sequence& x)
+    : Small_sequence()
+  {
+    reserve(x.size());
+    for (const T& y : x)
+      emplace_back(y);
+  }
+
+template<typename T, std::size_t N>
+  Small_sequence<T, N>&
+  Small_sequence<T, N>::operator=(const Small_sequence& x)
+  {
+    if (this != &x) {
+      clear();
+      reserve(x.size());
+      for (const T& y : x)
+        emplace_back(y);
+    }
+    return *this;
+  }
+
+template<typename T, std::size_t N>
+  Small_sequence<T, N>::Small_sequence(Small_sequence&& x)
+    : Small_sequence()
+  {
+    steal(x);
+  }
+
+template<typename T, std::size_t N>
+  Small_sequence<T, N>&
+  Small_sequence<T, N>::operator=(Small_sequence&& x)
+  {
+    if (this != &x) {
+      release();
+      steal(x);
+    }
+    return *this;
+  }
+
+template<typename T, std::size_t N>
+  Small_sequence<T, N>::~Small_sequence() { release(); }
+
+// Take the elements of x, leaving it empty. Spilled storage is taken
+// with the allocator that owns it; inline elements are moved one by one.
+template<typename T, std::size_t N>
+  void
+  Small_sequence<T, N>::steal(Small_sequence& x)
+  {
+    if (x.is_local()) {
+      for (T& y : x)
+        emplace_back(std::move(y));
+      x.clear();
+    } else {
+      first_ = x.first_;
+      size_ = x.size_;
+      cap_ = x.cap_;
+      alloc_ = x.alloc_;
+      x.first_ = x.local();
+      x.size_ = 0;
+      x.cap_ = N;
+    }
+  }
+
+// Destroy the elements and return spilled storage, leaving the sequence
+// empty and inline.
+template<typename T, std::size_t N>
+  void
+  Small_sequence<T, N>::release()
+  {
+    clear();
+    if (not is_local()) {
+      alloc_.deallocate(first_, cap_);
+      first_ = local();
+      cap_ = N;
+    }
+  }
+
+template<typename T, std::size_t N>
+  void
+  Small_sequence<T, N>::reserve(size_type n)
+  {
+    if (n <= cap_)
+      return;
+    T* p = alloc_.allocate(n);
+    for (size_type i = 0; i < size_; ++i) {
+      new (p + i) T(std::move(first_[i]));
+      first_[i].~T();
+    }
+    if (not is_local())
+      alloc_.deallocate(first_, cap_);
+    first_ = p;
+    cap_ = n;
+  }
+
+template<typename T, std::size_t N>
+  template<typename... Args>
+    inline void
+    Small_sequence<T, N>::emplace_back(Args&&... args)
+    {
+      if (size_ == cap_) {
+        // The arguments may refer to an element, so construct the new
+        // one before the elements are moved.
+        T x(std::forward<Args>(args)...);
+        reserve(2 * cap_);
+        new (first_ + size_) T(std::move(x));
+      } else {
+        new (first_ + size_) T(std::forward<Args>(args)...);
+      }
+      ++size_;
+    }
+
+template<typename T, std::size_t N>
+  inline void
+  Small_sequence<T, N>::pop_back()
+  {
+    --size_;
+    first_[size_].~T();
+  }
+
+template<typename T, std::size_t N>
+  inline void
+  Small_sequence<T, N>::clear()
+  {
+    while (size_)
+      pop_back();
+  }
+
+// Equality comparison
+template<typename T, std::size_t N>
+  inline bool
+  operator==(const Small_sequence<T, N>& a, const Small_sequence<T, N>& b)
+  {
+    return a.size() == b.size() and std::equal(a.begin(), a.end(), b.begin());
+  }
+
+template<typename T, std::size_t N>
+  inline bool
+  operator!=(const Small_sequence<T, N>& a, const Small_sequence<T, N>& b)
+  {
+    return not (a == b);
+  }
+
+// Bytes
+template<typename T, std::size_t N>
+  inline std::size_t
+  bytes(const Small_sequence<T, N>& s) { return detail::sequence_bytes(s); }
+
+// To/from buffer
+template<typename T, std::size_t N>
+  inline Error_condition
+  to_buffer(Buffer_view& v, const Small_sequence<T, N>& s)
+  {
+    return detail::sequence_to_buffer(v, s);
+  }
+
+template<typename T, std::size_t N>
+  inline Error_condition
+  from_buffer(Buffer_view& v, Small_sequence<T, N>& s)
+  {
+    return detail::sequence_from_buffer(v, s);
+  }
+
+// Is valid
+template<typename T, std::size_t N>
+  inline Error_condition
+  is_valid(const Small_sequence<T, N>& s)
+  {
+    return detail::sequence_is_valid(s);
+  }
+
+// To string
+template<typename T, std::size_t N>
+  inline std::string
+  to_string(const Small_sequence<T, N>& s, Formatter& f)
+  {
+    return detail::sequence_to_string(s, f);
+  }
+
+} // namespace flog
+
+#endif
@@ -17,29 +17,49 @@
 
 #include "reactor.hpp"
 #include "socket.hpp"
-#include "connection.hpp"
+#include "service.hpp"
 
 #include <libflog/proto/internet.hpp>
 
 namespace flog {
 
+///
+/// An Acceptor listens on a local address and hands each accepted peer to
+/// the service of its manager, which makes the connection and runs its
+/// protocol. Peers are refused when there is no service, or when the
+/// service refuses them.
+/// Shared acceptors set SO_REUSEPORT, allowing one acceptor per reactor
+/// shard on the same address.
+///
+/// The listening socket does not block, and each read event accepts peers
+/// until none are left waiting, so that an edge triggered reactor strands
+/// none of them. On a reactor that performs I/O, the acceptor instead
+/// keeps an accept operation in flight, and is not polled.
+///
+
 struct Acceptor : Subscriber
 {
   static const std::string module_name;
-  Acceptor(Reactor& r, const net::Address& a);
+  Acceptor(Reactor& r, const net::Address& a,
+           Service* svc, bool shared = false);
+  ~Acceptor();
   void read(const Time& t);
   void write(const Time& t) {}
   void time(const Time& t) {}
   bool local_addr(const net::Address& addr);
+  void accepted(int res, const Time& t);
 
   socket::Socket skt;
+  Service* service;
 };
 
 inline
-Acceptor::Acceptor(Reactor& r, const net::Address& a)
-  : Subscriber(r), skt(a)
+Acceptor::Acceptor(Reactor& r, const net::Address& a,
+                   Service* svc, bool shared)
+  : Subscriber(r), skt(a, shared), service(svc)
 { 
-  if (not skt.bind()) {
+  // The socket is bound on construction.
+  if (not skt) {
     status = false;
     error = skt.error;
   }
@@ -47,14 +67,73 @@ Acceptor::Acceptor(Reactor& r, const net::Address& a)
     status = false;
     error = skt.error;
   }
+  fd = skt.fd;
+  int flags = ::fcntl(fd, F_GETFL);
+  if (flags >= 0)
+    ::fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+  if (status and performs_io(reactor) and not submit_accept(reactor, this)) {
+    status = false;
+    error = "accept was not submitted";
+  }
+}
+
+inline
+Acceptor::~Acceptor()
+{
+  release_io(reactor, this);
+}
+
+// Hand an accepted peer to the service.
+inline void
+admit(Acceptor& a, socket::Socket&& peer, const Time& t)
+{
+  count(a.reactor.stats.accepts);
+  if (not a.service) {
+    FLOG_SLOG(a, Log::Warning, ("Refused connection, no service: " +
+                                to_string(a.skt)));
+    return;
+  }
+  if (not a.service->accept(a.reactor, std::move(peer), t)) {
+    FLOG_SLOG(a, Log::Warning, ("Refused connection, " +
+                                a.service->error + ": " + to_string(a.skt)));
+    return;
+  }
+  FLOG_SLOG(a, Log::Info, ("Created connection: " + to_string(a.skt)));
 }
 
 inline void
 Acceptor::read(const Time& t)
 {
-  Connection* conn = new Connection(reactor, skt.accept());
-  subscribe_read(reactor, conn);
-  slog<Acceptor>(*this, Log::Info, ("Created connection: " + to_string(skt)));
+  for (;;) {
+    socket::Socket peer = skt.accept();
+    if (peer.fd < 0) {
+      int err = errno;
+      skt.status = true;
+      if (err == EINTR)
+        continue;
+      if (err != EAGAIN and err != EWOULDBLOCK)
+        FLOG_SLOG(*this, Log::Warning, ("Accept failed: " + skt.error));
+      return;
+    }
+    admit(*this, std::move(peer), t);
+  }
+}
+
+inline void
+Acceptor::accepted(int res, const Time& t)
+{
+  if (res == -ECANCELED)
+    return;
+  if (res < 0) {
+    FLOG_SLOG(*this, Log::Warning, ("Accept failed: " +
+                                    std::string(strerror(-res))));
+  } else {
+    socket::Address* peer = skt.local->defcons();
+    ::getpeername(res, peer->generic_address(), peer->generic_address_size());
+    admit(*this, socket::Socket(skt.transport, skt.local->copy(), peer, res), t);
+  }
+  if (not submit_accept(reactor, this))
+    FLOG_SLOG(*this, Log::Error, "Accept was not submitted");
 }
 
 inline bool
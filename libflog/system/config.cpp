@@ -55,6 +55,9 @@ to_string(const Ofp& o)
     case Ofp::Echo_miss:
       ss << "Echo Miss " << o.value;
       break;
+    case Ofp::Trust:
+      ss << "Trust " << o.value;
+      break;
     default:
       ss << "Uknown Ofp attribute";
       break;
@@ -86,6 +89,7 @@ to_string(Command::Action a)
     case Command::Set: return "Set";
     case Command::Stop: return "Stop";
     case Command::NoOp: return "NoOp";
+    case Command::Stats: return "Stats";
     default: return "Uknown";
   }
 }
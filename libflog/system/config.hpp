@@ -53,7 +53,7 @@ std::string to_string(Ofp_version v);
 
 struct Ofp
 {
-  enum Type { Version, Echo_interval, Echo_timeout, Echo_miss };
+  enum Type { Version, Echo_interval, Echo_timeout, Echo_miss, Trust };
 
   Ofp(const Ofp& o);
   Ofp(Type t, int v);
@@ -89,7 +89,7 @@ std::string to_string(const Client& c);
 
 struct Command
 {
-  enum Action { Add, Del, Set, Stop, NoOp };
+  enum Action { Add, Del, Set, Stop, NoOp, Stats };
   enum Name { REMOTE, LOCAL, APP, X509, ACL, OFP, SERVER, CLIENT };
 
   Command(Action a = NoOp);
@@ -158,6 +158,7 @@ Ofp::Ofp(const Ofp& o)
   switch(type) {
     case Version:
     case Echo_miss:
+    case Trust:
       value = o.value;
       break;
     case Echo_interval:
@@ -287,6 +288,7 @@ Channel::~Channel()
 struct Read_channel : Channel
 {
   Read_channel(const std::string& n);
+  Read_channel(const std::string& n, int f);
 };
 
 int read(Read_channel& ch, Command& cmd);
@@ -296,6 +298,16 @@ Read_channel::Read_channel(const std::string& n)
   : Channel(n, ::open(n.c_str(), O_RDONLY | O_NONBLOCK))
 { }
 
+// The channel is read until it would block, so it must not.
+inline
+Read_channel::Read_channel(const std::string& n, int f)
+  : Channel(n, f)
+{
+  int flags = ::fcntl(fd, F_GETFL);
+  if(flags >= 0)
+    ::fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
 struct Write_channel : Channel
 {
   Write_channel(const std::string& n);
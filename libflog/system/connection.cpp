@@ -12,10 +12,265 @@
 // or implied. See the License for the specific language governing
 // permissions and limitations under the License.
 
+extern "C" {
+#include <fcntl.h>
+#include <unistd.h>
+}
+
+#include <cerrno>
+#include <cstring>
+
 #include "connection.hpp"
 
 namespace flog {
 
 const std::string Connection::module_name = "Connection";
 
+namespace {
+
+// Send the front of the output with one gathering send, unless one is in
+// flight already. Returns false if the send cannot be submitted.
+bool
+submit(Connection& c)
+{
+  if(c.writing or empty(c.output))
+    return true;
+  iovec iov[Output_queue::Max_gather];
+  std::size_t n = gather(c.output, iov, Output_queue::Max_gather);
+  if(not submit_send(c.reactor, &c, iov, n))
+    return false;
+  ++c.output.calls;
+  c.writing = true;
+  return true;
+}
+
+// Frame received bytes and hand complete messages to the protocol. The
+// framer takes less than all of them when it is full, until the ready
+// messages are consumed. Returns false if the connection was closed.
+bool
+deliver(Connection& c, const Byte* data, std::size_t n, const Time& t)
+{
+  while(n) {
+    std::size_t k = c.input.append(data, n);
+    if(not c.input) {
+      close(c, t, "bad message length");
+      return false;
+    }
+    data += k;
+    n -= k;
+    if(not c.input.ready()) {
+      if(k == 0) {
+        close(c, t, "input overflow");
+        return false;
+      }
+      continue;
+    }
+    if(c.protocol and not c.protocol->recv(c, c.input, t)) {
+      close(c, t, "protocol error");
+      return false;
+    }
+    while(c.input.ready())
+      c.input.next();
+  }
+  return true;
+}
+
+// Send what the protocol queued last, e.g. an error, before the peer is
+// told that the stream has ended. The socket no longer owns the descriptor
+// once it is closed.
+void
+shut(Connection& c)
+{
+  if(c.fd > -1) {
+    flush(c.output, c.fd);
+    ::close(c.fd);
+    c.fd = c.skt.fd = -1;
+  }
+}
+
+// Finish closing a connection whose last operation has completed.
+void
+finish(Connection& c)
+{
+  shut(c);
+  if(c.self_owned)
+    delete &c;
+}
+
+} // namespace
+
+Connection::~Connection()
+{
+  release_io(reactor, this);
+}
+
+void
+Connection::read(const Time& t)
+{
+  // Each pass reads until the socket is drained or the framer is full. A
+  // full framer is emptied by the protocol and read into again, so that no
+  // input is left behind when the reactor is edge triggered.
+  do {
+    input.read();
+    if(not input)
+      return close(*this, t, "bad message length");
+    if(input.ready()) {
+      if(protocol and not protocol->recv(*this, input, t))
+        return close(*this, t, "protocol error");
+      while(input.ready())
+        input.next();
+    }
+    if(input.closed())
+      return close(*this, t, "closed by peer");
+  } while(input.full());
+  flush(*this, t);
+}
+
+void
+Connection::time(const Time& t)
+{
+  if(not protocol)
+    return;
+  handling = true;
+  if(not protocol->time(*this, t))
+    return close(*this, t, "protocol timeout");
+  handling = false;
+  flush(*this, t);
+}
+
+void
+Connection::received(const Byte* data, int res, const Time& t)
+{
+  if(closing) {
+    if(not busy(reactor, this))
+      finish(*this);
+    return;
+  }
+  if(res < 0)
+    return close(*this, t, "read failed: " + std::string(strerror(-res)));
+  if(res == 0)
+    return close(*this, t, "closed by peer");
+
+  handling = true;
+  if(not deliver(*this, data, res, t))
+    return;
+  handling = false;
+  if(not submit_recv(reactor, this))
+    return close(*this, t, "read was not submitted");
+  flush(*this, t);
+}
+
+void
+Connection::sent(int res, const Time& t)
+{
+  writing = false;
+  if(res > 0)
+    consume(output, res);
+  if(closing) {
+    if(not busy(reactor, this))
+      finish(*this);
+    return;
+  }
+  if(res < 0)
+    return close(*this, t, "write failed: " + std::string(strerror(-res)));
+  flush(*this, t);
+}
+
+void
+attach(Connection& c, Protocol& p, const Time& t)
+{
+  // Input is read until the socket would block, so it must not.
+  int flags = ::fcntl(c.fd, F_GETFL);
+  if(flags >= 0)
+    ::fcntl(c.fd, F_SETFL, flags | O_NONBLOCK);
+
+  c.protocol = &p;
+  if(not performs_io(c.reactor))
+    subscribe_read(c.reactor, &c);
+  else if(not submit_recv(c.reactor, &c))
+    return close(c, t, "read was not submitted");
+  c.handling = true;
+  if(not p.open(c, t))
+    return close(c, t, "protocol error");
+  c.handling = false;
+  flush(c, t);
+}
+
+void
+wake(Connection& c, const Time& deadline)
+{
+  arm_by(c.reactor.timers, c.timer, deadline);
+}
+
+void
+close(Connection& c, const Time& t, const std::string& why)
+{
+  FLOG_SLOG(c, Log::Info, "closed: " + why);
+  unschedule(c.reactor, &c);
+  if(reader(c.reactor, c.fd) == &c)
+    unsubscribe_read(c.reactor, &c);
+  if(writer(c.reactor, c.fd) == &c)
+    unsubscribe_write(c.reactor, &c);
+  c.handling = false;
+
+  // The kernel may still use the output and the descriptor of operations
+  // in flight, so the connection is finished by the last completion.
+  c.closing = busy(c.reactor, &c);
+  if(c.closing) {
+    cancel_io(c.reactor, &c);
+  } else {
+    c.writing = false;
+    shut(c);
+  }
+
+  if(Protocol* p = c.protocol) {
+    c.protocol = nullptr;
+    p->close(c, t);
+  }
+  c.status = false;
+  c.error = why;
+  if(not c.closing and c.self_owned)
+    delete &c;
+}
+
+void
+send(Connection& c, Buffer&& b)
+{
+  push(c.output, std::move(b));
+
+  // A send that cannot be submitted leaves the output for the next flush.
+  if(performs_io(c.reactor)) {
+    if(not c.handling)
+      submit(c);
+    return;
+  }
+  if(not c.writing and not empty(c.output)) {
+    subscribe_write(c.reactor, &c);
+    c.writing = true;
+  }
+}
+
+void
+flush(Connection& c, const Time& t)
+{
+  if(performs_io(c.reactor)) {
+    if(not submit(c))
+      close(c, t, "write was not submitted");
+    return;
+  }
+
+  // Nothing more can be sent once a write fails, so the connection is
+  // closed rather than left to queue output for ever.
+  flush(c.output, c.fd);
+  if(not c.output.status)
+    return close(c, t, "write failed: " + c.output.error);
+
+  bool backlog = not empty(c.output);
+  if(backlog and not c.writing)
+    subscribe_write(c.reactor, &c);
+  else if(not backlog and c.writing)
+    unsubscribe_write(c.reactor, &c);
+  c.writing = backlog;
+}
+
 } // namespace flog
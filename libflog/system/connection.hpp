@@ -17,49 +17,135 @@
 
 #include "reactor.hpp"
 #include "socket.hpp"
+#include "output.hpp"
 
+#include <libflog/framer.hpp>
 #include <libflog/proto/internet.hpp>
 
 namespace flog {
 
+struct Connection;
+
+///
+/// The protocol spoken on a connection. The connection frames the bytes it
+/// receives and hands each run of complete messages to the protocol, which
+/// consumes them from the framer in place. Replies are queued on the
+/// connection's output, and everything queued by one handler leaves in a
+/// single gathering write once it returns. A handler returns false to close
+/// the connection.
+///
+/// The connection's timer is only armed when the protocol asks for it,
+/// with wake(), at the next deadline it has to meet. A connection with
+/// nothing pending is not woken at all.
+///
+struct Protocol
+{
+  virtual ~Protocol() { }
+
+  /// Called when the protocol is attached to the connection.
+  virtual bool open(Connection& c, const Time& t) = 0;
+
+  /// Called when the framer has complete messages ready.
+  virtual bool recv(Connection& c, Framer& f, const Time& t) = 0;
+
+  /// Called when the connection's timer fires.
+  virtual bool time(Connection& c, const Time& t) = 0;
+
+  /// Called when the connection is closed.
+  virtual void close(Connection& c, const Time& t) { }
+};
+
+///
+/// A Connection is a stream to a peer. Messages sent on it are queued and
+/// flushed with gathering writes; the connection is subscribed for write
+/// events only while some of its output is waiting for the socket. Input is
+/// framed in a buffer owned by the connection and passed to the attached
+/// protocol, which is also called when the connection's timer fires so that
+/// it can run its timers.
+///
+/// Closing a connection closes its socket. A connection that owns itself,
+/// as those made by acceptors and managers do, is then deleted.
+///
+/// On a reactor that performs I/O, the connection keeps a receive in
+/// flight instead of waiting to be readable, and sends its output with
+/// one gathering send at a time. Output queued by a handler leaves when
+/// the handler returns; output queued from elsewhere leaves at once. A
+/// closed connection whose operations are still in flight closes its
+/// socket, and is deleted, when the last of them completes.
+///
+
 struct Connection : Subscriber
 {
   static const std::string module_name;
   Connection(Reactor& r, socket::Socket&& s);
   Connection(Reactor& r, const net::Address& d, 
             const net::Address& s = net::Address());
+  ~Connection();
 
   void read(const Time& t);
   void write(const Time& t);
   void time(const Time& t);
   bool local_addr(const net::Address& addr);
+  void received(const Byte* data, int res, const Time& t);
+  void sent(int res, const Time& t);
 
   socket::Socket skt;
+  Framer input;
+  Output_queue output;
+  Protocol* protocol;
+  bool writing;     // Waiting to be writable, or a send is in flight
+  bool handling;    // A handler is running, and will flush the output
+  bool closing;     // Closed, but operations are still in flight
+  bool self_owned;
 };
 
+/// Attach the protocol p to the connection and subscribe for read events.
+/// The protocol is not owned by the connection, and must outlive it or be
+/// detached by close().
+void attach(Connection& c, Protocol& p, const Time& t);
+
+/// Arrange for the connection's timer to fire no later than the deadline.
+/// A deadline that has passed fires it once the reactor next runs its
+/// timers.
+void wake(Connection& c, const Time& deadline);
+
+/// Stop reading, writing and waking, close the socket and detach the
+/// protocol. The reason is recorded as the connection's error. A
+/// connection that owns itself is deleted, and must not be used after.
+void close(Connection& c, const Time& t, const std::string& why);
+
+/// Queue an encoded message. It is sent when the connection next becomes
+/// writable, together with everything else queued by then.
+void send(Connection& c, Buffer&& b);
+
+/// Send as much queued output as the socket accepts now, and subscribe
+/// for write events only if some remains. The connection is closed if the
+/// write fails, e.g. because the peer has gone.
+void flush(Connection& c, const Time& t);
+
 inline
 Connection::Connection(Reactor& r, socket::Socket&& s)
-  : Subscriber(r), skt(std::move(s))
-{ }
+  : Subscriber(r), skt(std::move(s)), input(skt.fd), protocol(nullptr),
+    writing(false), handling(false), closing(false), self_owned(false)
+{
+  fd = skt.fd;
+}
 
 inline
 Connection::Connection(Reactor& r, const net::Address& d, const net::Address& s)
-  : Subscriber(r), skt(s)
+  : Subscriber(r), skt(s), input(-1), protocol(nullptr), writing(false),
+    handling(false), closing(false), self_owned(false)
 {
   skt.connect(d);
+  fd = skt.fd;
+  input = Framer(fd);
 }
 
-inline void
-Connection::read(const Time& t)
-{ }
-
 inline void
 Connection::write(const Time& t)
-{ }
-
-inline void
-Connection::time(const Time& t)
-{ }
+{
+  flush(*this, t);
+}
 
 inline bool
 Connection::local_addr(const net::Address& addr)
@@ -0,0 +1,169 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+extern "C" {
+#include <unistd.h>
+}
+
+#include <cerrno>
+#include <cstring>
+
+#include "epoll.hpp"
+
+namespace flog {
+
+namespace {
+
+// Compute the epoll event mask for an interest set.
+inline uint32_t
+event_mask(const Epoll& e, uint32_t bits)
+{
+  uint32_t mask = 0;
+  if(bits & Epoll::Read)
+    mask |= EPOLLIN | EPOLLRDHUP;
+  if(bits & Epoll::Write)
+    mask |= EPOLLOUT;
+  if(e.edge)
+    mask |= EPOLLET;
+  return mask;
+}
+
+// Move the registration of fd from its current interest to bits, adding,
+// modifying or removing the kernel registration as needed.
+bool
+update(Epoll& e, int fd, uint32_t bits)
+{
+  if(fd < 0)
+    return false;
+  if(e.interest.size() <= static_cast<std::size_t>(fd))
+    e.interest.resize(fd + 1, 0);
+
+  uint32_t prev = e.interest[fd];
+  if(prev == bits)
+    return true;
+
+  epoll_event ev;
+  ev.events = event_mask(e, bits);
+  ev.data.u64 = 0;
+  ev.data.fd = fd;
+
+  int op;
+  if(prev == 0)
+    op = EPOLL_CTL_ADD;
+  else if(bits == 0)
+    op = EPOLL_CTL_DEL;
+  else
+    op = EPOLL_CTL_MOD;
+
+  if(::epoll_ctl(e.fd, op, fd, &ev) < 0) {
+    // The descriptor may already have been closed, in which case the
+    // kernel has dropped it from the interest list on its own.
+    if(not (op == EPOLL_CTL_DEL and (errno == EBADF or errno == ENOENT))) {
+      e.error = strerror(errno);
+      return false;
+    }
+  }
+  e.interest[fd] = bits;
+  return true;
+}
+
+} // namespace
+
+bool
+open(Epoll& e, bool edge, std::size_t n)
+{
+  close(e);
+  e.fd = ::epoll_create1(EPOLL_CLOEXEC);
+  if(e.fd < 0) {
+    e.error = strerror(errno);
+    return false;
+  }
+  e.edge = edge;
+  e.events.resize(n);
+  e.ready = 0;
+  return true;
+}
+
+void
+close(Epoll& e)
+{
+  if(e.fd >= 0)
+    ::close(e.fd);
+  e.fd = -1;
+  e.ready = 0;
+  e.interest.clear();
+}
+
+int
+wait(Epoll& e, const Time* t)
+{
+  int ms = -1;
+  if(t != nullptr)
+    ms = t->sec * 1000 + (t->usec + 999) / 1000;
+
+  e.ready = ::epoll_wait(e.fd, e.events.data(), e.events.size(), ms);
+  if(e.ready < 0) {
+    int err = errno;
+    e.ready = 0;
+    errno = err;
+    return -1;
+  }
+
+  // Grow the event buffer when it was filled so that the next wait can
+  // report more descriptors at once.
+  if(static_cast<std::size_t>(e.ready) == e.events.size())
+    e.events.resize(2 * e.events.size());
+  return e.ready;
+}
+
+int
+ready_event(const Epoll& e, int i, bool& rd, bool& wr)
+{
+  const epoll_event& ev = e.events[i];
+  rd = ev.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR);
+  wr = ev.events & (EPOLLOUT | EPOLLHUP | EPOLLERR);
+  return ev.data.fd;
+}
+
+bool
+set_read(Epoll& e, int fd)
+{
+  uint32_t bits = fd < static_cast<int>(e.interest.size()) ? e.interest[fd] : 0;
+  return update(e, fd, bits | Epoll::Read);
+}
+
+bool
+set_write(Epoll& e, int fd)
+{
+  uint32_t bits = fd < static_cast<int>(e.interest.size()) ? e.interest[fd] : 0;
+  return update(e, fd, bits | Epoll::Write);
+}
+
+bool
+clear_read(Epoll& e, int fd)
+{
+  if(fd < 0 or fd >= static_cast<int>(e.interest.size()))
+    return true;
+  return update(e, fd, e.interest[fd] & ~Epoll::Read);
+}
+
+bool
+clear_write(Epoll& e, int fd)
+{
+  if(fd < 0 or fd >= static_cast<int>(e.interest.size()))
+    return true;
+  return update(e, fd, e.interest[fd] & ~Epoll::Write);
+}
+
+} // namespace flog
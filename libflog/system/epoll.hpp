@@ -0,0 +1,93 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_EPOLL_H
+#define FLOWGRAMMABLE_EPOLL_H
+
+extern "C" {
+#include <sys/epoll.h>
+}
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "time.hpp"
+
+namespace flog {
+
+///
+/// @brief An epoll based readiness selector
+///
+/// Epoll keeps the read/write interest of each file descriptor in the
+/// kernel, so a wait only reports the descriptors that are actually ready
+/// instead of requiring a scan of every registered descriptor. Interest is
+/// tracked per descriptor in a dense vector so that read and write interest
+/// can be combined into the single registration epoll keeps per descriptor.
+///
+/// When edge is set, descriptors are registered edge-triggered, and
+/// subscribers are expected to drain their descriptors until EAGAIN.
+///
+
+struct Epoll
+{
+  /// Bits recorded in the interest vector.
+  enum Interest : uint32_t { Read = 0x01, Write = 0x02 };
+
+  Epoll();
+  ~Epoll();
+
+  Epoll(const Epoll&) = delete;
+  Epoll& operator=(const Epoll&) = delete;
+
+  int fd;
+  bool edge;
+
+  std::vector<uint32_t> interest;
+
+  /// The results of the last wait.
+  std::vector<epoll_event> events;
+  int ready;
+
+  std::string error;
+};
+
+bool open(Epoll& e, bool edge = false, std::size_t n = 256);
+void close(Epoll& e);
+int wait(Epoll& e, const Time* t = nullptr);
+
+/// Returns the descriptor of the i-th ready event of the last wait and
+/// sets the readable and writable flags for that event. Errors and hangups
+/// are reported as both so that the subscriber observes them.
+int ready_event(const Epoll& e, int i, bool& rd, bool& wr);
+
+bool set_read(Epoll& e, int fd);
+bool set_write(Epoll& e, int fd);
+bool clear_read(Epoll& e, int fd);
+bool clear_write(Epoll& e, int fd);
+
+inline
+Epoll::Epoll()
+  : fd(-1), edge(false), interest(), events(), ready(0)
+{ }
+
+inline
+Epoll::~Epoll()
+{
+  close(*this);
+}
+
+} // namespace flog
+
+#endif
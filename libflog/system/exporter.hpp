@@ -31,20 +31,23 @@ template<typename T>
   using Cons_if = T* (*)();
 using Dest_if = void (*)();
 
-#define EXPORT_IMPLEMENTATION(TYPE) \
-  static TYPE* app = nullptr;       \
-                                    \
-  TYPE* EXPORT_CONS(TYPE)() {       \
-    if(not app)                     \
-      app = new TYPE();             \
-    return app;                     \
-  }                                 \
-                                    \
-  void EXPORT_DEST(TYPE)() {        \
-    if(app) {                       \
-      delete app;                   \
-      app = nullptr;                \
-    }                               \
+// Each thread that constructs the exported type, e.g. the thread of each
+// reactor shard, gets an instance of its own, so that shards share no
+// application state. The destructor releases the calling thread's one.
+#define EXPORT_IMPLEMENTATION(TYPE)          \
+  static thread_local TYPE* app = nullptr;   \
+                                             \
+  TYPE* EXPORT_CONS(TYPE)() {                \
+    if(not app)                              \
+      app = new TYPE();                      \
+    return app;                              \
+  }                                          \
+                                             \
+  void EXPORT_DEST(TYPE)() {                 \
+    if(app) {                                \
+      delete app;                            \
+      app = nullptr;                         \
+    }                                        \
   }
 
 } // namespace plugin
@@ -1,25 +1,204 @@
 // Copyright (c) 2013 Flowgrammable, LLC.
-// 
+//
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
 // You may obtain a copy of the License at:
-// 
+//
 // http://www.apache.org/licenses/LICENSE-2.0
-// 
+//
 // Unless required by applicable law or agreed to in writing,
 // software distributed under the License is distributed on an "AS IS"
 // BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing
 // permissions and limitations under the License.
 
+#include <algorithm>
+#include <cstring>
+
 #include "logger.hpp"
 
 namespace flog {
 
+namespace {
+
+// Distinguishes loggers that are created at the address of a destroyed
+// one, so that a thread's cached ring is never reused across them.
+std::atomic<uint64_t> next_serial(1);
+
+// The ring the calling thread last logged to, and its logger.
+struct Ring_cache
+{
+  const Logger* logger;
+  uint64_t serial;
+  Log_ring* ring;
+};
+
+thread_local Ring_cache cache = { nullptr, 0, nullptr };
+
+// Returns the ring of the calling thread, registering one on first use.
+Log_ring&
+thread_ring(Logger& lr)
+{
+  if(cache.logger == &lr and cache.serial == lr.serial)
+    return *cache.ring;
+
+  std::thread::id self = std::this_thread::get_id();
+  std::lock_guard<std::mutex> lock(lr.rings_mutex);
+  auto iter = std::find_if(lr.rings.begin(), lr.rings.end(),
+                           [self](const std::unique_ptr<Log_ring>& r) {
+                             return r->owner == self;
+                           });
+  Log_ring* ring;
+  if(iter != lr.rings.end()) {
+    ring = iter->get();
+  } else {
+    ring = new Log_ring(self);
+    lr.rings.emplace_back(ring);
+  }
+  cache = Ring_cache{ &lr, lr.serial, ring };
+  return *ring;
+}
+
+void
+write(Logger& lr, const Log_record& r)
+{
+  lr.output << to_string(r.time);
+  lr.output << " " << to_string(r.level);
+  lr.output << " " << r.module;
+  lr.output << " ";
+  lr.output.write(r.msg, r.length);
+  lr.output << "\n";
+}
+
+// Write the records queued in a ring. Returns the number written.
+std::size_t
+drain(Logger& lr, Log_ring& ring)
+{
+  std::size_t tail = ring.tail.load(std::memory_order_relaxed);
+  std::size_t head = ring.head.load(std::memory_order_acquire);
+  for(std::size_t i = tail; i != head; ++i)
+    write(lr, ring.records[i % Log_ring::Size]);
+  ring.tail.store(head, std::memory_order_release);
+  return head - tail;
+}
+
+// Wake the flusher, unless a wake up is already pending. The flag is set
+// under the lock the flusher waits with, so that the signal is not lost
+// between its test of the flag and its wait.
+void
+wake(Logger& lr)
+{
+  if(lr.pending.load(std::memory_order_relaxed))
+    return;
+  {
+    std::lock_guard<std::mutex> lock(lr.wake_mutex);
+    if(lr.pending.exchange(true, std::memory_order_relaxed))
+      return;
+  }
+  lr.wake.notify_one();
+}
+
+void
+run_flusher(Logger& lr)
+{
+  std::unique_lock<std::mutex> lock(lr.wake_mutex);
+  while(not lr.done.load(std::memory_order_acquire)) {
+    lr.wake.wait(lock, [&lr]() {
+      return lr.pending.load(std::memory_order_relaxed) or
+             lr.done.load(std::memory_order_acquire);
+    });
+
+    // Records queued from here on set the flag again.
+    lr.pending.store(false, std::memory_order_relaxed);
+    lock.unlock();
+    flush(lr);
+    lock.lock();
+  }
+  lock.unlock();
+  flush(lr);
+}
+
+} // namespace
+
+Logger::Logger(const std::string& f)
+  : filename(f), output(filename, std::ios::out),
+    serial(next_serial.fetch_add(1)), pending(false), done(false)
+{
+  flusher = std::thread([this]() { run_flusher(*this); });
+}
+
+Logger::~Logger()
+{
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex);
+    done.store(true, std::memory_order_release);
+  }
+  wake.notify_one();
+  flusher.join();
+}
+
+void
+log(Logger& lr, const Time& t, Log::Level ll, const std::string& md,
+    const std::string& msg)
+{
+  Log_ring& ring = thread_ring(lr);
+  std::size_t head = ring.head.load(std::memory_order_relaxed);
+  std::size_t tail = ring.tail.load(std::memory_order_acquire);
+  if(head - tail == Log_ring::Size) {
+    ring.dropped.store(ring.dropped.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+    return;
+  }
+
+  Log_record& r = ring.records[head % Log_ring::Size];
+  r.time = t;
+  r.level = ll;
+  std::size_t n = std::min(md.size(), Log_record::Module_size - 1);
+  std::memcpy(r.module, md.data(), n);
+  r.module[n] = 0;
+  r.length = std::min(msg.size(), std::size_t(Log_record::Message_size));
+  std::memcpy(r.msg, msg.data(), r.length);
+
+  ring.head.store(head + 1, std::memory_order_release);
+  wake(lr);
+}
+
+void
+flush(Logger& lr)
+{
+  std::lock_guard<std::mutex> lock(lr.mutex);
+
+  // Rings are only ever added, and are owned by the logger, so the rings
+  // lock is only needed to copy the list. Threads may register while the
+  // records are written.
+  {
+    std::lock_guard<std::mutex> rings_lock(lr.rings_mutex);
+    lr.draining.clear();
+    for(auto& ring : lr.rings)
+      lr.draining.push_back(ring.get());
+  }
+  std::size_t n = 0;
+  for(Log_ring* ring : lr.draining)
+    n += drain(lr, *ring);
+  if(n)
+    lr.output.flush();
+}
+
+uint64_t
+dropped(const Logger& lr)
+{
+  std::lock_guard<std::mutex> lock(lr.rings_mutex);
+  uint64_t n = 0;
+  for(auto& ring : lr.rings)
+    n += ring->dropped.load(std::memory_order_relaxed);
+  return n;
+}
+
 std::string
 to_string(Log::Level ll)
 {
   switch(ll) {
+    case Log::Debug: return "Debug";
     case Log::Info: return "Info";
     case Log::Warning: return "Warning";
     case Log::Error: return "Error";
@@ -1,11 +1,11 @@
 // Copyright (c) 2013 Flowgrammable, LLC.
-// 
+//
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
 // You may obtain a copy of the License at:
-// 
+//
 // http://www.apache.org/licenses/LICENSE-2.0
-// 
+//
 // Unless required by applicable law or agreed to in writing,
 // software distributed under the License is distributed on an "AS IS"
 // BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
@@ -15,15 +15,29 @@
 #ifndef FLOWGRAMMABLE_LOGGER_H
 #define FLOWGRAMMABLE_LOGGER_H
 
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "time.hpp"
 
+/// The lowest level of log record compiled into the program: 0 for Debug,
+/// 1 for Info, 2 for Warning and 3 for Error. Records logged through the
+/// FLOG_LOG and FLOG_SLOG macros below this level are discarded at compile
+/// time, without evaluating their message.
+#ifndef FLOG_LOG_LEVEL
+#  define FLOG_LOG_LEVEL 1
+#endif
+
 namespace flog {
 
 struct Log
 {
-  enum Level { Info, Warning, Error };
+  enum Level { Debug, Info, Warning, Error };
 
   Log(const Time& t, Level l, const std::string& md, const std::string& ms);
 
@@ -35,14 +49,108 @@ struct Log
 
 std::string to_string(Log::Level ll);
 
+/// Returns true if records of the given level are compiled in.
+constexpr bool
+log_enabled(Log::Level ll)
+{
+  return ll >= FLOG_LOG_LEVEL;
+}
+
+///
+/// A log record as queued between a logging thread and the flusher. It has
+/// a fixed size so that queueing never allocates; longer module names and
+/// messages are truncated.
+///
+
+struct Log_record
+{
+  static const std::size_t Module_size = 16;
+  static const std::size_t Message_size = 216;
+
+  Time time;
+  Log::Level level;
+  uint16_t length;
+  char module[Module_size];
+  char msg[Message_size];
+};
+
+///
+/// A single-producer, single-consumer ring of log records. Each thread
+/// that logs to a Logger owns one ring, which only the Logger's flusher
+/// thread consumes. When the ring is full, records are dropped and
+/// counted rather than blocking the producer.
+///
+
+struct Log_ring
+{
+  static const std::size_t Size = 1024;
+
+  Log_ring(std::thread::id o);
+
+  std::thread::id owner;
+
+  // The producer and consumer indices are kept on separate cache lines.
+  char pad0[64];
+  std::atomic<std::size_t> head;
+  char pad1[64];
+  std::atomic<std::size_t> tail;
+  char pad2[64];
+
+  std::atomic<uint64_t> dropped;
+  Log_record records[Size];
+};
+
+///
+/// @brief An asynchronous logger
+///
+/// Logging copies a record into the calling thread's ring and returns;
+/// a background thread formats the records of all rings and writes them
+/// to the log file. The rings of threads are registered with the logger
+/// the first time they log to it.
+///
+/// The flusher sleeps until a record is queued. The first record queued
+/// after it wakes sets the pending flag and signals it, so that a thread
+/// logging in bursts signals once per flush rather than once per record.
+/// The file is written without holding the lock that registers rings.
+///
+
 struct Logger
 {
   Logger(const std::string& f);
+  ~Logger();
+
+  Logger(const Logger&) = delete;
+  Logger& operator=(const Logger&) = delete;
+
   std::string filename;
   std::fstream output;
+  uint64_t serial;
+
+  // Serializes the writers of the file, and guards the rings being drained.
+  std::mutex mutex;
+  std::vector<Log_ring*> draining;
+
+  mutable std::mutex rings_mutex;
+  std::vector<std::unique_ptr<Log_ring>> rings;
+
+  std::mutex wake_mutex;
+  std::condition_variable wake;
+  std::atomic<bool> pending;
+
+  std::atomic<bool> done;
+  std::thread flusher;
 };
 
 void log(Logger& lr, const Log& lg);
+void log(Logger& lr, const Time& t, Log::Level ll, const std::string& md,
+         const std::string& msg);
+
+/// Write all queued records to the log file. This is normally done by the
+/// flusher thread, but may be called from any thread.
+void flush(Logger& lr);
+
+/// Returns the number of records dropped because a ring was full.
+uint64_t dropped(const Logger& lr);
 
 inline
 Log::Log(const Time& t, Level l, const std::string& md, const std::string& ms)
@@ -50,27 +158,37 @@ Log::Log(const Time& t, Level l, const std::string& md, const std::string& ms)
 { }
 
 inline
-Logger::Logger(const std::string& f)
-  : filename(f), output(filename, std::ios::out)
+Log_ring::Log_ring(std::thread::id o)
+  : owner(o), head(0), tail(0), dropped(0)
 { }
 
 inline void
 log(Logger& lr, const Log& lg)
 {
-  lr.output << to_string(lg.time);
-  lr.output << " " << to_string(lg.level);
-  lr.output << " " << lg.module;
-  lr.output << " " << lg.msg;
-  lr.output << "\n";
+  log(lr, lg.time, lg.level, lg.module, lg.msg);
 }
 
 template<typename T>
   void
   slog(T& t, Log::Level ll, const std::string& msg)
   {
-    log(t.reactor.logger, Log(t.current_time, ll, t.module_name, msg));
+    log(t.reactor.logger, t.current_time, ll, t.module_name, msg);
   }
 
 } // namespace flog
 
+/// Log a message to a logger if its level is compiled in.
+#define FLOG_LOG(lr, t, ll, md, msg)                          \
+  do {                                                        \
+    if(::flog::log_enabled(ll))                               \
+      ::flog::log(lr, t, ll, md, msg);                        \
+  } while(0)
+
+/// Log a message on behalf of a subscriber if its level is compiled in.
+#define FLOG_SLOG(s, ll, msg)                                 \
+  do {                                                        \
+    if(::flog::log_enabled(ll))                               \
+      ::flog::slog(s, ll, msg);                               \
+  } while(0)
+
 #endif
@@ -0,0 +1,101 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <libflog/system/logger.hpp>
+
+using namespace flog;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+const char* path = "logger_async.log";
+
+std::size_t
+count_lines()
+{
+  std::ifstream in(path);
+  std::string line;
+  std::size_t n = 0;
+  while(std::getline(in, line))
+    ++n;
+  return n;
+}
+
+// Counts the evaluations of a message.
+int evaluated = 0;
+
+std::string
+message(const std::string& s)
+{
+  ++evaluated;
+  return s;
+}
+
+int main()
+{
+  static_assert(not log_enabled(Log::Debug) or FLOG_LOG_LEVEL == 0,
+                "debug records are compiled out by default");
+
+  // Records from several threads all reach the file.
+  {
+    Logger logger(path);
+    auto work = [&logger]() {
+      for(int i = 0; i < 100; ++i)
+        log(logger, Time(), Log::Info, "test", "record");
+    };
+    std::thread a(work), b(work);
+    a.join();
+    b.join();
+  }
+  if (count_lines() != 200)
+    return fail("records did not all reach the file");
+
+  // Disabled levels do not evaluate their message.
+  {
+    Logger logger(path);
+    FLOG_LOG(logger, Time(), Log::Error, "test", message("enabled"));
+    if (evaluated != 1)
+      return fail("enabled message was not evaluated");
+    if(not log_enabled(Log::Debug)) {
+      FLOG_LOG(logger, Time(), Log::Debug, "test", message("disabled"));
+      if (evaluated != 1)
+        return fail("disabled message was evaluated");
+    }
+  }
+
+  // Records are dropped and counted when the flusher falls behind.
+  {
+    Logger logger(path);
+    log(logger, Time(), Log::Info, "test", "register");
+    {
+      // Holding the logger's lock stalls the flusher.
+      std::lock_guard<std::mutex> lock(logger.mutex);
+      for(std::size_t i = 0; i < Log_ring::Size + 5; ++i)
+        log(logger, Time(), Log::Info, "test", "record");
+    }
+    if (dropped(logger) < 5)
+      return fail("records were not dropped when the flusher fell behind");
+  }
+
+  std::remove(path);
+}
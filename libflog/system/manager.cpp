@@ -15,6 +15,7 @@
 #include "manager.hpp"
 #include "acceptor.hpp"
 #include "connection.hpp"
+#include "shard.hpp"
 
 namespace flog {
 
@@ -23,90 +24,119 @@ const std::string Manager::module_name = "Manager";
 void
 add_remote(Manager& m, const std::string& s)
 {
-  slog<Manager>(m, Log::Info, ("add remote " + s));
+  FLOG_SLOG(m, Log::Info, ("add remote " + s));
 }
 
 void
 add_local(Manager& m, const std::string& s)
 {
-  slog<Manager>(m, Log::Info, ("add local " + s));
+  FLOG_SLOG(m, Log::Info, ("add local " + s));
 }
 
 void
 add_app(Manager& m, const std::string& n, const std::string& t)
 {
-  slog<Manager>(m, Log::Info, ("add app " + n + " -> " + t));
+  FLOG_SLOG(m, Log::Info, ("add app " + n + " -> " + t));
+  if(not m.service) {
+    FLOG_SLOG(m, Log::Error, "add app failed: no service");
+    return;
+  }
+  if(not m.service->add_app(n)) {
+    FLOG_SLOG(m, Log::Error, ("add app failed: " + m.service->error));
+    return;
+  }
+  if(not m.service->error.empty())
+    FLOG_SLOG(m, Log::Warning, m.service->error);
 }
 
 void
 add_x509(Manager& m, const std::string& n, const std::string& t)
 {
-  slog<Manager>(m, Log::Info, ("add x509 " + n + " -> " + t));
+  FLOG_SLOG(m, Log::Info, ("add x509 " + n + " -> " + t));
 }
 
 void
 add_acl(Manager& m, const config::Acl& a, const std::string& t)
 {
-  slog<Manager>(m, Log::Info, ("add acl " + to_string(a) + " -> " + t));
+  FLOG_SLOG(m, Log::Info, ("add acl " + to_string(a) + " -> " + t));
 }
 
 void
 add_server(Manager& m, const config::Server& s, const std::string& t)
 {
-  slog<Manager>(m, Log::Info, ("add server " + to_string(s) + " -> " + t));
-  subscribe_read(m.reactor, new Acceptor(m.reactor, s.local));
+  FLOG_SLOG(m, Log::Info, ("add server " + to_string(s) + " -> " + t));
+  Acceptor* acceptor = new Acceptor(m.reactor, s.local, m.service.get(), m.shared);
+  if(not *acceptor) {
+    FLOG_SLOG(m, Log::Error, ("add server failed: " + acceptor->error));
+    delete acceptor;
+    return;
+  }
+  subscribe_read(m.reactor, acceptor, s.local);
 }
   
 void
 add_client(Manager& m, const config::Client& c, const std::string& t)
 {
-  slog<Manager>(m, Log::Info, ("add client " + to_string(c) + " -> " + t));
-  Connection *conn = new Connection(m.reactor, c.remote, c.local);
-
-  subscribe_read(m.reactor, conn);
-  subscribe_write(m.reactor, conn);
+  FLOG_SLOG(m, Log::Info, ("add client " + to_string(c) + " -> " + t));
+  if(not m.service) {
+    FLOG_SLOG(m, Log::Error, "add client failed: no service");
+    return;
+  }
+  if(not m.service->connect(m.reactor, c.remote, c.local, now()))
+    FLOG_SLOG(m, Log::Error, ("add client failed: " + m.service->error));
 }
 
 void
 del_remote(Manager& m, const std::string& s)
 {
-  slog<Manager>(m, Log::Info, ("del remote " + s));
+  FLOG_SLOG(m, Log::Info, ("del remote " + s));
 }
 
 void
 del_local(Manager& m, const std::string& s)
 {
-  slog<Manager>(m, Log::Info, ("del local " + s));
+  FLOG_SLOG(m, Log::Info, ("del local " + s));
 }
 
 void
 del_app(Manager& m, const std::string& n, const std::string& t)
 {
-  slog<Manager>(m, Log::Info, ("del app " + n + " -> " + t));
+  FLOG_SLOG(m, Log::Info, ("del app " + n + " -> " + t));
+  if(not m.service) {
+    FLOG_SLOG(m, Log::Error, "del app failed: no service");
+    return;
+  }
+  if(not m.service->del_app(n)) {
+    FLOG_SLOG(m, Log::Error, ("Delete failed: " + n + ": " + m.service->error));
+    return;
+  }
+  FLOG_SLOG(m, Log::Info, ("Deleted: " + n));
+  if(not m.service->error.empty())
+    FLOG_SLOG(m, Log::Warning, m.service->error);
 }
 
 void
 del_x509(Manager& m, const std::string& n, const std::string& t)
 {
-  slog<Manager>(m, Log::Info, ("del x509 " + n + " -> " + t));
+  FLOG_SLOG(m, Log::Info, ("del x509 " + n + " -> " + t));
 }
 
 void
 del_acl(Manager& m, const config::Acl& a, const std::string& t)
 {
-  slog<Manager>(m, Log::Info, ("del acl " + to_string(a) + " -> " + t));
+  FLOG_SLOG(m, Log::Info, ("del acl " + to_string(a) + " -> " + t));
 }
 
 void
 del_server(Manager& m, const config::Server& s, const std::string& t)
 {
-  slog<Manager>(m, Log::Info, ("del server " + to_string(s) + " -> " + t));
+  FLOG_SLOG(m, Log::Info, ("del server " + to_string(s) + " -> " + t));
   if(Subscriber* acceptor = find_reader(m.reactor, s.local)) {
     unsubscribe_read(m.reactor, acceptor);
-    slog<Manager>(m, Log::Info, ("Deleted: " + to_string(s)));
+    FLOG_SLOG(m, Log::Info, ("Deleted: " + to_string(s)));
     delete acceptor;
   } else {
-    slog<Manager>(m, Log::Info, ("Delete failed: " + to_string(s)));
+    FLOG_SLOG(m, Log::Info, ("Delete failed: " + to_string(s)));
   }
   // del a listener
 }
@@ -114,29 +144,51 @@ del_server(Manager& m, const config::Server& s, const std::string& t)
 void
 del_client(Manager& m, const config::Client& c, const std::string& t)
 {
-  slog<Manager>(m, Log::Info, ("del client " + to_string(c) + " -> " + t));
+  FLOG_SLOG(m, Log::Info, ("del client " + to_string(c) + " -> " + t));
   // del a client
 }
 
+// Apply an ofp setting through the manager's service, reporting a failure
+// under the name of the setting.
 void
-set_ofp_version(Manager& m, unsigned int v, const std::string& t)
+set_ofp(Manager& m, const config::Ofp& o, const std::string& what)
 {
-  slog<Manager>(m, Log::Info, ("set ofp version " + to_string(config::Ofp_version(v)) + " -> " + t));
+  if(not m.service) {
+    FLOG_SLOG(m, Log::Error, ("set ofp " + what + " failed: no service"));
+    return;
+  }
+  if(not m.service->set_ofp(o))
+    FLOG_SLOG(m, Log::Error, ("set ofp " + what + " failed: " + m.service->error));
 }
+
 void
-set_ofp_echo_interval(Manager& m, const Time& tm, const std::string& t)
+set_ofp_version(Manager& m, const config::Ofp& o, const std::string& t)
 {
-  slog<Manager>(m, Log::Info, ("set ofp echo interval " + to_string(tm) + " -> " + t));
+  FLOG_SLOG(m, Log::Info, ("set ofp version " + to_string(config::Ofp_version(o.value)) + " -> " + t));
+  set_ofp(m, o, "version");
 }
 void
-set_ofp_echo_timeout(Manager& m, const Time& tm, const std::string& t)
+set_ofp_echo_interval(Manager& m, const config::Ofp& o, const std::string& t)
 {
-  slog<Manager>(m, Log::Info, ("set ofp echo timeout " + to_string(tm) + " -> " + t));
+  FLOG_SLOG(m, Log::Info, ("set ofp echo interval " + to_string(o.time) + " -> " + t));
+  set_ofp(m, o, "echo interval");
+}
+void
+set_ofp_echo_timeout(Manager& m, const config::Ofp& o, const std::string& t)
+{
+  FLOG_SLOG(m, Log::Info, ("set ofp echo timeout " + to_string(o.time) + " -> " + t));
+  set_ofp(m, o, "echo timeout");
 }
 void
 set_ofp_echo_miss(Manager& m, unsigned int v, const std::string& t)
 {
-  //slog<Manager>(m, Log::Info, ("set ofp echo miss" + v + " -> " + t));
+  //FLOG_SLOG(m, Log::Info, ("set ofp echo miss" + v + " -> " + t));
+}
+void
+set_ofp_trust(Manager& m, const config::Ofp& o, const std::string& t)
+{
+  FLOG_SLOG(m, Log::Info, ("set ofp trust " + std::to_string(o.value) + " -> " + t));
+  set_ofp(m, o, "trust");
 }
 
 void 
@@ -165,7 +217,7 @@ add(Manager& m, const config::Command& cmd)
       add_client(m, cmd.get_client(), std::string(cmd.target));
       break;
     default:
-      slog<Manager>(m, Log::Warning, "unknown name");
+      FLOG_SLOG(m, Log::Warning, "unknown name");
       break;
   }
 }
@@ -175,28 +227,28 @@ del(Manager& m, const config::Command& cmd)
 {
   switch(cmd.name) {
     case config::Command::REMOTE:
-      add_remote(m, std::string(cmd.target));
+      del_remote(m, std::string(cmd.target));
       break;
     case config::Command::LOCAL:
-      add_local(m, std::string(cmd.target));
+      del_local(m, std::string(cmd.target));
       break;
     case config::Command::APP:
-      add_app(m, std::string(cmd.get_filename()), std::string(cmd.target));
+      del_app(m, std::string(cmd.get_filename()), std::string(cmd.target));
       break;
     case config::Command::X509:
-      add_x509(m, std::string(cmd.get_filename()), std::string(cmd.target));
+      del_x509(m, std::string(cmd.get_filename()), std::string(cmd.target));
       break;
     case config::Command::ACL:
-      add_acl(m, cmd.get_acl(), std::string(cmd.target));
+      del_acl(m, cmd.get_acl(), std::string(cmd.target));
       break;
     case config::Command::SERVER:
-      add_server(m, cmd.get_server(), std::string(cmd.target));
+      del_server(m, cmd.get_server(), std::string(cmd.target));
       break;
     case config::Command::CLIENT:
-      add_client(m, cmd.get_client(), std::string(cmd.target));
+      del_client(m, cmd.get_client(), std::string(cmd.target));
       break;
     default:
-      slog<Manager>(m, Log::Warning, "unknown name");
+      FLOG_SLOG(m, Log::Warning, "unknown name");
       break;
   }
 }
@@ -207,19 +259,22 @@ set(Manager& m, const config::Command& cmd)
   if(cmd.name == config::Command::OFP) {
     switch(cmd.get_ofp().type) {
       case config::Ofp::Version:
-        set_ofp_version(m, cmd.get_ofp().value, std::string(cmd.target));
+        set_ofp_version(m, cmd.get_ofp(), std::string(cmd.target));
         break;
       case config::Ofp::Echo_interval:
-        set_ofp_echo_interval(m, cmd.get_ofp().time, std::string(cmd.target));
+        set_ofp_echo_interval(m, cmd.get_ofp(), std::string(cmd.target));
         break;
       case config::Ofp::Echo_timeout:
-        set_ofp_echo_timeout(m, cmd.get_ofp().time, std::string(cmd.target));
+        set_ofp_echo_timeout(m, cmd.get_ofp(), std::string(cmd.target));
         break;
       case config::Ofp::Echo_miss:
         set_ofp_echo_miss(m, cmd.get_ofp().value, std::string(cmd.target));
         break;
+      case config::Ofp::Trust:
+        set_ofp_trust(m, cmd.get_ofp(), std::string(cmd.target));
+        break;
       default:
-        slog<Manager>(m, Log::Warning, "unknown name");
+        FLOG_SLOG(m, Log::Warning, "unknown name");
         break;
     }
   }
@@ -228,46 +283,99 @@ set(Manager& m, const config::Command& cmd)
 void
 stop(Manager& m)
 {
-  slog<Manager>(m, Log::Info, "stopping");
+  FLOG_SLOG(m, Log::Info, "stopping");
+  for(Shard* s : m.shards)
+    stop(*s);
   stop(m.reactor);
 }
 
+void
+stats(Manager& m)
+{
+  FLOG_SLOG(m, Log::Info, "reactor: " + to_string(m.reactor.stats) +
+                          ", log drops " + std::to_string(dropped(m.reactor.logger)));
+  for(Shard* s : m.shards)
+    FLOG_SLOG(m, Log::Info, to_string(*s));
+}
+
+// Forward a command to the shards. A client connection is created by a
+// single shard; everything else is applied by all of them.
+void
+forward(Manager& m, const config::Command& cmd)
+{
+  if(cmd.action == config::Command::Add and 
+     cmd.name == config::Command::CLIENT) {
+    Shard* s = m.shards[m.next_shard++ % m.shards.size()];
+    if(not send(*s, cmd))
+      FLOG_SLOG(m, Log::Error, "shard " + std::to_string(s->id) + ": " + s->error);
+    return;
+  }
+  for(Shard* s : m.shards) {
+    if(not send(*s, cmd))
+      FLOG_SLOG(m, Log::Error, "shard " + std::to_string(s->id) + ": " + s->error);
+  }
+}
+
+// Apply a command read from the channel, or forward it to the shards.
+void
+apply(Manager& m, const config::Command& cmd)
+{
+  if(not m.shards.empty() and 
+     cmd.action != config::Command::Stop and
+     cmd.action != config::Command::Stats) {
+    forward(m, cmd);
+    return;
+  }
+  switch(cmd.action) {
+    case config::Command::Add:
+      add(m, cmd);
+      break;
+    case config::Command::Del:
+      del(m, cmd);
+      break;
+    case config::Command::Set:
+      set(m, cmd);
+      break;
+    case config::Command::Stop:
+      stop(m);
+      break;
+    case config::Command::Stats:
+      stats(m);
+      break;
+    default:
+      FLOG_SLOG(m, Log::Warning, "unknown action");
+      break;
+  }
+}
+
 void
 Manager::read(const Time& ct)
 {
-  config::Command cmd;
-  auto result = config::read(channel, cmd);
-  slog<Manager>(*this, Log::Info, "read event");
+  FLOG_SLOG(*this, Log::Info, "read event");
 
-  if(result < 0) {
-    slog<Manager>(*this, Log::Error, strerror(errno));
-  } else if(result == 0) {
-    slog<Manager>(*this, Log::Info, "writer closed");
-  } else if(result != sizeof(config::Command)) {
-    std::stringstream ss;
-    ss << "malformed command, bytes rx: " << result << ", ";
-    ss << "expected: " << sizeof(config::Command);
-    slog<Manager>(*this, Log::Error, ss.str());
-  } else {
-    switch(cmd.action) {
-      case config::Command::Add:
-        add(*this, cmd);
-        break;
-      case config::Command::Del:
-        del(*this, cmd);
-        break;
-      case config::Command::Set:
-        set(*this, cmd);
-        break;
-      case config::Command::Stop:
-        stop(*this);
-        break;
-      default:
-        slog<Manager>(*this, Log::Warning, "unknown action");
-        break;
+  // Commands are read until the channel is drained, so that none is left
+  // behind when the reactor is edge triggered.
+  for(;;) {
+    config::Command cmd;
+    auto result = config::read(channel, cmd);
+    if(result < 0) {
+      if(errno == EINTR)
+        continue;
+      if(errno != EAGAIN and errno != EWOULDBLOCK)
+        FLOG_SLOG(*this, Log::Error, strerror(errno));
+      return;
+    } else if(result == 0) {
+      FLOG_SLOG(*this, Log::Info, "writer closed");
+      return;
+    } else if(result != sizeof(config::Command)) {
+      std::stringstream ss;
+      ss << "malformed command, bytes rx: " << result << ", ";
+      ss << "expected: " << sizeof(config::Command);
+      FLOG_SLOG(*this, Log::Error, ss.str());
+    } else {
+      apply(*this, cmd);
     }
   }
-
 }
 
 } // namespace flog
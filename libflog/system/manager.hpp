@@ -15,15 +15,37 @@
 #ifndef FLOWGRAMMABLE_MANAGER_H
 #define FLOWGRAMMABLE_MANAGER_H
 
+#include <memory>
+#include <vector>
+
 #include "reactor.hpp"
 #include "config.hpp"
+#include "service.hpp"
 
 namespace flog {
 
+struct Shard;
+
+///
+/// The Manager applies configuration commands read from its channel to its
+/// reactor. When shards are attached, commands are instead fanned out to
+/// every shard, except that each new client connection is created by a
+/// single shard chosen round-robin. Managers owned by a shard create shared
+/// acceptors, so that every shard listens on each server address.
+///
+/// Connections are made, and their protocol run, by the manager's service,
+/// which also applies the application and ofp commands. A manager without
+/// a service makes no connections, and reports those commands as failed.
+///
+/// The channel does not block, and each read event applies commands until
+/// none are left, so that an edge triggered reactor strands none of them.
+///
+
 struct Manager : Subscriber
 {
   static const std::string module_name;
   Manager(Reactor& r, const std::string& s);
+  Manager(Reactor& r, const std::string& s, int f);
 
   void read(const Time& ct);
   void write(const Time& ct) { }
@@ -31,15 +53,35 @@ struct Manager : Subscriber
   bool local_addr(const net::Address& addr) { return false; }
 
   config::Read_channel channel;
+  std::unique_ptr<Service> service;
+
+  bool shared;
+  std::vector<Shard*> shards;
+  std::size_t next_shard;
 };
 
+void add_shard(Manager& m, Shard* s);
+
 inline
 Manager::Manager(Reactor& r, const std::string& s)
-  : Subscriber(r), channel(s)
+  : Subscriber(r), channel(s), shared(false), shards(), next_shard(0)
 { 
   fd = channel.fd;
 }
 
+inline
+Manager::Manager(Reactor& r, const std::string& s, int f)
+  : Subscriber(r), channel(s, f), shared(false), shards(), next_shard(0)
+{
+  fd = channel.fd;
+}
+
+inline void
+add_shard(Manager& m, Shard* s)
+{
+  m.shards.push_back(s);
+}
+
 } // namespace flog
 
 #endif
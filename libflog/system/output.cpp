@@ -0,0 +1,105 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+extern "C" {
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+}
+
+#include <cstring>
+
+#include "output.hpp"
+
+namespace flog {
+
+const std::size_t Output_queue::Max_gather;
+
+namespace {
+
+// Send the vector without blocking and without raising SIGPIPE, whatever
+// the mode of the descriptor. Descriptors that are not sockets fall back
+// to writev.
+ssize_t
+send(int fd, iovec* iov, std::size_t n)
+{
+  msghdr msg;
+  std::memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = n;
+  ssize_t r = ::sendmsg(fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+  if(r < 0 and errno == ENOTSOCK)
+    r = ::writev(fd, iov, n);
+  return r;
+}
+
+} // namespace
+
+std::size_t
+gather(const Output_queue& q, iovec* iov, std::size_t max)
+{
+  std::size_t n = 0;
+  for(auto i = q.buffers.begin(); i != q.buffers.end(); ++i) {
+    if(n == max)
+      break;
+    std::size_t skip = n == 0 ? q.offset : 0;
+    iov[n].iov_base = const_cast<Byte*>(i->data()) + skip;
+    iov[n].iov_len = i->size() - skip;
+    ++n;
+  }
+  return n;
+}
+
+void
+consume(Output_queue& q, std::size_t k)
+{
+  q.bytes -= k;
+  while(k) {
+    std::size_t left = q.buffers.front().size() - q.offset;
+    if(k < left) {
+      q.offset += k;
+      return;
+    }
+    k -= left;
+    q.offset = 0;
+    q.buffers.pop_front();
+    ++q.sent;
+  }
+}
+
+std::size_t
+flush(Output_queue& q, int fd)
+{
+  std::size_t total = 0;
+  iovec iov[Output_queue::Max_gather];
+  while(q.status and not empty(q)) {
+    std::size_t n = gather(q, iov, Output_queue::Max_gather);
+    ssize_t r = send(fd, iov, n);
+    if(r < 0) {
+      if(errno == EINTR)
+        continue;
+      if(errno != EAGAIN and errno != EWOULDBLOCK) {
+        q.status = false;
+        q.error = strerror(errno);
+      }
+      break;
+    }
+    ++q.calls;
+    total += r;
+    consume(q, r);
+  }
+  return total;
+}
+
+} // namespace flog
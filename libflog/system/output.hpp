@@ -0,0 +1,94 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_OUTPUT_H
+#define FLOWGRAMMABLE_OUTPUT_H
+
+extern "C" {
+#include <sys/uio.h>
+}
+
+#include <deque>
+#include <string>
+
+#include <libflog/buffer.hpp>
+
+namespace flog {
+
+///
+/// @brief A queue of encoded messages waiting to be sent on a stream
+///
+/// Messages are appended as whole buffers and sent with gathering writes,
+/// so that everything queued during one turn of the reactor usually leaves
+/// in a single system call. The queue remembers how much of its front
+/// buffer has been sent when the socket accepts only part of the backlog.
+///
+
+struct Output_queue
+{
+  /// The most buffers gathered into one system call.
+  static const std::size_t Max_gather = 64;
+
+  Output_queue();
+
+  std::deque<Buffer> buffers;
+  std::size_t offset;   // Bytes of the front buffer already sent
+  std::size_t bytes;    // Bytes waiting to be sent
+
+  uint64_t calls;       // Gathering writes performed
+  uint64_t sent;        // Buffers completely sent
+
+  bool status;
+  std::string error;
+};
+
+void push(Output_queue& q, Buffer&& b);
+bool empty(const Output_queue& q);
+
+/// Send as much of the queue as the descriptor accepts without blocking.
+/// Returns the number of bytes sent. On an error other than the descriptor
+/// being full, the queue is put into a bad state.
+std::size_t flush(Output_queue& q, int fd);
+
+/// Gather the front of the queue into at most max entries of iov, for a
+/// send made by other means. Returns the number of entries. The buffers
+/// remain queued, and in place, until they are consumed.
+std::size_t gather(const Output_queue& q, iovec* iov, std::size_t max);
+
+/// Drop k sent bytes from the front of the queue.
+void consume(Output_queue& q, std::size_t k);
+
+inline
+Output_queue::Output_queue()
+  : buffers(), offset(0), bytes(0), calls(0), sent(0), status(true)
+{ }
+
+inline void
+push(Output_queue& q, Buffer&& b)
+{
+  if(b.empty())
+    return;
+  q.bytes += b.size();
+  q.buffers.push_back(std::move(b));
+}
+
+inline bool
+empty(const Output_queue& q)
+{
+  return q.buffers.empty();
+}
+
+} // namespace flog
+
+#endif
@@ -0,0 +1,158 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+extern "C" {
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+#include <iostream>
+
+#include <libflog/system/connection.hpp>
+
+using namespace flog;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+Buffer
+make_buffer(std::size_t n, Byte x)
+{
+  Buffer b(n);
+  std::fill(b.begin(), b.end(), x);
+  return b;
+}
+
+// A protocol that only records whether it was closed.
+struct Closing : Protocol
+{
+  bool open(Connection& c, const Time& t) { return true; }
+  bool recv(Connection& c, Framer& f, const Time& t) { return true; }
+  bool time(Connection& c, const Time& t) { return true; }
+  void close(Connection& c, const Time& t) { closed = true; }
+
+  bool closed = false;
+};
+
+// Read everything available without blocking.
+std::size_t
+drain(int fd)
+{
+  std::size_t total = 0;
+  Byte buf[4096];
+  ssize_t n;
+  while((n = ::recv(fd, buf, sizeof(buf), MSG_DONTWAIT)) > 0)
+    total += n;
+  return total;
+}
+
+int main()
+{
+  int sv[2];
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+    return fail("socketpair");
+
+  // Many small messages leave in one system call, in order.
+  {
+    Output_queue q;
+    for(Byte i = 0; i < 10; ++i)
+      push(q, make_buffer(16, i));
+    if (q.bytes != 160)
+      return fail("queue did not count its bytes");
+    if (flush(q, sv[0]) != 160)
+      return fail("queue was not flushed");
+    if (not empty(q) or q.calls != 1 or q.sent != 10)
+      return fail("messages did not leave in one call");
+
+    Byte buf[160];
+    if (::recv(sv[1], buf, sizeof(buf), MSG_WAITALL) != 160)
+      return fail("messages were not received");
+    for(int i = 0; i < 160; ++i) {
+      if (buf[i] != i / 16)
+        return fail("messages were not received in order");
+    }
+  }
+
+  // A full socket leaves a backlog, which is sent once it drains.
+  {
+    Output_queue q;
+    for(int i = 0; i < 64; ++i)
+      push(q, make_buffer(32768, 1));
+    std::size_t total = q.bytes;
+    std::size_t sent = flush(q, sv[0]);
+    if (sent >= total or empty(q) or not q.status)
+      return fail("full socket did not leave a backlog");
+    std::size_t received = drain(sv[1]);
+    while(not empty(q)) {
+      if (not q.status)
+        return fail("backlog could not be sent");
+      sent += flush(q, sv[0]);
+      received += drain(sv[1]);
+    }
+    received += drain(sv[1]);
+    if (sent != total or received != total)
+      return fail("backlog was not sent once the socket drained");
+  }
+
+  // A connection is subscribed for writing only while it has a backlog.
+  {
+    Logger logger("/dev/null");
+    Reactor reactor(logger, Time(0, 1000));
+    Connection c(reactor, socket::Socket(net::TCP, nullptr, nullptr, sv[0]));
+    if (writer(reactor, c.fd) != nullptr)
+      return fail("idle connection is subscribed for writing");
+
+    send(c, make_buffer(100, 2));
+    send(c, make_buffer(100, 3));
+    if (not c.writing or writer(reactor, c.fd) != &c)
+      return fail("connection with a backlog is not subscribed");
+
+    process(reactor);
+    if (c.writing or writer(reactor, c.fd) != nullptr)
+      return fail("connection is still subscribed after its backlog");
+    if (c.output.calls != 1 or drain(sv[1]) != 200)
+      return fail("backlog was not sent in one call");
+  }
+
+  ::close(sv[1]);
+
+  // A write to a peer that has gone closes the connection, which stops
+  // reading and no longer queues output.
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+    return fail("socketpair");
+  {
+    Logger logger("/dev/null");
+    Reactor reactor(logger, Time(0, 1000));
+    Connection c(reactor, socket::Socket(net::TCP, nullptr, nullptr, sv[0]));
+    Closing p;
+    attach(c, p, now());
+    if (reader(reactor, sv[0]) != &c)
+      return fail("attached connection is not subscribed for reading");
+
+    ::close(sv[1]);
+    send(c, make_buffer(100, 4));
+    flush(c, now());
+    if (c.status or c.fd != -1 or not p.closed or c.protocol)
+      return fail("failed write did not close the connection");
+    if (reader(reactor, sv[0]) != nullptr
+        or writer(reactor, sv[0]) != nullptr)
+      return fail("closed connection is still subscribed");
+    if (c.error.compare(0, 12, "write failed") != 0)
+      return fail("closed connection did not record the failed write");
+  }
+}
@@ -14,6 +14,9 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <sstream>
+
 #include "reactor.hpp"
 
 namespace flog {
@@ -26,79 +29,372 @@ run(Reactor& r)
   }
 }
 
+namespace {
+
+// Scan every subscribed descriptor for readiness.
 void
-process(Reactor& r)
+process_select(Reactor& r, const Time* timeout)
 {
-  log(r.logger, Log(Time(), Log::Info, "Reactor", to_string(r.selector)));
+  FLOG_LOG(r.logger, Time(), Log::Debug, "Reactor", to_string(r.selector));
   // block on select
-  auto result = select(r.selector);
-  Time current_time;
+  auto result = select(r.selector, timeout);
+  Time current_time = now();
 
   if (result < 0) {
-    log(r.logger, Log(current_time, Log::Error, "Reactor", std::string(strerror(errno))));
+    FLOG_LOG(r.logger, current_time, Log::Error, "Reactor", std::string(strerror(errno)));
   } else if (result == 0) {
-    log(r.logger, Log(current_time, Log::Info, "Reactor", "timeout"));
+    FLOG_LOG(r.logger, current_time, Log::Debug, "Reactor", "timeout");
   } else
-    log(r.logger, Log(current_time, Log::Info, "Reactor", to_string(r.selector)));
+    FLOG_LOG(r.logger, current_time, Log::Debug, "Reactor", to_string(r.selector));
 
-  // go through read set
-  for(auto entry : r.readers) {
-    if(isset_read(r.selector, entry.first)) {
-      entry.second->read(current_time);
+  // Go through the slots of every descriptor up to the highest one that
+  // was selected. Handlers may subscribe and unsubscribe, so the slots are
+  // re-read rather than held across calls.
+  int max = std::min<int>(r.subscribers.size(), r.selector.max + 1);
+  for(int fd = 0; fd < max; ++fd) {
+    if(isset_read(r.selector, fd)) {
+      if(Subscriber* s = reader(r, fd)) {
+        count(r.stats.reads);
+        s->read(current_time);
+      }
     }
+    if(isset_write(r.selector, fd)) {
+      if(Subscriber* s = writer(r, fd)) {
+        count(r.stats.writes);
+        s->write(current_time);
+      }
+    }
+  }
+}
+
+// Visit only the descriptors reported ready by epoll. Subscribers are
+// looked up by descriptor for each event so that a subscriber removed by
+// an earlier event in the same batch is not dispatched.
+void
+process_epoll(Reactor& r, const Time* timeout)
+{
+  auto result = wait(r.epoll, timeout);
+  Time current_time = now();
+
+  if (result < 0) {
+    if (errno != EINTR)
+      FLOG_LOG(r.logger, current_time, Log::Error, "Reactor", std::string(strerror(errno)));
+    return;
+  }
+
+  for(int i = 0; i < result; ++i) {
+    bool rd, wr;
+    int fd = ready_event(r.epoll, i, rd, wr);
+    if(rd) {
+      if(Subscriber* s = reader(r, fd)) {
+        count(r.stats.reads);
+        s->read(current_time);
+      }
+    }
+    if(wr) {
+      if(Subscriber* s = writer(r, fd)) {
+        count(r.stats.writes);
+        s->write(current_time);
+      }
+    }
+  }
+}
+
+// Dispatch the result of an operation to the subscriber that submitted
+// it. The slot is released once the subscriber has nothing in flight, and
+// is not touched through the subscriber, which may have been deleted.
+void
+dispatch_io(Reactor& r, const Uring::Event& ev, const Time& t)
+{
+  if(static_cast<std::size_t>(ev.fd) >= r.subscribers.size())
+    return;
+  Subscriber* s = r.subscribers[ev.fd].io;
+  if(not s)
+    return;
+  switch(ev.op) {
+    case Uring::Accept:
+      s->accepted(ev.res, t);
+      break;
+    case Uring::Recv:
+      count(r.stats.reads);
+      s->received(ev.data, ev.res, t);
+      break;
+    case Uring::Send:
+      count(r.stats.writes);
+      s->sent(ev.res, t);
+      break;
+    default:
+      break;
+  }
+  Subscriber_slot& slot = r.subscribers[ev.fd];
+  if(slot.io == s and not busy(r.uring, ev.fd))
+    slot.io = nullptr;
+}
+
+// Submit the queued interest changes and operations, wait for completions
+// and dispatch them. The one-shot poll of each dispatched descriptor is
+// re-armed afterwards, and operations submitted by the handlers are
+// queued; both are submitted with the next wait.
+void
+process_uring(Reactor& r, const Time* timeout)
+{
+  auto result = wait(r.uring, timeout);
+  Time current_time = now();
+
+  if (result < 0) {
+    if (errno != EINTR)
+      FLOG_LOG(r.logger, current_time, Log::Error, "Reactor", std::string(strerror(errno)));
+    return;
   }
-  // go through write set
-  for(auto entry : r.writers) {
-    if(isset_write(r.selector, entry.first)) {
-      entry.second->write(current_time);
+
+  for(const Uring::Event& ev : r.uring.events) {
+    if(ev.op != Uring::Poll) {
+      dispatch_io(r, ev, current_time);
+      continue;
+    }
+    if(ev.read) {
+      if(Subscriber* s = reader(r, ev.fd)) {
+        count(r.stats.reads);
+        s->read(current_time);
+      }
     }
+    if(ev.write) {
+      if(Subscriber* s = writer(r, ev.fd)) {
+        count(r.stats.writes);
+        s->write(current_time);
+      }
+    }
+    rearm(r.uring, ev.fd);
+  }
+}
+
+// Bound the wait by the configured timeout and by the nearest timer
+// deadline. Returns null, waiting indefinitely, when neither is set.
+const Time*
+wait_timeout(Reactor& r, Time& t)
+{
+  t = r.timeout;
+  Time deadline = next_deadline(r.timers);
+  if(deadline) {
+    // An expired deadline gives an invalid difference: poll instead.
+    Time left = deadline - now();
+    if(not left)
+      left = Time(0);
+    if(not t or left < t)
+      t = left;
   }
+  return t ? &t : nullptr;
+}
+
+} // namespace
+
+void
+process(Reactor& r)
+{
+  count(r.stats.iterations);
+  Time t;
+  const Time* timeout = wait_timeout(r, t);
+  switch(r.backend) {
+    case Reactor::Epoll:
+      process_epoll(r, timeout);
+      break;
+    case Reactor::Uring:
+      process_uring(r, timeout);
+      break;
+    default:
+      process_select(r, timeout);
+      break;
+  }
+  advance(r.timers, now());
 }
 
 Subscriber*
 find_reader(Reactor& r, const net::Address& addr)
 {
-  auto itr = r.readers.begin();
-  while(itr != r.readers.end()) {
-    if(itr->second->local_addr(addr))
-      return itr->second;
-    ++itr;
-  }
-  return nullptr;
+  auto iter = r.addresses.find(addr);
+  return iter == r.addresses.end() ? nullptr : iter->second;
 }
 
 Subscriber*
-find_writer(Reactor& r)
+find_writer(Reactor& r, const net::Address& addr)
+{
+  Subscriber* s = find_reader(r, addr);
+  return s and writer(r, s->fd) == s ? s : nullptr;
+}
+
+namespace {
+
+// Returns the slot of a descriptor, growing the table to hold it.
+Subscriber_slot&
+slot(Reactor& r, int fd)
 {
-  return nullptr;
+  if(static_cast<std::size_t>(fd) >= r.subscribers.size())
+    r.subscribers.resize(fd + 1);
+  return r.subscribers[fd];
 }
 
+// Remove the address index entry of a descriptor's reader, if any.
+void
+unindex(Reactor& r, Subscriber_slot& s)
+{
+  if(not s.key)
+    return;
+  auto iter = r.addresses.find(*s.key);
+  if(iter != r.addresses.end())
+    r.addresses.erase(iter);
+  s.key = nullptr;
+}
+
+} // namespace
+
 void 
 subscribe_read(Reactor& r, Subscriber* s)
 {
-  set_read(r.selector, s->fd);
-  r.readers.insert(Sub_entry(s->fd, s));
+  if(r.backend == Reactor::Uring) {
+    if(slot(r, s->fd).io != s and not set_read(r.uring, s->fd))
+      FLOG_LOG(r.logger, Time(), Log::Error, "Reactor", r.uring.error);
+  } else if(r.backend == Reactor::Epoll) {
+    if(not set_read(r.epoll, s->fd))
+      FLOG_LOG(r.logger, Time(), Log::Error, "Reactor", r.epoll.error);
+  } else
+    set_read(r.selector, s->fd);
+  slot(r, s->fd).reader = s;
+}
+
+void
+subscribe_read(Reactor& r, Subscriber* s, const net::Address& local)
+{
+  subscribe_read(r, s);
+  Subscriber_slot& e = slot(r, s->fd);
+  unindex(r, e);
+  auto ins = r.addresses.emplace(local, s);
+  if(not ins.second) {
+    FLOG_LOG(r.logger, Time(), Log::Warning, "Reactor",
+                      "address already indexed: " + net::to_string(local));
+    return;
+  }
+  e.key = &ins.first->first;
 }
 
 void 
 subscribe_write(Reactor& r, Subscriber* s)
 {
-  set_write(r.selector, s->fd);
-  r.writers.insert(Sub_entry(s->fd, s));
+  if(r.backend == Reactor::Uring) {
+    if(slot(r, s->fd).io != s and not set_write(r.uring, s->fd))
+      FLOG_LOG(r.logger, Time(), Log::Error, "Reactor", r.uring.error);
+  } else if(r.backend == Reactor::Epoll) {
+    if(not set_write(r.epoll, s->fd))
+      FLOG_LOG(r.logger, Time(), Log::Error, "Reactor", r.epoll.error);
+  } else
+    set_write(r.selector, s->fd);
+  slot(r, s->fd).writer = s;
 }
 
 void 
 unsubscribe_read(Reactor& r, Subscriber* s)
 {
-  clear_read(r.selector, s->fd);
-  r.readers.erase(s->fd);
+  if(r.backend == Reactor::Uring) {
+    if(not clear_read(r.uring, s->fd))
+      FLOG_LOG(r.logger, Time(), Log::Error, "Reactor", r.uring.error);
+  } else if(r.backend == Reactor::Epoll) {
+    if(not clear_read(r.epoll, s->fd))
+      FLOG_LOG(r.logger, Time(), Log::Error, "Reactor", r.epoll.error);
+  } else
+    clear_read(r.selector, s->fd);
+  if(static_cast<std::size_t>(s->fd) < r.subscribers.size()) {
+    unindex(r, r.subscribers[s->fd]);
+    r.subscribers[s->fd].reader = nullptr;
+  }
 }
 
 void 
 unsubscribe_write(Reactor& r, Subscriber* s)
 {
-  clear_write(r.selector, s->fd);
-  r.writers.erase(s->fd);
+  if(r.backend == Reactor::Uring) {
+    if(not clear_write(r.uring, s->fd))
+      FLOG_LOG(r.logger, Time(), Log::Error, "Reactor", r.uring.error);
+  } else if(r.backend == Reactor::Epoll) {
+    if(not clear_write(r.epoll, s->fd))
+      FLOG_LOG(r.logger, Time(), Log::Error, "Reactor", r.epoll.error);
+  } else
+    clear_write(r.selector, s->fd);
+  if(static_cast<std::size_t>(s->fd) < r.subscribers.size())
+    r.subscribers[s->fd].writer = nullptr;
+}
+
+namespace {
+
+// Record the subscriber of an operation that was queued.
+bool
+submitted(Reactor& r, Subscriber* s, bool ok)
+{
+  if(not ok) {
+    FLOG_LOG(r.logger, Time(), Log::Error, "Reactor", r.uring.error);
+    return false;
+  }
+  slot(r, s->fd).io = s;
+  return true;
+}
+
+} // namespace
+
+bool
+submit_accept(Reactor& r, Subscriber* s)
+{
+  return performs_io(r) and submitted(r, s, accept(r.uring, s->fd));
+}
+
+bool
+submit_recv(Reactor& r, Subscriber* s)
+{
+  return performs_io(r) and submitted(r, s, recv(r.uring, s->fd));
+}
+
+bool
+submit_send(Reactor& r, Subscriber* s, const iovec* iov, std::size_t n)
+{
+  return performs_io(r) and submitted(r, s, send(r.uring, s->fd, iov, n));
+}
+
+void
+cancel_io(Reactor& r, Subscriber* s)
+{
+  if(performs_io(r))
+    cancel(r.uring, s->fd);
+}
+
+void
+release_io(Reactor& r, Subscriber* s)
+{
+  if(not performs_io(r) or s->fd < 0)
+    return;
+  if(static_cast<std::size_t>(s->fd) < r.subscribers.size() and
+     r.subscribers[s->fd].io == s) {
+    release(r.uring, s->fd);
+    r.subscribers[s->fd].io = nullptr;
+  }
+}
+
+std::string
+to_string(const Reactor_stats& s)
+{
+  std::stringstream ss;
+  ss << "iterations " << s.iterations.load(std::memory_order_relaxed);
+  ss << ", reads " << s.reads.load(std::memory_order_relaxed);
+  ss << ", writes " << s.writes.load(std::memory_order_relaxed);
+  ss << ", accepts " << s.accepts.load(std::memory_order_relaxed);
+  return ss.str();
+}
+
+std::string
+to_string(Reactor::Backend b)
+{
+  switch(b) {
+    case Reactor::Select: return "select";
+    case Reactor::Epoll: return "epoll";
+    case Reactor::Uring: return "io_uring";
+    default: return "unknown";
+  }
 }
 
 } // namespace flog
@@ -15,19 +15,31 @@
 #ifndef FLOWGRAMMABLE_REACTOR_H
 #define FLOWGRAMMABLE_REACTOR_H
 
-#include <map>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
 
+#include <libflog/buffer.hpp>
 #include <libflog/proto/internet.hpp>
 
 #include "time.hpp"
+#include "timer.hpp"
 #include "logger.hpp"
 #include "selector.hpp"
+#include "epoll.hpp"
+#include "uring.hpp"
 
 namespace flog {
 
 struct Reactor;
 
-// TODO: Make this hashable.
+///
+/// A Subscriber is told when its descriptor is ready, or, on a reactor
+/// that performs I/O itself (see performs_io), of the results of the
+/// accepts, receives and sends it submitted. The results are negated error
+/// numbers on failure, and -ECANCELED for cancelled operations.
+///
+
 struct Subscriber
 {
   Subscriber(Reactor& r);
@@ -38,48 +50,167 @@ struct Subscriber
   virtual void time(const Time& ct) = 0;
   virtual bool local_addr(const net::Address& addr) = 0;
 
+  /// Called with the descriptor accepted by submit_accept.
+  virtual void accepted(int res, const Time& ct) { }
+
+  /// Called with the bytes received by submit_recv. They are owned by the
+  /// reactor, and valid until the handler returns.
+  virtual void received(const Byte* data, int res, const Time& ct) { }
+
+  /// Called with the number of bytes sent by submit_send.
+  virtual void sent(int res, const Time& ct) { }
+
   bool operator<(const Subscriber& s) const;
   inline operator bool() const { return status; }
 
   Reactor& reactor;
   Time current_time;
+  Timer timer;
   int fd;
 
   bool status;
   std::string error;
 };
 
-// TODO: Use hash tables.
-using Sub_entry = std::pair<int,Subscriber*>;
-using Subscribers = std::map<int,Subscriber*>;
+///
+/// The subscribers of a descriptor. The reactor keeps one slot per
+/// descriptor number so that dispatch is a direct index into contiguous
+/// memory. If the reader was subscribed under a local address, key points
+/// to that address in the reactor's address index. The io subscriber
+/// receives the results of the operations submitted on the descriptor.
+///
+
+struct Subscriber_slot
+{
+  Subscriber_slot();
+
+  Subscriber* reader;
+  Subscriber* writer;
+  Subscriber* io;
+  const net::Address* key;
+};
+
+using Subscribers = std::vector<Subscriber_slot>;
+using Address_index = std::unordered_map<net::Address, Subscriber*>;
+
+///
+/// Counters maintained by the thread running a reactor. They are atomic so
+/// that other threads, e.g. a manager of reactor shards, can sample them.
+///
+
+struct Reactor_stats
+{
+  Reactor_stats();
+
+  std::atomic<uint64_t> iterations;
+  std::atomic<uint64_t> reads;
+  std::atomic<uint64_t> writes;
+  std::atomic<uint64_t> accepts;
+};
+
+std::string to_string(const Reactor_stats& s);
+
+/// Increment a counter that is only written by the reactor's thread. This
+/// avoids the cost of an atomic read-modify-write.
+void count(std::atomic<uint64_t>& c);
+
+///
+/// The Reactor demultiplexes readiness events to its subscribers using one
+/// of several backends. The select backend scans every subscribed descriptor
+/// on each iteration, while the epoll backend only visits the descriptors
+/// that the kernel reports as ready. The uring backend batches all interest
+/// changes of a loop turn into the single io_uring_enter call that also
+/// waits for completions. If the requested backend cannot be initialized
+/// the reactor falls back to epoll, and then to select.
+///
+/// The uring backend also performs accepts, receives and sends submitted
+/// by subscribers as ring operations, and dispatches their results. A
+/// subscriber with operations in flight on its descriptor is not polled
+/// for readiness on it.
+///
+/// The reactor owns a timer wheel. Each wait is bounded by the nearest
+/// armed deadline, and expired timers fire after the ready descriptors
+/// have been dispatched. A subscriber's own timer calls its time() handler.
+///
 
 struct Reactor {
-  Reactor(Logger& lgr, const Time& t = Time());
+  enum Backend { Select, Epoll, Uring };
+
+  Reactor(Logger& lgr, const Time& t = Time(), Backend b = Epoll,
+          bool edge = false);
 
   Logger& logger;
   bool done;
+  Backend backend;
   Selector selector;
+  flog::Epoll epoll;
+  flog::Uring uring;
   Time timeout;
+  Timer_wheel timers;
+  Reactor_stats stats;
 
-  Subscribers readers;
-  Subscribers writers;
+  Subscribers subscribers;
+  Address_index addresses;
 };
 
 void run(Reactor& r);
 void process(Reactor& r);
 void stop(Reactor& r);
 
+std::string to_string(Reactor::Backend b);
+
 Subscriber* find_reader(Reactor& r, const net::Address& addr);
 Subscriber* find_writer(Reactor& r, const net::Address& addr);
+Subscriber* reader(const Reactor& r, int fd);
+Subscriber* writer(const Reactor& r, int fd);
 void subscribe_read(Reactor& r, Subscriber* s);
+
+/// Subscribe to read events and index the subscriber by its local address,
+/// so that it can be found with find_reader. The index entry is removed
+/// when the subscriber unsubscribes from read events.
+void subscribe_read(Reactor& r, Subscriber* s, const net::Address& local);
 void subscribe_write(Reactor& r, Subscriber* s);
 void unsubscribe_read(Reactor& r, Subscriber* s);
 void unsubscribe_write(Reactor& r, Subscriber* s);
 
+/// Arrange for the subscriber's time() handler to be called once the
+/// monotonic clock reaches the deadline. Rescheduling replaces any
+/// previously scheduled deadline.
+void schedule(Reactor& r, Subscriber* s, const Time& deadline);
+void unschedule(Reactor& r, Subscriber* s);
+
+/// Returns true if subscribers may submit accepts, receives and sends to
+/// the reactor rather than wait for readiness.
+bool performs_io(const Reactor& r);
+
+/// Submit an accept, receive or send on the subscriber's descriptor. Each
+/// kind may have one operation in flight. The buffers of a send must stay
+/// valid until it completes. The operations are queued, and leave with
+/// the reactor's next wait. Returns false if they cannot be queued.
+bool submit_accept(Reactor& r, Subscriber* s);
+bool submit_recv(Reactor& r, Subscriber* s);
+bool submit_send(Reactor& r, Subscriber* s, const iovec* iov, std::size_t n);
+
+/// Cancel the operations of the subscriber. Their results are still
+/// dispatched to it.
+void cancel_io(Reactor& r, Subscriber* s);
+
+/// Cancel the operations of the subscriber and dispatch nothing more to
+/// it, e.g. before it is destroyed.
+void release_io(Reactor& r, Subscriber* s);
+
+/// Returns true if the subscriber has operations in flight.
+bool busy(const Reactor& r, const Subscriber* s);
+
 inline
 Subscriber::Subscriber(Reactor& r)
   : reactor(r), current_time(), fd(-1), status(true)
-{ }
+{
+  timer.fire = [](Timer& t, const Time& now) {
+    static_cast<Subscriber*>(t.data)->time(now);
+  };
+  timer.data = this;
+}
 
 inline bool
 Subscriber::operator<(const Subscriber& s) const
@@ -88,16 +219,84 @@ Subscriber::operator<(const Subscriber& s) const
 }
 
 inline
-Reactor::Reactor(Logger& lgr, const Time& t)
-  : logger(lgr), done(false), selector(), timeout(t), readers(), writers()
+Reactor::Reactor(Logger& lgr, const Time& t, Backend b, bool edge)
+  : logger(lgr), done(false), backend(b), selector(), epoll(), uring(),
+    timeout(t), timers(), stats(), subscribers(), addresses()
+{
+  if(backend == Uring and not open(uring)) {
+    FLOG_LOG(logger, Time(), Log::Warning, "Reactor",
+             "io_uring unavailable, using epoll: " + uring.error);
+    backend = Epoll;
+  }
+  if(backend == Epoll and not open(epoll, edge)) {
+    FLOG_LOG(logger, Time(), Log::Warning, "Reactor",
+             "epoll unavailable, using select: " + epoll.error);
+    backend = Select;
+  }
+}
+
+inline
+Subscriber_slot::Subscriber_slot()
+  : reader(nullptr), writer(nullptr), io(nullptr), key(nullptr)
+{ }
+
+inline Subscriber*
+reader(const Reactor& r, int fd)
+{
+  if(fd < 0 or static_cast<std::size_t>(fd) >= r.subscribers.size())
+    return nullptr;
+  return r.subscribers[fd].reader;
+}
+
+inline Subscriber*
+writer(const Reactor& r, int fd)
+{
+  if(fd < 0 or static_cast<std::size_t>(fd) >= r.subscribers.size())
+    return nullptr;
+  return r.subscribers[fd].writer;
+}
+
+inline
+Reactor_stats::Reactor_stats()
+  : iterations(0), reads(0), writes(0), accepts(0)
 { }
 
+inline void
+count(std::atomic<uint64_t>& c)
+{
+  c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
 inline void
 stop(Reactor& r)
 {
   r.done = true;
 }
 
+inline void
+schedule(Reactor& r, Subscriber* s, const Time& deadline)
+{
+  arm(r.timers, s->timer, deadline);
+}
+
+inline void
+unschedule(Reactor& r, Subscriber* s)
+{
+  cancel(s->timer);
+}
+
+inline bool
+performs_io(const Reactor& r)
+{
+  return r.backend == Reactor::Uring;
+}
+
+inline bool
+busy(const Reactor& r, const Subscriber* s)
+{
+  return performs_io(r) and busy(r.uring, s->fd);
+}
+
 } // namespace flog
 
 #endif
@@ -0,0 +1,129 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+extern "C" {
+#include <unistd.h>
+}
+
+#include <iostream>
+
+#include <libflog/system/reactor.hpp>
+
+using namespace flog;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+// A subscriber that drains one end of a pipe and counts its events.
+struct Pipe_reader : Subscriber
+{
+  Pipe_reader(Reactor& r, int f)
+    : Subscriber(r), reads(0), writes(0)
+  { fd = f; }
+
+  void read(const Time& t)
+  {
+    char buf[64];
+    while(::read(fd, buf, sizeof(buf)) == sizeof(buf))
+      ;
+    ++reads;
+  }
+
+  void write(const Time& t) { ++writes; }
+  void time(const Time& t) { }
+  bool local_addr(const net::Address& addr) { return false; }
+
+  int reads;
+  int writes;
+};
+
+int
+test_backend(Logger& logger, Reactor::Backend b)
+{
+  Reactor reactor(logger, Time(0, 1000), b);
+
+  // The uring backend falls back when the kernel does not support it.
+  if (reactor.backend != b and b != Reactor::Uring)
+    return fail("reactor did not use the requested backend");
+
+  int a[2], c[2];
+  if (::pipe(a) != 0 or ::pipe(c) != 0)
+    return fail("pipe");
+
+  Pipe_reader ra(reactor, a[0]);
+  Pipe_reader rc(reactor, c[0]);
+  subscribe_read(reactor, &ra);
+  subscribe_read(reactor, &rc);
+
+  // Only the subscriber whose descriptor is ready is dispatched.
+  if (::write(a[1], "x", 1) != 1)
+    return fail("write to the pipe");
+  process(reactor);
+  if (ra.reads != 1 or rc.reads != 0)
+    return fail("only the ready subscriber was not dispatched");
+
+  // Interest survives across iterations.
+  if (::write(c[1], "y", 1) != 1)
+    return fail("write to the pipe");
+  process(reactor);
+  if (ra.reads != 1 or rc.reads != 1)
+    return fail("interest did not survive across iterations");
+
+  // Nothing is dispatched once a subscriber is removed.
+  unsubscribe_read(reactor, &ra);
+  if (::write(a[1], "z", 1) != 1)
+    return fail("write to the pipe");
+  process(reactor);
+  if (ra.reads != 1 or rc.reads != 1)
+    return fail("removed subscriber was dispatched");
+
+  // Write interest is reported for the write end of a pipe.
+  Pipe_reader wc(reactor, c[1]);
+  subscribe_write(reactor, &wc);
+  process(reactor);
+  if (wc.writes != 1)
+    return fail("write interest was not reported");
+  unsubscribe_write(reactor, &wc);
+  unsubscribe_read(reactor, &rc);
+
+  // Subscribers can be found by the local address they are indexed under.
+  net::Address addr = net::make_address(net::TCP, net::IPv4, "127.0.0.1", 6633);
+  net::Address other = net::make_address(net::TCP, net::IPv4, "127.0.0.1", 6653);
+  subscribe_read(reactor, &rc, addr);
+  if (find_reader(reactor, addr) != &rc)
+    return fail("subscriber was not found by its address");
+  if (find_reader(reactor, other) != nullptr
+      or find_writer(reactor, addr) != nullptr)
+    return fail("subscriber was found under another address");
+  unsubscribe_read(reactor, &rc);
+  if (find_reader(reactor, addr) != nullptr)
+    return fail("removed subscriber was found by its address");
+
+  ::close(a[0]); ::close(a[1]);
+  ::close(c[0]); ::close(c[1]);
+  return 0;
+}
+
+int main()
+{
+  Logger logger("/dev/null");
+  if (test_backend(logger, Reactor::Select)
+      or test_backend(logger, Reactor::Epoll)
+      or test_backend(logger, Reactor::Uring))
+    return -1;
+}
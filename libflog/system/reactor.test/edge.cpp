@@ -0,0 +1,108 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+extern "C" {
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+#include <iostream>
+
+#include <libflog/system/acceptor.hpp>
+#include <libflog/system/manager.hpp>
+
+using namespace flog;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+const uint16_t port = 36663;
+const int clients = 3;
+
+// Process the reactor until it dispatches an event, or a few seconds pass.
+bool
+dispatch(Reactor& r)
+{
+  uint64_t reads = r.stats.reads;
+  Time limit = now() + Time(5);
+  while (r.stats.reads == reads) {
+    if (limit < now())
+      return false;
+    process(r);
+  }
+  return true;
+}
+
+// The listeners of an edge triggered reactor drain their descriptors on
+// each event: one event applies every queued command and accepts every
+// waiting peer.
+int main()
+{
+  Logger logger("/dev/null");
+  Reactor reactor(logger, Time(0, 1000), Reactor::Epoll, true);
+
+  int channel[2];
+  if (::pipe(channel) != 0)
+    return fail("pipe");
+  Manager manager(reactor, "test", channel[0]);
+  subscribe_read(reactor, &manager);
+
+  // The refused peers are closed by the acceptor first, leaving the port
+  // in TIME_WAIT; shared acceptors may still bind it when the test reruns.
+  manager.shared = true;
+
+  net::Address a = net::make_address(net::TCP, net::IPv4, "127.0.0.1", port);
+  net::Address b = net::make_address(net::TCP, net::IPv4, "127.0.0.1",
+                                     port + 1);
+  config::Command add_a(config::Command::Add, config::Server(a), "test");
+  config::Command add_b(config::Command::Add, config::Server(b), "test");
+  if (::write(channel[1], &add_a, sizeof(add_a)) != sizeof(add_a)
+      or ::write(channel[1], &add_b, sizeof(add_b)) != sizeof(add_b))
+    return fail("commands were not written");
+  if (not dispatch(reactor))
+    return fail("commands were not read");
+  if (not find_reader(reactor, a) or not find_reader(reactor, b))
+    return fail("queued commands were not all applied");
+
+  sockaddr_in sa;
+  sa.sin_family = AF_INET;
+  sa.sin_port = htons(port);
+  sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  int fds[clients];
+  for (int i = 0; i < clients; ++i) {
+    fds[i] = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fds[i] < 0)
+      return fail("socket");
+    if (::connect(fds[i], reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) != 0)
+      return fail("client did not connect");
+  }
+  if (not dispatch(reactor))
+    return fail("peers were not accepted");
+  if (reactor.stats.accepts != clients)
+    return fail("waiting peers were not all accepted");
+
+  for (int i = 0; i < clients; ++i)
+    ::close(fds[i]);
+  for (Subscriber* s : { find_reader(reactor, a), find_reader(reactor, b) }) {
+    unsubscribe_read(reactor, s);
+    delete s;
+  }
+  ::close(channel[1]);
+}
@@ -0,0 +1,289 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+extern "C" {
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <libflog/system/connection.hpp>
+
+using namespace flog;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+// A subscriber that records the results of the operations it submitted.
+struct Recorder : Subscriber
+{
+  Recorder(Reactor& r, int f)
+    : Subscriber(r), accepts(0), peer(-1), receives(0), sends(0), res(0)
+  { fd = f; }
+
+  void read(const Time& t) { }
+  void write(const Time& t) { }
+  void time(const Time& t) { }
+  bool local_addr(const net::Address& addr) { return false; }
+
+  void accepted(int r, const Time& t)
+  {
+    ++accepts;
+    peer = res = r;
+  }
+
+  void received(const Byte* data, int r, const Time& t)
+  {
+    ++receives;
+    res = r;
+    if (r > 0)
+      in.append(reinterpret_cast<const char*>(data), r);
+  }
+
+  void sent(int r, const Time& t)
+  {
+    ++sends;
+    res = r;
+  }
+
+  int accepts;
+  int peer;
+  int receives;
+  int sends;
+  int res;
+  std::string in;
+};
+
+// Process the reactor until the predicate holds or too many iterations
+// have passed.
+template<typename P>
+  bool
+  until(Reactor& r, P pred)
+  {
+    for (int i = 0; i < 100 and not pred(); ++i)
+      process(r);
+    return pred();
+  }
+
+int
+test_transfer(Reactor& reactor)
+{
+  int sv[2];
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+    return fail("socketpair");
+  Recorder a(reactor, sv[0]);
+  Recorder b(reactor, sv[1]);
+
+  // A gathered send arrives in order at the receiving end.
+  char hello[] = "hello, ";
+  char world[] = "world";
+  iovec iov[2] = {{hello, 7}, {world, 5}};
+  if (not submit_recv(reactor, &b))
+    return fail("recv was not submitted");
+  if (not submit_send(reactor, &a, iov, 2))
+    return fail("send was not submitted");
+  if (not busy(reactor, &a) or not busy(reactor, &b))
+    return fail("submitted operations are not in flight");
+  if (not until(reactor, [&]() { return a.sends and b.in.size() == 12; }))
+    return fail("data was not transferred");
+  if (a.res != 12 or b.in != "hello, world")
+    return fail("wrong data was transferred");
+  if (busy(reactor, &a) or busy(reactor, &b))
+    return fail("completed operations are still in flight");
+
+  // A cancelled receive completes without data.
+  if (not submit_recv(reactor, &b))
+    return fail("recv was not submitted");
+  cancel_io(reactor, &b);
+  if (not until(reactor, [&]() { return b.receives == 2; }))
+    return fail("cancelled recv did not complete");
+  if (b.res != -ECANCELED)
+    return fail("cancelled recv did not report cancellation");
+  if (busy(reactor, &b))
+    return fail("cancelled recv is still in flight");
+
+  // A released receive is never reported.
+  if (not submit_recv(reactor, &b))
+    return fail("recv was not submitted");
+  release_io(reactor, &b);
+  if (busy(reactor, &b))
+    return fail("released recv is still in flight");
+  process(reactor);
+  if (b.receives != 2)
+    return fail("released recv was reported");
+
+  // The peer closing its end completes a receive with no data.
+  if (not submit_recv(reactor, &b))
+    return fail("recv was not submitted");
+  ::close(sv[0]);
+  if (not until(reactor, [&]() { return b.receives == 3; }))
+    return fail("recv did not complete on close");
+  if (b.res != 0)
+    return fail("recv did not report the end of the stream");
+
+  ::close(sv[1]);
+  return 0;
+}
+
+int
+test_accept(Reactor& reactor)
+{
+  int l = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(addr);
+  if (l < 0
+      or ::bind(l, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+      or ::listen(l, 4) != 0
+      or ::getsockname(l, reinterpret_cast<sockaddr*>(&addr), &len) != 0)
+    return fail("listen");
+  Recorder acceptor(reactor, l);
+
+  // A connection is accepted without waiting for readiness.
+  if (not submit_accept(reactor, &acceptor))
+    return fail("accept was not submitted");
+  int c = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (c < 0 or ::connect(c, reinterpret_cast<sockaddr*>(&addr), len) != 0)
+    return fail("connect");
+  if (not until(reactor, [&]() { return acceptor.accepts == 1; }))
+    return fail("connection was not accepted");
+  if (acceptor.peer < 0)
+    return fail("accept did not return a descriptor");
+  ::close(acceptor.peer);
+
+  // A pending accept can be released before the listener is closed.
+  if (not submit_accept(reactor, &acceptor))
+    return fail("accept was not submitted");
+  release_io(reactor, &acceptor);
+  process(reactor);
+  if (acceptor.accepts != 1 or busy(reactor, &acceptor))
+    return fail("released accept was reported");
+
+  ::close(c);
+  ::close(l);
+  return 0;
+}
+
+// A protocol that sends every message back to the peer.
+struct Echo : Protocol
+{
+  Echo() : messages(0), closed(false) { }
+
+  bool open(Connection& c, const Time& t) { return true; }
+
+  bool recv(Connection& c, Framer& f, const Time& t)
+  {
+    while (f.ready()) {
+      Buffer_view v = f.next();
+      send(c, Buffer(v.first, v.last));
+      ++messages;
+    }
+    return true;
+  }
+
+  bool time(Connection& c, const Time& t) { return true; }
+  void close(Connection& c, const Time& t) { closed = true; }
+
+  int messages;
+  bool closed;
+};
+
+// A connection that counts its deletions.
+struct Counted : Connection
+{
+  Counted(Reactor& r, int fd, int& n)
+    : Connection(r, socket::Socket(net::TCP, nullptr, nullptr, fd)),
+      deleted(n)
+  { self_owned = true; }
+
+  ~Counted() { ++deleted; }
+
+  int& deleted;
+};
+
+int
+test_connection(Reactor& reactor)
+{
+  int sv[2];
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+    return fail("socketpair");
+  int deleted = 0;
+  Echo echo;
+  Counted* c = new Counted(reactor, sv[0], deleted);
+  attach(*c, echo, now());
+  if (not busy(reactor, c))
+    return fail("connection did not submit a recv");
+
+  // Messages received in one completion are answered by one send.
+  const Byte hello[] = {4, 0, 0, 8, 0, 0, 0, 1, 4, 0, 0, 8, 0, 0, 0, 2};
+  if (::write(sv[1], hello, sizeof(hello)) != sizeof(hello))
+    return fail("write to the connection");
+  if (not until(reactor, [&]() { return echo.messages == 2
+                                        and empty(c->output); }))
+    return fail("messages were not echoed");
+  Byte reply[sizeof(hello)];
+  if (::read(sv[1], reply, sizeof(reply)) != sizeof(reply)
+      or std::memcmp(reply, hello, sizeof(hello)) != 0)
+    return fail("wrong messages were echoed");
+
+  // Closing with a recv in flight is finished by its completion.
+  close(*c, now(), "test");
+  if (not echo.closed)
+    return fail("protocol was not closed");
+  if (deleted != 0)
+    return fail("connection was deleted with a recv in flight");
+  if (not until(reactor, [&]() { return deleted == 1; }))
+    return fail("connection was not deleted after its recv completed");
+  if (::read(sv[1], reply, sizeof(reply)) != 0)
+    return fail("peer did not see the end of the stream");
+
+  // A peer closing its end closes the connection.
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+    return fail("socketpair");
+  Echo other;
+  c = new Counted(reactor, sv[0], deleted);
+  attach(*c, other, now());
+  ::close(sv[1]);
+  if (not until(reactor, [&]() { return deleted == 2; }))
+    return fail("connection was not closed by its peer");
+  if (not other.closed)
+    return fail("protocol was not closed by the peer");
+  return 0;
+}
+
+int main()
+{
+  Logger logger("/dev/null");
+  Reactor reactor(logger, Time(0, 1000), Reactor::Uring);
+
+  // Nothing to test when the kernel does not support io_uring.
+  if (not performs_io(reactor))
+    return 0;
+
+  if (test_transfer(reactor)
+      or test_accept(reactor)
+      or test_connection(reactor))
+    return -1;
+}
@@ -23,6 +23,12 @@ extern "C" {
 
 namespace flog {
 
+///
+/// The read and write sets record the interest of each subscriber, and
+/// select() reports readiness in the separate ready sets so that the
+/// interest survives across calls.
+///
+
 struct Selector
 {
   Selector();
@@ -30,6 +36,8 @@ struct Selector
   int max;
   fd_set read_set;
   fd_set write_set;
+  fd_set read_ready;
+  fd_set write_ready;
 };
 
 int select(Selector& s, const Time* t = nullptr);
@@ -48,28 +56,32 @@ Selector::Selector()
 {
   FD_ZERO(&read_set);
   FD_ZERO(&write_set);
+  FD_ZERO(&read_ready);
+  FD_ZERO(&write_ready);
 }
 
 inline int
 select(Selector& s, const Time* tm)
 {
+  s.read_ready = s.read_set;
+  s.write_ready = s.write_set;
   if(tm != nullptr) {
     timeval timeout = c_timeval(*tm);
-    return ::select(s.max+1, &s.read_set, &s.write_set, nullptr, &timeout);
+    return ::select(s.max+1, &s.read_ready, &s.write_ready, nullptr, &timeout);
   } else
-    return ::select(s.max+1, &s.read_set, &s.write_set, nullptr, nullptr);
+    return ::select(s.max+1, &s.read_ready, &s.write_ready, nullptr, nullptr);
 }
 
 inline bool 
 isset_read(Selector& s, int fd)
 {
-  return FD_ISSET(fd, &s.read_set);
+  return FD_ISSET(fd, &s.read_ready);
 }
 
 inline bool 
 isset_write(Selector& s, int fd)
 {
-  return FD_ISSET(fd, &s.write_set);
+  return FD_ISSET(fd, &s.write_ready);
 }
 
 inline void
@@ -90,9 +102,9 @@ inline int
 find_max(Selector& s, int fd)
 {
   for(;fd>=0;--fd) {
-    if(isset_read(s, fd))
+    if(FD_ISSET(fd, &s.read_set))
       return fd;
-    if(isset_write(s, fd))
+    if(FD_ISSET(fd, &s.write_set))
       return fd;
   }
   return -1;
@@ -102,14 +114,16 @@ inline void
 clear_read(Selector& s, int fd)
 {
   FD_CLR(fd, &s.read_set);
-  s.max = find_max(s, fd);
+  FD_CLR(fd, &s.read_ready);
+  s.max = find_max(s, s.max);
 }
 
 inline void
 clear_write(Selector& s, int fd)
 {
   FD_CLR(fd, &s.write_set);
-  s.max = find_max(s, fd);
+  FD_CLR(fd, &s.write_ready);
+  s.max = find_max(s, s.max);
 }
 
 } // namespace flog
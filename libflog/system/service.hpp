@@ -0,0 +1,67 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+// 
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_SERVICE_H
+#define FLOWGRAMMABLE_SERVICE_H
+
+#include <string>
+
+#include "reactor.hpp"
+#include "socket.hpp"
+#include "config.hpp"
+
+namespace flog {
+
+///
+/// A Service runs a protocol on the connections that a manager and its
+/// acceptors make, so that neither needs to know the protocol. It makes a
+/// connection for each peer, with the protocol attached, and applies the
+/// configuration commands that concern the protocol: the loading and
+/// unloading of applications, and the ofp settings.
+///
+/// The connections a service makes own themselves, and are deleted when
+/// they close. A call that fails leaves the reason in error.
+///
+
+struct Service
+{
+  virtual ~Service() { }
+
+  /// Run the protocol on a connection to the peer accepted on s. Returns
+  /// false if the peer is refused.
+  virtual bool accept(Reactor& r, socket::Socket&& s, const Time& t) = 0;
+
+  /// Run the protocol on a connection to the remote address, from the
+  /// local one. Returns false if the connection cannot be made.
+  virtual bool connect(Reactor& r, const net::Address& remote,
+                       const net::Address& local, const Time& t) = 0;
+
+  /// Load the application of the named plugin for the connections made
+  /// after it. A warning about a plugin that loaded is left in error.
+  virtual bool add_app(const std::string& name) = 0;
+
+  /// Stop using the application of the named plugin for the connections
+  /// made after it. Returns false if no such plugin is loaded. A note on
+  /// what the connections use instead may be left in error.
+  virtual bool del_app(const std::string& name) = 0;
+
+  /// Apply an ofp setting to the connections made after it.
+  virtual bool set_ofp(const config::Ofp& o) = 0;
+
+  std::string error;
+};
+
+} // namespace flog
+
+#endif
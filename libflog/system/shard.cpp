@@ -0,0 +1,111 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+extern "C" {
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+}
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+#include "shard.hpp"
+
+namespace flog {
+
+namespace {
+
+// Create the command pipe of a shard and return its read end, which is
+// owned by the shard's manager.
+int
+open_channel(int (&fds)[2])
+{
+  if(::pipe2(fds, O_NONBLOCK | O_CLOEXEC) < 0)
+    fds[0] = fds[1] = -1;
+  return fds[0];
+}
+
+} // namespace
+
+Shard::Shard(int i, int c, const std::string& log, Reactor::Backend b)
+  : id(i), core(c), channel{-1, -1}, logger(log), reactor(logger, Time(), b),
+    manager(reactor, "shard", open_channel(channel)), thread(), status(true)
+{
+  manager.shared = true;
+  subscribe_read(reactor, &manager);
+}
+
+Shard::~Shard()
+{
+  stop(*this);
+  if(channel[1] > -1)
+    ::close(channel[1]);
+}
+
+bool
+start(Shard& s)
+{
+  s.thread = std::thread([&s]() { run(s.reactor); });
+
+  if(s.core >= 0) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(s.core, &cpus);
+    int err = ::pthread_setaffinity_np(s.thread.native_handle(),
+                                       sizeof(cpu_set_t), &cpus);
+    if(err != 0) {
+      s.status = false;
+      s.error = strerror(err);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+send(Shard& s, const config::Command& cmd)
+{
+  // Commands are smaller than PIPE_BUF, so each write is atomic.
+  auto n = ::write(s.channel[1], &cmd, sizeof(config::Command));
+  if(n != sizeof(config::Command)) {
+    s.status = false;
+    s.error = n < 0 ? strerror(errno) : "short write";
+    return false;
+  }
+  return true;
+}
+
+void
+stop(Shard& s)
+{
+  if(not s.thread.joinable())
+    return;
+  send(s, config::Command(config::Command::Stop));
+  s.thread.join();
+}
+
+std::string
+to_string(const Shard& s)
+{
+  std::stringstream ss;
+  ss << "shard " << s.id << " (core " << s.core << "): ";
+  ss << to_string(stats(s));
+  ss << ", log drops " << dropped(s.logger);
+  return ss.str();
+}
+
+} // namespace flog
@@ -0,0 +1,76 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_SHARD_H
+#define FLOWGRAMMABLE_SHARD_H
+
+#include <thread>
+
+#include "reactor.hpp"
+#include "manager.hpp"
+
+namespace flog {
+
+///
+/// @brief A reactor running on its own thread, pinned to a core
+///
+/// A Shard owns a reactor, its logger and a Manager that reads commands
+/// from a pipe. The controlling Manager fans configuration commands out
+/// to every shard through that pipe, so each shard creates its own shared
+/// (SO_REUSEPORT) acceptor for a server address and owns the connections
+/// it accepts. No state is shared between shards except the reactor
+/// statistics, which may be sampled from any thread.
+///
+
+struct Shard
+{
+  Shard(int i, int c, const std::string& log,
+        Reactor::Backend b = Reactor::Epoll);
+  ~Shard();
+
+  Shard(const Shard&) = delete;
+  Shard& operator=(const Shard&) = delete;
+
+  int id;
+  int core;
+  int channel[2];
+
+  Logger logger;
+  Reactor reactor;
+  Manager manager;
+  std::thread thread;
+
+  bool status;
+  std::string error;
+};
+
+/// Start the shard's reactor thread and pin it to the shard's core. A
+/// negative core leaves the thread unpinned.
+bool start(Shard& s);
+
+/// Queue a command for the shard. The command is applied on the shard's
+/// own thread.
+bool send(Shard& s, const config::Command& cmd);
+
+/// Stop the shard's reactor and wait for its thread to finish.
+void stop(Shard& s);
+
+/// Sample the statistics of the shard's reactor.
+inline const Reactor_stats& stats(const Shard& s) { return s.reactor.stats; }
+
+std::string to_string(const Shard& s);
+
+} // namespace flog
+
+#endif
@@ -0,0 +1,85 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+extern "C" {
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <libflog/system/shard.hpp>
+
+using namespace flog;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+const uint16_t port = 36653;
+const int clients = 16;
+
+uint64_t
+accepted(Shard& a, Shard& b)
+{
+  return stats(a).accepts.load() + stats(b).accepts.load();
+}
+
+int main()
+{
+  Shard a(0, -1, "/dev/null");
+  Shard b(1, -1, "/dev/null");
+  if (not start(a) or not start(b))
+    return fail("shards were not started");
+
+  // Both shards listen on the same address.
+  net::Address addr = net::make_address(net::TCP, net::IPv4, "127.0.0.1", port);
+  config::Command cmd(config::Command::Add, config::Server(addr), "test");
+  if (not send(a, cmd) or not send(b, cmd))
+    return fail("listen command was not sent");
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  sockaddr_in sa;
+  sa.sin_family = AF_INET;
+  sa.sin_port = htons(port);
+  sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  int fds[clients];
+  for(int i = 0; i < clients; ++i) {
+    fds[i] = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fds[i] < 0)
+      return fail("socket");
+    if (::connect(fds[i], reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) != 0)
+      return fail("client did not connect");
+  }
+
+  // Every connection is accepted by exactly one of the shards.
+  for(int i = 0; i < 100 and accepted(a, b) < clients; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  uint64_t n = accepted(a, b);
+
+  stop(a);
+  stop(b);
+  for(int i = 0; i < clients; ++i)
+    ::close(fds[i]);
+  if (n != clients)
+    return fail("connections were not each accepted once");
+}
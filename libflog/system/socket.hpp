@@ -85,8 +85,15 @@ struct IPv6 : Address {
 
 Address* make_address(const net::Address& a);
 
+///
+/// A socket constructed from an address is bound to it. When shared is
+/// set, SO_REUSEADDR and SO_REUSEPORT are enabled before binding so that
+/// several sockets, e.g. one per reactor shard, can listen on the same
+/// address and have the kernel balance connections between them.
+///
+
 struct Socket {
-  Socket(const net::Address& a);
+  Socket(const net::Address& a, bool shared = false);
   Socket(net::Transport t, const Address& l);
   Socket(net::Transport t, Address* l);
   Socket(net::Transport t, Address* l, Address* p, int f);
@@ -247,14 +254,20 @@ IPv6::copy() const
 }
 
 inline
-Socket::Socket(const net::Address& a)
+Socket::Socket(const net::Address& a, bool shared)
   : transport(a.transport), local(make_address(a)), peer(nullptr),
     fd(::socket(local->type(), to_domain(a.transport), 0)), status(true)
 {
   int flags;
+  int on = 1;
   if (fd < 0) {
     status = false;
     error = strerror(errno);
+  } else if (shared and 
+             (::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) < 0 or
+              ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0)) {
+    status = false;
+    error = strerror(errno);
   } else {
     flags = ::fcntl(fd, F_GETFD);
     if (flags < 0) {
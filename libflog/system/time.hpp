@@ -17,6 +17,7 @@
 
 extern "C" {
 #include <sys/time.h>
+#include <time.h>
 }
 
 #include <string>
@@ -96,6 +97,13 @@ Time operator-(const Time& lhs, const Time& rhs);
 
 timeval c_timeval(const Time& t);
 
+///
+/// Return the current time of the monotonic clock. Unlike the wall clock,
+/// it never steps backward, so it is suitable for computing deadlines.
+///
+
+Time now();
+
 std::string to_string(const Time& t);
 
 inline
@@ -132,6 +140,12 @@ Time::operator=(const Time& t)
   return *this;
 }
 
+inline
+Time::operator bool() const
+{
+  return good;
+}
+
 inline timeval
 c_timeval(const Time& t)
 {
@@ -182,15 +196,25 @@ operator+(const Time& lhs, const Time& rhs)
 }
 
 inline Time
-operator-(Time lhs, const Time& rhs)
+operator-(const Time& lhs, const Time& rhs)
 {
-  if(rhs.sec < lhs.sec or (lhs.sec == rhs.sec and rhs.usec > lhs.usec)) 
+  if(lhs < rhs)
     return Time();
-  if(lhs.usec < rhs.usec) {
-    --lhs.sec;
-    lhs.usec += Time::Radix;
+  int sec = lhs.sec;
+  int usec = lhs.usec;
+  if(usec < rhs.usec) {
+    --sec;
+    usec += Time::Radix;
   }
-  return Time(lhs.sec-rhs.sec, lhs.usec-rhs.usec);
+  return Time(sec-rhs.sec, usec-rhs.usec);
+}
+
+inline Time
+now()
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return Time(ts.tv_sec, ts.tv_nsec / 1000);
 }
 
 } // namespace
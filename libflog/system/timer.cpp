@@ -0,0 +1,235 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include "timer.hpp"
+
+namespace flog {
+
+namespace {
+
+inline uint64_t
+microseconds(const Time& t)
+{
+  return static_cast<uint64_t>(t.sec) * Time::Radix + t.usec;
+}
+
+// The tick containing t.
+inline uint64_t
+floor_ticks(const Timer_wheel& w, const Time& t)
+{
+  return microseconds(t) / microseconds(w.resolution);
+}
+
+// The first tick at or after t, so that timers never fire early.
+inline uint64_t
+ceil_ticks(const Timer_wheel& w, const Time& t)
+{
+  uint64_t r = microseconds(w.resolution);
+  return (microseconds(t) + r - 1) / r;
+}
+
+inline Time
+tick_time(const Timer_wheel& w, uint64_t tick)
+{
+  uint64_t us = tick * microseconds(w.resolution);
+  return Time(us / Time::Radix, us % Time::Radix);
+}
+
+inline bool
+empty(const Timer_link& l)
+{
+  return l.next == &l;
+}
+
+inline void
+link(Timer_link& head, Timer_link& l)
+{
+  l.prev = head.prev;
+  l.next = &head;
+  head.prev->next = &l;
+  head.prev = &l;
+}
+
+inline void
+unlink(Timer_link& l)
+{
+  l.prev->next = l.next;
+  l.next->prev = l.prev;
+  l.prev = l.next = &l;
+}
+
+// Move all links of from to the end of to.
+inline void
+splice(Timer_link& to, Timer_link& from)
+{
+  if(empty(from))
+    return;
+  from.next->prev = to.prev;
+  to.prev->next = from.next;
+  from.prev->next = &to;
+  to.prev = from.prev;
+  from.prev = from.next = &from;
+}
+
+inline void
+set_occupied(Timer_wheel& w, std::size_t slot)
+{
+  w.occupied[slot / 64] |= uint64_t(1) << (slot % 64);
+}
+
+inline void
+clear_occupied(Timer_wheel& w, std::size_t slot)
+{
+  w.occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+}
+
+inline bool
+is_occupied(const Timer_wheel& w, std::size_t slot)
+{
+  return w.occupied[slot / 64] & (uint64_t(1) << (slot % 64));
+}
+
+// Returns the distance, in [1, Slots], from the current slot to the next
+// occupied slot.
+std::size_t
+next_occupied(const Timer_wheel& w)
+{
+  std::size_t start = (w.current + 1) % Timer_wheel::Slots;
+  for(std::size_t n = 0; n <= Timer_wheel::Words; ++n) {
+    std::size_t word = (start / 64 + n) % Timer_wheel::Words;
+    uint64_t bits = w.occupied[word];
+    // Ignore the bits before the start slot in the first word.
+    if(n == 0)
+      bits &= ~uint64_t(0) << (start % 64);
+    if(bits) {
+      std::size_t slot = word * 64 + __builtin_ctzll(bits);
+      return (slot + Timer_wheel::Slots - start) % Timer_wheel::Slots + 1;
+    }
+  }
+  return Timer_wheel::Slots;
+}
+
+} // namespace
+
+Timer_wheel::Timer_wheel(const Time& r)
+  : resolution(r), current(0), size(0), due()
+{
+  for(std::size_t i = 0; i < Words; ++i)
+    occupied[i] = 0;
+}
+
+Timer_wheel::~Timer_wheel()
+{
+  // Detach any timers that outlive the wheel.
+  for(Timer_link* head = slots; head != slots + Slots + 1; ++head) {
+    Timer_link& list = head == slots + Slots ? due : *head;
+    while(not empty(list)) {
+      Timer* t = static_cast<Timer*>(list.next);
+      unlink(*t);
+      t->wheel = nullptr;
+    }
+  }
+}
+
+void
+arm(Timer_wheel& w, Timer& t, const Time& deadline)
+{
+  cancel(t);
+  t.wheel = &w;
+  t.deadline = deadline;
+  t.expired = false;
+  t.expiry = ceil_ticks(w, deadline);
+  ++w.size;
+
+  if(t.expiry <= w.current) {
+    link(w.due, t);
+  } else {
+    std::size_t slot = t.expiry % Timer_wheel::Slots;
+    link(w.slots[slot], t);
+    set_occupied(w, slot);
+  }
+}
+
+void
+cancel(Timer& t)
+{
+  t.expired = false;
+  if(not t.wheel)
+    return;
+
+  Timer_wheel& w = *t.wheel;
+  unlink(t);
+  t.wheel = nullptr;
+  --w.size;
+
+  std::size_t slot = t.expiry % Timer_wheel::Slots;
+  if(empty(w.slots[slot]))
+    clear_occupied(w, slot);
+}
+
+void
+advance(Timer_wheel& w, const Time& now)
+{
+  // Collect the expired timers before firing any of them, so that
+  // callbacks are free to arm and cancel timers.
+  Timer_link batch;
+  splice(batch, w.due);
+
+  uint64_t target = now ? floor_ticks(w, now) : w.current;
+  if(target > w.current) {
+    uint64_t steps = target - w.current;
+    if(steps > Timer_wheel::Slots)
+      steps = Timer_wheel::Slots;
+    for(uint64_t i = 1; i <= steps; ++i) {
+      std::size_t slot = (w.current + i) % Timer_wheel::Slots;
+      if(not is_occupied(w, slot))
+        continue;
+      Timer_link& list = w.slots[slot];
+      Timer_link* l = list.next;
+      while(l != &list) {
+        Timer_link* next = l->next;
+        if(static_cast<Timer*>(l)->expiry <= target) {
+          unlink(*l);
+          link(batch, *l);
+        }
+        l = next;
+      }
+      if(empty(list))
+        clear_occupied(w, slot);
+    }
+    w.current = target;
+  }
+
+  while(not empty(batch)) {
+    Timer& t = *static_cast<Timer*>(batch.next);
+    unlink(t);
+    t.wheel = nullptr;
+    t.expired = true;
+    --w.size;
+    if(t.fire)
+      t.fire(t, now);
+  }
+}
+
+Time
+next_deadline(const Timer_wheel& w)
+{
+  if(w.size == 0)
+    return Time();
+  if(not empty(w.due))
+    return tick_time(w, w.current);
+  return tick_time(w, w.current + next_occupied(w));
+}
+
+} // namespace flog
@@ -0,0 +1,151 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_TIMER_H
+#define FLOWGRAMMABLE_TIMER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "time.hpp"
+
+namespace flog {
+
+struct Timer;
+struct Timer_wheel;
+
+/// The function called when a timer expires.
+using Timer_callback = void (*)(Timer& t, const Time& now);
+
+/// The links of a doubly linked, circular timer list.
+struct Timer_link
+{
+  Timer_link();
+
+  Timer_link* prev;
+  Timer_link* next;
+};
+
+///
+/// @brief A timer that can be armed on a Timer_wheel
+///
+/// Timers are intrusive: the wheel links the timer objects themselves,
+/// so arming and cancelling never allocate. When a timer fires, its
+/// expired flag is set before its callback, if any, is invoked. The
+/// flag is cleared when the timer is armed or cancelled. A timer is
+/// cancelled when it is destroyed.
+///
+
+struct Timer : Timer_link
+{
+  Timer(Timer_callback cb = nullptr, void* d = nullptr);
+  ~Timer();
+
+  Timer(const Timer&) = delete;
+  Timer& operator=(const Timer&) = delete;
+
+  Timer_wheel* wheel;
+  uint64_t expiry;
+  Time deadline;
+  bool expired;
+
+  Timer_callback fire;
+  void* data;
+};
+
+bool is_armed(const Timer& t);
+
+///
+/// @brief A hashed timing wheel
+///
+/// Time is divided into ticks of a fixed resolution, and each timer is
+/// hashed into the slot of the tick at which it expires. Arming and
+/// cancelling are constant time. Advancing the wheel visits the slots of
+/// the elapsed ticks, at most one revolution's worth, and fires the timers
+/// in those slots whose expiry has passed; timers that are more than one
+/// revolution away remain in their slot until a later visit.
+///
+/// A timer armed with a deadline that has already passed is fired by the
+/// next call to advance, regardless of the time given to it.
+///
+/// An occupancy bitmap over the slots allows the next deadline to be found
+/// without visiting empty slots. The deadline it reports may be early, by
+/// whole revolutions, but is never late.
+///
+
+struct Timer_wheel
+{
+  static const std::size_t Slots = 512;
+  static const std::size_t Words = Slots / 64;
+
+  Timer_wheel(const Time& r = Time(0, 1000));
+  ~Timer_wheel();
+
+  Timer_wheel(const Timer_wheel&) = delete;
+  Timer_wheel& operator=(const Timer_wheel&) = delete;
+
+  Time resolution;
+  uint64_t current;
+  std::size_t size;
+
+  Timer_link due;
+  Timer_link slots[Slots];
+  uint64_t occupied[Words];
+};
+
+void arm(Timer_wheel& w, Timer& t, const Time& deadline);
+void cancel(Timer& t);
+
+/// Arm the timer to fire no later than the deadline. A timer that is
+/// armed with an earlier deadline is left alone.
+void arm_by(Timer_wheel& w, Timer& t, const Time& deadline);
+
+void advance(Timer_wheel& w, const Time& now);
+
+/// Returns the time at which the next timer may expire, or an invalid time
+/// if no timers are armed.
+Time next_deadline(const Timer_wheel& w);
+
+inline
+Timer_link::Timer_link()
+  : prev(this), next(this)
+{ }
+
+inline
+Timer::Timer(Timer_callback cb, void* d)
+  : wheel(nullptr), expiry(0), deadline(), expired(false), fire(cb), data(d)
+{ }
+
+inline
+Timer::~Timer()
+{
+  cancel(*this);
+}
+
+inline bool
+is_armed(const Timer& t)
+{
+  return t.wheel != nullptr;
+}
+
+inline void
+arm_by(Timer_wheel& w, Timer& t, const Time& deadline)
+{
+  if(not is_armed(t) or deadline < t.deadline)
+    arm(w, t, deadline);
+}
+
+} // namespace flog
+
+#endif
@@ -0,0 +1,91 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <iostream>
+
+#include <libflog/system/timer.hpp>
+
+using namespace flog;
+
+int
+fail(const char* what)
+{
+  std::cerr << "FAIL: " << what << std::endl;
+  return -1;
+}
+
+// Counts the number of times a timer fires.
+void
+tally(Timer& t, const Time& now)
+{
+  ++*static_cast<int*>(t.data);
+}
+
+int main()
+{
+  Timer_wheel wheel(Time(0, 1000));
+  if (next_deadline(wheel))
+    return fail("empty wheel has a deadline");
+
+  int a = 0, b = 0, c = 0;
+  Timer ta(tally, &a), tb(tally, &b), tc(tally, &c);
+
+  arm(wheel, ta, Time(0, 5000));
+  arm(wheel, tb, Time(2));          // More than one revolution away.
+  arm(wheel, tc, Time(0, 7000));
+  if (wheel.size != 3 or next_deadline(wheel) != Time(0, 5000))
+    return fail("armed timers were not counted");
+
+  // Timers never fire early.
+  advance(wheel, Time(0, 4999));
+  if (a != 0)
+    return fail("timer fired early");
+
+  advance(wheel, Time(0, 5000));
+  if (a != 1 or not ta.expired or is_armed(ta))
+    return fail("timer did not fire at its deadline");
+  if (next_deadline(wheel) != Time(0, 7000))
+    return fail("next deadline was not that of the next timer");
+
+  // Cancelled timers do not fire.
+  cancel(tc);
+  if (is_armed(tc))
+    return fail("cancelled timer is armed");
+  advance(wheel, Time(1));
+  if (c != 0 or b != 0)
+    return fail("cancelled or distant timer fired");
+
+  // The deadline of a distant timer may be reported early, never late.
+  if (Time(2) < next_deadline(wheel))
+    return fail("deadline of a distant timer was reported late");
+  advance(wheel, Time(2));
+  if (b != 1 or wheel.size != 0)
+    return fail("distant timer did not fire");
+
+  // A timer armed in the past fires on the next advance.
+  arm(wheel, ta, Time(1));
+  if (ta.expired or next_deadline(wheel) != Time(2))
+    return fail("timer armed in the past was not due");
+  advance(wheel, Time());
+  if (a != 2)
+    return fail("timer armed in the past did not fire");
+
+  // Timers detach from a wheel that is destroyed before them.
+  {
+    Timer_wheel w;
+    arm(w, tc, Time(10));
+  }
+  if (is_armed(tc))
+    return fail("timer is armed on a destroyed wheel");
+}
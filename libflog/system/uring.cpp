@@ -0,0 +1,598 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "uring.hpp"
+
+#ifdef FLOG_HAVE_IO_URING
+
+extern "C" {
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+}
+
+namespace flog {
+
+namespace {
+
+// User data tags. Requests carry the descriptor in the low word, and the
+// operation and its generation in the high word. Requests issued by the
+// selector itself (timeouts, poll removals and cancellations) have the
+// internal bit set.
+const uint64_t Internal = 1ull << 63;
+const uint32_t Generation_mask = 0x1fffffff;
+
+inline uint64_t
+tag(int fd, Uring::Op op, uint32_t gen)
+{
+  return (static_cast<uint64_t>(op) << 61) |
+         (static_cast<uint64_t>(gen & Generation_mask) << 32) |
+         static_cast<uint32_t>(fd);
+}
+
+inline uint64_t
+poll_tag(int fd, uint32_t gen)
+{
+  return tag(fd, Uring::Poll, gen);
+}
+
+inline uint32_t
+op_bit(Uring::Op op)
+{
+  return 1u << op;
+}
+
+inline int
+sys_setup(unsigned entries, io_uring_params* p)
+{
+  return ::syscall(__NR_io_uring_setup, entries, p);
+}
+
+inline int
+sys_enter(int fd, unsigned submit, unsigned complete, unsigned flags)
+{
+  return ::syscall(__NR_io_uring_enter, fd, submit, complete, flags, nullptr, 0);
+}
+
+inline int
+sys_register(int fd, unsigned op, void* arg, unsigned n)
+{
+  return ::syscall(__NR_io_uring_register, fd, op, arg, n);
+}
+
+// Returns true if the kernel supports every operation used here.
+bool
+probe(Uring& u)
+{
+  const unsigned n = 256;
+  std::vector<char> buf(sizeof(io_uring_probe) + n * sizeof(io_uring_probe_op));
+  io_uring_probe* p = reinterpret_cast<io_uring_probe*>(buf.data());
+  if(sys_register(u.fd, IORING_REGISTER_PROBE, p, n) < 0) {
+    u.error = strerror(errno);
+    return false;
+  }
+  const unsigned ops[] = { IORING_OP_POLL_ADD, IORING_OP_POLL_REMOVE,
+                           IORING_OP_TIMEOUT, IORING_OP_ACCEPT,
+                           IORING_OP_RECV, IORING_OP_SENDMSG,
+                           IORING_OP_ASYNC_CANCEL };
+  for(unsigned op : ops) {
+    if(op > p->last_op or not (p->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+      u.error = "io_uring lacks poll, timeout, socket or cancel support";
+      return false;
+    }
+  }
+  return true;
+}
+
+// Submit all queued entries without waiting for completions.
+int
+submit(Uring& u)
+{
+  int n = sys_enter(u.fd, u.queued, 0, 0);
+  if(n > 0)
+    u.queued -= n;
+  return n;
+}
+
+// Return a cleared submission entry, flushing the queue to the kernel if
+// the submission ring is full.
+io_uring_sqe*
+get_sqe(Uring& u)
+{
+  unsigned tail = *u.sq_tail;
+  unsigned head = __atomic_load_n(u.sq_head, __ATOMIC_ACQUIRE);
+  if(tail - head >= u.sq_entries) {
+    if(submit(u) < 0)
+      return nullptr;
+    head = __atomic_load_n(u.sq_head, __ATOMIC_ACQUIRE);
+    if(tail - head >= u.sq_entries)
+      return nullptr;
+  }
+  unsigned index = tail & *u.sq_mask;
+  io_uring_sqe* sqe = static_cast<io_uring_sqe*>(u.sqes) + index;
+  std::memset(sqe, 0, sizeof(io_uring_sqe));
+  u.sq_array[index] = index;
+  return sqe;
+}
+
+// Publish the entry most recently returned by get_sqe.
+inline void
+push_sqe(Uring& u)
+{
+  __atomic_store_n(u.sq_tail, *u.sq_tail + 1, __ATOMIC_RELEASE);
+  ++u.queued;
+}
+
+inline uint32_t
+poll_mask(uint32_t bits)
+{
+  uint32_t mask = 0;
+  if(bits & Uring::Read)
+    mask |= POLLIN | POLLRDHUP;
+  if(bits & Uring::Write)
+    mask |= POLLOUT;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  mask = (mask << 16) | (mask >> 16);
+#endif
+  return mask;
+}
+
+bool
+poll_add(Uring& u, int fd, uint32_t bits)
+{
+  io_uring_sqe* sqe = get_sqe(u);
+  if(not sqe) {
+    u.error = "submission queue full";
+    return false;
+  }
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+  sqe->poll32_events = poll_mask(bits);
+  sqe->user_data = poll_tag(fd, u.generation[fd]);
+  push_sqe(u);
+  u.armed[fd] = bits;
+  return true;
+}
+
+bool
+poll_remove(Uring& u, int fd)
+{
+  io_uring_sqe* sqe = get_sqe(u);
+  if(not sqe) {
+    u.error = "submission queue full";
+    return false;
+  }
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = poll_tag(fd, u.generation[fd]);
+  sqe->user_data = Internal;
+  push_sqe(u);
+  ++u.generation[fd];
+  u.armed[fd] = 0;
+  return true;
+}
+
+void
+reserve(Uring& u, int fd)
+{
+  if(u.interest.size() <= static_cast<std::size_t>(fd)) {
+    u.interest.resize(fd + 1, 0);
+    u.armed.resize(fd + 1, 0);
+    u.generation.resize(fd + 1, 0);
+  }
+}
+
+// Replace the outstanding poll request of fd with one for bits.
+bool
+update(Uring& u, int fd, uint32_t bits)
+{
+  if(fd < 0)
+    return false;
+  reserve(u, fd);
+  u.interest[fd] = bits;
+  if(u.armed[fd] == bits)
+    return true;
+  if(u.armed[fd] and not poll_remove(u, fd))
+    return false;
+  if(bits)
+    return poll_add(u, fd, bits);
+  return true;
+}
+
+inline uint32_t
+interest(const Uring& u, int fd)
+{
+  return fd >= 0 and fd < static_cast<int>(u.interest.size()) ? u.interest[fd] : 0;
+}
+
+// Returns the operations of fd, allocating them on first use.
+Uring::Io&
+io_state(Uring& u, int fd)
+{
+  if(u.io.size() <= static_cast<std::size_t>(fd))
+    u.io.resize(fd + 1);
+  if(not u.io[fd])
+    u.io[fd].reset(new Uring::Io());
+  return *u.io[fd];
+}
+
+inline Uring::Io*
+find_io(const Uring& u, int fd)
+{
+  return fd >= 0 and fd < static_cast<int>(u.io.size()) ? u.io[fd].get() : nullptr;
+}
+
+// Returns a submission entry for the operation op on fd, or null if one is
+// already in flight or the submission queue is full.
+io_uring_sqe*
+start(Uring& u, int fd, Uring::Op op)
+{
+  if(fd < 0) {
+    u.error = "bad descriptor";
+    return nullptr;
+  }
+  Uring::Io& io = io_state(u, fd);
+  if(io.pending & op_bit(op)) {
+    u.error = "operation already in flight";
+    return nullptr;
+  }
+  io_uring_sqe* sqe = get_sqe(u);
+  if(not sqe) {
+    u.error = "submission queue full";
+    return nullptr;
+  }
+  sqe->fd = fd;
+  sqe->user_data = tag(fd, op, io.generation);
+  io.pending |= op_bit(op);
+  return sqe;
+}
+
+} // namespace
+
+bool
+open(Uring& u, unsigned entries)
+{
+  close(u);
+
+  io_uring_params p;
+  std::memset(&p, 0, sizeof(p));
+  u.fd = sys_setup(entries, &p);
+  if(u.fd < 0) {
+    u.error = strerror(errno);
+    return false;
+  }
+
+  u.sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  u.cq_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+  bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+  if(single)
+    u.sq_size = u.cq_size = std::max(u.sq_size, u.cq_size);
+
+  u.sq_ring = ::mmap(nullptr, u.sq_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, u.fd, IORING_OFF_SQ_RING);
+  if(u.sq_ring == MAP_FAILED) {
+    u.sq_ring = nullptr;
+    u.error = strerror(errno);
+    close(u);
+    return false;
+  }
+  if(single) {
+    u.cq_ring = u.sq_ring;
+  } else {
+    u.cq_ring = ::mmap(nullptr, u.cq_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, u.fd, IORING_OFF_CQ_RING);
+    if(u.cq_ring == MAP_FAILED) {
+      u.cq_ring = nullptr;
+      u.error = strerror(errno);
+      close(u);
+      return false;
+    }
+  }
+
+  u.sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+  u.sqes = ::mmap(nullptr, u.sqes_size, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, u.fd, IORING_OFF_SQES);
+  if(u.sqes == MAP_FAILED) {
+    u.sqes = nullptr;
+    u.error = strerror(errno);
+    close(u);
+    return false;
+  }
+
+  char* sq = static_cast<char*>(u.sq_ring);
+  u.sq_head = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+  u.sq_tail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+  u.sq_mask = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+  u.sq_array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+  u.sq_entries = p.sq_entries;
+
+  char* cq = static_cast<char*>(u.cq_ring);
+  u.cq_head = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+  u.cq_tail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+  u.cq_mask = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+  u.cqes = cq + p.cq_off.cqes;
+
+  if(not probe(u)) {
+    std::string err = u.error;
+    close(u);
+    u.error = err;
+    return false;
+  }
+  return true;
+}
+
+void
+close(Uring& u)
+{
+  if(u.sqes)
+    ::munmap(u.sqes, u.sqes_size);
+  if(u.cq_ring and u.cq_ring != u.sq_ring)
+    ::munmap(u.cq_ring, u.cq_size);
+  if(u.sq_ring)
+    ::munmap(u.sq_ring, u.sq_size);
+  if(u.fd >= 0)
+    ::close(u.fd);
+
+  u.fd = -1;
+  u.sq_ring = u.cq_ring = u.sqes = u.cqes = nullptr;
+  u.sq_head = u.sq_tail = u.sq_mask = u.sq_array = nullptr;
+  u.cq_head = u.cq_tail = u.cq_mask = nullptr;
+  u.queued = 0;
+  u.interest.clear();
+  u.armed.clear();
+  u.generation.clear();
+  u.io.clear();
+  u.retired.clear();
+  u.events.clear();
+}
+
+int
+wait(Uring& u, const Time* t)
+{
+  u.events.clear();
+
+  // A timeout request with a completion count of one finishes as soon as
+  // any other request completes, so it never outlives the wait.
+  __kernel_timespec ts;
+  if(t != nullptr) {
+    if(io_uring_sqe* sqe = get_sqe(u)) {
+      ts.tv_sec = t->sec;
+      ts.tv_nsec = static_cast<long long>(t->usec) * 1000;
+      sqe->opcode = IORING_OP_TIMEOUT;
+      sqe->fd = -1;
+      sqe->addr = reinterpret_cast<uint64_t>(&ts);
+      sqe->len = 1;
+      sqe->off = 1;
+      sqe->user_data = Internal;
+      push_sqe(u);
+    }
+  }
+
+  int n = sys_enter(u.fd, u.queued, 1, IORING_ENTER_GETEVENTS);
+  if(n < 0 and errno != EBUSY)
+    return -1;
+  if(n > 0)
+    u.queued -= n;
+
+  unsigned head = *u.cq_head;
+  unsigned tail = __atomic_load_n(u.cq_tail, __ATOMIC_ACQUIRE);
+  io_uring_cqe* cqes = static_cast<io_uring_cqe*>(u.cqes);
+  for(; head != tail; ++head) {
+    const io_uring_cqe& cqe = cqes[head & *u.cq_mask];
+    if(cqe.user_data & Internal)
+      continue;
+
+    int fd = static_cast<int>(cqe.user_data & 0xffffffff);
+    Uring::Op op = static_cast<Uring::Op>((cqe.user_data >> 61) & 0x3);
+    uint32_t gen = static_cast<uint32_t>(cqe.user_data >> 32) & Generation_mask;
+
+    if(op != Uring::Poll) {
+      // The descriptor accepted by a released listener has no one to own
+      // it.
+      Uring::Io* io = find_io(u, fd);
+      if(not io or gen != (io->generation & Generation_mask)) {
+        if(op == Uring::Accept and cqe.res >= 0)
+          ::close(cqe.res);
+        continue;
+      }
+      io->pending &= ~op_bit(op);
+      const uint8_t* data = op == Uring::Recv ? io->in.data() : nullptr;
+      u.events.push_back(Uring::Event { fd, op, false, false, cqe.res, data });
+      continue;
+    }
+
+    if(fd >= static_cast<int>(u.generation.size()) or
+       gen != (u.generation[fd] & Generation_mask))
+      continue;
+
+    u.armed[fd] = 0;
+    Uring::Event ev { fd, Uring::Poll, false, false, cqe.res, nullptr };
+    if(cqe.res < 0) {
+      ev.read = ev.write = true;
+    } else {
+      ev.read = cqe.res & (POLLIN | POLLRDHUP | POLLHUP | POLLERR);
+      ev.write = cqe.res & (POLLOUT | POLLHUP | POLLERR);
+    }
+    u.events.push_back(ev);
+  }
+  __atomic_store_n(u.cq_head, head, __ATOMIC_RELEASE);
+
+  return u.events.size();
+}
+
+bool
+set_read(Uring& u, int fd)
+{
+  return update(u, fd, interest(u, fd) | Uring::Read);
+}
+
+bool
+set_write(Uring& u, int fd)
+{
+  return update(u, fd, interest(u, fd) | Uring::Write);
+}
+
+bool
+clear_read(Uring& u, int fd)
+{
+  return update(u, fd, interest(u, fd) & ~Uring::Read);
+}
+
+bool
+clear_write(Uring& u, int fd)
+{
+  return update(u, fd, interest(u, fd) & ~Uring::Write);
+}
+
+void
+rearm(Uring& u, int fd)
+{
+  if(fd < 0 or fd >= static_cast<int>(u.interest.size()))
+    return;
+  if(u.interest[fd] and not u.armed[fd])
+    poll_add(u, fd, u.interest[fd]);
+}
+
+bool
+accept(Uring& u, int fd)
+{
+  io_uring_sqe* sqe = start(u, fd, Uring::Accept);
+  if(not sqe)
+    return false;
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+  push_sqe(u);
+  return true;
+}
+
+bool
+recv(Uring& u, int fd)
+{
+  io_uring_sqe* sqe = start(u, fd, Uring::Recv);
+  if(not sqe)
+    return false;
+  Uring::Io& io = *u.io[fd];
+  if(io.in.empty())
+    io.in.resize(Uring::Recv_size);
+  sqe->opcode = IORING_OP_RECV;
+  sqe->addr = reinterpret_cast<uint64_t>(io.in.data());
+  sqe->len = io.in.size();
+  push_sqe(u);
+  return true;
+}
+
+bool
+send(Uring& u, int fd, const iovec* iov, std::size_t n)
+{
+  io_uring_sqe* sqe = start(u, fd, Uring::Send);
+  if(not sqe)
+    return false;
+  Uring::Io& io = *u.io[fd];
+  if(n > Uring::Max_iov)
+    n = Uring::Max_iov;
+  std::copy(iov, iov + n, io.iov);
+  std::memset(&io.msg, 0, sizeof(io.msg));
+  io.msg.msg_iov = io.iov;
+  io.msg.msg_iovlen = n;
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->addr = reinterpret_cast<uint64_t>(&io.msg);
+  sqe->len = 1;
+  sqe->msg_flags = MSG_NOSIGNAL;
+  push_sqe(u);
+  return true;
+}
+
+void
+cancel(Uring& u, int fd)
+{
+  Uring::Io* io = find_io(u, fd);
+  if(not io)
+    return;
+  for(Uring::Op op : { Uring::Accept, Uring::Recv, Uring::Send }) {
+    if(not (io->pending & op_bit(op)))
+      continue;
+    io_uring_sqe* sqe = get_sqe(u);
+    if(not sqe)
+      return;
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = tag(fd, op, io->generation);
+    sqe->user_data = Internal;
+    push_sqe(u);
+  }
+}
+
+void
+release(Uring& u, int fd)
+{
+  Uring::Io* io = find_io(u, fd);
+  if(not io or not io->pending)
+    return;
+  cancel(u, fd);
+
+  // A cancelled receive may still write into its buffer, which is kept
+  // until the selector is closed rather than reused.
+  if(io->pending & op_bit(Uring::Recv))
+    u.retired.push_back(std::move(io->in));
+  io->in.clear();
+  ++io->generation;
+  io->pending = 0;
+}
+
+bool
+busy(const Uring& u, int fd)
+{
+  Uring::Io* io = find_io(u, fd);
+  return io and io->pending;
+}
+
+} // namespace flog
+
+#else
+
+namespace flog {
+
+// Without the io_uring headers the selector cannot be opened, and the
+// reactor falls back to another backend.
+
+bool
+open(Uring& u, unsigned entries)
+{
+  u.error = "io_uring is not supported on this platform";
+  return false;
+}
+
+void close(Uring& u) { }
+int wait(Uring& u, const Time* t) { errno = ENOSYS; return -1; }
+bool set_read(Uring& u, int fd) { return false; }
+bool set_write(Uring& u, int fd) { return false; }
+bool clear_read(Uring& u, int fd) { return false; }
+bool clear_write(Uring& u, int fd) { return false; }
+void rearm(Uring& u, int fd) { }
+bool accept(Uring& u, int fd) { return false; }
+bool recv(Uring& u, int fd) { return false; }
+bool send(Uring& u, int fd, const iovec* iov, std::size_t n) { return false; }
+void cancel(Uring& u, int fd) { }
+void release(Uring& u, int fd) { }
+bool busy(const Uring& u, int fd) { return false; }
+
+} // namespace flog
+
+#endif
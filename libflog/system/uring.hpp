@@ -0,0 +1,202 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#ifndef FLOWGRAMMABLE_URING_H
+#define FLOWGRAMMABLE_URING_H
+
+extern "C" {
+#include <sys/socket.h>
+#include <sys/uio.h>
+}
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "time.hpp"
+
+namespace flog {
+
+///
+/// @brief An io_uring based completion selector
+///
+/// Uring drives descriptor readiness through one-shot poll requests on an
+/// io_uring instance. Changes in read/write interest only queue submission
+/// entries; all entries queued during a loop turn, including the re-arming
+/// of polls that completed in the previous turn, are submitted together
+/// with the wait for completions in a single io_uring_enter call.
+///
+/// The rings are mapped with raw system calls, so no liburing is needed.
+/// When the headers or the running kernel lack io_uring support, open()
+/// fails and the caller is expected to fall back to another selector.
+///
+/// Each poll request is tagged with the descriptor and a generation that
+/// is bumped whenever the descriptor's request is replaced, so completions
+/// of cancelled requests are recognized and discarded.
+///
+/// Accepts, receives and sends may also be issued as ring operations, so
+/// that the kernel performs them and reports their results rather than
+/// readiness. Each descriptor has at most one operation of each kind in
+/// flight. A receive lands in a buffer owned by the selector, which stays
+/// valid until the next wait. The data of a send must stay valid until its
+/// completion is reported.
+///
+
+struct Uring
+{
+  /// Bits recorded in the interest vector.
+  enum Interest : uint32_t { Read = 0x01, Write = 0x02 };
+
+  /// The operations whose completions are reported.
+  enum Op : uint32_t { Poll, Accept, Recv, Send };
+
+  /// The most bytes received by one receive operation.
+  static const std::size_t Recv_size = 16384;
+
+  /// The most buffers gathered into one send operation.
+  static const std::size_t Max_iov = 64;
+
+  /// The readiness, or the result of an operation, reported by a single
+  /// completion. The result is that of the system call performed, or a
+  /// negated error number. The data of a receive is in the selector's
+  /// buffer for the descriptor.
+  struct Event
+  {
+    int fd;
+    Op op;
+    bool read;
+    bool write;
+    int res;
+    const uint8_t* data;
+  };
+
+  /// The operations in flight on a descriptor, and the memory the kernel
+  /// uses while they are. It is allocated once per descriptor and never
+  /// moves.
+  struct Io
+  {
+    Io();
+
+    uint32_t pending;
+    uint32_t generation;
+    std::vector<uint8_t> in;
+    msghdr msg;
+    iovec iov[Max_iov];
+  };
+
+  Uring();
+  ~Uring();
+
+  Uring(const Uring&) = delete;
+  Uring& operator=(const Uring&) = delete;
+
+  int fd;
+
+  // Submission ring.
+  void* sq_ring;
+  std::size_t sq_size;
+  unsigned* sq_head;
+  unsigned* sq_tail;
+  unsigned* sq_mask;
+  unsigned* sq_array;
+  void* sqes;
+  std::size_t sqes_size;
+  unsigned sq_entries;
+  unsigned queued;
+
+  // Completion ring. The completion ring may share the mapping of the
+  // submission ring.
+  void* cq_ring;
+  std::size_t cq_size;
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned* cq_mask;
+  void* cqes;
+
+  /// Per descriptor interest, and the interest of the outstanding poll
+  /// request, if any.
+  std::vector<uint32_t> interest;
+  std::vector<uint32_t> armed;
+  std::vector<uint32_t> generation;
+
+  /// Per descriptor operations, and the receive buffers of released ones.
+  std::vector<std::unique_ptr<Io>> io;
+  std::vector<std::vector<uint8_t>> retired;
+
+  /// The readiness events and results collected by the last wait.
+  std::vector<Event> events;
+
+  std::string error;
+};
+
+bool open(Uring& u, unsigned entries = 256);
+void close(Uring& u);
+int wait(Uring& u, const Time* t = nullptr);
+
+bool set_read(Uring& u, int fd);
+bool set_write(Uring& u, int fd);
+bool clear_read(Uring& u, int fd);
+bool clear_write(Uring& u, int fd);
+
+/// Re-arm the poll request of fd after its completion has been dispatched.
+/// The request is queued and submitted with the next wait.
+void rearm(Uring& u, int fd);
+
+/// Queue an accept on the listening descriptor fd. The accepted descriptor
+/// does not block, and is the result of the completion.
+bool accept(Uring& u, int fd);
+
+/// Queue a receive of at most Recv_size bytes into the buffer of fd.
+bool recv(Uring& u, int fd);
+
+/// Queue a gathering send of the n buffers of iov on fd. The vector is
+/// copied; the buffers it refers to are not.
+bool send(Uring& u, int fd, const iovec* iov, std::size_t n);
+
+/// Cancel the operations in flight on fd. Their completions are still
+/// reported, with -ECANCELED unless they finished first.
+void cancel(Uring& u, int fd);
+
+/// Cancel the operations in flight on fd, and discard their completions.
+/// A descriptor accepted regardless is closed. The data of a send must
+/// still stay valid until the cancellation completes.
+void release(Uring& u, int fd);
+
+/// Returns true if an operation is in flight on fd.
+bool busy(const Uring& u, int fd);
+
+inline
+Uring::Uring()
+  : fd(-1), sq_ring(nullptr), sq_size(0), sq_head(nullptr), sq_tail(nullptr),
+    sq_mask(nullptr), sq_array(nullptr), sqes(nullptr), sqes_size(0),
+    sq_entries(0), queued(0), cq_ring(nullptr), cq_size(0), cq_head(nullptr),
+    cq_tail(nullptr), cq_mask(nullptr), cqes(nullptr)
+{ }
+
+inline
+Uring::Io::Io()
+  : pending(0), generation(0), in(), msg(), iov()
+{ }
+
+inline
+Uring::~Uring()
+{
+  close(*this);
+}
+
+} // namespace flog
+
+#endif
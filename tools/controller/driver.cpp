@@ -12,14 +12,20 @@
 // or implied. See the License for the specific language governing
 // permissions and limitations under the License.
 
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include "libflog/system/manager.hpp"
 #include "libflog/system/reactor.hpp"
+#include "libflog/system/shard.hpp"
+#include "libflog/proto/ofp/service.hpp"
 
 int main(int argc, char** argv) {
-  if(argc != 2) {
-    std::cerr << "usage error: " << argv[0] << " <manager pipe>" << std::endl;
+  if(argc != 2 and argc != 3) {
+    std::cerr << "usage error: " << argv[0] << " <manager pipe> [shards]" << std::endl;
     std::exit(-1);
   }
 
@@ -28,7 +34,23 @@ int main(int argc, char** argv) {
   Logger logger("controller.log");
   Reactor reactor(logger);
   Manager manager(reactor, argv[1]);
+  manager.service.reset(new ofp::Session_service());
   subscribe_read(reactor, &manager);
+
+  // Run one reactor shard per core, each pinned to its core. Commands
+  // read by the manager are fanned out to the shards.
+  std::vector<std::unique_ptr<Shard>> shards;
+  int n = argc == 3 ? std::atoi(argv[2]) : 0;
+  int cores = std::thread::hardware_concurrency();
+  for(int i = 0; i < n; ++i) {
+    std::string log = "controller." + std::to_string(i) + ".log";
+    shards.emplace_back(new Shard(i, cores > 0 ? i % cores : -1, log));
+    shards.back()->manager.service.reset(new ofp::Session_service());
+    if(not start(*shards.back()))
+      std::cerr << "shard " << i << ": " << shards.back()->error << std::endl;
+    add_shard(manager, shards.back().get());
+  }
+
   run(reactor);
 
   return 0;
@@ -23,9 +23,10 @@ usage_error(char* name)
 {
   std::cerr << "usage: " << name << " ";
   std::cerr << "Action Name <attributes ...> [Target]" << std::endl;
-  std::cerr << "Action: add|del|set|stop" << std::endl;
+  std::cerr << "Action: add|del|set|stop|stats" << std::endl;
   std::cerr << "Name: remote|local|app|x509|acl|ofp|server|client" << std::endl;
   std::cerr << "\tstop: no attributes" << std::endl;
+  std::cerr << "\tstats: no attributes" << std::endl;
   std::cerr << "\tremote: - no attributes" << std::endl;
   std::cerr << "\tlocal: - no attributes" << std::endl;
   std::cerr << "\tapp: <name> - application name to load or unload" << std::endl;
@@ -35,6 +36,7 @@ usage_error(char* name)
   std::cerr << "\tofp: echo interval <sec>.<usec> - time between requests" << std::endl; 
   std::cerr << "\tofp: echo timeout <sec>.<usec> - time till miss" << std::endl; 
   std::cerr << "\tofp: echo miss <count> - misses till failure" << std::endl; 
+  std::cerr << "\tofp: trust 0|1|2 - full, structural or no validation" << std::endl; 
   std::cerr << "\tserver: <ip>:TCP|UDP|SCTP|TLS:<port> - to listen on" << std::endl;
   std::cerr << "\tclient: <ip>:TCP|UDP|SCTP|TLS:<port> <ip>:TCP|UDP|SCTP|TLS:<port> - to connect" << std::endl;
   std::cerr << "Target: <identifier> - to target" << std::endl;
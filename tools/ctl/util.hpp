@@ -87,6 +87,8 @@ to_action(const std::string& in)
     return Command::Stop;
   if(s.compare("NOOP")==0)
     return Command::NoOp;
+  if(s.compare("STATS")==0)
+    return Command::Stats;
   //if it's at this point, we need to throw
   throw Some_Error("no conversion for action, input: "+in+"\n");
 }
@@ -269,6 +271,8 @@ make_command(const std::vector<std::string>& arglist)
     Command::Action act = to_action(arglist[0]);
     if(act == Command::Stop)
       return Command(Command::Stop);//TODO make this better?
+    if(act == Command::Stats)
+      return Command(Command::Stats);
     if(arglist.size()<3)
       throw Some_Error("Too few arguments\n");
     Command::Name name = to_name(arglist[1]);
@@ -0,0 +1,308 @@
+// Copyright (c) 2013 Flowgrammable, LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS"
+// BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <libflog/arena.hpp>
+#include <libflog/buffer.hpp>
+#include <libflog/proto/ofp/v1_0/message.hpp>
+#include <libflog/proto/ofp/v1_1/message.hpp>
+#include <libflog/proto/ofp/v1_2/message.hpp>
+#include <libflog/proto/ofp/v1_3/message.hpp>
+#include <libflog/proto/ofp/v1_3/encoder.hpp>
+#include <libflog/proto/ofp/v1_3_1/message.hpp>
+
+using namespace flog;
+
+using Clock = std::chrono::steady_clock;
+
+// Print the rate of n messages of the given total size processed in the
+// interval [start, stop).
+void
+report(const char* what, std::size_t n, std::size_t size,
+       Clock::time_point start, Clock::time_point stop)
+{
+  double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+  std::cout << std::left << std::setw(10) << what
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << ns / n << " ns/msg"
+            << std::setw(10) << size * 1e3 / ns << " MB/s\n";
+}
+
+// Versions without a single-pass encoder have nothing to report.
+template<typename Message>
+  std::size_t
+  run_encoder(const std::vector<Message>&, int, std::size_t, std::size_t)
+  {
+    return 0;
+  }
+
+// Encode the decoded messages in a single pass.
+std::size_t
+run_encoder(const std::vector<ofp::v1_3::Message>& messages, int iterations,
+            std::size_t n, std::size_t size)
+{
+  // The encoders should agree on every message whose stored lengths
+  // are correct.
+  std::size_t differ = 0;
+  for (const ofp::v1_3::Message& m : messages) {
+    Buffer a(bytes(m));
+    Buffer_view v(a);
+    Buffer b;
+    differ += not to_buffer(v, m) or not ofp::v1_3::encode(b, m) or a != b;
+  }
+  if (differ)
+    std::cout << differ << " messages encode differently\n";
+
+  std::size_t failures = 0;
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    for (const ofp::v1_3::Message& m : messages) {
+      Buffer buf;
+      failures += not ofp::v1_3::encode(buf, m);
+    }
+  }
+  report("encode1", n, size, start, Clock::now());
+  return failures;
+}
+
+// Versions whose messages cannot be decoded over a previous message have
+// nothing to report.
+template<typename Message>
+  std::size_t
+  run_recycled(const std::vector<Message>&, std::vector<Buffer>&, int,
+               std::size_t, std::size_t)
+  {
+    return 0;
+  }
+
+// Decode the corpus into one message object, reusing its payload and
+// sequences from each message to the next.
+template<typename Message>
+  std::size_t
+  recycle(std::vector<Buffer>& corpus, int iterations,
+          std::size_t n, std::size_t size)
+  {
+    std::size_t failures = 0;
+    Message m;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      for (Buffer& buf : corpus) {
+        Buffer_view v(buf);
+        failures += not from_buffer(v, m);
+      }
+    }
+    report("decoder", n, size, start, Clock::now());
+    return failures;
+  }
+
+std::size_t
+run_recycled(const std::vector<ofp::v1_3::Message>&,
+             std::vector<Buffer>& corpus, int iterations,
+             std::size_t n, std::size_t size)
+{
+  return recycle<ofp::v1_3::Message>(corpus, iterations, n, size);
+}
+
+std::size_t
+run_recycled(const std::vector<ofp::v1_3_1::Message>&,
+             std::vector<Buffer>& corpus, int iterations,
+             std::size_t n, std::size_t size)
+{
+  return recycle<ofp::v1_3_1::Message>(corpus, iterations, n, size);
+}
+
+// Versions whose decoders do not honor the trust level have nothing to
+// report.
+template<typename Message>
+  std::size_t
+  run_trusted(const std::vector<Message>&, std::vector<Buffer>&, int,
+              std::size_t, std::size_t)
+  {
+    return 0;
+  }
+
+// Decode the corpus into one message object at each trust level. Full
+// validation is compared with a structural decode followed by a call to
+// is_valid(), and must reject the same messages.
+template<typename Message>
+  std::size_t
+  trusted(std::vector<Buffer>& corpus, int iterations,
+          std::size_t n, std::size_t size)
+  {
+    using namespace ofp;
+
+    Message m;
+    std::size_t invalid = 0;
+    {
+      Trust_scope scope(STRUCTURAL_VALIDATION);
+      Clock::time_point start = Clock::now();
+      for (int i = 0; i < iterations; ++i) {
+        for (Buffer& buf : corpus) {
+          Buffer_view v(buf);
+          if (from_buffer(v, m))
+            invalid += not is_valid(m);
+        }
+      }
+      report("validate", n, size, start, Clock::now());
+    }
+
+    std::size_t differ = 0;
+    for (Trust_level t : {FULL_VALIDATION, STRUCTURAL_VALIDATION,
+                          NO_VALIDATION}) {
+      Trust_scope scope(t);
+      std::size_t rejected = 0;
+      Clock::time_point start = Clock::now();
+      for (int i = 0; i < iterations; ++i) {
+        for (Buffer& buf : corpus) {
+          Buffer_view v(buf);
+          rejected += not from_buffer(v, m);
+        }
+      }
+      report(to_string(t).c_str(), n, size, start, Clock::now());
+      if (t == FULL_VALIDATION and rejected != invalid) {
+        std::cout << "full validation rejects " << rejected
+                  << " messages, is_valid() " << invalid << "\n";
+        ++differ;
+      }
+    }
+    return differ;
+  }
+
+std::size_t
+run_trusted(const std::vector<ofp::v1_3::Message>&,
+            std::vector<Buffer>& corpus, int iterations,
+            std::size_t n, std::size_t size)
+{
+  return trusted<ofp::v1_3::Message>(corpus, iterations, n, size);
+}
+
+std::size_t
+run_trusted(const std::vector<ofp::v1_3_1::Message>&,
+            std::vector<Buffer>& corpus, int iterations,
+            std::size_t n, std::size_t size)
+{
+  return trusted<ofp::v1_3_1::Message>(corpus, iterations, n, size);
+}
+
+// Decode and re-encode every message in the corpus the given number of
+// times. Messages that do not decode are skipped.
+template<typename Message>
+  int
+  run(const std::vector<Buffer>& files, int iterations)
+  {
+    std::vector<Buffer> corpus;
+    std::vector<Message> messages;
+    std::size_t size = 0;
+    for (const Buffer& f : files) {
+      Buffer buf = f;
+      Buffer_view v(buf);
+      Message m;
+      if (not from_buffer(v, m) or remaining(v) != 0)
+        continue;
+      size += buf.size();
+      corpus.push_back(std::move(buf));
+      messages.push_back(std::move(m));
+    }
+    if (corpus.empty()) {
+      std::cerr << "no messages could be decoded\n";
+      return -1;
+    }
+    std::cout << corpus.size() << " of " << files.size() << " messages, "
+              << size << " bytes\n";
+
+    std::size_t n = corpus.size() * iterations;
+    size *= iterations;
+
+    // Decode the corpus.
+    std::size_t failures = 0;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      for (Buffer& buf : corpus) {
+        Message m;
+        Buffer_view v(buf);
+        failures += not from_buffer(v, m);
+      }
+    }
+    report("decode", n, size, start, Clock::now());
+
+    // Decode the corpus into an arena that is reset after each message.
+    Arena arena;
+    start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      for (Buffer& buf : corpus) {
+        {
+          Arena_scope scope(arena);
+          Message m;
+          Buffer_view v(buf);
+          failures += not from_buffer(v, m);
+        }
+        arena.reset();
+      }
+    }
+    report("decodea", n, size, start, Clock::now());
+
+    failures += run_recycled(messages, corpus, iterations, n, size);
+    failures += run_trusted(messages, corpus, iterations, n, size);
+
+    // Encode the decoded messages.
+    start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      for (const Message& m : messages) {
+        Buffer buf(bytes(m));
+        Buffer_view v(buf);
+        failures += not to_buffer(v, m);
+      }
+    }
+    report("encode", n, size, start, Clock::now());
+
+    failures += run_encoder(messages, iterations, n, size);
+
+    return failures ? -1 : 0;
+  }
+
+int
+main(int argc, char* argv[])
+{
+  if (argc < 4) {
+    std::cerr << "usage: " << argv[0]
+              << " <version> <iterations> <file>...\n";
+    return -1;
+  }
+
+  std::string version = argv[1];
+  int iterations = std::atoi(argv[2]);
+  std::vector<Buffer> files;
+  for (int i = 3; i < argc; ++i)
+    if (Buffer buf = buffer_from_file(argv[i]))
+      files.push_back(std::move(buf));
+
+  if (version == "1.0")
+    return run<ofp::v1_0::Message>(files, iterations);
+  if (version == "1.1")
+    return run<ofp::v1_1::Message>(files, iterations);
+  if (version == "1.2")
+    return run<ofp::v1_2::Message>(files, iterations);
+  if (version == "1.3")
+    return run<ofp::v1_3::Message>(files, iterations);
+  if (version == "1.3.1")
+    return run<ofp::v1_3_1::Message>(files, iterations);
+
+  std::cerr << "unsupported version '" << version << "'\n";
+  return -1;
+}
@@ -36,8 +36,9 @@ int switch_test() {
     
   Test_agent ta;
   Xid_generator<uint32_t> xid;
+  Timer_wheel wheel;
   FSM_config c(FSM_config::v1_0, FSM_config::a1_0, tc);
-  FSM_switch fsm_sw(c, xid, ta);
+  FSM_switch fsm_sw(c, xid, ta, wheel);
 
   if (fsm_sw.state != FSM_switch::IDLE) {
    std::cout << "FAIL: switch did not reach IDLE state " << '\n';
@@ -62,7 +63,9 @@ int switch_test() {
    }
 
   // Test 5: Verify echo timeout triggers FAIL state
+  advance(wheel, Time(7));
   time(fsm_sw, Time(7)); 
+  advance(wheel, Time(9, 1));
   time(fsm_sw, Time(9, 1));
   if (fsm_sw.state != FSM_switch::FAIL){
 	  std::cout << "FAIL: switch did not reach FAIL state after echo timeout" << '\n';
@@ -83,12 +86,14 @@ int switch_test() {
   init(fsm_sw, t);
   t = Time(5, 1);
 
+  advance(wheel, t);
   time(fsm_sw, t);
   if (fsm_sw.state != FSM_switch::FAIL){
    std::cout << "FAIL: switch did not reach FAIL state after feature_req timeout " << '\n';
    return -1;
   }
 
+  advance(wheel, t);
   time(fsm_sw, t);
   return 0;
 }
@@ -108,9 +113,10 @@ int controller_test() {
   tc.barrier_res_wait = Time(5);
   
   Test_app myapp;
-  Xid_generator<uint32_t> xid; 
+  Xid_generator<uint32_t> xid;
+  Timer_wheel wheel;
   FSM_config c(FSM_config::v1_0, FSM_config::a1_0, tc);
-  FSM_controller fsm_ctl(c,xid, myapp);
+  FSM_controller fsm_ctl(c,xid, myapp, wheel);
 
   if (fsm_ctl.state != FSM_controller::IDLE) {
    std::cout << "FAIL: controller did not reach IDLE state " << '\n';
@@ -133,7 +139,9 @@ int controller_test() {
     std::cout << "FAIL: controller did not reach ESTABLISHED state" << '\n';
     return -1;
   }
+  advance(wheel, Time(7));
   time(fsm_ctl, Time(7));
+  advance(wheel, Time(9, 1));
   time(fsm_ctl, Time(9, 1));
   // Test 5:  Verify controller is in fail state after echo timeout
   if (fsm_ctl.state != FSM_controller::FAIL) {
@@ -153,6 +161,7 @@ int controller_test() {
   // Test 4: Verify fsm_ctl reaches fail state after feature_req timeout
   init(fsm_ctl, t);
   t = Time(5,1);
+  advance(wheel, t);
   time(fsm_ctl, t);
   if (fsm_ctl.state != FSM_controller::FAIL) {
     std::cout << "FAIL: controller did not reach FAIL state after feature_req timeout " << '\n';
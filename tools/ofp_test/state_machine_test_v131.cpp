@@ -34,9 +34,10 @@ int switch_test() {
   tc.barrier_res_wait = Time(5);
   
   Test_agent ta;
-  Xid_generator<uint32_t> xid;  
+  Xid_generator<uint32_t> xid;
+  Timer_wheel wheel;
   FSM_config c(FSM_config::v1_3_1, FSM_config::a1_3, tc);
-  FSM_switch fsm_sw(c,xid, ta);
+  FSM_switch fsm_sw(c,xid, ta, wheel);
 
   if (fsm_sw.state != FSM_switch::IDLE) {
     std::cerr << "FAIL: switch did not read IDLE state" << std::endl;
@@ -61,7 +62,9 @@ int switch_test() {
     return -1;
   }
   // Test 5: Verify echo timeout triggers FAIL state
+  advance(wheel, Time(7));
   time(fsm_sw, Time(7));
+  advance(wheel, Time(9,1));
   time(fsm_sw, Time(9,1));
   if (fsm_sw.state != FSM_switch::FAIL){
       std::cout << "FAIL: switch did not reach FAIL state after echo timeout " << '\n';
@@ -80,6 +83,7 @@ int switch_test() {
   t = Time(0,0);
   init(fsm_sw, t);
   t = Time(5, 1);
+  advance(wheel, t);
   time(fsm_sw, t);
   if (fsm_sw.state != FSM_switch::FAIL) {
     std::cerr << "FAIL: switch did not reach FAIL state after feature_req timeout " << std::endl;
@@ -105,9 +109,10 @@ int controller_test()
   tc.barrier_res_wait = Time(5);
   
   Test_app myapp;
-  Xid_generator<uint32_t> xid; 
+  Xid_generator<uint32_t> xid;
+  Timer_wheel wheel;
   FSM_config c(FSM_config::v1_3_1, FSM_config::a1_3, tc);
-  FSM_controller fsm_ctl(c,xid,myapp);
+  FSM_controller fsm_ctl(c,xid,myapp, wheel);
 
   if (fsm_ctl.state != FSM_controller::IDLE) {
     std::cerr << "FAIL: controller did not reach IDLE state " << std::endl;
@@ -131,7 +136,9 @@ int controller_test()
     std::cerr << "FAIL: controller did not reach ESTABLISHED state" << std::endl;
     return -1;
   }
+  advance(wheel, Time(7));
   time(fsm_ctl, Time(7));
+  advance(wheel, Time(9,1));
   time(fsm_ctl, Time(9,1));
   // Test 5: Verify controller is in fail state after echo timeout
   if (fsm_ctl.state != FSM_controller::FAIL) {
@@ -152,6 +159,7 @@ int controller_test()
   t = Time(0,0);
   init(fsm_ctl, t);
   t = Time(5,1);
+  advance(wheel, t);
   time(fsm_ctl, t);
   if (fsm_ctl.state != FSM_controller::FAIL) {
     std::cerr << "FAIL: controller did not reach FAIL state after feature_req timeout " << std::endl;
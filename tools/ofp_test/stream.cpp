@@ -13,11 +13,13 @@
 // permissions and limitations under the License.
 
 #include <iostream>
-//#include <sstream>
+#include <iterator>
+#include <sstream>
 
-#include <libflog/proto/ofp/v1_0/message.hpp>
+#include <libflog/proto/ofp/batch.hpp>
 
 using namespace flog;
+using namespace flog::ofp;
 
 // Report the success or failure of a specific test.
 bool 
@@ -29,78 +31,39 @@ report(const std::string& name, bool result)
   return result;
 }
 
-template<typename Message>
-  bool 
-  run_version(Buffer_view& v)
-  {
-    // Read the message from the buffer.  
-    Message msg;
-    Formatter f;
-    if (not from_buffer(v, msg)) {
-      std::cout << to_string(msg, f) << std::endl ;
-      return report("from-buffer", false);
-    }
-    std::cout << to_string(msg, f) << std::endl ;
-    return true;
+std::string
+to_string(const Common_message& m, Formatter& f)
+{
+  switch (m.version) {
+  case 1: return to_string(*m.ptr.m1, f);
+  case 2: return to_string(*m.ptr.m2, f);
+  case 3: return to_string(*m.ptr.m3, f);
+  case 4:
+    if (m.patch == 0)
+      return to_string(*m.ptr.m4, f);
+    else
+      return to_string(*m.ptr.m5, f);
+  default: return std::string();
   }
+}
 
-bool
-wrap_version(Buffer_view& v)
+// Print the messages decoded into the batch.
+void
+print(const Message_batch& b)
 {
-  switch(*v.first) {
-  case ofp::v1_0::VERSION:
-    return run_version<ofp::v1_0::Message>(v);
-    break;
-    
-    /*
-  case v1_1::version::value:
-    return run_version<v1_1::payload>(buf);
-    break;
-  case v1_2::version::value:
-    return run_version<v1_2::payload>(buf);
-    break;
-  case v1_3::version::value:
-    return run_version<v1_3::payload>(buf);
-    break;
-  case v1_3_1::version::value:
-    return run_version<v1_3_1::payload>(buf);
-    break;
-    */
-  default:
-    std::cout << "Bad version: " << int(*v.first) << std::endl;
-    return false;
-  }
+  Formatter f;
+  for (std::size_t i = 0; i < b.size(); ++i)
+    std::cout << to_string(b[i], f) << std::endl;
 }
 
+// Read the whole of standard input into a buffer.
 Buffer 
 read_stdin()
 {
-  using namespace ofp;
-
-  Buffer buf(8);
-  std::cin.read((char*)buf.data(), 8);
-  std::size_t sz = std::cin.gcount();
-  if (sz < 8) {
-    std::cerr << "Hdr Bytes Missing:" << (8 - sz) << std::endl;
-    buf.bad();
-    return buf;
-  }
-
-  uint16_t len = *reinterpret_cast<uint16_t*>(buf.data() + 2);
-  len = Foreign_byte_order::msbf(len);
-
-  // Resize so we can read the entire buffer.
-  if (std::size_t(len) - 8 > buf.size())
-    buf.resize(len - 8);
-
-  std::cin.read((char*)buf.data() + 8, len - 8);
-  
-  // Resize so that we hold exactly the entire buffer.
-  sz = std::cin.gcount();
-  if (sz < len)
-    buf.resize(sz + 8);
-  
-  return buf;
+  std::istreambuf_iterator<char> first(std::cin), last;
+  std::string s(first, last);
+  const Byte* p = reinterpret_cast<const Byte*>(s.data());
+  return Buffer(p, p + s.size());
 }
 
 int main(int argc, char** argv)
@@ -110,18 +73,36 @@ int main(int argc, char** argv)
     return -1;
   }
 
+  // Decode the stream in batches. A message that cannot be decoded is
+  // written to a file and skipped, so long as its length can be read.
+  Buffer buf = read_stdin();
+  Buffer_view v = buf;
+  Message_batch batch;
   std::size_t cnt = 0;
-  while (Buffer buf = read_stdin()) {
-    Buffer_view v = buf;
-    std::cout << "remaining: " << remaining(v) << std::endl;
-    if (not wrap_version(v)) {
-      std::cout << "remaining: " << remaining(v) << std::endl;
-      std::stringstream ss;
-      ss << "fail_file_" << cnt;
-      buffer_to_file(ss.str(), buf);
-      std::cerr << "fail:" << remaining(v) << std::endl;
+  int status = 0;
+  while (remaining(v) != 0) {
+    clear(batch);
+    bool ok = decode(v, batch);
+    print(batch);
+    if (ok) {
+      if (remaining(v) != 0) {
+        std::cerr << "incomplete message: " << remaining(v) << std::endl;
+        status = -1;
+      }
+      break;
     }
+
+    report("from-buffer", false);
+    status = -1;
+    std::size_t n = remaining(v) < 4 ? 0 : load<uint16_t>(v.first + 2);
+    if (n < 8 or n > remaining(v))
+      break;
+    std::stringstream ss;
+    ss << "fail_file_" << cnt++;
+    Buffer fail(v.first, v.first + n);
+    buffer_to_file(ss.str(), fail);
+    v.first += n;
   }
   
-  return 0;
+  return status;
 }
@@ -16,6 +16,7 @@
 
 #include "libflog/system/manager.hpp"
 #include "libflog/system/reactor.hpp"
+#include "libflog/proto/ofp/service.hpp"
 
 int main(int argc, char** argv) {
   if(argc != 2) {
@@ -28,6 +29,7 @@ int main(int argc, char** argv) {
   Logger logger("switch-agent.log");
   Reactor reactor(logger);
   Manager manager(reactor, argv[1]);
+  manager.service.reset(new ofp::Session_service());
   subscribe_read(reactor, &manager);
   run(reactor);
 